@@ -0,0 +1,171 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/BoostFilesystem.hpp"
+#include "common/Log.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/StringConversion.hpp"
+
+#include "Tools/Testing/BenchmarkReport.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace Tools {
+namespace Testing {
+
+using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+
+/// Quote a string for use in JSON
+std::string json_string(const std::string& str)
+{
+  std::string result("\"");
+  for(std::string::const_iterator c = str.begin(); c != str.end(); ++c)
+  {
+    if(*c == '"' || *c == '\\')
+      result += '\\';
+    result += *c == '\n' ? ' ' : *c;
+  }
+  result += "\"";
+  return result;
+}
+
+std::string json_number(const Real value)
+{
+  std::ostringstream str;
+  str.precision(10);
+  str << value;
+  return str.str();
+}
+
+} // detail
+
+////////////////////////////////////////////////////////////////////////////////
+
+BenchmarkReport::BenchmarkReport(const std::string& name) :
+  m_name(name)
+{
+}
+
+void BenchmarkReport::add_parameter(const std::string& name, const Uint value)
+{
+  m_parameters.push_back(std::make_pair(name, to_str(value)));
+}
+
+void BenchmarkReport::add_parameter(const std::string& name, const Real value)
+{
+  m_parameters.push_back(std::make_pair(name, detail::json_number(value)));
+}
+
+void BenchmarkReport::add_parameter(const std::string& name, const std::string& value)
+{
+  m_parameters.push_back(std::make_pair(name, detail::json_string(value)));
+}
+
+void BenchmarkReport::add_timing(const std::string& kernel, const Real seconds, const Uint nb_calls)
+{
+  cf3_assert(nb_calls > 0);
+  Timing timing;
+  timing.kernel = kernel;
+  timing.seconds = seconds;
+  timing.nb_calls = nb_calls;
+  m_timings.push_back(timing);
+}
+
+std::string BenchmarkReport::filename() const
+{
+  const Uint nb_procs = PE::Comm::instance().is_active() ? PE::Comm::instance().size() : 1u;
+  return "benchmark-" + m_name + "-P" + to_str(nb_procs) + ".json";
+}
+
+void BenchmarkReport::write(const std::string& directory) const
+{
+  const bool parallel = PE::Comm::instance().is_active();
+  const Uint nb_procs = parallel ? PE::Comm::instance().size() : 1u;
+  const Uint rank = parallel ? PE::Comm::instance().rank() : 0u;
+
+  // Reduce all timings at once, rather than one collective per kernel
+  const Uint nb_timings = m_timings.size();
+  std::vector<Real> seconds(nb_timings);
+  for(Uint i = 0; i != nb_timings; ++i)
+    seconds[i] = m_timings[i].seconds;
+  std::vector<Real> min_seconds(seconds), max_seconds(seconds), sum_seconds(seconds);
+  if(parallel && nb_timings != 0)
+  {
+    PE::Comm::instance().all_reduce(PE::min(), &seconds[0], nb_timings, &min_seconds[0]);
+    PE::Comm::instance().all_reduce(PE::max(), &seconds[0], nb_timings, &max_seconds[0]);
+    PE::Comm::instance().all_reduce(PE::plus(), &seconds[0], nb_timings, &sum_seconds[0]);
+  }
+
+  if(rank != 0)
+    return;
+
+  std::ostringstream json;
+  json << "{\n";
+  json << "  \"benchmark\": " << detail::json_string(m_name) << ",\n";
+  json << "  \"nb_procs\": " << nb_procs << ",\n";
+  json << "  \"parameters\": {";
+  for(Uint i = 0; i != m_parameters.size(); ++i)
+    json << (i == 0 ? "\n" : ",\n") << "    " << detail::json_string(m_parameters[i].first) << ": " << m_parameters[i].second;
+  json << (m_parameters.empty() ? "},\n" : "\n  },\n");
+  json << "  \"kernels\": [";
+  for(Uint i = 0; i != nb_timings; ++i)
+  {
+    const Timing& timing = m_timings[i];
+    json << (i == 0 ? "\n" : ",\n")
+         << "    { \"name\": " << detail::json_string(timing.kernel)
+         << ", \"nb_calls\": " << timing.nb_calls
+         << ", \"min\": " << detail::json_number(min_seconds[i])
+         << ", \"mean\": " << detail::json_number(sum_seconds[i] / static_cast<Real>(nb_procs))
+         << ", \"max\": " << detail::json_number(max_seconds[i])
+         << ", \"max_per_call\": " << detail::json_number(max_seconds[i] / static_cast<Real>(timing.nb_calls))
+         << " }";
+
+    std::cout << "<DartMeasurement name=\"" << m_name << " " << timing.kernel << " time\" type=\"numeric/double\">" << max_seconds[i] << "</DartMeasurement>" << std::endl;
+  }
+  json << (nb_timings == 0 ? "]\n" : "\n  ]\n");
+  json << "}\n";
+
+  const boost::filesystem::path path = boost::filesystem::path(directory) / filename();
+  std::ofstream file(path.string().c_str());
+  if(!file)
+    throw FileSystemError(FromHere(), "Could not open benchmark report " + path.string());
+  file << json.str();
+  file.close();
+
+  CFinfo << "Benchmark results written to " << path.string() << CFendl;
+}
+
+void BenchmarkReport::barrier() const
+{
+  if(PE::Comm::instance().is_active())
+    PE::Comm::instance().barrier();
+}
+
+Real BenchmarkReport::wall_time()
+{
+  using namespace boost::posix_time;
+  static const ptime epoch(microsec_clock::universal_time());
+  return static_cast<Real>((microsec_clock::universal_time() - epoch).total_microseconds()) * 1e-6;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Testing
+} // Tools
+} // cf3
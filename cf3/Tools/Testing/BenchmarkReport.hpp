@@ -0,0 +1,101 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Tools_Testing_BenchmarkReport_hpp
+#define cf3_Tools_Testing_BenchmarkReport_hpp
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Tools/Testing/LibTesting.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace Tools {
+namespace Testing {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Collects the timings of the kernels of a benchmark, and writes them as JSON.
+/// Timings are reduced over all processes, and rank 0 writes the file
+/// benchmark-<name>-P<nb_procs>.json, so runs with a different number of processes
+/// can be compared. tools/benchmark-suite.py runs the benchmarks and merges the files.
+///
+/// All processes must time the same kernels in the same order:
+/// @code
+/// BenchmarkReport report("mesh-synchronize");
+/// report.add_parameter("nb_cells", nb_cells);
+/// report.time("synchronize", boost::bind(&Field::synchronize, &field), 100);
+/// report.write();
+/// @endcode
+class Testing_API BenchmarkReport
+{
+public:
+
+  /// @param name Name of the benchmark, used in the file name
+  BenchmarkReport(const std::string& name);
+
+  /// Record a parameter of the run, such as the mesh size
+  void add_parameter(const std::string& name, const Uint value);
+  void add_parameter(const std::string& name, const Real value);
+  void add_parameter(const std::string& name, const std::string& value);
+
+  /// Record the time spent on this process in nb_calls calls of a kernel
+  void add_timing(const std::string& kernel, const Real seconds, const Uint nb_calls = 1);
+
+  /// Time nb_calls calls of functor, in wall clock time. One untimed call is done first to warm up
+  /// caches and lazily built data, then all processes are synchronized before the timer starts.
+  template<typename FunctorT>
+  void time(const std::string& kernel, FunctorT functor, const Uint nb_calls = 1)
+  {
+    functor();
+    barrier();
+    const Real start = wall_time();
+    for(Uint i = 0; i != nb_calls; ++i)
+      functor();
+    add_timing(kernel, wall_time() - start, nb_calls);
+  }
+
+  /// Wall clock time in seconds. common::Timer measures the CPU time of the process,
+  /// which is wrong for kernels that wait for communication or run in several threads.
+  static Real wall_time();
+
+  /// Name of the file written by write(), depending on the number of processes
+  std::string filename() const;
+
+  /// Reduce the timings over all processes and let rank 0 write them to directory.
+  /// For each kernel a DartMeasurement with the maximum time is printed as well,
+  /// as expected by CDash and tools/test-mpi-scalability.py. Must be called on all processes.
+  void write(const std::string& directory = ".") const;
+
+private:
+  /// Barrier, if running in parallel
+  void barrier() const;
+
+  struct Timing
+  {
+    std::string kernel;
+    Real seconds;
+    Uint nb_calls;
+  };
+
+  const std::string m_name;
+  /// Parameter names and their values, formatted as JSON
+  std::vector< std::pair<std::string, std::string> > m_parameters;
+  std::vector<Timing> m_timings;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Testing
+} // Tools
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_Tools_Testing_BenchmarkReport_hpp
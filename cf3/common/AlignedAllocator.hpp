@@ -0,0 +1,97 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_AlignedAllocator_hpp
+#define cf3_common_AlignedAllocator_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <boost/static_assert.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Allocator for standard containers, returning memory aligned to ALIGNMENT bytes,
+/// e.g. 64 for the size of a cache line and of the widest vector registers.
+/// Eigen::aligned_allocator only guarantees the alignment Eigen itself needs.
+template <typename T, std::size_t ALIGNMENT = 64>
+class AlignedAllocator
+{
+  BOOST_STATIC_ASSERT( ALIGNMENT >= sizeof(void*) && (ALIGNMENT & (ALIGNMENT-1)) == 0 );
+
+public: // typedefs
+
+  typedef T                 value_type;
+  typedef T*                pointer;
+  typedef const T*          const_pointer;
+  typedef T&                reference;
+  typedef const T&          const_reference;
+  typedef std::size_t       size_type;
+  typedef std::ptrdiff_t    difference_type;
+
+  template <typename U>
+  struct rebind { typedef AlignedAllocator<U,ALIGNMENT> other; };
+
+public: // functions
+
+  AlignedAllocator() {}
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U,ALIGNMENT>&) {}
+
+  pointer address(reference x) const { return &x; }
+
+  const_pointer address(const_reference x) const { return &x; }
+
+  size_type max_size() const { return (size_type(-1) - ALIGNMENT) / sizeof(T); }
+
+  /// Allocate n values. The address returned by malloc is stored just before the aligned block.
+  pointer allocate(size_type n, const void* = 0)
+  {
+    if (n > max_size())
+      throw std::bad_alloc();
+    void* raw = std::malloc(n*sizeof(T) + ALIGNMENT + sizeof(void*));
+    if (raw == NULL)
+      throw std::bad_alloc();
+    const std::size_t start = reinterpret_cast<std::size_t>(raw) + sizeof(void*);
+    void* aligned = reinterpret_cast<void*>( (start + ALIGNMENT-1) & ~(ALIGNMENT-1) );
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return static_cast<pointer>(aligned);
+  }
+
+  void deallocate(pointer p, size_type)
+  {
+    if (p != NULL)
+      std::free(reinterpret_cast<void**>(p)[-1]);
+  }
+
+  void construct(pointer p, const T& value) { new (static_cast<void*>(p)) T(value); }
+
+  void destroy(pointer p) { p->~T(); }
+};
+
+template <typename T, typename U, std::size_t ALIGNMENT>
+bool operator==(const AlignedAllocator<T,ALIGNMENT>&, const AlignedAllocator<U,ALIGNMENT>&) { return true; }
+
+template <typename T, typename U, std::size_t ALIGNMENT>
+bool operator!=(const AlignedAllocator<T,ALIGNMENT>&, const AlignedAllocator<U,ALIGNMENT>&) { return false; }
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_AlignedAllocator_hpp
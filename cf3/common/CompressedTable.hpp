@@ -0,0 +1,201 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_CompressedTable_hpp
+#define cf3_common_CompressedTable_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+
+#include "common/Assertions.hpp"
+#include "common/Component.hpp"
+#include "common/Foreach.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Component holding a table with variable row-size per row, in compressed row storage.
+/// All rows are stored one after the other in one array of values, and an array of
+/// offsets gives the start of each row. Compared to DynTable this avoids one
+/// allocation per row, and rows that are adjacent in the table are adjacent in memory.
+///
+/// The table is built in two passes over the data, first counting the row sizes,
+/// then filling in the values:
+/// @code
+/// table.start_build(nb_rows);
+/// for (...) table.count(row);
+/// table.allocate();
+/// for (...) table.push_back(row, value);
+/// table.finish_build();
+/// @endcode
+/// Rows have the same access API as DynTable rows: size(), operator[] and iteration.
+template<typename T>
+class CompressedTable : public common::Component {
+
+public:
+
+  typedef std::vector<T> ValuesT;
+  typedef std::vector<Uint> OffsetsT;
+  typedef boost::iterator_range<T*> Row;
+  typedef boost::iterator_range<const T*> ConstRow;
+
+  /// Contructor
+  /// @param name of the component
+  CompressedTable ( const std::string& name ) : Component(name), m_offsets(1,0u) { }
+
+  ~CompressedTable () {}
+
+  /// Get the class name
+  static std::string type_name () { return "CompressedTable<"+common::class_name<T>()+">"; }
+
+  /// @return the number of rows
+  Uint size() const { return m_offsets.size()-1; }
+
+  /// @return the total number of values in all rows
+  Uint nb_values() const { return m_values.size(); }
+
+  Uint row_size(const Uint i) const { cf3_assert(i<size()); return m_offsets[i+1]-m_offsets[i]; }
+
+  /// Resize the number of rows. Existing rows are kept, new rows are empty.
+  void resize(const Uint new_size)
+  {
+    if (new_size < size())
+    {
+      m_offsets.resize(new_size+1);
+      m_values.resize(m_offsets.back());
+    }
+    else
+    {
+      m_offsets.resize(new_size+1,m_offsets.back());
+    }
+  }
+
+  /// Remove all rows and free the memory
+  void clear()
+  {
+    OffsetsT(1,0u).swap(m_offsets);
+    ValuesT().swap(m_values);
+    OffsetsT().swap(m_fill);
+  }
+
+  /// First pass of the construction: removes all rows, and creates nb_rows empty rows
+  /// whose size is set with count()
+  void start_build(const Uint nb_rows)
+  {
+    m_offsets.assign(nb_rows+1,0u);
+    m_values.clear();
+    m_fill.clear();
+  }
+
+  /// Increase the size of a row by n values
+  /// @pre start_build() was called
+  void count(const Uint row, const Uint n=1)
+  {
+    cf3_assert(row<size());
+    m_offsets[row+1] += n;
+  }
+
+  /// Allocate the counted values. Rows can be accessed after this,
+  /// and filled with push_back() in the second pass.
+  void allocate()
+  {
+    for (Uint i=0; i<size(); ++i)
+      m_offsets[i+1] += m_offsets[i];
+    m_values.resize(m_offsets.back());
+    m_fill.assign(m_offsets.begin(),m_offsets.end()-1);
+  }
+
+  /// Second pass of the construction: append a value to a row
+  /// @pre allocate() was called and the row is not full yet
+  void push_back(const Uint row, const T& value)
+  {
+    cf3_assert(row<m_fill.size());
+    cf3_assert(m_fill[row]<m_offsets[row+1]);
+    m_values[m_fill[row]++] = value;
+  }
+
+  /// Release the memory used during construction
+  void finish_build()
+  {
+    OffsetsT().swap(m_fill);
+  }
+
+  /// Copy a nested container, such as a std::vector< std::vector<T> >
+  template<typename RaggedT>
+  void assign(const RaggedT& rows)
+  {
+    start_build(rows.size());
+    for (Uint i=0; i<rows.size(); ++i)
+      count(i,rows[i].size());
+    allocate();
+    for (Uint i=0; i<rows.size(); ++i)
+      boost_foreach( const typename RaggedT::value_type::value_type& v, rows[i] )
+        push_back(i,v);
+    finish_build();
+  }
+
+  Row operator[] (const Uint idx)
+  {
+    cf3_assert(idx<size());
+    return Row(data()+m_offsets[idx],data()+m_offsets[idx+1]);
+  }
+
+  ConstRow operator[] (const Uint idx) const
+  {
+    cf3_assert(idx<size());
+    return ConstRow(data()+m_offsets[idx],data()+m_offsets[idx+1]);
+  }
+
+  /// @return A const reference to the values of all rows
+  const ValuesT& values() const { return m_values; }
+
+  /// @return A const reference to the row offsets in values(), of size size()+1
+  const OffsetsT& offsets() const { return m_offsets; }
+
+private: // functions
+
+  T* data() { return m_values.empty() ? 0 : &m_values[0]; }
+
+  const T* data() const { return m_values.empty() ? 0 : &m_values[0]; }
+
+private: // data
+
+  /// start of each row in m_values, followed by the total number of values
+  OffsetsT m_offsets;
+
+  /// values of all rows
+  ValuesT m_values;
+
+  /// insertion position of each row, only used during construction
+  OffsetsT m_fill;
+
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::ostream& operator<<(std::ostream& os, CompressedTable<Uint>::ConstRow row);
+std::ostream& operator<<(std::ostream& os, CompressedTable<int>::ConstRow row);
+std::ostream& operator<<(std::ostream& os, CompressedTable<Real>::ConstRow row);
+
+std::ostream& operator<<(std::ostream& os, const CompressedTable<Uint>& table);
+std::ostream& operator<<(std::ostream& os, const CompressedTable<int>& table);
+std::ostream& operator<<(std::ostream& os, const CompressedTable<Real>& table);
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_CompressedTable_hpp
@@ -98,6 +98,14 @@ public:
     return m_weak_ptr.expired();
   }
 
+  /// Shared ownership of the object, null if it was destroyed.
+  /// Components are owned by their parent, so this is only meant for holders outside the component tree
+  /// that must keep the object alive, such as python objects sharing its memory.
+  boost::shared_ptr<T> lock() const
+  {
+    return m_weak_ptr.lock();
+  }
+
   T* operator->() const
   {
     cf3_assert(!m_weak_ptr.expired());
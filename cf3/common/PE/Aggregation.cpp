@@ -0,0 +1,109 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <limits>
+
+#include <boost/cstdint.hpp>
+
+#include "common/PE/Comm.hpp"
+#include "common/PE/Aggregation.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common  {
+namespace PE {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// message tag for the data sent to the aggregators
+  const int aggregation_tag = 7332;
+
+  /// largest message, as MPI counts are int
+  const Uint max_message_size = 1u << 30;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Aggregation::Aggregation(const Uint nb_aggregators) :
+  m_nb_ranks(1u),
+  m_rank(0u),
+  m_nb_groups(1u),
+  m_group(0u)
+{
+  if (Comm::instance().is_active())
+  {
+    m_nb_ranks = Comm::instance().size();
+    m_rank = Comm::instance().rank();
+  }
+
+  m_nb_groups = nb_aggregators == 0 ? m_nb_ranks : std::min(nb_aggregators, m_nb_ranks);
+  m_group = m_rank * m_nb_groups / m_nb_ranks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint Aggregation::group_begin(const Uint group) const
+{
+  // first rank r with r*nb_groups >= group*nb_ranks
+  return (group * m_nb_ranks + m_nb_groups - 1) / m_nb_groups;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Aggregation::send(const char* data, const Uint size) const
+{
+  cf3_assert(!is_aggregator());
+
+  const int aggregator = group_begin(m_group);
+  const boost::uint64_t nb_bytes = size;
+  MPI_CHECK_RESULT(MPI_Send,(const_cast<boost::uint64_t*>(&nb_bytes), (int)sizeof(boost::uint64_t), MPI_BYTE, aggregator, detail::aggregation_tag, Comm::instance().communicator()));
+
+  for (Uint begin = 0; begin < size; begin += detail::max_message_size)
+  {
+    const int count = std::min(size - begin, detail::max_message_size);
+    MPI_CHECK_RESULT(MPI_Send,(const_cast<char*>(data + begin), count, MPI_BYTE, aggregator, detail::aggregation_tag, Comm::instance().communicator()));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Aggregation::receive(const Uint rank, std::vector<char>& data) const
+{
+  cf3_assert(is_aggregator());
+  cf3_assert(rank > m_rank && rank < group_end(m_group));
+
+  boost::uint64_t nb_bytes = 0;
+  MPI_CHECK_RESULT(MPI_Recv,(&nb_bytes, (int)sizeof(boost::uint64_t), MPI_BYTE, (int)rank, detail::aggregation_tag, Comm::instance().communicator(), MPI_STATUS_IGNORE));
+
+  const Uint size = nb_bytes;
+  data.resize(size);
+  for (Uint begin = 0; begin < size; begin += detail::max_message_size)
+  {
+    const int count = std::min(size - begin, detail::max_message_size);
+    MPI_CHECK_RESULT(MPI_Recv,(&data[begin], count, MPI_BYTE, (int)rank, detail::aggregation_tag, Comm::instance().communicator(), MPI_STATUS_IGNORE));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Aggregation::receive(const Uint rank, std::string& data) const
+{
+  std::vector<char> buffer;
+  receive(rank, buffer);
+  data.assign(buffer.begin(), buffer.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // PE
+} // common
+} // cf3
@@ -0,0 +1,90 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_PE_Aggregation_hpp
+#define cf3_common_PE_Aggregation_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+
+#include "common/CF.hpp"
+#include "common/CommonAPI.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+namespace PE {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file Aggregation.hpp
+  @brief Groups of consecutive ranks for aggregated output.
+  The first rank of every group, its aggregator, receives the data of the other ranks of the group and writes it,
+  so that only the aggregators open files. Data sent to an aggregator is received in the order it was sent,
+  so an aggregator can first receive small headers of all ranks of its group, and then their data one rank at a time.
+  Without an active communicator, there is a single group with only this process.
+**/
+
+class Common_API Aggregation {
+
+public:
+
+  /// constructor
+  /// @param nb_aggregators number of groups, limited to the number of ranks. 0 makes every rank an aggregator.
+  Aggregation(const Uint nb_aggregators);
+
+  /// number of groups
+  Uint nb_groups() const { return m_nb_groups; }
+
+  /// group of this rank
+  Uint group() const { return m_group; }
+
+  /// first rank of a group, which is its aggregator
+  Uint group_begin(const Uint group) const;
+
+  /// one past the last rank of a group
+  Uint group_end(const Uint group) const { return group_begin(group+1); }
+
+  /// check if this rank writes the data of its group
+  bool is_aggregator() const { return m_rank == group_begin(m_group); }
+
+  /// check if the groups contain more than one rank, so that data has to be sent
+  bool is_aggregating() const { return m_nb_groups != m_nb_ranks; }
+
+  /// send data to the aggregator of the group of this rank
+  void send(const char* data, const Uint size) const;
+
+  /// send data to the aggregator of the group of this rank
+  void send(const std::string& data) const { send(data.data(), data.size()); }
+
+  /// receive on an aggregator the next data sent by a rank of its group
+  void receive(const Uint rank, std::vector<char>& data) const;
+
+  /// receive on an aggregator the next data sent by a rank of its group
+  void receive(const Uint rank, std::string& data) const;
+
+private:
+
+  Uint m_nb_ranks;
+  Uint m_rank;
+  Uint m_nb_groups;
+  Uint m_group;
+
+}; // Aggregation
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // PE
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_PE_Aggregation_hpp
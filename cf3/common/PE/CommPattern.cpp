@@ -56,6 +56,7 @@ CommPattern::CommPattern(const std::string& name): Component(name), m_gid(alloca
   //self->regist_signal ( "update" , "Executes communication patterns on all the registered data.", "" ).connect ( boost::bind ( &CommPattern2::update, self, _1 ) );
   m_isUpToDate=false;
   m_isFreeze=false;
+  m_revision=0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -461,6 +462,9 @@ void CommPattern::setup()
   Uint *gid=cwv_gid();
   BOOST_FOREACH(temp_buffer_item& i, m_add_buffer) *gid++=i.gid;
 
+  // the send and receive maps changed
+  ++m_revision;
+
   // clear stuff and reset other things
   m_isUpToDate=true;
   m_add_buffer.clear();
@@ -591,6 +595,48 @@ void CommPattern::synchronize( const CommWrapper& pobj )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CommPattern::synchronize_start( const std::string& name )
+{
+  Handle<CommWrapper> pobj(get_child(name));
+  synchronize_start(*pobj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CommPattern::synchronize_start( const CommWrapper& pobj )
+{
+  if ( !pobj.needs_update() )
+    return;
+
+  if ( m_pending_exchanges.count(&pobj) )
+    throw common::IllegalCall(FromHere(), name() + ": synchronization of " + pobj.name() + " was already started.");
+
+  PendingExchange& pending = m_pending_exchanges[&pobj];
+  post_exchange(pobj,pending.sndbuf,pending.rcvbuf,pending.requests);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CommPattern::synchronize_finish( const std::string& name )
+{
+  Handle<CommWrapper> pobj(get_child(name));
+  synchronize_finish(*pobj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CommPattern::synchronize_finish( const CommWrapper& pobj )
+{
+  std::map<const CommWrapper*, PendingExchange>::iterator pending = m_pending_exchanges.find(&pobj);
+  if ( pending == m_pending_exchanges.end() )
+    return;
+
+  complete_exchange(pobj,pending->second.rcvbuf,pending->second.requests);
+  m_pending_exchanges.erase(pending);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 // having the vectors for the intermediate buf coming from outside allows keeping them and reuse for all synchronize
 void CommPattern::synchronize_this( const CommWrapper& pobj, std::vector<unsigned char>& sndbuf, std::vector<unsigned char>& rcvbuf )
 {
@@ -598,11 +644,73 @@ void CommPattern::synchronize_this( const CommWrapper& pobj, std::vector<unsigne
 //  std::cout << PERank << pobj.needs_update() << "\n" << std::flush;
   if ( pobj.needs_update() )
   {
-    pobj.pack(sndbuf,m_sendMap);
-    rcvbuf.resize(m_recvMap.size()*pobj.size_of()*pobj.stride());
-    PE::Comm::instance().all_to_all(sndbuf,m_sendCount,rcvbuf,m_recvCount,pobj.size_of()*pobj.stride());
+    std::vector<MPI_Request> requests;
+    post_exchange(pobj,sndbuf,rcvbuf,requests);
+    complete_exchange(pobj,rcvbuf,requests);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// only ranks with a nonzero count in m_sendCount/m_recvCount are contacted, which avoids the latency of an all_to_all when a rank has few neighbours
+void CommPattern::post_exchange( const CommWrapper& pobj, std::vector<unsigned char>& sndbuf, std::vector<unsigned char>& rcvbuf, std::vector<MPI_Request>& requests )
+{
+  const int item_size=pobj.size_of()*pobj.stride();
+  const int nproc=(const int)m_sendCount.size();
+  const int tag=exchange_tag(pobj);
+  Communicator comm=PE::Comm::instance().communicator();
+
+  pobj.pack(sndbuf,m_sendMap);
+  rcvbuf.resize(m_recvMap.size()*item_size);
+
+  // receives are posted first, so that the sends can complete without intermediate buffering
+  int offset=0;
+  for (int i=0; i<nproc; i++)
+  {
+    if (m_recvCount[i]!=0)
+    {
+      requests.push_back(MPI_REQUEST_NULL);
+      MPI_CHECK_RESULT(MPI_Irecv,(&rcvbuf[offset], m_recvCount[i]*item_size, MPI_BYTE, i, tag, comm, &requests.back()));
+    }
+    offset+=m_recvCount[i]*item_size;
+  }
+
+  offset=0;
+  for (int i=0; i<nproc; i++)
+  {
+    if (m_sendCount[i]!=0)
+    {
+      requests.push_back(MPI_REQUEST_NULL);
+      MPI_CHECK_RESULT(MPI_Isend,(&sndbuf[offset], m_sendCount[i]*item_size, MPI_BYTE, i, tag, comm, &requests.back()));
+    }
+    offset+=m_sendCount[i]*item_size;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CommPattern::complete_exchange( const CommWrapper& pobj, std::vector<unsigned char>& rcvbuf, std::vector<MPI_Request>& requests )
+{
+  if (requests.size()!=0)
+    MPI_CHECK_RESULT(MPI_Waitall,((int)requests.size(), &requests[0], MPI_STATUSES_IGNORE));
+  requests.clear();
+
+  if (m_recvMap.size()!=0)
     pobj.unpack(rcvbuf,m_recvMap);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int CommPattern::exchange_tag( const CommWrapper& pobj ) const
+{
+  // commwrappers are registered in the same order on all ranks, so their position is a tag that matches on both sides
+  int tag=0;
+  BOOST_FOREACH( const CommWrapper& child, find_components<CommWrapper>(*this) )
+  {
+    if (&child==&pobj) return tag;
+    ++tag;
   }
+  return tag;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
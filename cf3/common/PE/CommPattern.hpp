@@ -7,6 +7,8 @@
 #ifndef cf3_common_PE_CommPattern_hpp
 #define cf3_common_PE_CommPattern_hpp
 
+#include <map>
+
 #include "common/Component.hpp"
 #include "common/BoostArray.hpp"
 #include "common/PE/Comm.hpp"
@@ -229,6 +231,26 @@ public:
   /// @param name the name of the parallel object
   void synchronize( const CommWrapper& pobj );
 
+  /// start a non-blocking synchronization of the parallel object designated by its name
+  /// only the ranks that actually share nodes with the current rank are contacted
+  /// the registered data must not be modified until synchronize_finish is called for the same object
+  /// @param name the name of the parallel object
+  void synchronize_start( const std::string& name );
+
+  /// start a non-blocking synchronization of the parallel object designated by its commwrapper reference
+  /// @param pobj the parallel object
+  /// @see synchronize_start( const std::string& name )
+  void synchronize_start( const CommWrapper& pobj );
+
+  /// wait for the synchronization started by synchronize_start and copy the received data into the ghost nodes
+  /// does nothing if no synchronization was started for the object
+  /// @param name the name of the parallel object
+  void synchronize_finish( const std::string& name );
+
+  /// wait for the synchronization started by synchronize_start and copy the received data into the ghost nodes
+  /// @param pobj the parallel object
+  void synchronize_finish( const CommWrapper& pobj );
+
   /// add element to the commpattern
   /// when all changes done, all needs to be committed by calling setup
   /// if global id is not on current rank, then a ghost is automatically created on current rank
@@ -269,6 +291,10 @@ public:
   /// @return true or false, respectively
   bool isUpToDate() const { return m_isUpToDate; }
 
+  /// accessor to the revision of the send and receive maps, incremented by every setup
+  /// @return the number of times setup was called
+  Uint revision() const { return m_revision; }
+
   /// accessor to check if compattern is frozen or not
   /// @return true or false, respectively
   bool isFreeze() const { return m_isFreeze; }
@@ -281,6 +307,18 @@ public:
   /// @return vector of bools
   std::vector<bool>& isUpdatable() { return m_isUpdatable; }
 
+  /// accessor to the number of items sent to each rank
+  const std::vector< CPint >& send_count() const { return m_sendCount; }
+
+  /// accessor to the local ids of the items sent, grouped per receiving rank
+  const std::vector< CPint >& send_map() const { return m_sendMap; }
+
+  /// accessor to the number of items received from each rank
+  const std::vector< CPint >& recv_count() const { return m_recvCount; }
+
+  /// accessor to the local ids of the items received, grouped per sending rank
+  const std::vector< CPint >& recv_map() const { return m_recvMap; }
+
   //@} END ACCESSORS
 
 protected: // helper function
@@ -292,6 +330,19 @@ protected: // helper function
   /// @param rcvbuf vector for intermediate buffer for recieve
   void synchronize_this( const CommWrapper& pobj, std::vector<unsigned char>& sndbuf, std::vector<unsigned char>& rcvbuf );
 
+  /// pack the data and post the non-blocking sends and receives to the neighbouring ranks
+  /// @param pobj reference to commwrapper object to synchronize
+  /// @param sndbuf vector for intermediate buffer for send, must stay alive until complete_exchange
+  /// @param rcvbuf vector for intermediate buffer for recieve, must stay alive until complete_exchange
+  /// @param requests the posted requests are appended here
+  void post_exchange( const CommWrapper& pobj, std::vector<unsigned char>& sndbuf, std::vector<unsigned char>& rcvbuf, std::vector<MPI_Request>& requests );
+
+  /// wait for the posted requests and unpack the received data
+  void complete_exchange( const CommWrapper& pobj, std::vector<unsigned char>& rcvbuf, std::vector<MPI_Request>& requests );
+
+  /// message tag used when exchanging the data of a commwrapper, unique within this commpattern
+  int exchange_tag( const CommWrapper& pobj ) const;
+
 private:
 
   /// @name PROPERTIES
@@ -303,6 +354,9 @@ private:
   /// flag telling if pattern are set not to be allowed to change
   bool m_isFreeze;
 
+  /// incremented by setup, so users of the maps can tell they changed
+  Uint m_revision;
+
   //@} END PROPERTIES
 
   /// @name BUFFERS HOLDING TEMPORARY DATA, TILL SETUP IS CALLED
@@ -343,6 +397,17 @@ private:
   /// this is the map of receiveing communication pattern
   std::vector< CPint > m_recvMap;
 
+  /// buffers and requests of a non-blocking synchronization in progress
+  struct PendingExchange
+  {
+    std::vector<unsigned char> sndbuf;
+    std::vector<unsigned char> rcvbuf;
+    std::vector<MPI_Request> requests;
+  };
+
+  /// non-blocking synchronizations in progress, by commwrapper
+  std::map<const CommWrapper*, PendingExchange> m_pending_exchanges;
+
 }; // CommPattern
 
 ////////////////////////////////////////////////////////////////////////////////////////////
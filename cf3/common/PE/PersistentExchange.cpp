@@ -0,0 +1,244 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "common/LibCommon.hpp"
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+
+#include "common/PE/Comm.hpp"
+#include "common/PE/CommPattern.hpp"
+#include "common/PE/PersistentExchange.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common  {
+namespace PE {
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < PersistentExchange, Component, LibCommon > PersistentExchange_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// message tag for the persistent exchanges, distinct from the tags used by CommPattern
+  const int persistent_exchange_tag = 7331;
+
+  /// round up a byte count, so that the data of the next commwrapper in a message stays aligned
+  inline Uint aligned_size(const Uint nb_bytes)
+  {
+    const Uint alignment = sizeof(double);
+    return ((nb_bytes + alignment - 1) / alignment) * alignment;
+  }
+
+  /// split a commpattern map, grouped per rank, into one map per rank with a nonzero count
+  void split_map(const std::vector<CommPattern::CPint>& count, const std::vector<CommPattern::CPint>& map, std::vector<int>& ranks, std::vector< std::vector<int> >& maps)
+  {
+    ranks.clear();
+    maps.clear();
+    Uint begin = 0;
+    const int nproc = count.size();
+    for(int i = 0; i != nproc; ++i)
+    {
+      if(count[i] != 0)
+      {
+        ranks.push_back(i);
+        maps.push_back(std::vector<int>(map.begin() + begin, map.begin() + begin + count[i]));
+      }
+      begin += count[i];
+    }
+  }
+
+  /// compute the byte offset of each commwrapper in each message, returning the total buffer size
+  Uint compute_offsets(const std::vector< Handle<CommWrapper> >& wrappers, const std::vector< std::vector<int> >& maps, std::vector< std::vector<Uint> >& offsets, std::vector<Uint>& message_begin, std::vector<Uint>& message_size)
+  {
+    const Uint nb_wrappers = wrappers.size();
+    const Uint nb_neighbours = maps.size();
+    offsets.assign(nb_wrappers, std::vector<Uint>(nb_neighbours, 0));
+    message_begin.assign(nb_neighbours, 0);
+    message_size.assign(nb_neighbours, 0);
+
+    Uint offset = 0;
+    for(Uint k = 0; k != nb_neighbours; ++k)
+    {
+      message_begin[k] = offset;
+      for(Uint w = 0; w != nb_wrappers; ++w)
+      {
+        offsets[w][k] = offset;
+        offset += aligned_size(maps[k].size() * wrappers[w]->size_of() * wrappers[w]->stride());
+      }
+      message_size[k] = offset - message_begin[k];
+    }
+    return offset;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+PersistentExchange::PersistentExchange(const std::string& name) :
+  Component(name),
+  m_comm_pattern_revision(0),
+  m_in_progress(false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+PersistentExchange::~PersistentExchange()
+{
+  free_requests();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PersistentExchange::setup(CommPattern& comm_pattern, const std::vector< Handle<CommWrapper> >& wrappers)
+{
+  if(m_in_progress)
+    throw common::IllegalCall(FromHere(), name() + ": can't setup while an exchange is in progress.");
+
+  free_requests();
+
+  m_comm_pattern = Handle<CommPattern>(comm_pattern.handle<Component>());
+
+  m_wrappers.clear();
+  m_wrapper_sizes.clear();
+  boost_foreach(const Handle<CommWrapper>& wrapper, wrappers)
+  {
+    if(is_null(wrapper))
+      throw common::BadPointer(FromHere(), name() + ": null commwrapper passed to setup.");
+    if(wrapper->needs_update())
+    {
+      m_wrappers.push_back(wrapper);
+      m_wrapper_sizes.push_back(wrapper->size());
+    }
+  }
+
+  m_comm_pattern_revision = comm_pattern.revision();
+
+  detail::split_map(comm_pattern.send_count(), comm_pattern.send_map(), m_send_ranks, m_send_maps);
+  detail::split_map(comm_pattern.recv_count(), comm_pattern.recv_map(), m_recv_ranks, m_recv_maps);
+
+  std::vector<Uint> send_begin, send_size, recv_begin, recv_size;
+  m_sndbuf.resize(detail::compute_offsets(m_wrappers, m_send_maps, m_send_offsets, send_begin, send_size));
+  m_rcvbuf.resize(detail::compute_offsets(m_wrappers, m_recv_maps, m_recv_offsets, recv_begin, recv_size));
+
+  if(m_wrappers.empty() || !PE::Comm::instance().is_active())
+    return;
+
+  // The buffers are never resized after this point, so the requests can be bound to them
+  Communicator comm = PE::Comm::instance().communicator();
+  const Uint nb_recv = m_recv_ranks.size();
+  const Uint nb_send = m_send_ranks.size();
+  m_requests.assign(nb_recv + nb_send, MPI_REQUEST_NULL);
+  for(Uint k = 0; k != nb_recv; ++k)
+    MPI_CHECK_RESULT(MPI_Recv_init,(&m_rcvbuf[recv_begin[k]], (int)recv_size[k], MPI_BYTE, m_recv_ranks[k], detail::persistent_exchange_tag, comm, &m_requests[k]));
+  for(Uint k = 0; k != nb_send; ++k)
+    MPI_CHECK_RESULT(MPI_Send_init,(&m_sndbuf[send_begin[k]], (int)send_size[k], MPI_BYTE, m_send_ranks[k], detail::persistent_exchange_tag, comm, &m_requests[nb_recv + k]));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PersistentExchange::start()
+{
+  if(m_in_progress)
+    throw common::IllegalCall(FromHere(), name() + ": exchange was already started.");
+
+  if(m_requests.empty())
+    return;
+
+  cf3_assert(is_valid());
+
+  const Uint nb_wrappers = m_wrappers.size();
+  const Uint nb_send = m_send_ranks.size();
+  for(Uint w = 0; w != nb_wrappers; ++w)
+  {
+    for(Uint k = 0; k != nb_send; ++k)
+      m_wrappers[w]->pack(m_send_maps[k], &m_sndbuf[m_send_offsets[w][k]]);
+  }
+
+  MPI_CHECK_RESULT(MPI_Startall,((int)m_requests.size(), &m_requests[0]));
+  m_in_progress = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PersistentExchange::finish()
+{
+  if(!m_in_progress)
+    return;
+
+  MPI_CHECK_RESULT(MPI_Waitall,((int)m_requests.size(), &m_requests[0], MPI_STATUSES_IGNORE));
+  m_in_progress = false;
+
+  const Uint nb_wrappers = m_wrappers.size();
+  const Uint nb_recv = m_recv_ranks.size();
+  for(Uint w = 0; w != nb_wrappers; ++w)
+  {
+    for(Uint k = 0; k != nb_recv; ++k)
+      m_wrappers[w]->unpack(&m_rcvbuf[m_recv_offsets[w][k]], m_recv_maps[k]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool PersistentExchange::is_valid() const
+{
+  if(is_null(m_comm_pattern))
+    return false;
+
+  // the maps may change without changing size, e.g. after renumbering
+  if(m_comm_pattern->revision() != m_comm_pattern_revision)
+    return false;
+
+  const Uint nb_wrappers = m_wrappers.size();
+  for(Uint w = 0; w != nb_wrappers; ++w)
+  {
+    if(is_null(m_wrappers[w]) || m_wrappers[w]->size() != m_wrapper_sizes[w])
+      return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint PersistentExchange::nb_neighbours() const
+{
+  std::vector<int> neighbours(m_send_ranks);
+  neighbours.insert(neighbours.end(), m_recv_ranks.begin(), m_recv_ranks.end());
+  std::sort(neighbours.begin(), neighbours.end());
+  return std::unique(neighbours.begin(), neighbours.end()) - neighbours.begin();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PersistentExchange::free_requests()
+{
+  if(!PE::Comm::instance().is_active())
+  {
+    m_requests.clear();
+    return;
+  }
+
+  boost_foreach(MPI_Request& request, m_requests)
+  {
+    if(request != MPI_REQUEST_NULL)
+      MPI_Request_free(&request);
+  }
+  m_requests.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // PE
+} // common
+} // cf3
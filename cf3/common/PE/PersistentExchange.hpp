@@ -0,0 +1,128 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_PE_PersistentExchange_hpp
+#define cf3_common_PE_PersistentExchange_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "common/Component.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/CommWrapper.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+namespace PE {
+
+class CommPattern;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file PersistentExchange.hpp
+  @brief Repeated synchronization of a fixed set of data registered in a CommPattern.
+  All the setup work of a synchronization is done once in setup(): the per-neighbour gather and scatter lists are extracted from the
+  commpattern, the send and receive buffers are sized, and persistent MPI requests are created on them.
+  Each synchronization then only packs the data, starts the requests and unpacks, sending a single message per neighbouring rank
+  that contains the data of all the registered commwrappers.
+  setup must be called again whenever the commpattern or the size of any of the commwrappers changes.
+**/
+
+class Common_API PersistentExchange : public Component {
+
+public:
+
+  /// constructor
+  /// @param name under this name will the component be registered
+  PersistentExchange(const std::string& name);
+
+  /// destructor
+  ~PersistentExchange();
+
+  /// Get the class name
+  static std::string type_name () { return "PersistentExchange"; }
+
+  /// precompute the buffers and requests to exchange the data of the given commwrappers
+  /// commwrappers that don't need updating are skipped
+  /// @param comm_pattern the communication pattern that defines the ghost nodes, must be set up
+  /// @param wrappers the data to synchronize, must all be registered in comm_pattern
+  void setup(CommPattern& comm_pattern, const std::vector< Handle<CommWrapper> >& wrappers);
+
+  /// pack the data and start the exchange. The data must not be modified until finish is called
+  void start();
+
+  /// wait for the exchange to complete and copy the received data to the ghost nodes
+  void finish();
+
+  /// blocking synchronization, equivalent to start() followed by finish()
+  void synchronize() { start(); finish(); }
+
+  /// check if the buffers still match the commpattern, i.e. it was not set up again, and the size of the registered data
+  bool is_valid() const;
+
+  /// number of neighbouring ranks that are communicated with
+  Uint nb_neighbours() const;
+
+private:
+
+  /// release the persistent MPI requests
+  void free_requests();
+
+  /// the commpattern used in the setup
+  Handle<CommPattern> m_comm_pattern;
+
+  /// the data to synchronize
+  std::vector< Handle<CommWrapper> > m_wrappers;
+
+  /// size of each commwrapper at setup time
+  std::vector<int> m_wrapper_sizes;
+
+  /// revision of the commpattern at setup time
+  Uint m_comm_pattern_revision;
+
+  /// ranks that data is sent to
+  std::vector<int> m_send_ranks;
+
+  /// ranks that data is received from
+  std::vector<int> m_recv_ranks;
+
+  /// for each rank in m_send_ranks, local ids of the items to send
+  std::vector< std::vector<int> > m_send_maps;
+
+  /// for each rank in m_recv_ranks, local ids of the ghost items to receive
+  std::vector< std::vector<int> > m_recv_maps;
+
+  /// for each commwrapper and each rank in m_send_ranks, byte offset of the packed data in m_sndbuf
+  std::vector< std::vector<Uint> > m_send_offsets;
+
+  /// for each commwrapper and each rank in m_recv_ranks, byte offset of the packed data in m_rcvbuf
+  std::vector< std::vector<Uint> > m_recv_offsets;
+
+  /// buffer holding the packed data of all commwrappers for all neighbours
+  std::vector<unsigned char> m_sndbuf;
+
+  /// buffer receiving the data of all commwrappers from all neighbours
+  std::vector<unsigned char> m_rcvbuf;
+
+  /// persistent requests, receives first
+  std::vector<MPI_Request> m_requests;
+
+  /// true between start and finish
+  bool m_in_progress;
+
+}; // PersistentExchange
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // PE
+} // common
+} // cf3
+
+#endif // cf3_common_PE_PersistentExchange_hpp
@@ -0,0 +1,462 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "fparser/fparser.hh"
+#include "extrasrc/fptypes.hh"
+#include "extrasrc/fpaux.hh"
+
+#include "common/Assertions.hpp"
+
+#include "math/FunctionProgram.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace FUNCTIONPARSERTYPES;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Operations of the instructions
+enum Operation
+{
+  // unary
+  NEG, ABS, ACOS, ACOSH, ASIN, ASINH, ATAN, ATANH, CBRT, CEIL, COS, COSH, COT, CSC,
+  EXP, EXP2, FLOOR, INT, LOG, LOG10, LOG2, SEC, SIN, SINH, SQRT, TAN, TANH, TRUNC,
+  NOT, NOTNOT, ABSNOT, ABSNOTNOT, INV, SQR, RSQRT, DEG, RAD,
+  // binary
+  ADD, SUB, MUL, DIV, MOD, POW, ATAN2, HYPOT, MAX, MIN,
+  EQUAL, NEQUAL, LESS, LESSOREQ, AND, OR, ABSAND, ABSOR, LOG2BY,
+  // ternary: select b or c depending on the truth of a
+  IF, ABSIF
+};
+
+/// Parser giving access to its bytecode
+class ProgramParser : public FunctionParser
+{
+public:
+  ProgramParser(const FunctionParser& parser) : FunctionParser(parser) {}
+
+  const std::vector<unsigned>& bytecode() { return getParserData()->mByteCode; }
+  const std::vector<Real>& immediates() { return getParserData()->mImmed; }
+};
+
+/// Operation of a unary opcode of the parser, or -1
+int unary_operation(const unsigned opcode)
+{
+  switch (opcode)
+  {
+    case cNeg:       return NEG;
+    case cAbs:       return ABS;
+    case cAcos:      return ACOS;
+    case cAcosh:     return ACOSH;
+    case cAsin:      return ASIN;
+    case cAsinh:     return ASINH;
+    case cAtan:      return ATAN;
+    case cAtanh:     return ATANH;
+    case cCbrt:      return CBRT;
+    case cCeil:      return CEIL;
+    case cCos:       return COS;
+    case cCosh:      return COSH;
+    case cCot:       return COT;
+    case cCsc:       return CSC;
+    case cExp:       return EXP;
+    case cExp2:      return EXP2;
+    case cFloor:     return FLOOR;
+    case cInt:       return INT;
+    case cLog:       return LOG;
+    case cLog10:     return LOG10;
+    case cLog2:      return LOG2;
+    case cSec:       return SEC;
+    case cSin:       return SIN;
+    case cSinh:      return SINH;
+    case cSqrt:      return SQRT;
+    case cTan:       return TAN;
+    case cTanh:      return TANH;
+    case cTrunc:     return TRUNC;
+    case cNot:       return NOT;
+    case cNotNot:    return NOTNOT;
+    case cAbsNot:    return ABSNOT;
+    case cAbsNotNot: return ABSNOTNOT;
+    case cInv:       return INV;
+    case cSqr:       return SQR;
+    case cRSqrt:     return RSQRT;
+    case cDeg:       return DEG;
+    case cRad:       return RAD;
+    default:         return -1;
+  }
+}
+
+/// Operation of a binary opcode of the parser, or -1.
+/// @param [out] swap  true if the operation takes the operands in reverse order
+int binary_operation(const unsigned opcode, bool& swap)
+{
+  swap = false;
+  switch (opcode)
+  {
+    case cAdd:         return ADD;
+    case cSub:         return SUB;
+    case cMul:         return MUL;
+    case cDiv:         return DIV;
+    case cMod:         return MOD;
+    case cPow:         return POW;
+    case cAtan2:       return ATAN2;
+    case cHypot:       return HYPOT;
+    case cMax:         return MAX;
+    case cMin:         return MIN;
+    case cEqual:       return EQUAL;
+    case cNEqual:      return NEQUAL;
+    case cLess:        return LESS;
+    case cLessOrEq:    return LESSOREQ;
+    case cGreater:     swap = true; return LESS;
+    case cGreaterOrEq: swap = true; return LESSOREQ;
+    case cAnd:         return AND;
+    case cOr:          return OR;
+    case cAbsAnd:      return ABSAND;
+    case cAbsOr:       return ABSOR;
+    case cLog2by:      return LOG2BY;
+    case cRDiv:        swap = true; return DIV;
+    case cRSub:        swap = true; return SUB;
+    default:           return -1;
+  }
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+FunctionProgram::FunctionProgram() :
+  m_is_compiled(false),
+  m_nb_vars(0),
+  m_nb_registers(0),
+  m_result(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool FunctionProgram::compile(const FunctionParser& parser, const Uint nb_vars)
+{
+  m_is_compiled = false;
+  m_nb_vars = nb_vars;
+  m_nb_registers = nb_vars;
+  m_instructions.clear();
+  m_constant_registers.clear();
+  m_constants.clear();
+
+  // the copy shares the bytecode of the parser
+  ProgramParser program_parser(parser);
+
+  const std::vector<unsigned>& bytecode = program_parser.bytecode();
+  const std::vector<Real>& immediates = program_parser.immediates();
+
+  std::vector<Uint> stack;
+  Uint immediate = 0;
+  if ( !translate(bytecode, immediates, 0, bytecode.size(), immediate, stack) || stack.size() != 1 )
+    return false;
+
+  m_result = stack.back();
+  m_is_compiled = true;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool FunctionProgram::translate(const std::vector<unsigned>& bytecode, const std::vector<Real>& immediates,
+                                const Uint begin, const Uint end, Uint& immediate, std::vector<Uint>& stack)
+{
+  for (Uint ip = begin; ip < end; ++ip)
+  {
+    const unsigned opcode = bytecode[ip];
+
+    if (opcode >= VarBegin)
+    {
+      stack.push_back(opcode - VarBegin);
+      continue;
+    }
+
+    const int unary = unary_operation(opcode);
+    if (unary >= 0)
+    {
+      if (stack.empty())
+        return false;
+      stack.back() = add(unary, stack.back());
+      continue;
+    }
+
+    bool swap;
+    const int binary = binary_operation(opcode, swap);
+    if (binary >= 0)
+    {
+      if (stack.size() < 2)
+        return false;
+      const Uint rhs = stack.back(); stack.pop_back();
+      const Uint lhs = stack.back();
+      stack.back() = swap ? add(binary, rhs, lhs) : add(binary, lhs, rhs);
+      continue;
+    }
+
+    switch (opcode)
+    {
+      case cImmed:
+        if (immediate >= immediates.size())
+          return false;
+        stack.push_back(add_constant(immediates[immediate++]));
+        break;
+
+      case cDup:
+        if (stack.empty())
+          return false;
+        stack.push_back(stack.back());
+        break;
+
+      case cFetch:
+        if (ip+1 >= end || bytecode[ip+1] >= stack.size())
+          return false;
+        stack.push_back(stack[bytecode[++ip]]);
+        break;
+
+      case cPopNMov:
+      {
+        if (ip+2 >= end)
+          return false;
+        const Uint target = bytecode[++ip];
+        const Uint source = bytecode[++ip];
+        if (target >= stack.size() || source >= stack.size())
+          return false;
+        stack[target] = stack[source];
+        stack.resize(target+1);
+        break;
+      }
+
+      case cSinCos:
+      case cSinhCosh:
+      {
+        if (stack.empty())
+          return false;
+        const Uint x = stack.back();
+        stack.back() = add(opcode == cSinCos ? SIN : SINH, x);
+        stack.push_back(add(opcode == cSinCos ? COS : COSH, x));
+        break;
+      }
+
+      case cNop:
+        break;
+
+      case cIf:
+      case cAbsIf:
+      {
+        // layout: cond cIf else_ip else_immed  [then] cJump end_ip end_immed  [else]
+        // where execution continues after else_ip and end_ip
+        if (stack.empty() || ip+2 >= end)
+          return false;
+        if (bytecode[ip+1] < ip+5 || bytecode[ip+1] >= end || bytecode[bytecode[ip+1]-2] != cJump)
+          return false;
+        const Uint condition = stack.back(); stack.pop_back();
+        const Uint jump = bytecode[ip+1] - 2;
+        const Uint else_immediate = bytecode[ip+2];
+        const Uint last = bytecode[jump+1];
+        const Uint end_immediate = bytecode[jump+2];
+        if (last < jump+2 || last >= end)
+          return false;
+
+        std::vector<Uint> then_stack(stack);
+        if ( !translate(bytecode, immediates, ip+3, jump, immediate, then_stack) || immediate != else_immediate )
+          return false;
+        std::vector<Uint> else_stack(stack);
+        if ( !translate(bytecode, immediates, jump+3, last+1, immediate, else_stack) || immediate != end_immediate )
+          return false;
+
+        // both branches must push one value, and leave the rest of the stack alone
+        if (then_stack.size() != stack.size()+1 || else_stack.size() != stack.size()+1 ||
+            !std::equal(stack.begin(), stack.end(), then_stack.begin()) ||
+            !std::equal(stack.begin(), stack.end(), else_stack.begin()))
+          return false;
+
+        stack.push_back(add(opcode == cIf ? IF : ABSIF, condition, then_stack.back(), else_stack.back()));
+        ip = last;
+        break;
+      }
+
+      default: // cJump outside if(), user defined functions, eval() and complex functions
+        return false;
+    }
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FunctionProgram::add(const Uint op, const Uint a, const Uint b, const Uint c)
+{
+  m_instructions.push_back(Instruction(op, m_nb_registers, a, b, c));
+  return m_nb_registers++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FunctionProgram::add_constant(const Real value)
+{
+  m_constant_registers.push_back(m_nb_registers);
+  m_constants.push_back(value);
+  return m_nb_registers++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FunctionProgram::setup_registers(std::vector<Real>& registers) const
+{
+  // the values of all registers, followed by their error flags
+  registers.assign(2*m_nb_registers*block_size, 0.);
+  for (Uint i=0; i<m_constants.size(); ++i)
+    std::fill_n(&registers[m_constant_registers[i]*block_size], (Uint)block_size, m_constants[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Loops applying an expression of a, or of a and b, to all points.
+/// The error flag of the result is set if an operand has an error or if the error condition holds,
+/// which are the checks of FunctionParser::Eval().
+#define CF3_UNARY_LOOP(operation, expression, error) \
+  case operation: for (Uint i=0; i<nb_points; ++i) { const Real a = x[i]; r[i] = (expression); re[i] = xe[i] + Real(error); } break;
+#define CF3_BINARY_LOOP(operation, expression, error) \
+  case operation: for (Uint i=0; i<nb_points; ++i) { const Real a = x[i]; const Real b = y[i]; r[i] = (expression); re[i] = xe[i] + ye[i] + Real(error); } break;
+
+void FunctionProgram::evaluate(const Uint nb_points,
+                               const Real* vars, const Uint vars_stride,
+                               Real* result, const Uint result_stride,
+                               std::vector<Real>& registers) const
+{
+  cf3_assert(m_is_compiled);
+  cf3_assert(nb_points <= block_size);
+  cf3_assert(registers.size() == 2*m_nb_registers*block_size);
+
+  Real* reg = &registers[0];
+  Real* err = reg + m_nb_registers*block_size;
+
+  for (Uint var=0; var<m_nb_vars; ++var)
+  {
+    Real* r = reg + var*block_size;
+    for (Uint i=0; i<nb_points; ++i)
+      r[i] = vars[i*vars_stride+var];
+  }
+
+  const Real deg_to_rad = fp_const_deg_to_rad<Real>();
+  const Real rad_to_deg = fp_const_rad_to_deg<Real>();
+
+  for (std::vector<Instruction>::const_iterator instruction=m_instructions.begin(); instruction!=m_instructions.end(); ++instruction)
+  {
+    Real* r = reg + instruction->dst*block_size;
+    const Real* x = reg + instruction->a*block_size;
+    const Real* y = reg + instruction->b*block_size;
+    const Real* z = reg + instruction->c*block_size;
+    Real* re = err + instruction->dst*block_size;
+    const Real* xe = err + instruction->a*block_size;
+    const Real* ye = err + instruction->b*block_size;
+    const Real* ze = err + instruction->c*block_size;
+
+    switch (instruction->op)
+    {
+      CF3_UNARY_LOOP(   NEG,       -a,                     false )
+      CF3_UNARY_LOOP(   ABS,       fp_abs(a),              false )
+      CF3_UNARY_LOOP(   ACOS,      fp_acos(a),             a < -1. || a > 1. )
+      CF3_UNARY_LOOP(   ACOSH,     fp_acosh(a),            a < 1. )
+      CF3_UNARY_LOOP(   ASIN,      fp_asin(a),             a < -1. || a > 1. )
+      CF3_UNARY_LOOP(   ASINH,     fp_asinh(a),            false )
+      CF3_UNARY_LOOP(   ATAN,      fp_atan(a),             false )
+      CF3_UNARY_LOOP(   ATANH,     fp_atanh(a),            a <= -1. || a >= 1. )
+      CF3_UNARY_LOOP(   CBRT,      fp_cbrt(a),             false )
+      CF3_UNARY_LOOP(   CEIL,      fp_ceil(a),             false )
+      CF3_UNARY_LOOP(   COS,       fp_cos(a),              false )
+      CF3_UNARY_LOOP(   COSH,      fp_cosh(a),             false )
+      CF3_UNARY_LOOP(   COT,       1. / fp_tan(a),         fp_tan(a) == 0. )
+      CF3_UNARY_LOOP(   CSC,       1. / fp_sin(a),         fp_sin(a) == 0. )
+      CF3_UNARY_LOOP(   EXP,       fp_exp(a),              false )
+      CF3_UNARY_LOOP(   EXP2,      fp_exp2(a),             false )
+      CF3_UNARY_LOOP(   FLOOR,     fp_floor(a),            false )
+      CF3_UNARY_LOOP(   INT,       fp_int(a),              false )
+      CF3_UNARY_LOOP(   LOG,       fp_log(a),              !(a > 0.) )
+      CF3_UNARY_LOOP(   LOG10,     fp_log10(a),            !(a > 0.) )
+      CF3_UNARY_LOOP(   LOG2,      fp_log2(a),             !(a > 0.) )
+      CF3_UNARY_LOOP(   SEC,       1. / fp_cos(a),         fp_cos(a) == 0. )
+      CF3_UNARY_LOOP(   SIN,       fp_sin(a),              false )
+      CF3_UNARY_LOOP(   SINH,      fp_sinh(a),             false )
+      CF3_UNARY_LOOP(   SQRT,      fp_sqrt(a),             a < 0. )
+      CF3_UNARY_LOOP(   TAN,       fp_tan(a),              false )
+      CF3_UNARY_LOOP(   TANH,      fp_tanh(a),             false )
+      CF3_UNARY_LOOP(   TRUNC,     fp_trunc(a),            false )
+      CF3_UNARY_LOOP(   NOT,       fp_not(a),              false )
+      CF3_UNARY_LOOP(   NOTNOT,    fp_notNot(a),           false )
+      CF3_UNARY_LOOP(   ABSNOT,    fp_absNot(a),           false )
+      CF3_UNARY_LOOP(   ABSNOTNOT, fp_absNotNot(a),        false )
+      CF3_UNARY_LOOP(   INV,       1. / a,                 a == 0. )
+      CF3_UNARY_LOOP(   SQR,       a*a,                    false )
+      CF3_UNARY_LOOP(   RSQRT,     1. / fp_sqrt(a),        a == 0. )
+      CF3_UNARY_LOOP(   DEG,       a * rad_to_deg,         false )
+      CF3_UNARY_LOOP(   RAD,       a * deg_to_rad,         false )
+
+      CF3_BINARY_LOOP(  ADD,       a + b,                  false )
+      CF3_BINARY_LOOP(  SUB,       a - b,                  false )
+      CF3_BINARY_LOOP(  MUL,       a * b,                  false )
+      CF3_BINARY_LOOP(  DIV,       a / b,                  b == 0. )
+      CF3_BINARY_LOOP(  MOD,       fp_mod(a,b),            b == 0. )
+      CF3_BINARY_LOOP(  POW,       fp_pow(a,b),            a == 0. && b < 0. )
+      CF3_BINARY_LOOP(  ATAN2,     fp_atan2(a,b),          false )
+      CF3_BINARY_LOOP(  HYPOT,     fp_hypot(a,b),          false )
+      CF3_BINARY_LOOP(  MAX,       fp_max(a,b),            false )
+      CF3_BINARY_LOOP(  MIN,       fp_min(a,b),            false )
+      CF3_BINARY_LOOP(  EQUAL,     fp_equal(a,b),          false )
+      CF3_BINARY_LOOP(  NEQUAL,    fp_nequal(a,b),         false )
+      CF3_BINARY_LOOP(  LESS,      fp_less(a,b),           false )
+      CF3_BINARY_LOOP(  LESSOREQ,  fp_lessOrEq(a,b),       false )
+      CF3_BINARY_LOOP(  AND,       fp_and(a,b),            false )
+      CF3_BINARY_LOOP(  OR,        fp_or(a,b),             false )
+      CF3_BINARY_LOOP(  ABSAND,    fp_absAnd(a,b),         false )
+      CF3_BINARY_LOOP(  ABSOR,     fp_absOr(a,b),          false )
+      CF3_BINARY_LOOP(  LOG2BY,    fp_log2(a) * b,         !(a > 0.) )
+
+      // the parser only evaluates the branch that is taken
+      case IF:
+        for (Uint i=0; i<nb_points; ++i)
+        {
+          const bool truth = fp_truth(x[i]);
+          r[i] = truth ? y[i] : z[i];
+          re[i] = xe[i] + (truth ? ye[i] : ze[i]);
+        }
+        break;
+      case ABSIF:
+        for (Uint i=0; i<nb_points; ++i)
+        {
+          const bool truth = fp_absTruth(x[i]);
+          r[i] = truth ? y[i] : z[i];
+          re[i] = xe[i] + (truth ? ye[i] : ze[i]);
+        }
+        break;
+    }
+  }
+
+  const Real* r = reg + m_result*block_size;
+  const Real* re = err + m_result*block_size;
+  for (Uint i=0; i<nb_points; ++i)
+    result[i*result_stride] = re[i] == 0. ? r[i] : 0.;
+}
+
+#undef CF3_UNARY_LOOP
+#undef CF3_BINARY_LOOP
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // math
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
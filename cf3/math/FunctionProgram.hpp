@@ -0,0 +1,125 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_math_FunctionProgram_hpp
+#define cf3_math_FunctionProgram_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "fparser/fparser.hh"
+
+#include "math/LibMath.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Register program compiled from the bytecode of a parsed function,
+/// evaluating the function for a block of points at once.
+///
+/// Every value on the stack of the FunctionParser becomes a register holding
+/// the value for all points of the block, so that every instruction is a loop
+/// over the points, and the bytecode is decoded once per block instead of once
+/// per point. Both branches of if() are evaluated and the result is selected per point.
+/// Evaluation errors follow the checks of FunctionParser::Eval(): every register has an
+/// error flag per point, set by domain errors (e.g. sqrt(-1) or x/0) and propagated to the
+/// registers computed from it, except through the branch of if() that is not taken.
+/// Points with an error get the value 0, like the parser returns.
+class Math_API FunctionProgram
+{
+public: // typedefs
+
+  /// Number of points evaluated at once
+  enum { block_size = 128 };
+
+public: // functions
+
+  FunctionProgram();
+
+  /// Compile the bytecode of a parsed function
+  /// @param [in] parser  parser that parsed the function successfully
+  /// @param [in] nb_vars number of variables of the function
+  /// @return false if the function calls user defined functions or other parsers, which are
+  ///         only evaluated by the parser
+  bool compile(const FunctionParser& parser, const Uint nb_vars);
+
+  /// @return if the last compile() succeeded
+  bool is_compiled() const { return m_is_compiled; }
+
+  /// Allocate the registers and their error flags for one thread, and store the constants in them
+  void setup_registers(std::vector<Real>& registers) const;
+
+  /// Evaluate the function for a block of points
+  /// @param [in]  nb_points   number of points, at most block_size
+  /// @param [in]  vars        values of the variables: vars[pt*vars_stride + var]
+  /// @param [out] result      function values: result[pt*result_stride]
+  /// @param [in]  registers   registers prepared with setup_registers()
+  void evaluate(const Uint nb_points,
+                const Real* vars, const Uint vars_stride,
+                Real* result, const Uint result_stride,
+                std::vector<Real>& registers) const;
+
+private: // types
+
+  /// Instruction computing register dst from registers a, b and c
+  struct Instruction
+  {
+    Instruction(const Uint op_, const Uint dst_, const Uint a_, const Uint b_ = 0, const Uint c_ = 0) :
+      op(op_), dst(dst_), a(a_), b(b_), c(c_) {}
+    Uint op;
+    Uint dst;
+    Uint a;
+    Uint b;
+    Uint c;
+  };
+
+private: // functions
+
+  /// Translate the bytecode in [begin,end) to instructions, following the stack of registers
+  /// @return false if the bytecode contains opcodes or jumps that can't be translated
+  bool translate(const std::vector<unsigned>& bytecode, const std::vector<Real>& immediates,
+                 const Uint begin, const Uint end, Uint& immediate, std::vector<Uint>& stack);
+
+  /// Add an instruction computing a new register
+  Uint add(const Uint op, const Uint a, const Uint b = 0, const Uint c = 0);
+
+  /// Add a register holding a constant
+  Uint add_constant(const Real value);
+
+private: // data
+
+  bool m_is_compiled;
+
+  /// Number of variables, stored in the first registers
+  Uint m_nb_vars;
+
+  /// Total number of registers
+  Uint m_nb_registers;
+
+  /// Register holding the result
+  Uint m_result;
+
+  std::vector<Instruction> m_instructions;
+
+  /// Registers holding constants, and their values
+  std::vector<Uint> m_constant_registers;
+  std::vector<Real> m_constants;
+
+}; // FunctionProgram
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // math
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_math_FunctionProgram_hpp
@@ -73,6 +73,11 @@ public:
   /// local numbering of the unknowns
   std::vector<Uint> indices;
 
+  /// scratch space for the LSS backends to convert the indices into.
+  /// Threads that assemble concurrently each use their own BlockAccumulator,
+  /// so backends that convert into this instead of a member can scatter from several threads.
+  mutable std::vector<int> converted_indices;
+
   // rest of the operations should directly be the stuff off eigen
 
 };
@@ -102,7 +102,8 @@ public:
 
   /// The holy solve, for solving the m_mat*m_sol=m_rhs problem.
   /// We bow on our knees before your greatness.
-  void solve(LSS::Vector& solution, LSS::Vector& rhs) { cf3_assert(m_is_created); }
+  /// Nothing is solved, but the solver_reuse decisions are counted as for a solve in zero iterations.
+  void solve(LSS::Vector& solution, LSS::Vector& rhs) { cf3_assert(m_is_created); solver_update(); solver_finished(0); }
 
   //@} END SOLVE THE SYSTEM
 
@@ -117,6 +118,9 @@ public:
   /// eigen, templatization on top level
   void add_values(const BlockAccumulator& values) { cf3_assert(m_is_created); }
 
+  /// Nothing is stored, so scattering concurrently is safe
+  bool is_reentrant() const { return true; }
+
   /// Add a list of values
   void get_values(BlockAccumulator& values) { cf3_assert(m_is_created); values.mat.setConstant(0.); }
 
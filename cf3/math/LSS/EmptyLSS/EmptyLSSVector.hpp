@@ -117,6 +117,9 @@ public:
   /// Add a list of values to rhs
   void add_rhs_values(const BlockAccumulator& values) { cf3_assert(m_is_created); }
 
+  /// Nothing is stored, so scattering concurrently is safe
+  bool is_reentrant() const { return true; }
+
   /// Get a list of values from rhs
   void get_rhs_values(BlockAccumulator& values) { cf3_assert(m_is_created); values.rhs.setConstant(0.); }
 
@@ -0,0 +1,170 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <boost/assign/list_of.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/PropertyList.hpp"
+
+#include "math/LSS/Matrix.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file Matrix.cpp implementation of the solver reuse policy of LSS::Matrix
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Matrix::Matrix(const std::string& name) :
+  Component(name),
+  m_solver_built(false),
+  m_nb_solves_with_preconditioner(0),
+  m_reference_iterations(0),
+  m_recompute_requested(false),
+  m_warned_unknown_iterations(false)
+{
+  const std::vector<boost::any> policies = boost::assign::list_of
+    (boost::any(std::string("none")))
+    (boost::any(std::string("symbolic")))
+    (boost::any(std::string("interval")))
+    (boost::any(std::string("iterations")));
+
+  options().add_option("solver_reuse", std::string("none"))
+    .pretty_name("Solver Reuse")
+    .description("Policy for keeping the linear solver and preconditioner between solves. "
+                 "none: build everything for each solve. "
+                 "symbolic: keep the solver and the preconditioner structure, recompute the preconditioner values for each solve. "
+                 "interval: reuse the preconditioner, recompute it every rebuild_interval solves. "
+                 "iterations: reuse the preconditioner, recompute it when the iteration count exceeds iteration_growth times the count of its first solve.")
+    .attach_trigger(boost::bind(&Matrix::reset_solver, this))
+    .restricted_list() = policies;
+
+  options().add_option("rebuild_interval", 10u)
+    .pretty_name("Rebuild Interval")
+    .description("Number of solves with the same preconditioner, for the interval policy");
+
+  options().add_option("iteration_growth", 1.5)
+    .pretty_name("Iteration Growth")
+    .description("Allowed growth of the iteration count before recomputing the preconditioner, for the iterations policy");
+
+  // statistics of the reuse decisions, so the policy can be checked and tuned
+  properties().add_property("solver_builds", Uint(0));
+  properties().add_property("preconditioner_recomputes", Uint(0));
+  properties().add_property("preconditioner_reuses", Uint(0));
+  properties().add_property("solver_iterations", Uint(0));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Matrix::SolverUpdate Matrix::solver_update()
+{
+  const std::string policy = options().option("solver_reuse").value<std::string>();
+
+  if(policy == "none" || !m_solver_built)
+  {
+    m_solver_built = true;
+    m_nb_solves_with_preconditioner = 0;
+    m_reference_iterations = 0;
+    m_recompute_requested = false;
+    increment_property("solver_builds");
+    return BUILD_SOLVER;
+  }
+
+  if(policy == "symbolic")
+  {
+    increment_property("preconditioner_recomputes");
+    return RECOMPUTE_PRECONDITIONER;
+  }
+
+  if(policy == "interval" && m_nb_solves_with_preconditioner >= options().option("rebuild_interval").value<Uint>())
+    m_recompute_requested = true;
+
+  if(m_recompute_requested)
+  {
+    m_nb_solves_with_preconditioner = 0;
+    m_reference_iterations = 0;
+    m_recompute_requested = false;
+    increment_property("preconditioner_recomputes");
+    return RECOMPUTE_PRECONDITIONER;
+  }
+
+  increment_property("preconditioner_reuses");
+  return REUSE_PRECONDITIONER;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void Matrix::solver_finished(const Uint nb_iterations)
+{
+  ++m_nb_solves_with_preconditioner;
+  const bool known = nb_iterations != unknown_iterations();
+  properties()["solver_iterations"] = known ? nb_iterations : 0u;
+
+  if(options().option("solver_reuse").value<std::string>() != "iterations")
+    return;
+
+  // without an iteration count, a degrading preconditioner can't be detected
+  if(!known)
+  {
+    if(!m_warned_unknown_iterations)
+    {
+      CFwarn << uri().path() << ": the solver does not report its iteration count, the preconditioner is recomputed for every solve" << CFendl;
+      m_warned_unknown_iterations = true;
+    }
+    m_recompute_requested = true;
+    return;
+  }
+
+  if(m_nb_solves_with_preconditioner == 1)
+  {
+    m_reference_iterations = nb_iterations;
+    return;
+  }
+
+  if(static_cast<Real>(nb_iterations) > options().option("iteration_growth").value<Real>() * static_cast<Real>(m_reference_iterations))
+  {
+    CFdebug << uri().path() << ": iteration count grew from " << m_reference_iterations << " to " << nb_iterations << ", recomputing preconditioner" << CFendl;
+    m_recompute_requested = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void Matrix::reset_solver()
+{
+  m_solver_built = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void Matrix::request_recompute()
+{
+  m_recompute_requested = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void Matrix::increment_property(const std::string& name)
+{
+  properties()[name] = properties().value<Uint>(name) + 1u;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
@@ -14,6 +14,7 @@
 #include "math/LSS/LibLSS.hpp"
 #include "common/PE/CommPattern.hpp"
 #include "common/Log.hpp"
+#include "math/Consts.hpp"
 #include "math/LSS/BlockAccumulator.hpp"
 #include "math/LSS/Vector.hpp"
 
@@ -48,7 +49,7 @@ public:
   virtual const bool is_swappable(const LSS::Vector& solution, const LSS::Vector& rhs) = 0;
 
   /// Default constructor
-  Matrix(const std::string& name) : Component(name) { }
+  Matrix(const std::string& name);
 
   /// Setup sparsity structure
   /// should only work with local numbering (parallel computations, plus rcm could be a totally internal matter of the matrix)
@@ -87,6 +88,10 @@ public:
   /// We bow on our knees before your greatness.
   virtual void solve(LSS::Vector& solution, LSS::Vector& rhs) = 0;
 
+  /// Recompute the preconditioner at the next solve, e.g. because the matrix was assembled again.
+  /// Only needed with the solver_reuse policies that keep the preconditioner between solves.
+  void request_recompute();
+
   //@} END SOLVE THE SYSTEM
 
   /// @name EFFICCIENT ACCESS
@@ -103,6 +108,10 @@ public:
   /// Add a list of values
   virtual void get_values(BlockAccumulator& values) = 0;
 
+  /// True if set_values and add_values may be called from several threads at once,
+  /// for blocks whose rows are disjoint. Otherwise the caller must serialize them.
+  virtual bool is_reentrant() const { return false; }
+
   /// Set a row, diagonal and off-diagonals values separately (dirichlet-type boundaries)
   virtual void set_row(const Uint iblockrow, const Uint ieq, Real diagval, Real offdiagval) = 0;
 
@@ -166,6 +175,57 @@ public:
 
   //@} END TEST ONLY
 
+protected:
+
+  /// @name SOLVER REUSE
+  /// Bookkeeping for the "solver_reuse" option, so consecutive solves (e.g. over time steps) can keep the
+  /// linear solver and its preconditioner. Implementations call solver_update before and solver_finished after each solve.
+  /// The decisions are counted in the properties solver_builds, preconditioner_recomputes and preconditioner_reuses,
+  /// and the iteration count of the last solve is stored in solver_iterations.
+  //@{
+
+  /// What to do with the linear solver and preconditioner before a solve
+  enum SolverUpdate
+  {
+    BUILD_SOLVER,             ///< create the solver and the preconditioner from scratch
+    RECOMPUTE_PRECONDITIONER, ///< keep the solver objects and the preconditioner structure, recompute the preconditioner values
+    REUSE_PRECONDITIONER      ///< only update the operator, apply the preconditioner as it was computed before
+  };
+
+  /// Decide how the solver must be updated for the next solve, according to the reuse policy
+  SolverUpdate solver_update();
+
+  /// Iteration count to report for solvers that don't provide it
+  static Uint unknown_iterations() { return math::Consts::uint_max(); }
+
+  /// Report the number of iterations of the last solve, or unknown_iterations().
+  /// With the iterations policy, an unknown count recomputes the preconditioner for the next solve.
+  void solver_finished(const Uint nb_iterations);
+
+  /// Forget about the current solver, so the next solve builds it from scratch. Must be called when the sparsity changes.
+  void reset_solver();
+
+  //@} END SOLVER REUSE
+
+private:
+
+  /// Add one to the Uint property with the given name
+  void increment_property(const std::string& name);
+
+  /// True if a solver was built since the last reset
+  bool m_solver_built;
+
+  /// Number of solves with the current preconditioner
+  Uint m_nb_solves_with_preconditioner;
+
+  /// Iteration count of the first solve with the current preconditioner
+  Uint m_reference_iterations;
+
+  /// Set when the iteration count grew too much, to recompute the preconditioner on the next solve
+  bool m_recompute_requested;
+
+  /// Set when the iterations policy was used with a solver that doesn't report its iteration count
+  bool m_warned_unknown_iterations;
 
 }; // end of class Matrix
 
@@ -0,0 +1,522 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef CF3_HAVE_OPENMP
+  #include <omp.h>
+#endif
+
+#include <Eigen/Dense>
+
+#include "common/Assertions.hpp"
+#include "common/BasicExceptions.hpp"
+#include "common/StringConversion.hpp"
+
+#include "math/LSS/Native/NativeDetail.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file NativeDetail.cpp Storage, preconditioners and Krylov solvers used by LSS::NativeMatrix
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  typedef Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> BlockT;
+  typedef Eigen::Map<BlockT> BlockMapT;
+  typedef Eigen::Map<const BlockT> ConstBlockMapT;
+
+  /// inv = a^-1, for row-major blocks of size neq
+  void invert_block(const Real* a, Real* inv, const Uint neq, const Uint row)
+  {
+    const Eigen::FullPivLU<BlockT> lu(ConstBlockMapT(a, neq, neq));
+    if(!lu.isInvertible())
+      throw common::BadValue(FromHere(), "Singular diagonal block in row " + common::to_str(row));
+    BlockMapT(inv, neq, neq) = lu.inverse();
+  }
+
+  /// y = a*x
+  inline void block_vector(const Real* a, const Real* x, Real* y, const Uint neq)
+  {
+    for(Uint i = 0; i != neq; ++i)
+    {
+      Real sum = 0.;
+      for(Uint j = 0; j != neq; ++j)
+        sum += a[i*neq+j] * x[j];
+      y[i] = sum;
+    }
+  }
+
+  /// y -= a*x
+  inline void block_vector_subtract(const Real* a, const Real* x, Real* y, const Uint neq)
+  {
+    for(Uint i = 0; i != neq; ++i)
+    {
+      Real sum = 0.;
+      for(Uint j = 0; j != neq; ++j)
+        sum += a[i*neq+j] * x[j];
+      y[i] -= sum;
+    }
+  }
+
+  /// c -= a*b
+  inline void block_multiply_subtract(const Real* a, const Real* b, Real* c, const Uint neq)
+  {
+    for(Uint i = 0; i != neq; ++i)
+      for(Uint k = 0; k != neq; ++k)
+      {
+        const Real aik = a[i*neq+k];
+        for(Uint j = 0; j != neq; ++j)
+          c[i*neq+j] -= aik * b[k*neq+j];
+      }
+  }
+
+  /// Multiply the given range of rows
+  inline void multiply_rows(const BlockCrs& A, const Real* x, Real* y, const int begin, const int end)
+  {
+    const Uint neq = A.neq;
+    const Uint bs = A.block_size();
+    for(int row = begin; row < end; ++row)
+    {
+      Real* y_row = y + row*neq;
+      for(Uint i = 0; i != neq; ++i)
+        y_row[i] = 0.;
+      const Uint row_end = A.row_starts[row+1];
+      for(Uint pos = A.row_starts[row]; pos != row_end; ++pos)
+      {
+        const Real* block = &A.values[pos*bs];
+        const Real* x_col = x + A.columns[pos]*neq;
+        for(Uint i = 0; i != neq; ++i)
+        {
+          Real sum = 0.;
+          for(Uint j = 0; j != neq; ++j)
+            sum += block[i*neq+j] * x_col[j];
+          y_row[i] += sum;
+        }
+      }
+    }
+  }
+
+  inline void axpy(const Real a, const std::vector<Real>& x, std::vector<Real>& y)
+  {
+    const Uint n = y.size();
+    for(Uint i = 0; i != n; ++i)
+      y[i] += a * x[i];
+  }
+
+  /// r = b - A*x, returning the norm of r
+  Real residual(NativeOperator& op, const Real* b, const Real* x, std::vector<Real>& r)
+  {
+    const Uint n = op.size();
+    op.apply(x, vector_data(r));
+    for(Uint i = 0; i != n; ++i)
+      r[i] = b[i] - r[i];
+    return std::sqrt(op.dot(vector_data(r), vector_data(r)));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+int BlockCrs::find(const Uint row, const Uint column) const
+{
+  const std::vector<Uint>::const_iterator begin = columns.begin() + row_starts[row];
+  const std::vector<Uint>::const_iterator end = columns.begin() + row_starts[row+1];
+  const std::vector<Uint>::const_iterator it = std::lower_bound(begin, end, column);
+  if(it == end || *it != column)
+    return -1;
+  return it - columns.begin();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void multiply(const BlockCrs& A, const Real* x, Real* y, const Uint nb_threads)
+{
+  const int nb_rows = A.nb_rows();
+#ifdef CF3_HAVE_OPENMP
+  if(nb_threads > 1)
+  {
+    // Static chunks of rows, so each thread keeps touching the same part of y
+    #pragma omp parallel num_threads(nb_threads)
+    {
+      const int nb_chunks = omp_get_num_threads();
+      const int chunk = omp_get_thread_num();
+      detail::multiply_rows(A, x, y, (nb_rows * chunk) / nb_chunks, (nb_rows * (chunk+1)) / nb_chunks);
+    }
+    return;
+  }
+#endif
+  detail::multiply_rows(A, x, y, 0, nb_rows);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void IdentityPreconditioner::compute(const BlockCrs& A)
+{
+  m_size = A.nb_rows() * A.neq;
+}
+
+void IdentityPreconditioner::apply(const Real* r, Real* z) const
+{
+  std::copy(r, r + m_size, z);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockJacobiPreconditioner::compute(const BlockCrs& A)
+{
+  m_neq = A.neq;
+  const Uint nb_rows = A.nb_rows();
+  const Uint bs = A.block_size();
+  m_inverse_diagonal.resize(nb_rows*bs);
+  for(Uint row = 0; row != nb_rows; ++row)
+    detail::invert_block(A.block(A.diagonal[row]), &m_inverse_diagonal[row*bs], m_neq, row);
+}
+
+void BlockJacobiPreconditioner::apply(const Real* r, Real* z) const
+{
+  const Uint bs = m_neq*m_neq;
+  const Uint nb_rows = bs == 0 ? 0 : m_inverse_diagonal.size() / bs;
+  for(Uint row = 0; row != nb_rows; ++row)
+    detail::block_vector(&m_inverse_diagonal[row*bs], r + row*m_neq, z + row*m_neq, m_neq);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockILU0Preconditioner::setup(const BlockCrs& A, const std::vector<int>& column_rows)
+{
+  m_neq = A.neq;
+  const Uint nb_rows = A.nb_rows();
+
+  m_row_starts.assign(1, 0);
+  m_columns.clear();
+  m_source.clear();
+  m_diagonal.resize(nb_rows);
+
+  std::vector< std::pair<Uint, Uint> > row_entries;
+  for(Uint row = 0; row != nb_rows; ++row)
+  {
+    // Process-local columns are not in the same order as the rows, so sort again after renumbering
+    row_entries.clear();
+    for(Uint pos = A.row_starts[row]; pos != A.row_starts[row+1]; ++pos)
+    {
+      const int column_row = column_rows[A.columns[pos]];
+      if(column_row >= 0)
+        row_entries.push_back(std::make_pair(static_cast<Uint>(column_row), pos));
+    }
+    std::sort(row_entries.begin(), row_entries.end());
+
+    for(Uint i = 0; i != row_entries.size(); ++i)
+    {
+      if(row_entries[i].first == row)
+        m_diagonal[row] = m_columns.size();
+      m_columns.push_back(row_entries[i].first);
+      m_source.push_back(row_entries[i].second);
+    }
+    m_row_starts.push_back(m_columns.size());
+  }
+}
+
+void BlockILU0Preconditioner::compute(const BlockCrs& A)
+{
+  cf3_assert(A.neq == m_neq);
+  const Uint neq = m_neq;
+  const Uint bs = neq*neq;
+  const Uint nb_rows = m_diagonal.size();
+  const Uint nb_blocks = m_columns.size();
+
+  m_values.resize(nb_blocks*bs);
+  for(Uint i = 0; i != nb_blocks; ++i)
+    std::copy(A.block(m_source[i]), A.block(m_source[i]) + bs, &m_values[i*bs]);
+  m_inverse_diagonal.resize(nb_rows*bs);
+
+  // Position of each column in the current row, -1 if the column is not in the row
+  std::vector<int> positions(nb_rows, -1);
+  std::vector<Real> l_block(bs);
+
+  for(Uint row = 0; row != nb_rows; ++row)
+  {
+    const Uint row_begin = m_row_starts[row];
+    const Uint row_end = m_row_starts[row+1];
+    for(Uint p = row_begin; p != row_end; ++p)
+      positions[m_columns[p]] = p;
+
+    // Eliminate the blocks left of the diagonal, using the rows above that are already factorized
+    for(Uint p = row_begin; p != m_diagonal[row]; ++p)
+    {
+      const Uint k = m_columns[p];
+      Real* a_ik = &m_values[p*bs];
+      detail::BlockMapT(&l_block[0], neq, neq) = detail::ConstBlockMapT(a_ik, neq, neq) * detail::ConstBlockMapT(&m_inverse_diagonal[k*bs], neq, neq);
+      std::copy(l_block.begin(), l_block.end(), a_ik);
+      for(Uint q = m_diagonal[k] + 1; q != m_row_starts[k+1]; ++q)
+      {
+        const int target = positions[m_columns[q]];
+        if(target >= 0)
+          detail::block_multiply_subtract(a_ik, &m_values[q*bs], &m_values[target*bs], neq);
+      }
+    }
+
+    detail::invert_block(&m_values[m_diagonal[row]*bs], &m_inverse_diagonal[row*bs], neq, row);
+
+    for(Uint p = row_begin; p != row_end; ++p)
+      positions[m_columns[p]] = -1;
+  }
+}
+
+void BlockILU0Preconditioner::apply(const Real* r, Real* z) const
+{
+  const Uint neq = m_neq;
+  const Uint bs = neq*neq;
+  const Uint nb_rows = m_diagonal.size();
+
+  // forward substitution with the unit lower triangle
+  for(Uint row = 0; row != nb_rows; ++row)
+  {
+    Real* z_row = z + row*neq;
+    std::copy(r + row*neq, r + (row+1)*neq, z_row);
+    for(Uint p = m_row_starts[row]; p != m_diagonal[row]; ++p)
+      detail::block_vector_subtract(&m_values[p*bs], z + m_columns[p]*neq, z_row, neq);
+  }
+
+  // backward substitution with the upper triangle
+  std::vector<Real> tmp(neq);
+  for(Uint row = nb_rows; row-- != 0;)
+  {
+    Real* z_row = z + row*neq;
+    std::copy(z_row, z_row + neq, tmp.begin());
+    for(Uint p = m_diagonal[row] + 1; p != m_row_starts[row+1]; ++p)
+      detail::block_vector_subtract(&m_values[p*bs], z + m_columns[p]*neq, &tmp[0], neq);
+    detail::block_vector(&m_inverse_diagonal[row*bs], &tmp[0], z_row, neq);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+KrylovResult solve_cg(NativeOperator& op, const Real* b, Real* x, const Real tolerance, const Uint max_iterations)
+{
+  const Uint n = op.size();
+  std::vector<Real> r(n), z(n), p(n), q(n);
+
+  KrylovResult result;
+  result.initial_residual = result.residual = detail::residual(op, b, x, r);
+  if(result.initial_residual == 0.)
+  {
+    result.converged = true;
+    return result;
+  }
+
+  op.precondition(vector_data(r), vector_data(z));
+  p = z;
+  Real rz = op.dot(vector_data(r), vector_data(z));
+
+  while(result.iterations < max_iterations)
+  {
+    ++result.iterations;
+    op.apply(vector_data(p), vector_data(q));
+    const Real alpha = rz / op.dot(vector_data(p), vector_data(q));
+    for(Uint i = 0; i != n; ++i)
+    {
+      x[i] += alpha * p[i];
+      r[i] -= alpha * q[i];
+    }
+
+    result.residual = std::sqrt(op.dot(vector_data(r), vector_data(r)));
+    if(result.residual <= tolerance * result.initial_residual)
+    {
+      result.converged = true;
+      break;
+    }
+
+    op.precondition(vector_data(r), vector_data(z));
+    const Real rz_new = op.dot(vector_data(r), vector_data(z));
+    const Real beta = rz_new / rz;
+    rz = rz_new;
+    for(Uint i = 0; i != n; ++i)
+      p[i] = z[i] + beta * p[i];
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+KrylovResult solve_bicgstab(NativeOperator& op, const Real* b, Real* x, const Real tolerance, const Uint max_iterations)
+{
+  const Uint n = op.size();
+  std::vector<Real> r(n), r_hat(n), p(n, 0.), v(n, 0.), p_hat(n), s(n), s_hat(n), t(n);
+
+  KrylovResult result;
+  result.initial_residual = result.residual = detail::residual(op, b, x, r);
+  if(result.initial_residual == 0.)
+  {
+    result.converged = true;
+    return result;
+  }
+  r_hat = r;
+
+  Real rho = 1., alpha = 1., omega = 1.;
+  while(result.iterations < max_iterations)
+  {
+    ++result.iterations;
+    const Real rho_new = op.dot(vector_data(r_hat), vector_data(r));
+    if(rho_new == 0.)
+      break;
+
+    const Real beta = (rho_new / rho) * (alpha / omega);
+    rho = rho_new;
+    for(Uint i = 0; i != n; ++i)
+      p[i] = r[i] + beta * (p[i] - omega * v[i]);
+
+    op.precondition(vector_data(p), vector_data(p_hat));
+    op.apply(vector_data(p_hat), vector_data(v));
+    alpha = rho / op.dot(vector_data(r_hat), vector_data(v));
+    for(Uint i = 0; i != n; ++i)
+      s[i] = r[i] - alpha * v[i];
+
+    result.residual = std::sqrt(op.dot(vector_data(s), vector_data(s)));
+    if(result.residual <= tolerance * result.initial_residual)
+    {
+      for(Uint i = 0; i != n; ++i)
+        x[i] += alpha * p_hat[i];
+      result.converged = true;
+      break;
+    }
+
+    op.precondition(vector_data(s), vector_data(s_hat));
+    op.apply(vector_data(s_hat), vector_data(t));
+    const Real tt = op.dot(vector_data(t), vector_data(t));
+    omega = tt == 0. ? 0. : op.dot(vector_data(t), vector_data(s)) / tt;
+    for(Uint i = 0; i != n; ++i)
+    {
+      x[i] += alpha * p_hat[i] + omega * s_hat[i];
+      r[i] = s[i] - omega * t[i];
+    }
+
+    result.residual = std::sqrt(op.dot(vector_data(r), vector_data(r)));
+    if(result.residual <= tolerance * result.initial_residual)
+    {
+      result.converged = true;
+      break;
+    }
+    if(omega == 0.)
+      break;
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+KrylovResult solve_gmres(NativeOperator& op, const Real* b, Real* x, const Real tolerance, const Uint max_iterations, const Uint restart)
+{
+  const Uint n = op.size();
+  const Uint m = std::max(restart, Uint(1));
+  std::vector< std::vector<Real> > V(m+1, std::vector<Real>(n));
+  std::vector< std::vector<Real> > H(m+1, std::vector<Real>(m, 0.));
+  std::vector<Real> cs(m), sn(m), g(m+1), y(m), w(n), u(n), z(n);
+
+  KrylovResult result;
+  Real beta = detail::residual(op, b, x, V[0]);
+  result.initial_residual = result.residual = beta;
+  if(beta == 0.)
+  {
+    result.converged = true;
+    return result;
+  }
+
+  while(result.iterations < max_iterations)
+  {
+    for(Uint i = 0; i != n; ++i)
+      V[0][i] /= beta;
+    std::fill(g.begin(), g.end(), 0.);
+    g[0] = beta;
+
+    Uint k = 0;
+    while(k != m && result.iterations < max_iterations)
+    {
+      ++result.iterations;
+      op.precondition(vector_data(V[k]), vector_data(z));
+      op.apply(vector_data(z), vector_data(w));
+      for(Uint i = 0; i <= k; ++i)
+      {
+        H[i][k] = op.dot(vector_data(w), vector_data(V[i]));
+        detail::axpy(-H[i][k], V[i], w);
+      }
+      H[k+1][k] = std::sqrt(op.dot(vector_data(w), vector_data(w)));
+      if(H[k+1][k] != 0.)
+      {
+        for(Uint i = 0; i != n; ++i)
+          V[k+1][i] = w[i] / H[k+1][k];
+      }
+
+      // Apply the previous rotations to the new column, and compute the rotation that eliminates H[k+1][k]
+      for(Uint i = 0; i != k; ++i)
+      {
+        const Real tmp = cs[i]*H[i][k] + sn[i]*H[i+1][k];
+        H[i+1][k] = -sn[i]*H[i][k] + cs[i]*H[i+1][k];
+        H[i][k] = tmp;
+      }
+      const Real denom = std::sqrt(H[k][k]*H[k][k] + H[k+1][k]*H[k+1][k]);
+      cs[k] = denom == 0. ? 1. : H[k][k] / denom;
+      sn[k] = denom == 0. ? 0. : H[k+1][k] / denom;
+      H[k][k] = cs[k]*H[k][k] + sn[k]*H[k+1][k];
+      H[k+1][k] = 0.;
+      g[k+1] = -sn[k]*g[k];
+      g[k] = cs[k]*g[k];
+
+      const bool lucky_breakdown = denom == 0. || std::abs(g[k+1]) == 0.;
+      ++k;
+      result.residual = std::abs(g[k]);
+      if(result.residual <= tolerance * result.initial_residual || lucky_breakdown)
+        break;
+    }
+
+    // Solve the triangular least squares system and update the solution with M^-1 * V * y
+    for(Uint i = k; i-- != 0;)
+    {
+      Real sum = g[i];
+      for(Uint j = i+1; j != k; ++j)
+        sum -= H[i][j] * y[j];
+      y[i] = H[i][i] == 0. ? 0. : sum / H[i][i];
+    }
+    std::fill(u.begin(), u.end(), 0.);
+    for(Uint j = 0; j != k; ++j)
+      detail::axpy(y[j], V[j], u);
+    op.precondition(vector_data(u), vector_data(z));
+    for(Uint i = 0; i != n; ++i)
+      x[i] += z[i];
+
+    // The true residual also starts the next cycle
+    beta = detail::residual(op, b, x, V[0]);
+    result.residual = beta;
+    if(beta <= tolerance * result.initial_residual)
+    {
+      result.converged = true;
+      break;
+    }
+    if(k == 0)
+      break;
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
@@ -0,0 +1,192 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Math_LSS_NativeDetail_hpp
+#define cf3_Math_LSS_NativeDetail_hpp
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "common/CF.hpp"
+
+#include "math/LSS/LibLSS.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file NativeDetail.hpp Storage, preconditioners and Krylov solvers used by LSS::NativeMatrix
+
+  None of this depends on the component system, the distributed parts (ghost exchange and global reductions) are
+  hidden behind NativeOperator.
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Block compressed row storage of the rows owned by a rank. All blocks are neq x neq and stored row-major.
+/// Columns are process-local block indices, sorted in each row, so they index directly into a vector that includes the ghosts.
+struct LSS_API BlockCrs
+{
+  BlockCrs() : neq(0) {}
+
+  /// Number of equations, i.e. the size of a block
+  Uint neq;
+
+  /// Start of each row in columns, with one extra entry marking the end of the last row
+  std::vector<Uint> row_starts;
+
+  /// Process-local block column of each block
+  std::vector<Uint> columns;
+
+  /// Position of the diagonal block of each row
+  std::vector<Uint> diagonal;
+
+  /// Values of the blocks, neq*neq per block
+  std::vector<Real> values;
+
+  /// Number of block rows
+  Uint nb_rows() const { return row_starts.empty() ? 0 : row_starts.size() - 1; }
+
+  /// Number of blocks
+  Uint nb_blocks() const { return columns.size(); }
+
+  /// Number of values in a block
+  Uint block_size() const { return neq*neq; }
+
+  /// Position of the block at the given row and process-local column, or -1 if the block is not in the sparsity pattern
+  int find(const Uint row, const Uint column) const;
+
+  /// Pointer to the values of the block at the given position
+  Real* block(const Uint pos) { return &values[pos*neq*neq]; }
+  const Real* block(const Uint pos) const { return &values[pos*neq*neq]; }
+};
+
+/// Pointer to the first value of a vector, or NULL if it is empty. A rank may own no rows, and &v[0] is undefined for an empty vector.
+inline Real* vector_data(std::vector<Real>& v) { return v.empty() ? NULL : &v[0]; }
+inline const Real* vector_data(const std::vector<Real>& v) { return v.empty() ? NULL : &v[0]; }
+
+/// y = A*x. x is indexed by process-local block column and must include the ghosts, y is indexed by row.
+/// Rows are split over nb_threads OpenMP threads, if available.
+void LSS_API multiply(const BlockCrs& A, const Real* x, Real* y, const Uint nb_threads = 1);
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Base class of the preconditioners for the native solvers. Preconditioners only use the rows and columns owned by the rank,
+/// so in parallel they are combined as a block Jacobi method over the ranks.
+class LSS_API NativePreconditioner
+{
+public:
+  virtual ~NativePreconditioner() {}
+
+  /// Analyse the sparsity pattern. column_rows maps each process-local block column to its row, or -1 for ghosts
+  virtual void setup(const BlockCrs& A, const std::vector<int>& column_rows) {}
+
+  /// Compute the preconditioner from the values of A, using the pattern from the last call to setup
+  virtual void compute(const BlockCrs& A) = 0;
+
+  /// z = M^-1 r, both indexed by row
+  virtual void apply(const Real* r, Real* z) const = 0;
+};
+
+/// No preconditioning
+class LSS_API IdentityPreconditioner : public NativePreconditioner
+{
+public:
+  IdentityPreconditioner() : m_size(0) {}
+  virtual void compute(const BlockCrs& A);
+  virtual void apply(const Real* r, Real* z) const;
+private:
+  Uint m_size;
+};
+
+/// Multiply with the inverse of the diagonal blocks
+class LSS_API BlockJacobiPreconditioner : public NativePreconditioner
+{
+public:
+  BlockJacobiPreconditioner() : m_neq(0) {}
+  virtual void compute(const BlockCrs& A);
+  virtual void apply(const Real* r, Real* z) const;
+private:
+  Uint m_neq;
+  std::vector<Real> m_inverse_diagonal;
+};
+
+/// Incomplete block LU factorization without fill-in, restricted to the owned part of the matrix
+class LSS_API BlockILU0Preconditioner : public NativePreconditioner
+{
+public:
+  BlockILU0Preconditioner() : m_neq(0) {}
+  virtual void setup(const BlockCrs& A, const std::vector<int>& column_rows);
+  virtual void compute(const BlockCrs& A);
+  virtual void apply(const Real* r, Real* z) const;
+private:
+  Uint m_neq;
+  /// Local pattern, with the columns numbered as rows and sorted
+  std::vector<Uint> m_row_starts;
+  std::vector<Uint> m_columns;
+  std::vector<Uint> m_diagonal;
+  /// Position of each local block in the full matrix
+  std::vector<Uint> m_source;
+  /// Factorized blocks: L below the diagonal (unit diagonal not stored), U on and above
+  std::vector<Real> m_values;
+  /// Inverse of the diagonal blocks of U
+  std::vector<Real> m_inverse_diagonal;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Operations on the distributed system needed by the Krylov solvers. Vectors only hold the owned rows.
+class LSS_API NativeOperator
+{
+public:
+  virtual ~NativeOperator() {}
+
+  /// Number of owned scalar unknowns
+  virtual Uint size() const = 0;
+
+  /// y = A*x
+  virtual void apply(const Real* x, Real* y) = 0;
+
+  /// z = M^-1 r
+  virtual void precondition(const Real* r, Real* z) = 0;
+
+  /// Dot product, summed over all ranks
+  virtual Real dot(const Real* a, const Real* b) = 0;
+};
+
+/// Outcome of a Krylov solve
+struct LSS_API KrylovResult
+{
+  KrylovResult() : iterations(0), initial_residual(0.), residual(0.), converged(false) {}
+  Uint iterations;
+  Real initial_residual;
+  Real residual;
+  bool converged;
+};
+
+/// Preconditioned conjugate gradients, for symmetric positive definite systems.
+/// Convergence is reached when the residual norm is reduced by the factor tolerance.
+KrylovResult LSS_API solve_cg(NativeOperator& op, const Real* b, Real* x, const Real tolerance, const Uint max_iterations);
+
+/// Right-preconditioned BiCGStab
+KrylovResult LSS_API solve_bicgstab(NativeOperator& op, const Real* b, Real* x, const Real tolerance, const Uint max_iterations);
+
+/// Right-preconditioned restarted GMRES, using modified Gram-Schmidt
+KrylovResult LSS_API solve_gmres(NativeOperator& op, const Real* b, Real* x, const Real tolerance, const Uint max_iterations, const Uint restart);
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+#endif // cf3_Math_LSS_NativeDetail_hpp
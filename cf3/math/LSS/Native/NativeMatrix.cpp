@@ -0,0 +1,652 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <fstream>
+
+#include <boost/assign/list_of.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+
+#include "common/Assertions.hpp"
+#include "common/BasicExceptions.hpp"
+#include "common/Builder.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/PropertyList.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/CommPattern.hpp"
+#include "common/PE/CommWrapper.hpp"
+#include "common/PE/PersistentExchange.hpp"
+#include "math/VariablesDescriptor.hpp"
+#include "math/LSS/Native/NativeMatrix.hpp"
+#include "math/LSS/Native/NativeVector.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file NativeMatrix.cpp implementation of LSS::NativeMatrix
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3;
+using namespace cf3::math;
+using namespace cf3::math::LSS;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+/// The distributed system as seen by the Krylov solvers: owned rows only, ghosts are exchanged before each product
+class NativeSystemOperator : public NativeOperator
+{
+public:
+  NativeSystemOperator(NativeMatrix& matrix, NativePreconditioner& preconditioner, const Uint nb_threads) :
+    m_matrix(matrix),
+    m_preconditioner(preconditioner),
+    m_nb_threads(nb_threads)
+  {
+  }
+
+  Uint size() const
+  {
+    return m_matrix.m_blockrow_size * m_matrix.m_neq;
+  }
+
+  void apply(const Real* x, Real* y)
+  {
+    m_matrix.update_ghosts(x);
+    multiply(m_matrix.m_mat, vector_data(m_matrix.m_ghosted), y, m_nb_threads);
+  }
+
+  void precondition(const Real* r, Real* z)
+  {
+    m_preconditioner.apply(r, z);
+  }
+
+  Real dot(const Real* a, const Real* b)
+  {
+    const Uint n = size();
+    Real local = 0.;
+    for(Uint i = 0; i != n; ++i)
+      local += a[i] * b[i];
+    if(!common::PE::Comm::instance().is_active())
+      return local;
+    Real global = 0.;
+    common::PE::Comm::instance().all_reduce(common::PE::plus(), &local, 1, &global);
+    return global;
+  }
+
+private:
+  NativeMatrix& m_matrix;
+  NativePreconditioner& m_preconditioner;
+  const Uint m_nb_threads;
+};
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < LSS::NativeMatrix, LSS::Matrix, LSS::LibLSS > NativeMatrix_Builder;
+
+NativeMatrix::NativeMatrix(const std::string& name) :
+  LSS::Matrix(name),
+  m_is_created(false),
+  m_neq(0),
+  m_blockrow_size(0),
+  m_blockcol_size(0)
+{
+  const std::vector<boost::any> solvers = boost::assign::list_of
+    (boost::any(std::string("CG")))
+    (boost::any(std::string("BiCGStab")))
+    (boost::any(std::string("GMRES")))
+    (boost::any(std::string("None")));
+
+  const std::vector<boost::any> preconditioners = boost::assign::list_of
+    (boost::any(std::string("None")))
+    (boost::any(std::string("Jacobi")))
+    (boost::any(std::string("ILU0")));
+
+  options().add_option("solver", std::string("GMRES"))
+    .pretty_name("Solver")
+    .description("Krylov method. CG requires a symmetric positive definite matrix. "
+                 "None applies the preconditioner once, e.g. when the matrix is the preconditioner of an outer Krylov method.")
+    .restricted_list() = solvers;
+
+  options().add_option("preconditioner", std::string("ILU0"))
+    .pretty_name("Preconditioner")
+    .description("Preconditioner, applied to the rows owned by each rank. Jacobi uses the inverse of the diagonal blocks, ILU0 is an incomplete block LU factorization without fill-in.")
+    .attach_trigger(boost::bind(&NativeMatrix::reset_solver, this))
+    .restricted_list() = preconditioners;
+
+  options().add_option("max_iterations", 1000u)
+    .pretty_name("Max Iterations")
+    .description("Maximum number of iterations");
+
+  options().add_option("tolerance", 1e-8)
+    .pretty_name("Tolerance")
+    .description("Reduction of the residual norm at which the solver stops");
+
+  options().add_option("gmres_restart", 30u)
+    .pretty_name("GMRES Restart")
+    .description("Number of GMRES iterations between restarts");
+
+  options().add_option("nb_threads", 1u)
+    .pretty_name("Number of Threads")
+    .description("Number of OpenMP threads used in the matrix-vector product");
+
+  properties().add_property("vector_type", std::string("cf3.math.LSS.NativeVector"));
+}
+
+NativeMatrix::~NativeMatrix()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::create(cf3::common::PE::CommPattern& cp, const Uint neq, const std::vector<Uint>& node_connectivity, const std::vector<Uint>& starting_indices, LSS::Vector& solution, LSS::Vector& rhs)
+{
+  // if already created
+  if (m_is_created) destroy();
+
+  const Uint nb_nodes=cp.isUpdatable().size();
+
+  // process local to matrix local numbering mapper, owned nodes first
+  m_owned.clear();
+  for (Uint i=0; i<nb_nodes; i++)
+    if (cp.isUpdatable()[i]) m_owned.push_back(i);
+  m_blockrow_size=m_owned.size();
+  m_blockcol_size=cp.gid()->size();
+  m_p2m.resize(nb_nodes);
+  Uint iupd=0;
+  Uint ighost=m_blockrow_size;
+  for (Uint i=0; i<nb_nodes; i++)
+    m_p2m[i] = cp.isUpdatable()[i] ? iupd++ : ighost++;
+
+  // sparsity pattern, with sorted process-local columns and the diagonal block always present
+  m_mat.neq=neq;
+  m_mat.row_starts.assign(1,0);
+  m_mat.columns.clear();
+  m_mat.diagonal.resize(m_blockrow_size);
+  std::vector<Uint> row_columns;
+  for (Uint r=0; r<m_blockrow_size; r++)
+  {
+    const Uint i=m_owned[r];
+    row_columns.assign(node_connectivity.begin()+starting_indices[i],node_connectivity.begin()+starting_indices[i+1]);
+    row_columns.push_back(i);
+    std::sort(row_columns.begin(),row_columns.end());
+    row_columns.erase(std::unique(row_columns.begin(),row_columns.end()),row_columns.end());
+    m_mat.diagonal[r]=m_mat.columns.size()+(std::lower_bound(row_columns.begin(),row_columns.end(),i)-row_columns.begin());
+    m_mat.columns.insert(m_mat.columns.end(),row_columns.begin(),row_columns.end());
+    m_mat.row_starts.push_back(m_mat.columns.size());
+  }
+  m_mat.values.assign(m_mat.nb_blocks()*m_mat.block_size(),0.);
+
+  // ghost exchange of the matrix-vector product input
+  m_ghosted.assign(m_blockcol_size*neq,0.);
+  boost::shared_ptr< common::PE::CommWrapperVector<Real> > wrapper=common::allocate_component< common::PE::CommWrapperVector<Real> >("ghosted");
+  wrapper->setup(m_ghosted,neq,true);
+  m_ghosted_wrapper=wrapper;
+  m_exchange=common::allocate_component<common::PE::PersistentExchange>("exchange");
+  m_exchange->setup(cp,std::vector< Handle<common::PE::CommWrapper> >(1,Handle<common::PE::CommWrapper>(m_ghosted_wrapper)));
+
+  // set class properties
+  m_is_created=true;
+  m_neq=neq;
+  CFdebug << "Created a native matrix with " << m_blockrow_size << " block rows and " << m_mat.nb_blocks() << " blocks of size " << neq << "x" << neq << "." << CFendl;
+}
+
+void NativeMatrix::create_blocked(common::PE::CommPattern& cp, const VariablesDescriptor& vars, const std::vector< Uint >& node_connectivity, const std::vector< Uint >& starting_indices, Vector& solution, Vector& rhs)
+{
+  create(cp,vars.size(),node_connectivity,starting_indices,solution,rhs);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::destroy()
+{
+  m_mat=BlockCrs();
+  m_preconditioner.reset();
+  reset_solver();
+  m_exchange.reset();
+  m_ghosted_wrapper.reset();
+  std::vector<Real>().swap(m_ghosted);
+  m_p2m.clear();
+  m_owned.clear();
+  m_neq=0;
+  m_blockrow_size=0;
+  m_blockcol_size=0;
+  m_is_created=false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Uint NativeMatrix::block_position(const Uint iblockcol, const Uint iblockrow) const
+{
+  const Uint br=row(iblockrow);
+  if (br<m_blockrow_size)
+  {
+    const int pos=m_mat.find(br,iblockcol);
+    if (pos>=0) return pos;
+  }
+  throw common::BadValue(FromHere(),"Trying to access an illegal entry.");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::set_value(const Uint icol, const Uint irow, const Real value)
+{
+  cf3_assert(m_is_created);
+  m_mat.block(block_position(icol/m_neq,irow/m_neq))[(irow%m_neq)*m_neq+icol%m_neq]=value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::add_value(const Uint icol, const Uint irow, const Real value)
+{
+  cf3_assert(m_is_created);
+  m_mat.block(block_position(icol/m_neq,irow/m_neq))[(irow%m_neq)*m_neq+icol%m_neq]+=value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::get_value(const Uint icol, const Uint irow, Real& value)
+{
+  cf3_assert(m_is_created);
+  value=m_mat.block(block_position(icol/m_neq,irow/m_neq))[(irow%m_neq)*m_neq+icol%m_neq];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::create_preconditioner()
+{
+  const std::string preconditioner=options().option("preconditioner").value<std::string>();
+  if (preconditioner=="ILU0") m_preconditioner.reset(new BlockILU0Preconditioner());
+  else if (preconditioner=="Jacobi") m_preconditioner.reset(new BlockJacobiPreconditioner());
+  else m_preconditioner.reset(new IdentityPreconditioner());
+
+  std::vector<int> column_rows(m_blockcol_size,-1);
+  for (Uint i=0; i<m_blockcol_size; i++)
+    if (m_p2m[i]<m_blockrow_size) column_rows[i]=m_p2m[i];
+  m_preconditioner->setup(m_mat,column_rows);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::update_ghosts(const Real* owned)
+{
+  for (Uint r=0; r<m_blockrow_size; r++)
+    std::copy(owned+r*m_neq,owned+(r+1)*m_neq,&m_ghosted[m_owned[r]*m_neq]);
+  m_exchange->synchronize();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::solve(LSS::Vector& solution, LSS::Vector& rhs)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(solution.is_created());
+  cf3_assert(rhs.is_created());
+
+  std::vector<Real>& sol=dynamic_cast<LSS::NativeVector&>(solution).data();
+  const std::vector<Real>& b_all=dynamic_cast<LSS::NativeVector&>(rhs).data();
+
+  // work vectors with the owned rows only
+  const Uint n=m_blockrow_size*m_neq;
+  std::vector<Real> x(n),b(n);
+  for (Uint r=0; r<m_blockrow_size; r++)
+    for (Uint j=0; j<m_neq; j++)
+    {
+      x[r*m_neq+j]=sol[m_owned[r]*m_neq+j];
+      b[r*m_neq+j]=b_all[m_owned[r]*m_neq+j];
+    }
+
+  // build, update or keep the preconditioner
+  switch(solver_update())
+  {
+  case BUILD_SOLVER:
+    create_preconditioner();
+    m_preconditioner->compute(m_mat);
+    break;
+  case RECOMPUTE_PRECONDITIONER:
+    m_preconditioner->compute(m_mat);
+    break;
+  case REUSE_PRECONDITIONER:
+    break;
+  }
+
+  const std::string solver=options().option("solver").value<std::string>();
+  if (solver=="None")
+  {
+    m_preconditioner->apply(vector_data(b),vector_data(x));
+    solver_finished(unknown_iterations());
+    update_ghosts(vector_data(x));
+    std::copy(m_ghosted.begin(),m_ghosted.end(),sol.begin());
+    return;
+  }
+
+  // solve the matrix
+  NativeSystemOperator op(*this,*m_preconditioner,options().option("nb_threads").value<Uint>());
+  const Real tolerance=options().option("tolerance").value<Real>();
+  const Uint max_iterations=options().option("max_iterations").value<Uint>();
+  KrylovResult result;
+  if (solver=="CG") result=solve_cg(op,vector_data(b),vector_data(x),tolerance,max_iterations);
+  else if (solver=="BiCGStab") result=solve_bicgstab(op,vector_data(b),vector_data(x),tolerance,max_iterations);
+  else result=solve_gmres(op,vector_data(b),vector_data(x),tolerance,max_iterations,options().option("gmres_restart").value<Uint>());
+  solver_finished(result.iterations);
+
+  // write back, the ghosts of the solution are updated as well
+  update_ghosts(vector_data(x));
+  std::copy(m_ghosted.begin(),m_ghosted.end(),sol.begin());
+
+  // print in and out residuals
+  CFinfo << "Solver residuals: in " << result.initial_residual << ", out " << result.residual << " after " << result.iterations << " iterations" << CFendl;
+  if (!result.converged)
+    CFwarn << solver << " did not converge to a tolerance of " << tolerance << " in " << max_iterations << " iterations" << CFendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::set_values(const BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  const Uint numblocks=values.indices.size();
+  for (Uint irow=0; irow<numblocks; irow++)
+  {
+    const Uint br=row(values.indices[irow]);
+    if (br<m_blockrow_size)
+      for (Uint icol=0; icol<numblocks; icol++)
+      {
+        const int pos=m_mat.find(br,values.indices[icol]);
+        if (pos<0) continue;
+        Real* block=m_mat.block(pos);
+        for (Uint j=0; j<m_neq; j++)
+          for (Uint l=0; l<m_neq; l++)
+            block[j*m_neq+l]=values.mat(irow*m_neq+j,icol*m_neq+l);
+      }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::add_values(const BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  const Uint numblocks=values.indices.size();
+  for (Uint irow=0; irow<numblocks; irow++)
+  {
+    const Uint br=row(values.indices[irow]);
+    if (br<m_blockrow_size)
+      for (Uint icol=0; icol<numblocks; icol++)
+      {
+        const int pos=m_mat.find(br,values.indices[icol]);
+        if (pos<0) continue;
+        Real* block=m_mat.block(pos);
+        for (Uint j=0; j<m_neq; j++)
+          for (Uint l=0; l<m_neq; l++)
+            block[j*m_neq+l]+=values.mat(irow*m_neq+j,icol*m_neq+l);
+      }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::get_values(BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  const Uint numblocks=values.indices.size();
+  values.mat.setConstant(0.);
+  for (Uint irow=0; irow<numblocks; irow++)
+  {
+    const Uint br=row(values.indices[irow]);
+    if (br<m_blockrow_size)
+      for (Uint icol=0; icol<numblocks; icol++)
+      {
+        const int pos=m_mat.find(br,values.indices[icol]);
+        if (pos<0) continue;
+        const Real* block=m_mat.block(pos);
+        for (Uint j=0; j<m_neq; j++)
+          for (Uint l=0; l<m_neq; l++)
+            values.mat(irow*m_neq+j,icol*m_neq+l)=block[j*m_neq+l];
+      }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::set_row(const Uint iblockrow, const Uint ieq, Real diagval, Real offdiagval)
+{
+  cf3_assert(m_is_created);
+  const Uint br=row(iblockrow);
+  if (br<m_blockrow_size)
+  {
+    for (Uint pos=m_mat.row_starts[br]; pos<m_mat.row_starts[br+1]; pos++)
+    {
+      Real* block=m_mat.block(pos);
+      for (Uint l=0; l<m_neq; l++)
+        block[ieq*m_neq+l]=offdiagval;
+    }
+    m_mat.block(m_mat.diagonal[br])[ieq*m_neq+ieq]=diagval;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::get_column_and_replace_to_zero(const Uint iblockcol, Uint ieq, std::vector<Real>& values)
+{
+  cf3_assert(m_is_created);
+  values.assign(m_blockcol_size*m_neq,0.);
+  for (Uint k=0; k<m_blockcol_size; k++)
+  {
+    const Uint br=row(k);
+    if (br<m_blockrow_size)
+    {
+      const int pos=m_mat.find(br,iblockcol);
+      if (pos<0) continue;
+      Real* block=m_mat.block(pos);
+      for (Uint j=0; j<m_neq; j++)
+      {
+        values[k*m_neq+j]=block[j*m_neq+ieq];
+        block[j*m_neq+ieq]=0.;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from)
+{
+  cf3_assert(m_is_created);
+  const Uint br_to=row(iblockrow_to);
+  const Uint br_from=row(iblockrow_from);
+  cf3_assert(!(((br_to>=m_blockrow_size)&&(br_from<m_blockrow_size))||((br_to<m_blockrow_size)&&(br_from>=m_blockrow_size))));
+  if ((br_to<m_blockrow_size)&&(br_from<m_blockrow_size))
+  {
+    const Uint begin_to=m_mat.row_starts[br_to];
+    const Uint begin_from=m_mat.row_starts[br_from];
+    const Uint nb_to=m_mat.row_starts[br_to+1]-begin_to;
+    const Uint nb_from=m_mat.row_starts[br_from+1]-begin_from;
+    if (nb_to!=nb_from) throw common::BadValue(FromHere(),"Number of blocks do not match for the two block rows to be tied together.");
+    if (!std::equal(&m_mat.columns[begin_to],&m_mat.columns[begin_to]+nb_to,&m_mat.columns[begin_from]))
+      throw common::BadValue(FromHere(),"Columns do not match for the two block rows to be tied together.");
+
+    const Uint bs=m_mat.block_size();
+    Real* val_to=m_mat.block(begin_to);
+    Real* val_from=m_mat.block(begin_from);
+    for (Uint i=0; i<nb_to*bs; i++)
+    {
+      val_to[i]+=val_from[i];
+      val_from[i]=0.;
+    }
+
+    const int diag_pos=m_mat.find(br_from,iblockrow_from);
+    const int pair_pos=m_mat.find(br_from,iblockrow_to);
+    if (pair_pos<0) throw common::BadValue(FromHere(),"The block rows to be tied together are not connected.");
+    const Uint diag=diag_pos-begin_from;
+    const Uint pair=pair_pos-begin_from;
+    for (Uint i=0; i<m_neq; i++)
+    {
+      val_from[diag*bs+i*m_neq+i]=1.;
+      val_from[pair*bs+i*m_neq+i]=-1.;
+    }
+    for (Uint i=0; i<bs; i++)
+    {
+      val_to[pair*bs+i]+=val_to[diag*bs+i];
+      val_to[diag*bs+i]=0.;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::set_diagonal(const std::vector<Real>& diag)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(diag.size()==m_blockcol_size*m_neq);
+  for (Uint i=0; i<m_blockcol_size; i++)
+    if (row(i)<m_blockrow_size)
+    {
+      Real* block=m_mat.block(m_mat.diagonal[row(i)]);
+      for (Uint l=0; l<m_neq; l++)
+        block[l*m_neq+l]=diag[i*m_neq+l];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::add_diagonal(const std::vector<Real>& diag)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(diag.size()==m_blockcol_size*m_neq);
+  for (Uint i=0; i<m_blockcol_size; i++)
+    if (row(i)<m_blockrow_size)
+    {
+      Real* block=m_mat.block(m_mat.diagonal[row(i)]);
+      for (Uint l=0; l<m_neq; l++)
+        block[l*m_neq+l]+=diag[i*m_neq+l];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::get_diagonal(std::vector<Real>& diag)
+{
+  cf3_assert(m_is_created);
+  diag.assign(m_blockcol_size*m_neq,0.);
+  for (Uint i=0; i<m_blockcol_size; i++)
+    if (row(i)<m_blockrow_size)
+    {
+      const Real* block=m_mat.block(m_mat.diagonal[row(i)]);
+      for (Uint l=0; l<m_neq; l++)
+        diag[i*m_neq+l]=block[l*m_neq+l];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::reset(Real reset_to)
+{
+  cf3_assert(m_is_created);
+  std::fill(m_mat.values.begin(),m_mat.values.end(),reset_to);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::print(common::LogStream& stream)
+{
+  if (m_is_created)
+  {
+    for (Uint r=0; r<m_blockrow_size; r++)
+      for (Uint j=0; j<m_neq; j++)
+        for (Uint pos=m_mat.row_starts[r]; pos<m_mat.row_starts[r+1]; pos++)
+          for (Uint l=0; l<m_neq; l++)
+            stream << m_mat.columns[pos]*m_neq+l << " " << -(int)(m_owned[r]*m_neq+j) << " " << m_mat.block(pos)[j*m_neq+l] << "\n";
+    stream << "# name:                 " << name() << "\n";
+    stream << "# type_name:            " << type_name() << "\n";
+    stream << "# process:              " << common::PE::Comm::instance().rank() << "\n";
+    stream << "# number of equations:  " << m_neq << "\n";
+    stream << "# number of rows:       " << m_blockrow_size*m_neq << "\n";
+    stream << "# number of cols:       " << m_blockcol_size*m_neq << "\n";
+    stream << "# number of block rows: " << m_blockrow_size << "\n";
+    stream << "# number of block cols: " << m_blockcol_size << "\n";
+    stream << "# number of entries:    " << m_mat.values.size() << "\n";
+  } else {
+    stream << name() << " of type " << type_name() << "::is_created() is false, nothing is printed.";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::print(std::ostream& stream)
+{
+  if (m_is_created)
+  {
+    for (Uint r=0; r<m_blockrow_size; r++)
+      for (Uint j=0; j<m_neq; j++)
+        for (Uint pos=m_mat.row_starts[r]; pos<m_mat.row_starts[r+1]; pos++)
+          for (Uint l=0; l<m_neq; l++)
+            stream << m_mat.columns[pos]*m_neq+l << " " << -(int)(m_owned[r]*m_neq+j) << " " << m_mat.block(pos)[j*m_neq+l] << "\n";
+    stream << "# name:                 " << name() << "\n";
+    stream << "# type_name:            " << type_name() << "\n";
+    stream << "# process:              " << common::PE::Comm::instance().rank() << "\n";
+    stream << "# number of equations:  " << m_neq << "\n";
+    stream << "# number of rows:       " << m_blockrow_size*m_neq << "\n";
+    stream << "# number of cols:       " << m_blockcol_size*m_neq << "\n";
+    stream << "# number of block rows: " << m_blockrow_size << "\n";
+    stream << "# number of block cols: " << m_blockcol_size << "\n";
+    stream << "# number of entries:    " << m_mat.values.size() << "\n" << std::flush;
+  } else {
+    stream << name() << " of type " << type_name() << "::is_created() is false, nothing is printed.";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::print(const std::string& filename, std::ios_base::openmode mode )
+{
+  std::ofstream stream(filename.c_str(),mode);
+  stream << "VARIABLES=COL,ROW,VAL\n" << std::flush;
+  stream << "ZONE T=\"" << type_name() << "::" << name() <<  "\"\n" << std::flush;
+  print(stream);
+  stream.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::print_native(std::ostream& stream)
+{
+  print(stream);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void NativeMatrix::debug_data(std::vector<Uint>& row_indices, std::vector<Uint>& col_indices, std::vector<Real>& values)
+{
+  cf3_assert(m_is_created);
+  row_indices.clear();
+  col_indices.clear();
+  values.clear();
+  for (Uint r=0; r<m_blockrow_size; r++)
+    for (Uint j=0; j<m_neq; j++)
+      for (Uint pos=m_mat.row_starts[r]; pos<m_mat.row_starts[r+1]; pos++)
+        for (Uint l=0; l<m_neq; l++)
+        {
+          row_indices.push_back(m_owned[r]*m_neq+j);
+          col_indices.push_back(m_mat.columns[pos]*m_neq+l);
+          values.push_back(m_mat.block(pos)[j*m_neq+l]);
+        }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
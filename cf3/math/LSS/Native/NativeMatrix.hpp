@@ -0,0 +1,225 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Math_LSS_NativeMatrix_hpp
+#define cf3_Math_LSS_NativeMatrix_hpp
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/scoped_ptr.hpp>
+
+#include "math/LSS/LibLSS.hpp"
+#include "math/LSS/BlockAccumulator.hpp"
+#include "math/LSS/Vector.hpp"
+#include "math/LSS/Matrix.hpp"
+#include "math/LSS/Native/NativeDetail.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file NativeMatrix.hpp definition of LSS::NativeMatrix
+
+  Block compressed row matrix with built-in Krylov solvers, so a linear system can be solved without Trilinos.
+  Each rank stores the block rows it owns, with the columns in process-local numbering, ghosts included.
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common { namespace PE { class CommWrapper; class PersistentExchange; } }
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+class LSS_API NativeMatrix : public LSS::Matrix {
+public:
+
+  /// @name CREATION, DESTRUCTION AND COMPONENT SYSTEM
+  //@{
+
+  /// name of the type
+  static std::string type_name () { return "NativeMatrix"; }
+
+  /// Accessor to solver type
+  const std::string solvertype() { return "Native"; }
+
+  /// Accessor to the flag if matrix, solution and rhs are tied together or not
+  const bool is_swappable(const LSS::Vector& solution, const LSS::Vector& rhs) { return true; }
+
+  /// Default constructor
+  NativeMatrix(const std::string& name);
+
+  /// Destructor
+  ~NativeMatrix();
+
+  /// Setup sparsity structure
+  void create(cf3::common::PE::CommPattern& cp, const Uint neq, const std::vector<Uint>& node_connectivity, const std::vector<Uint>& starting_indices, LSS::Vector& solution, LSS::Vector& rhs);
+
+  /// The variables stay interlaced per node, as in create
+  void create_blocked(common::PE::CommPattern& cp, const VariablesDescriptor& vars, const std::vector< Uint >& node_connectivity, const std::vector< Uint >& starting_indices, Vector& solution, Vector& rhs);
+
+  /// Deallocate underlying data
+  void destroy();
+
+  //@} END CREATION, DESTRUCTION AND COMPONENT SYSTEM
+
+  /// @name INDIVIDUAL ACCESS
+  //@{
+
+  /// Set value at given location in the matrix
+  void set_value(const Uint icol, const Uint irow, const Real value);
+
+  /// Add value at given location in the matrix
+  void add_value(const Uint icol, const Uint irow, const Real value);
+
+  /// Get value at given location in the matrix
+  void get_value(const Uint icol, const Uint irow, Real& value);
+
+  //@} END INDIVIDUAL ACCESS
+
+  /// @name SOLVE THE SYSTEM
+  //@{
+
+  /// Solve with the Krylov method and preconditioner selected by the options
+  void solve(LSS::Vector& solution, LSS::Vector& rhs);
+
+  //@} END SOLVE THE SYSTEM
+
+  /// @name EFFICCIENT ACCESS
+  //@{
+
+  /// Set a list of values
+  void set_values(const BlockAccumulator& values);
+
+  /// Add a list of values
+  void add_values(const BlockAccumulator& values);
+
+  /// Blocks of disjoint rows can be scattered concurrently
+  bool is_reentrant() const { return true; }
+
+  /// Get a list of values
+  void get_values(BlockAccumulator& values);
+
+  /// Set a row, diagonal and off-diagonals values separately (dirichlet-type boundaries)
+  void set_row(const Uint iblockrow, const Uint ieq, Real diagval, Real offdiagval);
+
+  /// Get a column and replace it to zero (dirichlet-type boundaries, when trying to preserve symmetry)
+  /// Note that sparsity info is lost, values will contain zeros where no matrix entry is present
+  void get_column_and_replace_to_zero(const Uint iblockcol, Uint ieq, std::vector<Real>& values);
+
+  /// Add one line to another and tie to it via dirichlet-style (applying periodicity)
+  void tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from);
+
+  /// Set the diagonal
+  void set_diagonal(const std::vector<Real>& diag);
+
+  /// Add to the diagonal
+  void add_diagonal(const std::vector<Real>& diag);
+
+  /// Get the diagonal
+  void get_diagonal(std::vector<Real>& diag);
+
+  /// Reset Matrix
+  void reset(Real reset_to=0.);
+
+  //@} END EFFICCIENT ACCESS
+
+  /// @name MISCELLANEOUS
+  //@{
+
+  /// Print to wherever
+  void print(common::LogStream& stream);
+
+  /// Print to wherever
+  void print(std::ostream& stream);
+
+  /// Print to file given by filename
+  void print(const std::string& filename, std::ios_base::openmode mode = std::ios_base::out );
+
+  void print_native(std::ostream& stream);
+
+  /// Accessor to the state of create
+  const bool is_created() { return m_is_created; }
+
+  /// Accessor to the number of equations
+  const Uint neq() { cf3_assert(m_is_created); return m_neq; }
+
+  /// Accessor to the number of block rows
+  const Uint blockrow_size() {  cf3_assert(m_is_created); return m_blockrow_size; }
+
+  /// Accessor to the number of block columns
+  const Uint blockcol_size() {  cf3_assert(m_is_created); return m_blockcol_size; }
+
+  //@} END MISCELLANEOUS
+
+  /// @name TEST ONLY
+  //@{
+
+  /// exports the matrix into big linear arrays
+  /// @attention only for debug and utest purposes
+  void debug_data(std::vector<Uint>& row_indices, std::vector<Uint>& col_indices, std::vector<Real>& values);
+
+  //@} END TEST ONLY
+
+private:
+
+  /// Block row of a process-local block index, or a value of at least m_blockrow_size for ghosts
+  Uint row(const Uint iblock) const { return m_p2m[iblock]; }
+
+  /// Position of the block at the given process-local block indices, throws if the block is not in the sparsity pattern
+  Uint block_position(const Uint iblockcol, const Uint iblockrow) const;
+
+  /// Build the preconditioner selected by the options
+  void create_preconditioner();
+
+  /// Fill the owned entries of the ghosted work vector and update its ghosts from the other ranks
+  void update_ghosts(const Real* owned);
+
+  /// sparsity pattern and values
+  BlockCrs m_mat;
+
+  /// preconditioner, kept between solves according to the solver_reuse option
+  boost::scoped_ptr<NativePreconditioner> m_preconditioner;
+
+  /// state of creation
+  bool m_is_created;
+
+  /// number of equations
+  Uint m_neq;
+
+  /// number of block rows
+  Uint m_blockrow_size;
+
+  /// number of block columns
+  Uint m_blockcol_size;
+
+  /// mapper array, maps from process local numbering to block rows (ghosts are numbered after the owned rows)
+  std::vector<Uint> m_p2m;
+
+  /// process-local block index of each block row
+  std::vector<Uint> m_owned;
+
+  /// work vector in process-local order, ghosts included, used as input of the matrix-vector product
+  std::vector<Real> m_ghosted;
+
+  /// commwrapper of m_ghosted, with a stride of neq
+  boost::shared_ptr<common::PE::CommWrapper> m_ghosted_wrapper;
+
+  /// exchange of the ghosts of m_ghosted, set up once in create
+  boost::shared_ptr<common::PE::PersistentExchange> m_exchange;
+
+  friend class NativeSystemOperator;
+
+}; // end of class Matrix
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+#endif // cf3_Math_LSS_NativeMatrix_hpp
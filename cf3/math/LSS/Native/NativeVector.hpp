@@ -0,0 +1,178 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Math_LSS_NativeVector_hpp
+#define cf3_Math_LSS_NativeVector_hpp
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "math/LSS/LibLSS.hpp"
+#include "common/PE/CommPattern.hpp"
+#include "math/LSS/Vector.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file NativeVector.hpp implementation of LSS::NativeVector
+
+  Plain contiguous storage in process-local order, ghosts included, used together with NativeMatrix.
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+class LSS_API NativeVector : public LSS::Vector {
+public:
+
+  /// @name CREATION, DESTRUCTION AND COMPONENT SYSTEM
+  //@{
+
+  /// name of the type
+  static std::string type_name () { return "NativeVector"; }
+
+  /// Accessor to solver type
+  const std::string solvertype() { return "Native"; }
+
+  /// Default constructor
+  NativeVector(const std::string& name);
+
+  /// Setup sparsity structure
+  void create(common::PE::CommPattern& cp, Uint neq);
+
+  /// Variables are stored interlaced per node, as in create
+  void create_blocked(common::PE::CommPattern& cp, const VariablesDescriptor& vars);
+
+  /// Deallocate underlying data
+  void destroy();
+
+  //@} END CREATION, DESTRUCTION AND COMPONENT SYSTEM
+
+  /// @name INDIVIDUAL ACCESS
+  //@{
+
+  /// Set value at given location in the matrix
+  void set_value(const Uint irow, const Real value);
+
+  /// Add value at given location in the matrix
+  void add_value(const Uint irow, const Real value);
+
+  /// Get value at given location in the matrix
+  void get_value(const Uint irow, Real& value);
+
+  /// Set value at given location in the matrix
+  void set_value(const Uint iblockrow, const Uint ieq, const Real value);
+
+  /// Add value at given location in the matrix
+  void add_value(const Uint iblockrow, const Uint ieq, const Real value);
+
+  /// Get value at given location in the matrix
+  void get_value(const Uint iblockrow, const Uint ieq, Real& value);
+
+  //@} END INDIVIDUAL ACCESS
+
+  /// @name EFFICCIENT ACCESS
+  //@{
+
+  /// Set a list of values to rhs
+  void set_rhs_values(const BlockAccumulator& values);
+
+  /// Add a list of values to rhs
+  void add_rhs_values(const BlockAccumulator& values);
+
+  /// Blocks of disjoint rows can be scattered concurrently
+  bool is_reentrant() const { return true; }
+
+  /// Get a list of values from rhs
+  void get_rhs_values(BlockAccumulator& values);
+
+  /// Set a list of values to sol
+  void set_sol_values(const BlockAccumulator& values);
+
+  /// Add a list of values to sol
+  void add_sol_values(const BlockAccumulator& values);
+
+  /// Get a list of values from sol
+  void get_sol_values(BlockAccumulator& values);
+
+  /// Reset Vector
+  void reset(Real reset_to=0.);
+
+  /// Copies the contents out of the LSS::Vector to table.
+  void get( boost::multi_array<Real, 2>& data);
+
+  /// Copies the contents of the table into the LSS::Vector.
+  void set( boost::multi_array<Real, 2>& data);
+
+  //@} END EFFICCIENT ACCESS
+
+  /// @name MISCELLANEOUS
+  //@{
+
+  /// Print to wherever
+  void print(common::LogStream& stream);
+
+  /// Print to wherever
+  void print(std::ostream& stream);
+
+  /// Print to file given by filename
+  void print(const std::string& filename, std::ios_base::openmode mode = std::ios_base::out );
+
+  void print_native(std::ostream& stream);
+
+  /// Accessor to the state of create
+  const bool is_created() { return m_is_created; }
+
+  /// Accessor to the number of equations
+  const Uint neq() { return m_neq; }
+
+  /// Accessor to the number of block rows
+  const Uint blockrow_size() { return m_blockrow_size; }
+
+  /// Accessor to the values, in process-local order
+  /// @attention this function is not part of the interface itself, only used by NativeMatrix
+  std::vector<Real>& data() { return m_data; }
+
+  //@} END MISCELLANEOUS
+
+  /// @name TEST ONLY
+  //@{
+
+  /// exports the vector into big linear array
+  /// @attention only for debug and utest purposes
+  void debug_data(std::vector<Real>& values);
+
+  //@} END TEST ONLY
+
+private:
+
+  /// values of all process-local entries, ghosts included
+  std::vector<Real> m_data;
+
+  /// number of equations
+  Uint m_neq;
+
+  /// number of block rows, ghosts included
+  Uint m_blockrow_size;
+
+  /// status of the vector
+  bool m_is_created;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+#endif // cf3_Math_LSS_NativeVector_hpp
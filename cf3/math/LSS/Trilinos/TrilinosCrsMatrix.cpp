@@ -8,6 +8,8 @@
 
 #include <iostream>
 
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
 #include <boost/pointer_cast.hpp>
 
 #include "Teuchos_ConfigDefs.hpp"
@@ -28,6 +30,7 @@
 #include "Thyra_EpetraLinearOp.hpp"
 #include "Thyra_EpetraThyraWrappers.hpp"
 #include "Thyra_LinearOpWithSolveBase.hpp"
+#include "Thyra_LinearOpWithSolveFactoryHelpers.hpp"
 #include "Thyra_VectorBase.hpp"
 
 #include "Stratimikos_DefaultLinearSolverBuilder.hpp"
@@ -104,7 +107,8 @@ TrilinosCrsMatrix::TrilinosCrsMatrix(const std::string& name) :
   m_comm(common::PE::Comm::instance().communicator())
 {
   properties().add_property("vector_type", std::string("cf3.math.LSS.TrilinosVector"));
-  options().add_option( "settings_file", "trilinos_settings.xml" );
+  options().add_option( "settings_file", "trilinos_settings.xml" )
+    .attach_trigger(boost::bind(&TrilinosCrsMatrix::reset_solver, this));
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -197,6 +201,9 @@ void TrilinosCrsMatrix::destroy()
   {
     m_mat.reset();
   }
+  m_lows.reset();
+  m_lows_factory.reset();
+  reset_solver();
   m_p2m.resize(0);
   m_p2m.reserve(0);
   m_neq=0;
@@ -251,26 +258,41 @@ void TrilinosCrsMatrix::solve(LSS::Vector& solution, LSS::Vector& rhs)
   LSS::TrilinosVector& tsol = dynamic_cast<LSS::TrilinosVector&>(solution);
   LSS::TrilinosVector& trhs = dynamic_cast<LSS::TrilinosVector&>(rhs);
 
-  Teuchos::RCP<Teuchos::ParameterList> paramList = Teuchos::getParametersFromXmlFile(options().option("settings_file").value_str());
-
   // Build Thyra linear algebra objects
   Teuchos::RCP<const Thyra::LinearOpBase<double> > th_mat = Thyra::epetraLinearOp(m_mat);
   Teuchos::RCP<const Thyra::VectorBase<double> > th_rhs = Thyra::create_Vector(trhs.epetra_vector(),th_mat->range());
   Teuchos::RCP<Thyra::VectorBase<double> > th_sol = Thyra::create_Vector(tsol.epetra_vector(),th_mat->domain());
 
-  // Build stratimikos solver
+  // Build, update or keep the stratimikos solver
   /////////////////////////////////////////////////////////
 
-  Stratimikos::DefaultLinearSolverBuilder linearSolverBuilder;
+  switch(solver_update())
+  {
+  case BUILD_SOLVER:
+  {
+    Teuchos::RCP<Teuchos::ParameterList> paramList = Teuchos::getParametersFromXmlFile(options().option("settings_file").value_str());
 
-  //Teko::addTekoToStratimikosBuilder(linearSolverBuilder);
-  linearSolverBuilder.setParameterList(paramList);
+    Stratimikos::DefaultLinearSolverBuilder linearSolverBuilder;
 
-  Teuchos::RCP<Thyra::LinearOpWithSolveFactoryBase<double> > lowsFactory = Thyra::createLinearSolveStrategy(linearSolverBuilder);
-  Teuchos::RCP<Thyra::LinearOpWithSolveBase<double> > th_invA = Thyra::linearOpWithSolve(*lowsFactory, th_mat);
+    //Teko::addTekoToStratimikosBuilder(linearSolverBuilder);
+    linearSolverBuilder.setParameterList(paramList);
+
+    m_lows_factory = Thyra::createLinearSolveStrategy(linearSolverBuilder);
+    m_lows = Thyra::linearOpWithSolve(*m_lows_factory, th_mat);
+    break;
+  }
+  case RECOMPUTE_PRECONDITIONER:
+    // the existing preconditioner object is passed in, so its symbolic setup can be kept
+    Thyra::initializeOp(*m_lows_factory, th_mat, m_lows.ptr());
+    break;
+  case REUSE_PRECONDITIONER:
+    Thyra::initializeAndReuseOp(*m_lows_factory, th_mat, m_lows.ptr());
+    break;
+  }
 
   Thyra::assign(th_sol.ptr(), 0.0);
-  Thyra::SolveStatus<double> status = Thyra::solve<double>(*th_invA, Thyra::NOTRANS, *th_rhs, th_sol.ptr());
+  Thyra::SolveStatus<double> status = Thyra::solve<double>(*m_lows, Thyra::NOTRANS, *th_rhs, th_sol.ptr());
+  solver_finished(iteration_count(status));
   CFinfo << "Thyra::solve finished with status " << status.message << CFendl;
 }
 
@@ -282,20 +304,22 @@ void TrilinosCrsMatrix::set_values(const BlockAccumulator& values)
   const Uint nb_nodes = values.indices.size();
   const int num_entries = nb_nodes*m_neq;
   cf3_assert(values.mat.rows() == num_entries);
-  // Convert the index vector
+  // Convert the index vector, into the scratch space of the accumulator so that threads don't share it
+  std::vector<int>& converted_indices = values.converted_indices;
+  converted_indices.resize(num_entries);
   for(Uint i = 0; i != nb_nodes; ++i)
   {
     const Uint local_start_idx = values.indices[i]*m_neq;
     for(int j = 0; j != m_neq; ++j)
-      m_converted_indices[i*m_neq+j] = m_p2m[local_start_idx+j];
+      converted_indices[i*m_neq+j] = m_p2m[local_start_idx+j];
   }
   // insert the values
   for(Uint i = 0; i != nb_nodes; ++i)
   {
     for(int j = 0; j != m_neq; ++j)
     {
-      if(m_converted_indices[i*m_neq+j] < m_num_my_elements)
-        TRILINOS_THROW(m_mat->ReplaceMyValues(m_converted_indices[i*m_neq+j], num_entries, values.mat.data()+(num_entries*(i*m_neq+j)),&m_converted_indices[0]));
+      if(converted_indices[i*m_neq+j] < m_num_my_elements)
+        TRILINOS_THROW(m_mat->ReplaceMyValues(converted_indices[i*m_neq+j], num_entries, values.mat.data()+(num_entries*(i*m_neq+j)),&converted_indices[0]));
     }
   }
 }
@@ -308,20 +332,22 @@ void TrilinosCrsMatrix::add_values(const BlockAccumulator& values)
   const Uint nb_nodes = values.indices.size();
   const int num_entries = nb_nodes*m_neq;
   cf3_assert(values.mat.rows() == num_entries);
-  // Convert the index vector
+  // Convert the index vector, into the scratch space of the accumulator so that threads don't share it
+  std::vector<int>& converted_indices = values.converted_indices;
+  converted_indices.resize(num_entries);
   for(Uint i = 0; i != nb_nodes; ++i)
   {
     const Uint local_start_idx = values.indices[i]*m_neq;
     for(int j = 0; j != m_neq; ++j)
-      m_converted_indices[i*m_neq+j] = m_p2m[local_start_idx+j];
+      converted_indices[i*m_neq+j] = m_p2m[local_start_idx+j];
   }
   // insert the values
   for(Uint i = 0; i != nb_nodes; ++i)
   {
     for(int j = 0; j != m_neq; ++j)
     {
-      if(m_converted_indices[i*m_neq+j] < m_num_my_elements)
-        TRILINOS_THROW(m_mat->SumIntoMyValues(m_converted_indices[i*m_neq+j], num_entries, values.mat.data()+(num_entries*(i*m_neq+j)),&m_converted_indices[0]));
+      if(converted_indices[i*m_neq+j] < m_num_my_elements)
+        TRILINOS_THROW(m_mat->SumIntoMyValues(converted_indices[i*m_neq+j], num_entries, values.mat.data()+(num_entries*(i*m_neq+j)),&converted_indices[0]));
     }
   }
 }
@@ -12,6 +12,7 @@
 #include <Epetra_MpiComm.h>
 #include <Epetra_CrsMatrix.h>
 #include <Teuchos_RCP.hpp>
+#include <Thyra_LinearOpWithSolveFactoryBase.hpp>
 
 #include "math/LSS/LibLSS.hpp"
 #include "math/LSS/BlockAccumulator.hpp"
@@ -96,6 +97,9 @@ public:
   /// eigen, templatization on top level
   void add_values(const BlockAccumulator& values);
 
+  /// Blocks of disjoint rows can be scattered concurrently
+  bool is_reentrant() const { return true; }
+
   /// Add a list of values
   void get_values(BlockAccumulator& values);
 
@@ -165,6 +169,12 @@ private:
   /// teuchos style smart pointer wrapping the matrix
   Teuchos::RCP<Epetra_CrsMatrix> m_mat;
 
+  /// linear solver strategy, kept between solves according to the solver_reuse option
+  Teuchos::RCP<Thyra::LinearOpWithSolveFactoryBase<Real> > m_lows_factory;
+
+  /// linear solver and preconditioner, kept between solves according to the solver_reuse option
+  Teuchos::RCP<Thyra::LinearOpWithSolveBase<Real> > m_lows;
+
   /// epetra mpi environment
   Epetra_MpiComm m_comm;
 
@@ -6,13 +6,15 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "Teuchos_ParameterList.hpp"
+
 #include "common/PE/Comm.hpp"
 #include "common/PE/CommPattern.hpp"
 #include "common/Log.hpp"
 
 #include "math/VariablesDescriptor.hpp"
 
-
+#include "math/LSS/Matrix.hpp"
 #include "math/LSS/Trilinos/TrilinosDetail.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -117,6 +119,21 @@ void create_map_data(common::PE::CommPattern& cp, const VariablesDescriptor& var
   delete[] gid;
 }
 
+Uint iteration_count(const Thyra::SolveStatus<Real>& status)
+{
+  if(status.extraParameters.is_null())
+    return Matrix::unknown_iterations();
+
+  // AztecOO and Belos each use their own key
+  static const char* keys[] = { "AztecOO/Iteration Count", "Belos/Iteration Count", "Iteration Count" };
+  for(Uint i = 0; i != 3; ++i)
+  {
+    if(status.extraParameters->isType<int>(keys[i]))
+      return status.extraParameters->get<int>(keys[i]);
+  }
+
+  return Matrix::unknown_iterations();
+}
 
 } // namespace LSS
 } // namespace math
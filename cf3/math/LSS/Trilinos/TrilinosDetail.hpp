@@ -9,6 +9,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "Thyra_SolveSupportTypes.hpp"
+
 #include "common/CF.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -39,6 +41,9 @@ void create_map_data(cf3::common::PE::CommPattern& cp,
                       std::vector<int>& my_global_elements,
                       int& num_my_elements);
 
+/// Number of iterations reported by a Stratimikos solver, or Matrix::unknown_iterations() if the solver does not report it
+Uint iteration_count(const Thyra::SolveStatus<Real>& status);
+
 } // namespace LSS
 } // namespace math
 } // namespace cf3
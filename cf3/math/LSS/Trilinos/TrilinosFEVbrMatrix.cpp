@@ -8,6 +8,8 @@
 
 #include <iostream>
 
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
 #include <boost/pointer_cast.hpp>
 
 #include "Stratimikos_DefaultLinearSolverBuilder.hpp"
@@ -28,6 +30,7 @@
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
 #include "common/PropertyList.hpp"
+#include "math/LSS/Trilinos/TrilinosDetail.hpp"
 #include "math/LSS/Trilinos/TrilinosFEVbrMatrix.hpp"
 #include "math/LSS/Trilinos/TrilinosVector.hpp"
 
@@ -61,7 +64,8 @@ TrilinosFEVbrMatrix::TrilinosFEVbrMatrix(const std::string& name) :
   m_converted_indices(0),
   m_comm(common::PE::Comm::instance().communicator())
 {
-  options().add_option( "settings_file", "trilinos_settings.xml" );
+  options().add_option( "settings_file", "trilinos_settings.xml" )
+    .attach_trigger(boost::bind(&TrilinosFEVbrMatrix::reset_solver, this));
   properties().add_property("vector_type", std::string("cf3.math.LSS.TrilinosVector"));
 }
 
@@ -157,6 +161,9 @@ void TrilinosFEVbrMatrix::create_blocked(common::PE::CommPattern& cp, const Vari
 void TrilinosFEVbrMatrix::destroy()
 {
   if (m_is_created) m_mat.reset();
+  m_lows.reset();
+  m_lows_factory.reset();
+  reset_solver();
   m_p2m.resize(0);
   m_p2m.reserve(0);
   m_neq=0;
@@ -242,17 +249,6 @@ void TrilinosFEVbrMatrix::solve(LSS::Vector& solution, LSS::Vector& rhs)
   cf3_assert(solution.is_created());
   cf3_assert(rhs.is_created());
 
-  // general setup phase
-  Stratimikos::DefaultLinearSolverBuilder linearSolverBuilder(options().option("settings_file").value_str());
-  /// @todo decouple from fancyostream to ostream or to C stdout when possible
-  Teuchos::RCP<Teuchos::FancyOStream> out = Teuchos::VerboseObjectBase::getDefaultOStream();
-  Teuchos::CommandLineProcessor  clp(false); // false: don't throw exceptions
-  linearSolverBuilder.setupCLP(&clp); // not used, TODO: see if can be removed safely since not really used
-  /// @todo check whgats wrtong with input options via string
-  //clp.setOption( "tol",            &tol,            "Tolerance to check against the scaled residual norm." ); // input options via string, not working for some reason
-  int argc=0; char** argv=0; Teuchos::CommandLineProcessor::EParseCommandLineReturn parse_return = clp.parse(argc,argv);
-  if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL ) throw common::ParsingFailed(FromHere(),"Emulated command line parsing for stratimikos failed");
-
   // wrapping epetra to thyra
   Teuchos::RCP<const Thyra::LinearOpBase<double> > A = Thyra::epetraLinearOp( m_mat );
   LSS::TrilinosVector& tsol = dynamic_cast<LSS::TrilinosVector&>(solution);
@@ -270,30 +266,58 @@ void TrilinosFEVbrMatrix::solve(LSS::Vector& solution, LSS::Vector& rhs)
     epetra_r.Norm2(&norm2_in);
   }
 
-  // Reading in the solver parameters from the parameters file and/or from
-  // the command line.  This was setup by the command-line options
-  // set by the setupCLP(...) function above.
-  linearSolverBuilder.readParameters(0); // out.get() if want confirmation about the xml file within trilinos
-  Teuchos::RCP<Thyra::LinearOpWithSolveFactoryBase<double> > lowsFactory = linearSolverBuilder.createLinearSolveStrategy(""); // create linear solver strategy
-/// @todo verbosity level from option
-  lowsFactory->setVerbLevel((Teuchos::EVerbosityLevel)4); // set verbosity
-
-  // print back default and current settings
-  if (false) {
-    std::ofstream ofs("./trilinos_default.txt");
-    linearSolverBuilder.getValidParameters()->print(ofs,Teuchos::ParameterList::PrintOptions().indent(2).showTypes(true).showDoc(true)); // the last true-false is the deciding about whether printing documentation to option or not
-    ofs.flush();ofs.close();
-    ofs.open("./trilinos_default.xml");
-    Teuchos::writeParameterListToXmlOStream(*linearSolverBuilder.getValidParameters(),ofs);
-    ofs.flush();ofs.close();
+  // build, update or keep the linear solver and its preconditioner
+  switch(solver_update())
+  {
+  case BUILD_SOLVER:
+  {
+    // general setup phase
+    Stratimikos::DefaultLinearSolverBuilder linearSolverBuilder(options().option("settings_file").value_str());
+    /// @todo decouple from fancyostream to ostream or to C stdout when possible
+    Teuchos::RCP<Teuchos::FancyOStream> out = Teuchos::VerboseObjectBase::getDefaultOStream();
+    Teuchos::CommandLineProcessor  clp(false); // false: don't throw exceptions
+    linearSolverBuilder.setupCLP(&clp); // not used, TODO: see if can be removed safely since not really used
+    /// @todo check whgats wrtong with input options via string
+    //clp.setOption( "tol",            &tol,            "Tolerance to check against the scaled residual norm." ); // input options via string, not working for some reason
+    int argc=0; char** argv=0; Teuchos::CommandLineProcessor::EParseCommandLineReturn parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL ) throw common::ParsingFailed(FromHere(),"Emulated command line parsing for stratimikos failed");
+
+    // Reading in the solver parameters from the parameters file and/or from
+    // the command line.  This was setup by the command-line options
+    // set by the setupCLP(...) function above.
+    linearSolverBuilder.readParameters(0); // out.get() if want confirmation about the xml file within trilinos
+    m_lows_factory = linearSolverBuilder.createLinearSolveStrategy(""); // create linear solver strategy
+    /// @todo verbosity level from option
+    m_lows_factory->setVerbLevel((Teuchos::EVerbosityLevel)4); // set verbosity
+
+    // print back default and current settings
+    if (false) {
+      std::ofstream ofs("./trilinos_default.txt");
+      linearSolverBuilder.getValidParameters()->print(ofs,Teuchos::ParameterList::PrintOptions().indent(2).showTypes(true).showDoc(true)); // the last true-false is the deciding about whether printing documentation to option or not
+      ofs.flush();ofs.close();
+      ofs.open("./trilinos_default.xml");
+      Teuchos::writeParameterListToXmlOStream(*linearSolverBuilder.getValidParameters(),ofs);
+      ofs.flush();ofs.close();
+    }
+    if (false) {
+      linearSolverBuilder.writeParamsFile(*m_lows_factory,"./trilinos_current.xml");
+    }
+
+    m_lows = Thyra::linearOpWithSolve(*m_lows_factory, A);
+    break;
   }
-  if (false) {
-    linearSolverBuilder.writeParamsFile(*lowsFactory,"./trilinos_current.xml");
+  case RECOMPUTE_PRECONDITIONER:
+    // the existing preconditioner object is passed in, so its symbolic setup can be kept
+    Thyra::initializeOp(*m_lows_factory, A, m_lows.ptr());
+    break;
+  case REUSE_PRECONDITIONER:
+    Thyra::initializeAndReuseOp(*m_lows_factory, A, m_lows.ptr());
+    break;
   }
 
   // solve the matrix
-  Teuchos::RCP<Thyra::LinearOpWithSolveBase<double> > lows = Thyra::linearOpWithSolve(*lowsFactory, A);
-  lows->solve(Thyra::NOTRANS,*b,x.ptr());
+  const Thyra::SolveStatus<Real> status = m_lows->solve(Thyra::NOTRANS,*b,x.ptr());
+  solver_finished(iteration_count(status));
 
   // r = b - A*x, final L2 norm
   double norm2_out=0.;
@@ -322,9 +346,11 @@ void TrilinosFEVbrMatrix::set_values(const BlockAccumulator& values)
   const int numblocks=values.indices.size();
   const int rowoffset=(numblocks-1)*m_neq;
   const int neqneq=m_neq*m_neq;
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  for (int i=0; i<(const int)numblocks; i++) m_converted_indices[i]=m_p2m[values.indices[i]];
-  int* idxs=(int*)&m_converted_indices[0];
+  // convert into the scratch space of the accumulator, so that threads don't share it
+  std::vector<int>& converted_indices = values.converted_indices;
+  if (converted_indices.size()<numblocks) converted_indices.resize(numblocks);
+  for (int i=0; i<(const int)numblocks; i++) converted_indices[i]=m_p2m[values.indices[i]];
+  int* idxs=(int*)&converted_indices[0];
   for (int irow=0; irow<(const int)numblocks; irow++)
   {
     if (idxs[irow]<m_blockrow_size)
@@ -410,9 +436,11 @@ void TrilinosFEVbrMatrix::add_values(const BlockAccumulator& values)
   const int numblocks=values.indices.size();
   const int rowoffset=(numblocks-1)*m_neq;
   const int neqneq=m_neq*m_neq;
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  for (int i=0; i<(const int)numblocks; i++) m_converted_indices[i]=m_p2m[values.indices[i]];
-  int* idxs=(int*)&m_converted_indices[0];
+  // convert into the scratch space of the accumulator, so that threads don't share it
+  std::vector<int>& converted_indices = values.converted_indices;
+  if (converted_indices.size()<numblocks) converted_indices.resize(numblocks);
+  for (int i=0; i<(const int)numblocks; i++) converted_indices[i]=m_p2m[values.indices[i]];
+  int* idxs=(int*)&converted_indices[0];
   for (int irow=0; irow<(const int)numblocks; irow++)
   {
     if (idxs[irow]<m_blockrow_size)
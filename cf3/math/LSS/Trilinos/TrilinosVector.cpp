@@ -151,8 +151,6 @@ void TrilinosVector::set_rhs_values(const BlockAccumulator& values)
   /// @note looked up the code and access mechanism is a mess, much less cpu to access here in a for loop and directly do whats desired
   cf3_assert(m_is_created);
   const int numblocks=values.indices.size();
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  int *conv=&m_converted_indices[0];
   double *vals=(double*)&values.rhs[0];
   for (int i=0; i<(const int)numblocks; i++)
   {
@@ -168,8 +166,6 @@ void TrilinosVector::add_rhs_values(const BlockAccumulator& values)
   /// @note looked up the code and access mechanism is a mess, much less cpu to access here in a for loop and directly do whats desired
   cf3_assert(m_is_created);
   const int numblocks=values.indices.size();
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  int *conv=&m_converted_indices[0];
   double *vals=(double*)&values.rhs[0];
   for (int i=0; i<(const int)numblocks; i++)
   {
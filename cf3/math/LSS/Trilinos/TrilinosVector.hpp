@@ -103,6 +103,9 @@ public:
   /// Add a list of values to rhs
   void add_rhs_values(const BlockAccumulator& values);
 
+  /// Blocks of disjoint rows can be scattered concurrently
+  bool is_reentrant() const { return true; }
+
   /// Get a list of values from rhs
   void get_rhs_values(BlockAccumulator& values);
 
@@ -95,6 +95,10 @@ public:
   /// Get a list of values from rhs
   virtual void get_rhs_values(BlockAccumulator& values) = 0;
 
+  /// True if set_rhs_values and add_rhs_values may be called from several threads at once,
+  /// for blocks whose rows are disjoint. Otherwise the caller must serialize them.
+  virtual bool is_reentrant() const { return false; }
+
   /// Set a list of values to sol
   virtual void set_sol_values(const BlockAccumulator& values) = 0;
 
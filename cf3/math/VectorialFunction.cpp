@@ -4,8 +4,14 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
 #include <boost/tokenizer.hpp>
 
+#ifdef CF3_HAVE_OPENMP
+  #include <omp.h>
+#endif
+
 #include "common/Log.hpp"
 #include "common/BasicExceptions.hpp"
 #include "common/StringConversion.hpp"
@@ -31,6 +37,7 @@ VectorialFunction::VectorialFunction()
     m_nbvars(0),
     m_functions(0),
     m_parsers(),
+    m_programs(),
     m_result()
 {
 }
@@ -41,6 +48,7 @@ VectorialFunction::VectorialFunction( const std::string& funcs, const std::strin
     m_nbvars(0),
     m_functions(0),
     m_parsers(),
+    m_programs(),
     m_result()
 {
   functions( funcs );
@@ -66,6 +74,7 @@ void VectorialFunction::clear()
       delete_ptr(m_parsers[i]);
   }
   vector<FunctionParser*>().swap(m_parsers);
+  m_programs.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -173,6 +182,11 @@ void VectorialFunction::parse()
     }
   }
 
+  // compile the parsed functions for evaluate_batch()
+  m_programs.resize(m_parsers.size());
+  for(Uint i = 0; i < m_parsers.size(); ++i)
+    m_programs[i].compile(*m_parsers[i],m_nbvars);
+
   m_result.resize(m_functions.size());
   m_is_parsed = true;
 }
@@ -209,6 +223,85 @@ void VectorialFunction::evaluate( const RealVector& var_values, RealVector& ret_
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void VectorialFunction::evaluate_batch( const Uint nb_points,
+                                        const Real* var_values, const Uint vars_stride,
+                                        Real* ret_values, const Uint ret_stride,
+                                        const Uint nb_threads ) const
+{
+  cf3_assert(m_is_parsed);
+  cf3_assert(vars_stride >= m_nbvars);
+  cf3_assert(ret_stride >= m_parsers.size());
+
+  const Uint nb_funcs = m_parsers.size();
+  const Uint block_size = FunctionProgram::block_size;
+  const Uint nb_blocks = (nb_points + block_size - 1) / block_size;
+
+  Uint nb_chunks = 1;
+#ifdef CF3_HAVE_OPENMP
+  nb_chunks = std::max(1u, std::min(nb_threads, nb_blocks));
+#endif
+
+  // Eval() of the parser is not thread-safe, and copies share their data:
+  // every thread evaluates the functions that were not compiled with a deep copy, made here
+  std::vector<FunctionParser> parser_copies(nb_chunks > 1 ? nb_chunks*nb_funcs : 0);
+  for(Uint chunk = 1; chunk < nb_chunks; ++chunk)
+  {
+    for(Uint f = 0; f < nb_funcs; ++f)
+    {
+      if( !m_programs[f].is_compiled() )
+      {
+        parser_copies[chunk*nb_funcs+f] = *m_parsers[f];
+        parser_copies[chunk*nb_funcs+f].ForceDeepCopy();
+      }
+    }
+  }
+
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel num_threads(nb_chunks)
+#endif
+  {
+    Uint chunk = 0;
+    Uint nb_active_chunks = 1;
+#ifdef CF3_HAVE_OPENMP
+    chunk = omp_get_thread_num();
+    nb_active_chunks = omp_get_num_threads();
+#endif
+    const Uint begin_block = (nb_blocks * chunk) / nb_active_chunks;
+    const Uint end_block = (nb_blocks * (chunk+1)) / nb_active_chunks;
+
+    std::vector< std::vector<Real> > registers(nb_funcs);
+    for(Uint f = 0; f < nb_funcs; ++f)
+    {
+      if( m_programs[f].is_compiled() )
+        m_programs[f].setup_registers(registers[f]);
+    }
+
+    for(Uint block = begin_block; block < end_block; ++block)
+    {
+      const Uint begin = block*block_size;
+      const Uint nb_block_points = std::min(block_size, nb_points-begin);
+      const Real* vars = var_values + begin*vars_stride;
+      Real* ret = ret_values + begin*ret_stride;
+
+      for(Uint f = 0; f < nb_funcs; ++f)
+      {
+        if( m_programs[f].is_compiled() )
+        {
+          m_programs[f].evaluate(nb_block_points, vars, vars_stride, ret+f, ret_stride, registers[f]);
+        }
+        else
+        {
+          FunctionParser& parser = chunk == 0 ? *m_parsers[f] : parser_copies[chunk*nb_funcs+f];
+          for(Uint pt = 0; pt < nb_block_points; ++pt)
+            ret[pt*ret_stride+f] = parser.Eval(vars + pt*vars_stride);
+        }
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 RealVector& VectorialFunction::operator()( const VariablesT& var_values)
 {
   cf3_assert(m_is_parsed);
@@ -13,6 +13,7 @@
 
 #include "math/LibMath.hpp"
 #include "math/MatrixTypes.hpp"
+#include "math/FunctionProgram.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -57,6 +58,21 @@ public: // functions
   template <typename var_t, typename ret_t>
   void evaluate( const var_t& var_values, ret_t& ret_value) const;
 
+  /// Evaluate the Vectorial Function in many points at once.
+  /// The functions are evaluated for blocks of points by programs compiled once by parse(),
+  /// and the blocks are shared over the threads if OpenMP is available.
+  /// Functions that can't be compiled are evaluated point by point by the parser.
+  /// @param nb_points   number of points
+  /// @param var_values  values of the variables: var_values[point*vars_stride + var]
+  /// @param vars_stride number of values stored per point in var_values, at least nbvars()
+  /// @param ret_values  placeholder for the result: ret_values[point*ret_stride + function]
+  /// @param ret_stride  number of values stored per point in ret_values, at least nbfuncs()
+  /// @param nb_threads  number of threads
+  void evaluate_batch (const Uint nb_points,
+                       const Real* var_values, const Uint vars_stride,
+                       Real* ret_values, const Uint ret_stride,
+                       const Uint nb_threads = 1) const;
+
   /// Evaluate the Vectorial Function given the values of the variables
   /// and return it in the stored result. This function allows this class to work
   /// as a functor.
@@ -120,6 +136,9 @@ private: // data
   /// vector holding the parsers, one for each entry in the vector
   std::vector<FunctionParser*> m_parsers;
 
+  /// programs compiled from the parsers, for evaluate_batch()
+  std::vector<FunctionProgram> m_programs;
+
   /// storage of the result for using the class as functor
   RealVector m_result;
 
@@ -19,7 +19,7 @@
 #include "common/EventHandler.hpp"
 #include "common/StringConversion.hpp"
 #include "common/Tags.hpp"
-#include "common/DynTable.hpp"
+#include "common/CompressedTable.hpp"
 #include "common/List.hpp"
 
 #include "common/XML/SignalOptions.hpp"
@@ -67,7 +67,7 @@ Dictionary::Dictionary ( const std::string& name  ) :
   m_glb_to_loc = create_static_component< common::Map<boost::uint64_t,Uint> >(mesh::Tags::map_global_to_local());
   m_glb_to_loc->add_tag(mesh::Tags::map_global_to_local());
 
-  m_connectivity = create_static_component< common::DynTable<SpaceElem> >("element_connectivity");
+  m_connectivity = create_static_component< common::CompressedTable<SpaceElem> >("element_connectivity");
 
   // Event handlers
   //  Core::instance().event_handler().connect_to_event("mesh_loaded", this, &Dictionary::on_mesh_changed_event);
@@ -469,11 +469,11 @@ Field& Dictionary::create_coordinates()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-DynTable<Uint>& Dictionary::glb_elem_connectivity()
+CompressedTable<Uint>& Dictionary::glb_elem_connectivity()
 {
   if (is_null(m_glb_elem_connectivity))
   {
-    m_glb_elem_connectivity = create_static_component< DynTable<Uint> >("glb_elem_connectivity");
+    m_glb_elem_connectivity = create_static_component< CompressedTable<Uint> >("glb_elem_connectivity");
     m_glb_elem_connectivity->add_tag("glb_elem_connectivity");
     m_glb_elem_connectivity->resize(size());
   }
@@ -0,0 +1,440 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+#include <boost/tuple/tuple.hpp>
+
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/OptionComponent.hpp"
+
+#include "math/Consts.hpp"
+
+#include "mesh/ElementTree.hpp"
+#include "mesh/UnifiedData.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Field.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+  using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+cf3::common::ComponentBuilder < ElementTree, Component, LibMesh > ElementTree_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+/// Orders unified element indices by the coordinate of their centroid in one direction
+struct CentroidLess
+{
+  CentroidLess(const std::vector<Real>& centroids, const Uint dir) : m_centroids(centroids), m_dir(dir) {}
+
+  bool operator()(const Uint a, const Uint b) const
+  {
+    return m_centroids[3*a+m_dir] < m_centroids[3*b+m_dir];
+  }
+
+  const std::vector<Real>& m_centroids;
+  const Uint m_dir;
+};
+
+} // detail
+
+//////////////////////////////////////////////////////////////////////////////
+
+ElementTree::ElementTree( const std::string& name )
+  : Component(name), m_dim(0), m_tolerance(0.)
+{
+  options().add_option("mesh", m_mesh)
+      .description("Mesh to create the tree from")
+      .pretty_name("Mesh")
+      .mark_basic()
+      .link_to(&m_mesh);
+
+  options().add_option( "max_elems_per_leaf", 8u )
+      .description("The maximum number of elements in a leaf of the tree")
+      .pretty_name("Maximum Number of Elements per Leaf");
+
+  m_elements = create_component<UnifiedData>("elements");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementTree::build()
+{
+  if (is_null(m_mesh))
+    throw SetupError(FromHere(), "Option \"mesh\" has not been configured");
+
+  m_elements->reset();
+  m_components.clear();
+  m_nodes.clear();
+
+  boost_foreach (Elements& elements, find_components_recursively_with_filter<Elements>(*m_mesh,IsElementsVolume()))
+  {
+    m_elements->add(elements);
+    m_components.push_back(elements.handle<Elements>());
+  }
+
+  m_dim = m_mesh->geometry_fields().coordinates().row_size();
+
+  const Uint nb_elems = m_elements->size();
+  m_order.resize(nb_elems);
+  m_elem_min.assign(3*nb_elems,0.);
+  m_elem_max.assign(3*nb_elems,0.);
+  m_centroids.assign(3*nb_elems,0.);
+
+  Real extent = 0.;
+  Uint unif_elem_idx=0;
+  RealVector centroid(m_dim);
+  boost_foreach (const Handle<Elements>& elements, m_components)
+  {
+    RealMatrix coordinates;
+    elements->geometry_space().allocate_coordinates(coordinates);
+
+    for (Uint elem_idx=0; elem_idx<elements->size(); ++elem_idx, ++unif_elem_idx)
+    {
+      elements->geometry_space().put_coordinates(coordinates,elem_idx);
+      elements->element_type().compute_centroid(coordinates,centroid);
+      for (Uint d=0; d<m_dim; ++d)
+      {
+        m_elem_min[3*unif_elem_idx+d] = coordinates.col(d).minCoeff();
+        m_elem_max[3*unif_elem_idx+d] = coordinates.col(d).maxCoeff();
+        m_centroids[3*unif_elem_idx+d] = centroid[d];
+        extent = std::max(extent, m_elem_max[3*unif_elem_idx+d]-m_elem_min[3*unif_elem_idx+d]);
+      }
+      m_order[unif_elem_idx] = unif_elem_idx;
+    }
+  }
+
+  // Relative to the element sizes, as the coordinates may be scaled arbitrarily
+  m_tolerance = 100*math::Consts::eps()*std::max(1.,extent);
+
+  if (nb_elems == 0)
+    return;
+
+  m_nodes.reserve(2*nb_elems/std::max(1u,options().option("max_elems_per_leaf").value<Uint>())+1);
+  m_nodes.resize(1);
+  m_nodes[0].begin = 0;
+  m_nodes[0].end = nb_elems;
+  split_node(0);
+
+  CFdebug << "ElementTree: " << m_nodes.size() << " nodes for " << nb_elems << " elements" << CFendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementTree::split_node(const Uint node_idx)
+{
+  // m_nodes grows during the recursion, so nodes are accessed by index
+  compute_node_box(m_nodes[node_idx]);
+  m_nodes[node_idx].children = 0;
+
+  const Uint begin = m_nodes[node_idx].begin;
+  const Uint end   = m_nodes[node_idx].end;
+  if (end-begin <= std::max(1u,options().option("max_elems_per_leaf").value<Uint>()))
+    return;
+
+  // Split along the longest side of the bounding box of the centroids
+  Real cmin[3] = {0.,0.,0.};
+  Real cmax[3] = {0.,0.,0.};
+  for (Uint d=0; d<m_dim; ++d)
+  {
+    cmin[d] = m_centroids[3*m_order[begin]+d];
+    cmax[d] = cmin[d];
+  }
+  for (Uint i=begin+1; i<end; ++i)
+  {
+    for (Uint d=0; d<m_dim; ++d)
+    {
+      cmin[d] = std::min(cmin[d], m_centroids[3*m_order[i]+d]);
+      cmax[d] = std::max(cmax[d], m_centroids[3*m_order[i]+d]);
+    }
+  }
+  Uint dir=0;
+  for (Uint d=1; d<m_dim; ++d)
+  {
+    if (cmax[d]-cmin[d] > cmax[dir]-cmin[dir])
+      dir = d;
+  }
+
+  const Uint mid = begin + (end-begin)/2;
+  std::nth_element(m_order.begin()+begin, m_order.begin()+mid, m_order.begin()+end, detail::CentroidLess(m_centroids,dir));
+
+  const Uint children = m_nodes.size();
+  m_nodes.resize(children+2);
+  m_nodes[node_idx].children = children;
+  m_nodes[children].begin = begin;
+  m_nodes[children].end = mid;
+  m_nodes[children+1].begin = mid;
+  m_nodes[children+1].end = end;
+
+  split_node(children);
+  split_node(children+1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementTree::compute_node_box(Node& node) const
+{
+  for (Uint d=0; d<3; ++d)
+  {
+    node.min[d] = m_elem_min[3*m_order[node.begin]+d];
+    node.max[d] = m_elem_max[3*m_order[node.begin]+d];
+  }
+  for (Uint i=node.begin+1; i<node.end; ++i)
+  {
+    for (Uint d=0; d<m_dim; ++d)
+    {
+      node.min[d] = std::min(node.min[d], m_elem_min[3*m_order[i]+d]);
+      node.max[d] = std::max(node.max[d], m_elem_max[3*m_order[i]+d]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ElementTree::in_box(const Real* coord, const Real* min, const Real* max) const
+{
+  for (Uint d=0; d<m_dim; ++d)
+  {
+    if (coord[d] < min[d]-m_tolerance || coord[d] > max[d]+m_tolerance)
+      return false;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ElementTree::bounding_box(RealVector& min, RealVector& max) const
+{
+  min.resize(m_dim);
+  max.resize(m_dim);
+  if (m_nodes.empty())
+    return false;
+
+  // the root node holds the box of all elements
+  for (Uint d=0; d<m_dim; ++d)
+  {
+    min[d] = m_nodes[0].min[d] - m_tolerance;
+    max[d] = m_nodes[0].max[d] + m_tolerance;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Real ElementTree::distance_to_box(const Real* coord, const Node& node) const
+{
+  Real dist2 = 0.;
+  for (Uint d=0; d<m_dim; ++d)
+  {
+    const Real delta = std::max(0., std::max(node.min[d]-coord[d], coord[d]-node.max[d]));
+    dist2 += delta*delta;
+  }
+  return dist2;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ElementTree::is_coord_in_element(const RealVector& coord, const Uint unified_elem_idx, std::vector<RealMatrix>& nodes) const
+{
+  if (!in_box(coord.data(), &m_elem_min[3*unified_elem_idx], &m_elem_max[3*unified_elem_idx]))
+    return false;
+
+  Uint comp_idx, elem_idx;
+  boost::tie(comp_idx,elem_idx) = m_elements->location_idx(unified_elem_idx);
+  const Elements& elements = *m_components[comp_idx];
+  if (nodes[comp_idx].size() == 0)
+    elements.geometry_space().allocate_coordinates(nodes[comp_idx]);
+  elements.geometry_space().put_coordinates(nodes[comp_idx],elem_idx);
+  return elements.element_type().is_coord_in_element(coord,nodes[comp_idx]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint ElementTree::search(const RealVector& coord, std::vector<RealMatrix>& nodes, std::vector<Uint>& stack) const
+{
+  cf3_assert(coord.size() == static_cast<int>(m_dim));
+
+  stack.resize(0);
+  stack.push_back(0);
+  while (!stack.empty())
+  {
+    const Node& node = m_nodes[stack.back()];
+    stack.pop_back();
+    if (!in_box(coord.data(),node.min,node.max))
+      continue;
+    if (node.children)
+    {
+      stack.push_back(node.children+1);
+      stack.push_back(node.children);
+    }
+    else
+    {
+      for (Uint i=node.begin; i<node.end; ++i)
+      {
+        if (is_coord_in_element(coord,m_order[i],nodes))
+          return m_order[i];
+      }
+    }
+  }
+  return math::Consts::uint_max();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint ElementTree::find_element(const RealVector& coord) const
+{
+  if (m_nodes.empty())
+    return math::Consts::uint_max();
+
+  std::vector<RealMatrix> nodes(m_components.size());
+  std::vector<Uint> stack;
+  return search(coord,nodes,stack);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ElementTree::find_element(const RealVector& coord, Handle< Elements >& element_component, Uint& element_idx) const
+{
+  const Uint unified_elem_idx = find_element(coord);
+  if (unified_elem_idx == math::Consts::uint_max())
+  {
+    element_component.reset();
+    CFdebug << "coord " << coord.transpose() << " has not been found in any element of the tree" << CFendl;
+    return false;
+  }
+
+  location(unified_elem_idx,element_component,element_idx);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementTree::location(const Uint unified_elem_idx, Handle< Elements >& element_component, Uint& element_idx) const
+{
+  Uint comp_idx;
+  boost::tie(comp_idx,element_idx) = m_elements->location_idx(unified_elem_idx);
+  element_component = m_components[comp_idx];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementTree::find_elements(const boost::multi_array<Real,2>& coordinates, std::vector<Uint>& unified_elems) const
+{
+  const Uint nb_coords = coordinates.size();
+  unified_elems.assign(nb_coords,math::Consts::uint_max());
+  if (m_nodes.empty())
+    return;
+
+  std::vector<RealMatrix> nodes(m_components.size());
+  std::vector<Uint> stack;
+  const Uint coord_dim = std::min(m_dim, Uint(coordinates.shape()[1]));
+  RealVector coord(m_dim); coord.setZero();
+  Uint previous = math::Consts::uint_max();
+  for (Uint i=0; i<nb_coords; ++i)
+  {
+    for (Uint d=0; d<coord_dim; ++d)
+      coord[d] = coordinates[i][d];
+
+    if (previous != math::Consts::uint_max() && is_coord_in_element(coord,previous,nodes))
+    {
+      unified_elems[i] = previous;
+      continue;
+    }
+
+    unified_elems[i] = search(coord,nodes,stack);
+    if (unified_elems[i] != math::Consts::uint_max())
+      previous = unified_elems[i];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementTree::find_nearest_elements(const RealVector& coord, const Uint nb_elems, std::vector<Uint>& unified_elems) const
+{
+  cf3_assert(coord.size() == static_cast<int>(m_dim));
+
+  unified_elems.resize(0);
+  const Uint nb_nearest = std::min(nb_elems, Uint(m_order.size()));
+  if (nb_nearest == 0)
+    return;
+
+  typedef std::pair<Real,Uint> Entry;
+
+  // Nodes to visit, nearest first
+  std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > to_visit;
+  // Nearest elements found so far, farthest on top
+  std::priority_queue< Entry > nearest;
+
+  to_visit.push(Entry(distance_to_box(coord.data(),m_nodes[0]),0));
+  while (!to_visit.empty())
+  {
+    const Entry entry = to_visit.top();
+    to_visit.pop();
+
+    // The bounding box of a node contains the centroids of its elements
+    if (nearest.size() == nb_nearest && entry.first > nearest.top().first)
+      break;
+
+    const Node& node = m_nodes[entry.second];
+    if (node.children)
+    {
+      to_visit.push(Entry(distance_to_box(coord.data(),m_nodes[node.children]),node.children));
+      to_visit.push(Entry(distance_to_box(coord.data(),m_nodes[node.children+1]),node.children+1));
+    }
+    else
+    {
+      for (Uint i=node.begin; i<node.end; ++i)
+      {
+        Real dist2 = 0.;
+        for (Uint d=0; d<m_dim; ++d)
+        {
+          const Real delta = m_centroids[3*m_order[i]+d]-coord[d];
+          dist2 += delta*delta;
+        }
+        const Entry candidate(dist2,m_order[i]);
+        if (nearest.size() < nb_nearest)
+          nearest.push(candidate);
+        else if (candidate < nearest.top())
+        {
+          nearest.pop();
+          nearest.push(candidate);
+        }
+      }
+    }
+  }
+
+  unified_elems.resize(nearest.size());
+  for (Uint i=unified_elems.size(); i>0; --i)
+  {
+    unified_elems[i-1] = nearest.top().second;
+    nearest.pop();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
@@ -0,0 +1,165 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_ElementTree_hpp
+#define cf3_mesh_ElementTree_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/multi_array.hpp>
+
+#include "common/Component.hpp"
+#include "mesh/Elements.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+  class Mesh;
+  class UnifiedData;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Bounding volume hierarchy over the volume elements of a mesh
+///
+/// Every node of the tree holds the axis aligned bounding box of a range of elements.
+/// Ranges are split in two at the median of the element centroids, along the longest
+/// side of their bounding box, until at most "max_elems_per_leaf" elements are left.
+/// The tree adapts to the mesh, so that locating a coordinate costs O(log N) tests of
+/// bounding boxes, also for strongly stretched or locally refined meshes, for which
+/// a uniform grid of cells (Octtree) holds either many elements per cell, or misses
+/// elements that are larger than a cell.
+///
+/// Elements are numbered as in the UnifiedData "elements", which gathers the volume
+/// elements in the order of find_components_recursively.
+class Mesh_API ElementTree : public common::Component
+{
+public: // functions
+
+  /// constructor
+  ElementTree( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "ElementTree"; }
+
+  /// Build the tree over the volume elements of the configured mesh
+  void build();
+
+  /// @return true if the tree has been built
+  bool is_built() const { return !m_nodes.empty(); }
+
+  /// Find the element in which a coordinate resides
+  /// @param [in]  coord              the coordinate
+  /// @param [out] element_component  the elements holding the element, reset if not found
+  /// @param [out] element_idx        the index of the element in element_component
+  /// @return true if the element was found
+  bool find_element(const RealVector& coord, Handle< Elements >& element_component, Uint& element_idx) const;
+
+  /// Find the element in which a coordinate resides
+  /// @return the unified index of the element, or math::Consts::uint_max() if not found
+  Uint find_element(const RealVector& coord) const;
+
+  /// Find the elements in which many coordinates reside.
+  /// The element of the previous coordinate is tested first, which avoids most
+  /// traversals of the tree when subsequent coordinates are close to each other.
+  /// @param [in]  coordinates    the coordinates, one per row. Missing dimensions are taken as 0.
+  /// @param [out] unified_elems  unified index of the element of every coordinate,
+  ///                             or math::Consts::uint_max() if not found
+  void find_elements(const boost::multi_array<Real,2>& coordinates, std::vector<Uint>& unified_elems) const;
+
+  /// Find the elements with the centroids nearest to a coordinate
+  /// @param [in]  coord          the coordinate
+  /// @param [in]  nb_elems       the number of elements to find, limited to the number of elements in the tree
+  /// @param [out] unified_elems  unified indices of the elements, sorted by increasing distance
+  void find_nearest_elements(const RealVector& coord, const Uint nb_elems, std::vector<Uint>& unified_elems) const;
+
+  /// Location of an element given its unified index
+  /// @param [in]  unified_elem_idx   the unified index of the element
+  /// @param [out] element_component  the elements holding the element
+  /// @param [out] element_idx        the index of the element in element_component
+  void location(const Uint unified_elem_idx, Handle< Elements >& element_component, Uint& element_idx) const;
+
+  /// @return the volume elements, in the numbering of the tree
+  const UnifiedData& elements() const { return *m_elements; }
+
+  /// @return the number of elements in the tree
+  Uint nb_elems() const { return m_order.size(); }
+
+  /// Bounding box of all elements, enlarged with the margin used to locate coordinates
+  /// @param [out] min  minimum coordinates, resized to the dimension of the mesh
+  /// @param [out] max  maximum coordinates, resized to the dimension of the mesh
+  /// @return false if the tree holds no elements
+  bool bounding_box(RealVector& min, RealVector& max) const;
+
+private: // types
+
+  /// Node of the tree, holding the elements m_order[begin,end)
+  struct Node
+  {
+    Real min[3];
+    Real max[3];
+    Uint begin;
+    Uint end;
+    /// index of the first of both children, or 0 for a leaf
+    Uint children;
+  };
+
+private: // functions
+
+  /// Split the elements of a node in two children, recursively
+  void split_node(const Uint node);
+
+  /// Compute the bounding box of the elements of a node
+  void compute_node_box(Node& node) const;
+
+  /// @return true if the coordinate is in the bounding box of a node
+  bool in_box(const Real* coord, const Real* min, const Real* max) const;
+
+  /// Squared distance from a coordinate to the bounding box of a node
+  Real distance_to_box(const Real* coord, const Node& node) const;
+
+  /// Test if a coordinate is inside an element
+  /// @param [in,out] nodes  element node coordinates for every component, allocated on first use
+  bool is_coord_in_element(const RealVector& coord, const Uint unified_elem_idx, std::vector<RealMatrix>& nodes) const;
+
+  /// Search the tree for the element of a coordinate
+  Uint search(const RealVector& coord, std::vector<RealMatrix>& nodes, std::vector<Uint>& stack) const;
+
+private: // data
+
+  Handle<Mesh> m_mesh;
+
+  Handle<UnifiedData> m_elements;
+
+  /// Volume elements, by component index of m_elements
+  std::vector< Handle<Elements> > m_components;
+
+  Uint m_dim;
+
+  /// Margin added to the bounding boxes, to find coordinates on element faces
+  Real m_tolerance;
+
+  std::vector<Node> m_nodes;
+
+  /// Unified element indices, sorted such that every node holds a contiguous range
+  std::vector<Uint> m_order;
+
+  /// Bounding box (min, max) and centroid of every element, 3 values each
+  std::vector<Real> m_elem_min;
+  std::vector<Real> m_elem_max;
+  std::vector<Real> m_centroids;
+
+}; // end ElementTree
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_ElementTree_hpp
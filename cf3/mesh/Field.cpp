@@ -4,6 +4,9 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <cmath>
+
 #include <boost/assign/list_of.hpp>
 #include <boost/assign/std/vector.hpp>
 #include <boost/regex.hpp>
@@ -41,9 +44,17 @@ common::ComponentBuilder < Field, Component, LibMesh >  Field_Builder;
 ////////////////////////////////////////////////////////////////////////////////////////////
 
 Field::Field ( const std::string& name  ) :
-  common::Table<Real> ( name )
+  common::Table<Real> ( name ),
+  m_padded_row_size(0),
+  m_is_unpacked(false),
+  m_unpack_after_synchronize(false)
 {
   mark_basic();
+
+  options().add_option("padded", false)
+      .pretty_name("Padded")
+      .description("Let unpack() copy the values to 64-byte aligned storage, with rows padded to a multiple of 64 bytes, "
+                   "for the whole-field operations. pack() copies them back into the table.");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -137,6 +148,8 @@ Dictionary& Field::dict() const
 
 void Field::resize(const Uint size)
 {
+  // The padded storage is not resized, the values go back to the table first
+  pack();
   set_row_size(descriptor().size());
   common::Table<Real>::resize(size);
 }
@@ -182,7 +195,39 @@ CommPattern& Field::parallelize()
 void Field::synchronize()
 {
   if ( is_not_null(m_comm_pattern) )
+  {
+    // The comm pattern works on the table
+    const bool was_unpacked = m_is_unpacked;
+    pack();
     m_comm_pattern->synchronize( name() );
+    if (was_unpacked)
+      unpack();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Field::synchronize_start()
+{
+  if ( is_not_null(m_comm_pattern) )
+  {
+    m_unpack_after_synchronize = m_is_unpacked;
+    pack();
+    m_comm_pattern->synchronize_start( name() );
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Field::synchronize_finish()
+{
+  if ( is_not_null(m_comm_pattern) )
+  {
+    m_comm_pattern->synchronize_finish( name() );
+    if (m_unpack_after_synchronize)
+      unpack();
+    m_unpack_after_synchronize = false;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -206,5 +251,283 @@ void Field::create_descriptor(const std::string& description, const Uint dimensi
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+Field& Field::operator =(const Real& c)
+{
+  Real* u = values();
+  const Uint n = size();
+  const Uint m = row_size();
+  const Uint s = stride();
+  // the padding of unpacked rows is left at zero
+  for (Uint i=0; i<n; ++i)
+    for (Uint j=0; j<m; ++j)
+      u[i*s+j] = c;
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Field& Field::operator +=(const Real& c)
+{
+  Real* u = values();
+  const Uint n = size();
+  const Uint m = row_size();
+  const Uint s = stride();
+  for (Uint i=0; i<n; ++i)
+    for (Uint j=0; j<m; ++j)
+      u[i*s+j] += c;
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Field& Field::operator /=(const Real& c)
+{
+  Real* u = values();
+  const Uint n = size();
+  const Uint m = row_size();
+  const Uint s = stride();
+  for (Uint i=0; i<n; ++i)
+    for (Uint j=0; j<m; ++j)
+      u[i*s+j] /= c;
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Field& Field::operator *=(const Field& U)
+{
+  cf3_assert(size() == U.size());
+  const Uint n = size();
+  const Uint m = row_size();
+  const Uint s = stride();
+  const Uint us = U.stride();
+  Real* u = values();
+  const Real* v = U.values();
+  if (U.row_size() == 1) // U is a scalar field
+  {
+    for (Uint i=0; i<n; ++i)
+      for (Uint j=0; j<s; ++j)
+        u[i*s+j] *= v[i*us];
+  }
+  else if (s == us)
+  {
+    cf3_assert(m == U.row_size()); // field must be same size
+    for (Uint i=0; i<n*s; ++i)
+      u[i] *= v[i];
+  }
+  else
+  {
+    cf3_assert(m == U.row_size()); // field must be same size
+    for (Uint i=0; i<n; ++i)
+      for (Uint j=0; j<m; ++j)
+        u[i*s+j] *= v[i*us+j];
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Field& Field::operator /=(const Field& U)
+{
+  cf3_assert(size() == U.size());
+  const Uint n = size();
+  const Uint m = row_size();
+  const Uint s = stride();
+  const Uint us = U.stride();
+  Real* u = values();
+  const Real* v = U.values();
+  // The padding of U is zero, so only the values themselves are divided
+  if (U.row_size() == 1) // U is a scalar field
+  {
+    for (Uint i=0; i<n; ++i)
+      for (Uint j=0; j<m; ++j)
+        u[i*s+j] /= v[i*us];
+  }
+  else
+  {
+    cf3_assert(m == U.row_size()); // field must be same size
+    for (Uint i=0; i<n; ++i)
+      for (Uint j=0; j<m; ++j)
+        u[i*s+j] /= v[i*us+j];
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Field& Field::copy(const Field& X)
+{
+  cf3_assert(size() == X.size());
+  cf3_assert(row_size() == X.row_size());
+  if (&X == this)
+    return *this;
+  const Uint n = size();
+  const Uint m = row_size();
+  const Uint s = stride();
+  const Uint xs = X.stride();
+  Real* u = values();
+  const Real* x = X.values();
+  if (s == xs)
+  {
+    std::copy(x, x+n*s, u);
+  }
+  else
+  {
+    for (Uint i=0; i<n; ++i)
+      std::copy(x+i*xs, x+i*xs+m, u+i*s);
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Field& Field::scale(const Real a)
+{
+  Real* u = values();
+  const Uint n = size()*stride();
+  for (Uint i=0; i<n; ++i)
+    u[i] *= a;
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Field& Field::axpy(const Real a, const Field& X)
+{
+  cf3_assert(size() == X.size());
+  cf3_assert(row_size() == X.row_size());
+  const Uint n = size();
+  const Uint m = row_size();
+  const Uint s = stride();
+  const Uint xs = X.stride();
+  Real* u = values();
+  const Real* x = X.values();
+  if (s == xs)
+  {
+    for (Uint i=0; i<n*s; ++i)
+      u[i] += a*x[i];
+  }
+  else
+  {
+    for (Uint i=0; i<n; ++i)
+      for (Uint j=0; j<m; ++j)
+        u[i*s+j] += a*x[i*xs+j];
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Field& Field::axpby(const Real a, const Field& X, const Real b)
+{
+  cf3_assert(size() == X.size());
+  cf3_assert(row_size() == X.row_size());
+  const Uint n = size();
+  const Uint m = row_size();
+  const Uint s = stride();
+  const Uint xs = X.stride();
+  Real* u = values();
+  const Real* x = X.values();
+  if (s == xs)
+  {
+    for (Uint i=0; i<n*s; ++i)
+      u[i] = a*x[i] + b*u[i];
+  }
+  else
+  {
+    for (Uint i=0; i<n; ++i)
+      for (Uint j=0; j<m; ++j)
+        u[i*s+j] = a*x[i*xs+j] + b*u[i*s+j];
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Field& Field::axpy(const Real a, const Field& D, const Field& X)
+{
+  cf3_assert(size() == X.size());
+  cf3_assert(row_size() == X.row_size());
+  cf3_assert(size() == D.size());
+  cf3_assert(D.row_size() == 1);
+  const Uint n = size();
+  const Uint s = stride();
+  const Uint xs = X.stride();
+  const Uint ds = D.stride();
+  // With the same stride the padding is included, so the inner loop has a fixed length of whole vector registers
+  const Uint m = s == xs ? s : row_size();
+  Real* u = values();
+  const Real* d = D.values();
+  const Real* x = X.values();
+  for (Uint i=0; i<n; ++i)
+  {
+    const Real ad = a*d[i*ds];
+    for (Uint j=0; j<m; ++j)
+      u[i*s+j] += ad*x[i*xs+j];
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Real Field::norm() const
+{
+  // Independent partial sums, so the additions don't form a single dependency chain.
+  // The padding of unpacked rows is zero, and doesn't contribute.
+  const Real* u = values();
+  const Uint n = size()*stride();
+  Real sum[4] = {0., 0., 0., 0.};
+  Uint i=0;
+  for ( ; i+4<=n; i+=4)
+  {
+    sum[0] += u[i  ]*u[i  ];
+    sum[1] += u[i+1]*u[i+1];
+    sum[2] += u[i+2]*u[i+2];
+    sum[3] += u[i+3]*u[i+3];
+  }
+  for ( ; i<n; ++i)
+    sum[0] += u[i]*u[i];
+  return std::sqrt((sum[0]+sum[1]) + (sum[2]+sum[3]));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Field::unpack()
+{
+  if (m_is_unpacked || !options().option("padded").value<bool>())
+    return;
+
+  // Round the rows up to whole cache lines
+  const Uint reals_per_line = 64 / sizeof(Real);
+  const Uint n = size();
+  const Uint m = row_size();
+  m_padded_row_size = ((m + reals_per_line-1) / reals_per_line) * reals_per_line;
+
+  m_padded_values.assign(n*m_padded_row_size, 0.);
+  const Real* table = array().data();
+  Real* padded = padded_data();
+  for (Uint i=0; i<n; ++i)
+    std::copy(table+i*m, table+(i+1)*m, padded+i*m_padded_row_size);
+  m_is_unpacked = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Field::pack()
+{
+  if (!m_is_unpacked)
+    return;
+
+  const Uint n = size();
+  const Uint m = row_size();
+  const Real* padded = padded_data();
+  Real* table = array().data();
+  for (Uint i=0; i<n; ++i)
+    std::copy(padded+i*m_padded_row_size, padded+i*m_padded_row_size+m, table+i*m);
+  m_is_unpacked = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
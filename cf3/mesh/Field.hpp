@@ -8,6 +8,7 @@
 #define cf3_mesh_Field_hpp
 
 #include "common/Table.hpp"
+#include "common/AlignedAllocator.hpp"
 
 #include "mesh/Dictionary.hpp"
 #include "mesh/Entities.hpp"
@@ -32,6 +33,12 @@ namespace mesh {
 /// Field component class
 /// This class stores fields which can be applied
 /// to fields (Field)
+///
+/// With the option "padded", unpack() copies the values to 64-byte aligned storage whose rows are
+/// padded to a multiple of 64 bytes, and the whole-field operations work on that storage until pack()
+/// copies the values back into the table. In between, the values must not be accessed through the table:
+/// call pack() before passing the field to a CommPattern or a linear system. synchronize() packs and
+/// unpacks the field itself. Without the option, pack() and unpack() do nothing.
 /// @author Willem Deconinck, Tiago Quintino
 class Mesh_API Field : public common::Table<Real> {
 
@@ -116,8 +123,18 @@ public: // functions
 
   common::PE::CommPattern& parallelize();
 
+  /// The comm pattern this field is synchronized with, null if the field is not parallelized
+  const Handle< common::PE::CommPattern >& comm_pattern() const { return m_comm_pattern; }
+
   void synchronize();
 
+  /// Start a non-blocking synchronization of the ghost values. The field must not be modified until synchronize_finish is called,
+  /// but work that only reads the field (e.g. on interior nodes) can be done in the meantime
+  void synchronize_start();
+
+  /// Wait for the synchronization started with synchronize_start to complete
+  void synchronize_finish();
+
   math::VariablesDescriptor& descriptor() const { return *m_descriptor; }
 
   void set_descriptor(math::VariablesDescriptor& descriptor);
@@ -161,117 +178,94 @@ public: // functions
     /// U = U
     Field& operator =(const Field& U)
     {
-      cf3_assert(size() == U.size());
-      array() = U.array();
-      return *this;
+      return copy(U);
     }
 
     /// U = c
-    Field& operator =(const Real& c)
-    {
-      for (Uint i=0; i<size(); ++i)
-        for (Uint j=0; j<row_size(); ++j)
-          array()[i][j] = c;
-      return *this;
-    }
+    Field& operator =(const Real& c);
 
     /// U += c
-    Field& operator +=(const Real& c)
-    {
-      for (Uint i=0; i<size(); ++i)
-        for (Uint j=0; j<row_size(); ++j)
-          array()[i][j] += c;
-      return *this;
-    }
+    Field& operator +=(const Real& c);
 
     /// U += U
     Field& operator +=(const Field& U)
     {
-      cf3_assert(size() == U.size());
-      cf3_assert(row_size() == U.row_size());
-      for (Uint i=0; i<size(); ++i)
-        for (Uint j=0; j<row_size(); ++j)
-          array()[i][j] += U.array()[i][j];
-      return *this;
+      return axpy(1.,U);
     }
 
     /// U -= c
     Field& operator -=(const Real& c)
     {
-      for (Uint i=0; i<size(); ++i)
-        for (Uint j=0; j<row_size(); ++j)
-          array()[i][j] -= c;
-      return *this;
+      return operator+=(-c);
     }
 
     /// U -= U
     Field& operator -=(const Field& U)
     {
-      cf3_assert(size() == U.size());
-      cf3_assert(row_size() == U.row_size());
-      for (Uint i=0; i<size(); ++i)
-        for (Uint j=0; j<row_size(); ++j)
-          array()[i][j] -= U.array()[i][j];
-      return *this;
+      return axpy(-1.,U);
     }
 
     /// U *= c
     Field& operator *=(const Real& c)
     {
-      for (Uint i=0; i<size(); ++i)
-        for (Uint j=0; j<row_size(); ++j)
-          array()[i][j] *= c;
-      return *this;
+      return scale(c);
     }
 
     /// U *= U
-    Field& operator *=(const Field& U)
-    {
-      cf3_assert(size() == U.size());
-      if (U.row_size() == 1) // U is a scalar field
-      {
-        for (Uint i=0; i<size(); ++i)
-          for (Uint j=0; j<row_size(); ++j)
-            array()[i][j] *= U.array()[i][0];
-      }
-      else
-      {
-        cf3_assert(row_size() == U.row_size()); // field must be same size
-        for (Uint i=0; i<size(); ++i)
-          for (Uint j=0; j<row_size(); ++j)
-            array()[i][j] *= U.array()[i][j];
-      }
-      return *this;
-    }
+    Field& operator *=(const Field& U);
 
     /// U /= c
-    Field& operator /=(const Real& c)
-    {
-      for (Uint i=0; i<size(); ++i)
-        for (Uint j=0; j<row_size(); ++j)
-          array()[i][j] /= c;
-      return *this;
-    }
+    Field& operator /=(const Real& c);
 
     /// U /= U
-    Field& operator /=(const Field& U)
-    {
-      cf3_assert(size() == U.size());
-      if (U.row_size() == 1) // U is a scalar field
-      {
-        for (Uint i=0; i<size(); ++i)
-          for (Uint j=0; j<row_size(); ++j)
-            array()[i][j] /= U.array()[i][0];
-      }
-      else
-      {
-        cf3_assert(row_size() == U.row_size()); // field must be same size
-        for (Uint i=0; i<size(); ++i)
-          for (Uint j=0; j<row_size(); ++j)
-            array()[i][j] /= U.array()[i][j];
-      }
-      return *this;
-    }
+    Field& operator /=(const Field& U);
+
+    // Whole-field operations.
+    // -----------------------
+    // The table is stored contiguously, so these run as a single flat loop
+    // over size()*row_size() values, which the compiler vectorizes.
+    // When the operands are unpacked, the loop runs over the padded rows instead.
+    // All rows are processed, including ghost rows.
+
+    /// U = X, with X of the same shape
+    Field& copy(const Field& X);
+
+    /// U = a*U
+    Field& scale(const Real a);
+
+    /// U = U + a*X, with X of the same shape
+    Field& axpy(const Real a, const Field& X);
+
+    /// U = a*X + b*U, with X of the same shape
+    Field& axpby(const Real a, const Field& X, const Real b);
+
+    /// U = U + a*D*X, with X of the same shape and D a scalar field scaling each row,
+    /// e.g. the update coefficient in an explicit time integration
+    Field& axpy(const Real a, const Field& D, const Field& X);
+
+    /// @return the Euclidean norm of all values, local to this process
+    Real norm() const;
+
+    // Padded storage.
+    // ---------------
+
+    /// Copy the values to the padded storage, if the option "padded" is set
+    void unpack();
+
+    /// Copy the values from the padded storage back into the table
+    void pack();
+
+    /// @return true if the values are in the padded storage
+    bool is_unpacked() const { return m_is_unpacked; }
+
+    /// @return the distance between two rows of the padded storage, a multiple of 64 bytes
+    Uint padded_row_size() const { return m_padded_row_size; }
+
+    /// @return the start of the padded storage, aligned to 64 bytes
+    Real* padded_data() { return m_padded_values.empty() ? NULL : &m_padded_values[0]; }
+
+    /// @return the start of the padded storage, aligned to 64 bytes
+    const Real* padded_data() const { return m_padded_values.empty() ? NULL : &m_padded_values[0]; }
 
 
     // // Relational operators.
@@ -301,11 +295,28 @@ private:
   void config_var_names();
   void config_var_types();
 
+  /// @return the values the whole-field operations work on: the padded storage or the table
+  Real* values() { return m_is_unpacked ? padded_data() : array().data(); }
+  const Real* values() const { return m_is_unpacked ? padded_data() : array().data(); }
+
+  /// @return the distance between two rows of values()
+  Uint stride() const { return m_is_unpacked ? m_padded_row_size : row_size(); }
+
   Handle<Dictionary> m_dict;
 
   Handle< common::PE::CommPattern > m_comm_pattern;
 
   Handle< math::VariablesDescriptor > m_descriptor;
+
+  /// Values of the field while it is unpacked, rows padded to m_padded_row_size
+  std::vector< Real, common::AlignedAllocator<Real,64> > m_padded_values;
+
+  Uint m_padded_row_size;
+
+  bool m_is_unpacked;
+
+  /// True if synchronize_finish() has to unpack the field again
+  bool m_unpack_after_synchronize;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -104,5 +104,52 @@ boost::shared_ptr< common::List< Uint > > build_used_nodes_list( const Component
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void build_element_colors( const Connectivity& connectivity, const Uint nb_nodes, std::vector< std::vector<Uint> >& colors )
+{
+  colors.clear();
+
+  const Uint nb_elems = connectivity.size();
+  std::vector<bool> elem_is_colored(nb_elems, false);
+  std::vector<bool> node_is_used(nb_nodes, false);
+
+  // Each pass over the elements builds one color, taking every remaining element that doesn't touch a node used in this pass
+  Uint nb_colored = 0;
+  while(nb_colored != nb_elems)
+  {
+    colors.push_back(std::vector<Uint>());
+    std::vector<Uint>& color = colors.back();
+    node_is_used.assign(nb_nodes, false);
+
+    for(Uint elem = 0; elem != nb_elems; ++elem)
+    {
+      if(elem_is_colored[elem])
+        continue;
+
+      bool is_free = true;
+      boost_foreach(const Uint node, connectivity[elem])
+      {
+        cf3_assert(node < nb_nodes);
+        if(node_is_used[node])
+        {
+          is_free = false;
+          break;
+        }
+      }
+
+      if(!is_free)
+        continue;
+
+      boost_foreach(const Uint node, connectivity[elem])
+        node_is_used[node] = true;
+
+      color.push_back(elem);
+      elem_is_colored[elem] = true;
+      ++nb_colored;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
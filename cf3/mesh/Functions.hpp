@@ -7,6 +7,8 @@
 #ifndef cf3_mesh_Functions_hpp
 #define cf3_mesh_Functions_hpp
 
+#include <vector>
+
 #include "common/Handle.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -18,6 +20,7 @@ template <typename T> class List;
 }
 namespace mesh {
 
+  class Connectivity;
   class Dictionary;
   class Entities;
 
@@ -41,6 +44,17 @@ boost::shared_ptr< common::List< Uint > > build_used_nodes_list( const common::C
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// build_element_colors
+/// @brief Partition the rows of a connectivity table into colors, so that no two elements of the same color share a node.
+/// Elements of one color can safely scatter into nodal storage (fields, linear systems) concurrently.
+/// Colors are filled greedily in element order, so the first colors are the largest.
+/// @param [in]  connectivity  element to node connectivity
+/// @param [in]  nb_nodes      number of nodes referenced by the connectivity
+/// @param [out] colors        for each color, the ordered list of elements that have that color
+void build_element_colors( const Connectivity& connectivity, const Uint nb_nodes, std::vector< std::vector<Uint> >& colors );
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
 
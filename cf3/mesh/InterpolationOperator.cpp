@@ -0,0 +1,408 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+#include "common/Core.hpp"
+#include "common/EventHandler.hpp"
+#include "common/FindComponents.hpp"
+#include "common/OptionList.hpp"
+#include "common/Signal.hpp"
+#include "common/Table.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "math/Consts.hpp"
+
+#include "mesh/InterpolationOperator.hpp"
+#include "mesh/ElementTree.hpp"
+#include "mesh/UnifiedData.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/ShapeFunction.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+  using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+cf3::common::ComponentBuilder < InterpolationOperator, Component, LibMesh > InterpolationOperator_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// message tag for the interpolated values sent to the requesting ranks
+  const int interpolation_tag = 7333;
+
+  /// Copy the values of a table
+  void copy_values(const common::Table<Real>& table, std::vector<Real>& values)
+  {
+    values.assign(table.array().data(), table.array().data()+table.array().num_elements());
+  }
+
+  /// @return true if a table holds the given values
+  bool has_values(const common::Table<Real>& table, const std::vector<Real>& values)
+  {
+    return table.array().num_elements() == values.size() && std::equal(values.begin(), values.end(), table.array().data());
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+InterpolationOperator::InterpolationOperator( const std::string& name )
+  : Component(name), m_nb_source_rows(0), m_nb_coordinates(0)
+{
+  m_element_tree = create_component<ElementTree>("element_tree");
+
+  Core::instance().event_handler().connect_to_event("mesh_changed", this, &InterpolationOperator::on_mesh_changed_event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InterpolationOperator::reset()
+{
+  m_source.reset();
+  m_coordinates.reset();
+  m_nb_source_rows = 0;
+  m_nb_coordinates = 0;
+  m_local_rows.clear();
+  m_local_targets.clear();
+  m_send_ranks.clear();
+  m_send_rows.clear();
+  m_recv_ranks.clear();
+  m_recv_targets.clear();
+  m_missing.clear();
+  m_built_coordinates.clear();
+  m_built_source_coordinates.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InterpolationOperator::on_mesh_changed_event( SignalArgs& args )
+{
+  reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool InterpolationOperator::is_built_for(const Dictionary& source, const common::Table<Real>& coordinates) const
+{
+  // the coordinates and the source mesh may have been moved in place
+  bool valid = m_source.get() == &source && m_coordinates.get() == &coordinates &&
+               m_nb_source_rows == source.size() && m_nb_coordinates == coordinates.size() &&
+               detail::has_values(coordinates, m_built_coordinates) &&
+               detail::has_values(find_parent_component<Mesh>(source).geometry_fields().coordinates(), m_built_source_coordinates);
+
+  // all ranks must take part in a rebuild
+  if (PE::Comm::instance().is_active())
+    PE::Comm::instance().all_reduce(PE::logical_and(),&valid,1,&valid);
+  return valid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InterpolationOperator::build(const Dictionary& source, const common::Table<Real>& coordinates)
+{
+  reset();
+
+  Mesh& source_mesh = find_parent_component<Mesh>(source);
+  m_element_tree->options().configure_option("mesh",source_mesh.handle<Mesh>());
+  m_element_tree->build();
+
+  const Uint dim = source_mesh.dimension();
+  const Uint coord_dim = std::min(dim, coordinates.row_size());
+  const Uint nb_coords = coordinates.size();
+
+  // Coordinates found on this rank
+
+  std::vector<Uint> found;
+  m_element_tree->find_elements(coordinates.array(),found);
+
+  std::vector<Uint> missing;
+  std::vector<Real> missing_coords;
+  RealVector coord(dim); coord.setZero();
+  for (Uint i=0; i<nb_coords; ++i)
+  {
+    for (Uint d=0; d<coord_dim; ++d)
+      coord[d] = coordinates[i][d];
+
+    if (found[i] != math::Consts::uint_max())
+    {
+      add_row(source,found[i],coord,m_local_rows);
+      m_local_targets.push_back(i);
+    }
+    else
+    {
+      missing.push_back(i);
+      for (Uint d=0; d<dim; ++d)
+        missing_coords.push_back(coord[d]);
+    }
+  }
+
+  // Coordinates found on other ranks: the missing coordinates are only sent to the ranks
+  // with a bounding box containing them, and the lowest rank that finds a coordinate becomes its donor
+
+  const Uint nb_procs = PE::Comm::instance().is_active() ? PE::Comm::instance().size() : 1u;
+  if (nb_procs > 1)
+  {
+    const Uint rank = PE::Comm::instance().rank();
+
+    // Bounding boxes of the source mesh on all ranks, empty if a rank has no elements
+    std::vector<Real> box(2*dim);
+    RealVector box_min, box_max;
+    if (m_element_tree->bounding_box(box_min,box_max))
+    {
+      for (Uint d=0; d<dim; ++d)
+      {
+        box[d] = box_min[d];
+        box[dim+d] = box_max[d];
+      }
+    }
+    else
+    {
+      std::fill(box.begin(),box.begin()+dim,math::Consts::real_max());
+      std::fill(box.begin()+dim,box.end(),-math::Consts::real_max());
+    }
+    std::vector< std::vector<Real> > boxes;
+    PE::Comm::instance().all_gather(box,boxes);
+
+    // Request the missing coordinates from the ranks that may hold them
+    std::vector< std::vector<Real> > send_coords(nb_procs);
+    std::vector< std::vector<Uint> > send_missing(nb_procs);
+    for (Uint i=0; i<missing.size(); ++i)
+    {
+      const Real* missing_coord = &missing_coords[i*dim];
+      for (Uint p=0; p<nb_procs; ++p)
+      {
+        if (p == rank)
+          continue;
+        bool inside = true;
+        for (Uint d=0; d<dim && inside; ++d)
+          inside = missing_coord[d] >= boxes[p][d] && missing_coord[d] <= boxes[p][dim+d];
+        if (!inside)
+          continue;
+        send_coords[p].insert(send_coords[p].end(),missing_coord,missing_coord+dim);
+        send_missing[p].push_back(i);
+      }
+    }
+    std::vector< std::vector<Real> > requested_coords;
+    PE::Comm::instance().all_to_all(send_coords,requested_coords);
+
+    // Look for the requested coordinates, and tell the requesting ranks which were found
+    std::vector< std::vector<Uint> > requested_elems(nb_procs);
+    std::vector< std::vector<Uint> > send_found(nb_procs);
+    for (Uint p=0; p<nb_procs; ++p)
+    {
+      const Uint nb_requested = requested_coords[p].size()/dim;
+      if (p == rank || nb_requested == 0)
+        continue;
+      boost::multi_array<Real,2> requested(boost::extents[nb_requested][dim]);
+      for (Uint i=0; i<nb_requested; ++i)
+        for (Uint d=0; d<dim; ++d)
+          requested[i][d] = requested_coords[p][i*dim+d];
+      m_element_tree->find_elements(requested,requested_elems[p]);
+      send_found[p].resize(nb_requested);
+      for (Uint i=0; i<nb_requested; ++i)
+        send_found[p][i] = requested_elems[p][i] != math::Consts::uint_max();
+    }
+    std::vector< std::vector<Uint> > found_on;
+    PE::Comm::instance().all_to_all(send_found,found_on);
+
+    // Donors of the coordinates of this rank: the ranks are visited in increasing order
+    std::vector<Uint> donors(missing.size(),math::Consts::uint_max());
+    std::vector< std::vector<Uint> > accepted(nb_procs);
+    for (Uint p=0; p<nb_procs; ++p)
+    {
+      for (Uint k=0; k<found_on[p].size(); ++k)
+      {
+        const Uint i = send_missing[p][k];
+        if (found_on[p][k] && donors[i] == math::Consts::uint_max())
+        {
+          donors[i] = p;
+          accepted[p].push_back(k);
+        }
+      }
+    }
+    std::vector< std::vector<Uint> > donated;
+    PE::Comm::instance().all_to_all(accepted,donated);
+
+    // Rows computed on this rank for the others, in the order of their coordinates
+    for (Uint p=0; p<nb_procs; ++p)
+    {
+      if (p == rank || donated[p].empty())
+        continue;
+      Rows rows;
+      boost_foreach (const Uint k, donated[p])
+      {
+        for (Uint d=0; d<dim; ++d)
+          coord[d] = requested_coords[p][k*dim+d];
+        add_row(source,requested_elems[p][k],coord,rows);
+      }
+      m_send_ranks.push_back(p);
+      m_send_rows.push_back(rows);
+    }
+
+    // The donors send the values in the order of the accepted requests
+    for (Uint p=0; p<nb_procs; ++p)
+    {
+      if (accepted[p].empty())
+        continue;
+      m_recv_ranks.push_back(p);
+      m_recv_targets.push_back(std::vector<Uint>());
+      boost_foreach (const Uint k, accepted[p])
+        m_recv_targets.back().push_back(missing[send_missing[p][k]]);
+    }
+    for (Uint i=0; i<missing.size(); ++i)
+    {
+      if (donors[i] == math::Consts::uint_max())
+        m_missing.push_back(missing[i]);
+    }
+  }
+  else
+  {
+    m_missing = missing;
+  }
+
+  if (m_missing.size())
+    CFwarn << uri().string() << ": " << m_missing.size() << " coordinates were not found in source mesh "
+           << source_mesh.uri().string() << ". Values are set to zero." << CFendl;
+
+  m_source = Handle<Dictionary const>(source.handle<Component>());
+  m_coordinates = Handle< common::Table<Real> const >(coordinates.handle<Component>());
+  m_nb_source_rows = source.size();
+  m_nb_coordinates = nb_coords;
+  detail::copy_values(coordinates, m_built_coordinates);
+  detail::copy_values(source_mesh.geometry_fields().coordinates(), m_built_source_coordinates);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InterpolationOperator::add_row(const Dictionary& source, const Uint unified_elem_idx, const RealVector& coordinate, Rows& rows) const
+{
+  Handle<Elements> elements;
+  Uint elem_idx;
+  m_element_tree->location(unified_elem_idx,elements,elem_idx);
+
+  const Space& space = source.space(*elements);
+  const ShapeFunction& sf = space.shape_function();
+
+  RealMatrix nodes;
+  elements->geometry_space().allocate_coordinates(nodes);
+  elements->geometry_space().put_coordinates(nodes,elem_idx);
+  RealVector local_coord(sf.dimensionality());
+  elements->element_type().compute_mapped_coordinate(coordinate,nodes,local_coord);
+  RealRowVector sf_value(sf.nb_nodes());
+  sf.compute_value(local_coord,sf_value);
+
+  Connectivity::ConstRow source_indexes = space.connectivity()[elem_idx];
+  for (Uint n=0; n<source_indexes.size(); ++n)
+  {
+    rows.columns.push_back(source_indexes[n]);
+    rows.weights.push_back(sf_value[n]);
+  }
+  rows.offsets.push_back(rows.columns.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InterpolationOperator::multiply(const Rows& rows, const Uint row, const Field& source, Real* values) const
+{
+  const Uint nb_vars = source.row_size();
+  for (Uint v=0; v<nb_vars; ++v)
+    values[v] = 0.;
+  for (Uint k=rows.offsets[row]; k<rows.offsets[row+1]; ++k)
+  {
+    Field::ConstRow source_row = source[rows.columns[k]];
+    const Real w = rows.weights[k];
+    for (Uint v=0; v<nb_vars; ++v)
+      values[v] += w * source_row[v];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InterpolationOperator::apply(const Field& source, common::Table<Real>& target)
+{
+  if (m_source.get() != &source.dict())
+    throw SetupError(FromHere(), uri().string()+" was not built for the dictionary of field "+source.uri().string());
+
+  const Uint nb_vars = source.row_size();
+  if (target.size() != m_nb_coordinates || target.row_size() != nb_vars)
+    throw BadValue(FromHere(), "Table "+target.uri().string()+" should have "+to_str(m_nb_coordinates)+" rows of "+to_str(nb_vars)+" values");
+
+  std::vector<MPI_Request> requests;
+  requests.reserve(m_recv_ranks.size()+m_send_ranks.size());
+
+  // Post the receives, and send the values of the requested coordinates
+  m_recv_buffers.resize(m_recv_ranks.size());
+  for (Uint k=0; k<m_recv_ranks.size(); ++k)
+  {
+    m_recv_buffers[k].resize(m_recv_targets[k].size()*nb_vars);
+    requests.push_back(MPI_Request());
+    MPI_CHECK_RESULT(MPI_Irecv,(&m_recv_buffers[k][0], (int)m_recv_buffers[k].size(), PE::get_mpi_datatype(Real()), m_recv_ranks[k], detail::interpolation_tag, PE::Comm::instance().communicator(), &requests.back()));
+  }
+
+  m_send_buffers.resize(m_send_ranks.size());
+  for (Uint k=0; k<m_send_ranks.size(); ++k)
+  {
+    const Rows& rows = m_send_rows[k];
+    m_send_buffers[k].resize(rows.size()*nb_vars);
+    for (Uint r=0; r<rows.size(); ++r)
+      multiply(rows,r,source,&m_send_buffers[k][r*nb_vars]);
+    requests.push_back(MPI_Request());
+    MPI_CHECK_RESULT(MPI_Isend,(&m_send_buffers[k][0], (int)m_send_buffers[k].size(), PE::get_mpi_datatype(Real()), m_send_ranks[k], detail::interpolation_tag, PE::Comm::instance().communicator(), &requests.back()));
+  }
+
+  // Local coordinates, while the messages are underway
+  std::vector<Real> values(nb_vars);
+  for (Uint r=0; r<m_local_rows.size(); ++r)
+  {
+    multiply(m_local_rows,r,source,&values[0]);
+    common::Table<Real>::Row target_row = target[m_local_targets[r]];
+    for (Uint v=0; v<nb_vars; ++v)
+      target_row[v] = values[v];
+  }
+
+  boost_foreach(const Uint i, m_missing)
+  {
+    for (Uint v=0; v<nb_vars; ++v)
+      target[i][v] = 0.;
+  }
+
+  if (requests.size())
+    MPI_CHECK_RESULT(MPI_Waitall,((int)requests.size(), &requests[0], MPI_STATUSES_IGNORE));
+
+  for (Uint k=0; k<m_recv_ranks.size(); ++k)
+  {
+    for (Uint i=0; i<m_recv_targets[k].size(); ++i)
+    {
+      common::Table<Real>::Row target_row = target[m_recv_targets[k][i]];
+      for (Uint v=0; v<nb_vars; ++v)
+        target_row[v] = m_recv_buffers[k][i*nb_vars+v];
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
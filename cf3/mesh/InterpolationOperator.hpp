@@ -0,0 +1,145 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_InterpolationOperator_hpp
+#define cf3_mesh_InterpolationOperator_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common/Component.hpp"
+#include "common/Table_fwd.hpp"
+
+#include "math/MatrixTypes.hpp"
+
+#include "mesh/LibMesh.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+  class Dictionary;
+  class Field;
+  class ElementTree;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Precomputed interpolation from the fields of a dictionary to a set of coordinates
+///
+/// build() locates every coordinate in the elements of the source mesh, possibly on another rank,
+/// and stores the shape function values of the source space in this point as the weights of a
+/// sparse matrix, with the source rows as columns. Coordinates that are not found on this rank
+/// are only sent to the ranks with a bounding box of the source mesh containing them, and the
+/// lowest of these ranks that finds a coordinate becomes its donor. The rows for coordinates found
+/// on another rank are stored on that rank, together with the ranks to exchange the values with.
+/// Every apply() is then a sparse matrix-vector product for the local and for the requested
+/// coordinates, followed by one exchange of the requested values with the neighbouring ranks.
+///
+/// The operator stays valid as long as the source dictionary and the coordinates don't change,
+/// and is reset on the "mesh_changed" event. is_built_for() compares the coordinates and the
+/// coordinates of the source mesh with copies made by build(), to detect moved nodes.
+/// Fields with any number of variables can be interpolated with the same operator.
+/// build() and apply() are collective.
+class Mesh_API InterpolationOperator : public common::Component
+{
+public: // functions
+
+  /// constructor
+  InterpolationOperator( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "InterpolationOperator"; }
+
+  /// Find the donor elements of the coordinates and compute the weights
+  /// @param [in] source       dictionary of the fields to interpolate from
+  /// @param [in] coordinates  interpolate at these coordinates (rows are coordinates)
+  void build(const Dictionary& source, const common::Table<Real>& coordinates);
+
+  /// @return true if the operator was built for these source and coordinates, on all ranks,
+  ///         and neither the coordinates nor the nodes of the source mesh have moved since
+  bool is_built_for(const Dictionary& source, const common::Table<Real>& coordinates) const;
+
+  /// Interpolate a field
+  /// @param [in]  source  field of the dictionary the operator was built for
+  /// @param [out] target  values at the coordinates, with the row size of source.
+  ///                      Coordinates that were not found in the source mesh get 0.
+  void apply(const Field& source, common::Table<Real>& target);
+
+  /// Forget the weights, so that the next use rebuilds them
+  void reset();
+
+  /// @return the number of coordinates that were not found in the source mesh
+  Uint nb_missing() const { return m_missing.size(); }
+
+private: // types
+
+  /// Sparse matrix rows, in compressed row storage
+  struct Rows
+  {
+    Rows() : offsets(1,0) {}
+    void clear() { offsets.assign(1,0); columns.clear(); weights.clear(); }
+    Uint size() const { return offsets.size()-1; }
+
+    std::vector<Uint> offsets;
+    std::vector<Uint> columns;
+    std::vector<Real> weights;
+  };
+
+private: // functions
+
+  /// Add the row of weights for a coordinate located in an element of the tree
+  void add_row(const Dictionary& source, const Uint unified_elem_idx, const RealVector& coordinate, Rows& rows) const;
+
+  /// Multiply one row with the source values
+  /// @param [out] values  result, one value per variable of source
+  void multiply(const Rows& rows, const Uint row, const Field& source, Real* values) const;
+
+  /// Reset the operator when the mesh changes
+  void on_mesh_changed_event( common::SignalArgs& args );
+
+private: // data
+
+  /// Tree over the elements of the source mesh
+  Handle<ElementTree> m_element_tree;
+
+  Handle<Dictionary const> m_source;
+  Handle<common::Table<Real> const> m_coordinates;
+  Uint m_nb_source_rows;
+  Uint m_nb_coordinates;
+
+  /// Rows for the coordinates found on this rank, and their index in the coordinates
+  Rows m_local_rows;
+  std::vector<Uint> m_local_targets;
+
+  /// Ranks that requested coordinates found on this rank, and the rows of every rank
+  std::vector<int> m_send_ranks;
+  std::vector<Rows> m_send_rows;
+
+  /// Ranks that hold requested coordinates, and the index of these in the coordinates
+  std::vector<int> m_recv_ranks;
+  std::vector< std::vector<Uint> > m_recv_targets;
+
+  /// Coordinates not found on any rank
+  std::vector<Uint> m_missing;
+
+  /// Coordinates and source mesh coordinates the operator was built for
+  std::vector<Real> m_built_coordinates;
+  std::vector<Real> m_built_source_coordinates;
+
+  /// Exchange buffers
+  std::vector< std::vector<Real> > m_send_buffers;
+  std::vector< std::vector<Real> > m_recv_buffers;
+
+}; // end InterpolationOperator
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_InterpolationOperator_hpp
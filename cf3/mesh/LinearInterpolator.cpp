@@ -19,6 +19,8 @@
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
 #include "common/Link.hpp"
+#include "common/Core.hpp"
+#include "common/EventHandler.hpp"
 
 #include "math/Consts.hpp"
 
@@ -33,6 +35,7 @@
 #include "mesh/Space.hpp"
 #include "mesh/Connectivity.hpp"
 #include "mesh/UnifiedData.hpp"
+#include "mesh/ElementTree.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -49,20 +52,17 @@ cf3::common::ComponentBuilder < LinearInterpolator, Interpolator, LibMesh > Line
 //////////////////////////////////////////////////////////////////////////////
 
 LinearInterpolator::LinearInterpolator( const std::string& name )
-  : Interpolator(name), m_dim(0), m_bounding(2), m_N(3), m_D(3), m_point_idx(3), m_sufficient_nb_points(0)
+  : Interpolator(name), m_dim(0), m_bounding(2), m_sufficient_nb_points(0),
+    m_stencil_source_size(0), m_stencil_target_size(0), m_stencil_offsets(1,0)
 {
 
 
-  options().add_option( "ApproximateNbElementsPerCell", 1u)
-      .description("The approximate amount of elements that are stored in a structured");
+  options().add_option( "ApproximateNbElementsPerCell", 8u)
+      .description("The maximum amount of elements that are stored in a leaf of the element tree");
 
-  std::vector<Uint> dummy;
-  options().add_option( "Divisions", dummy)
-      .description("The number of divisions in each direction of the comb. "
-                        "Takes precedence over \"ApproximateNbElementsPerCell\". ");
-
-  m_elements = create_component<UnifiedData>("elements");
+  m_element_tree = create_component<ElementTree>("element_tree");
 
+  Core::instance().event_handler().connect_to_event("mesh_changed", this, &LinearInterpolator::on_mesh_changed_event);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -73,64 +73,137 @@ void LinearInterpolator::construct_internal_storage(Mesh& source)
   {
     m_source_mesh = source.handle<Mesh>();
     create_bounding_box();
-    create_octtree();
+
+    m_element_tree->options().configure_option("mesh",m_source_mesh);
+    m_element_tree->options().configure_option("max_elems_per_leaf",options().option("ApproximateNbElementsPerCell").value<Uint>());
+    m_element_tree->build();
+
+    m_sufficient_nb_points = static_cast<Uint>(std::pow(3.,(int)m_dim));
+
+    clear_stencils();
   }
 }
 
 //////////////////////////////////////////////////////////////////////
 
+void LinearInterpolator::on_mesh_changed_event( SignalArgs& args )
+{
+  clear_stencils();
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void LinearInterpolator::clear_stencils()
+{
+  m_stencil_source.reset();
+  m_stencil_target.reset();
+  m_stencil_source_size = 0;
+  m_stencil_target_size = 0;
+  m_stencil_targets.clear();
+  m_stencil_offsets.assign(1,0);
+  m_stencil_sources.clear();
+  m_stencil_weights.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void LinearInterpolator::add_stencil(const Uint target_row, const std::vector<Uint>& source_rows, const std::vector<Real>& weights)
+{
+  m_stencil_targets.push_back(target_row);
+  m_stencil_sources.insert(m_stencil_sources.end(), source_rows.begin(), source_rows.end());
+  m_stencil_weights.insert(m_stencil_weights.end(), weights.begin(), weights.end());
+  m_stencil_offsets.push_back(m_stencil_sources.size());
+}
+
+//////////////////////////////////////////////////////////////////////
+
 void LinearInterpolator::interpolate_field_from_to(const Field& source, Field& target)
 {
+  // The stencils and weights only depend on the dictionaries of the fields, so they are reused
+  // for all fields of the same dictionaries, as long as these don't change
+  const bool stored = options().option("store").value<bool>() &&
+      m_stencil_source.get() == &source.dict() && m_stencil_target.get() == &target.dict() &&
+      m_stencil_source_size == source.size() && m_stencil_target_size == target.size();
+  if (!stored)
+    compute_stencils(source, target);
+
+  const Uint row_size = target.row_size();
+  for (Uint s=0; s<m_stencil_targets.size(); ++s)
+  {
+    Field::Row target_row = target[m_stencil_targets[s]];
+    for (Uint idata=0; idata<row_size; ++idata)
+      target_row[idata] = 0;
+
+    for (Uint j=m_stencil_offsets[s]; j<m_stencil_offsets[s+1]; ++j)
+    {
+      Field::ConstRow source_row = source[m_stencil_sources[j]];
+      for (Uint idata=0; idata<row_size; ++idata)
+        target_row[idata] += m_stencil_weights[j]*source_row[idata];
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void LinearInterpolator::compute_stencils(const Field& source, const Field& target)
+{
+  clear_stencils();
+  m_stencil_source = source.dict().handle<Dictionary>();
+  m_stencil_target = target.dict().handle<Dictionary>();
+  m_stencil_source_size = source.size();
+  m_stencil_target_size = target.size();
+
   // Allocations
   Handle< Elements const > s_elements;
   Uint s_elm_idx;
   RealVector t_node(m_dim); t_node.setZero();
+  std::vector<Uint> s_field_indexes;
+  std::vector<RealVector> s_nodes;
+  std::vector<Real> w;
 
   if (source.continuous() && target.continuous())
   {
     const Field& source_coords = source.coordinates();
     const Field& target_coords = target.coordinates();
 
+    std::vector<Uint> s_unified_elems;
+    m_element_tree->find_elements(target_coords.array(),s_unified_elems);
+
+    Handle< Elements > s_found_elements;
     for (Uint t_node_idx=0; t_node_idx<target.size(); ++t_node_idx)
     {
-      to_vector(t_node,target_coords[t_node_idx]);
-      boost::tie(s_elements,s_elm_idx) = find_element(t_node);
-      if (is_not_null(s_elements))
+      if (s_unified_elems[t_node_idx] != math::Consts::uint_max())
       {
-        Connectivity::ConstRow s_field_indexes = source.space(*s_elements).connectivity()[s_elm_idx];
-        std::vector<RealVector> s_nodes(s_field_indexes.size(),RealVector(m_dim));
+        to_vector(t_node,target_coords[t_node_idx]);
+        m_element_tree->location(s_unified_elems[t_node_idx],s_found_elements,s_elm_idx);
+
+        Connectivity::ConstRow s_row = source.space(*s_found_elements).connectivity()[s_elm_idx];
+        s_field_indexes.assign(s_row.begin(),s_row.end());
+        s_nodes.assign(s_field_indexes.size(),RealVector(m_dim));
 
         fill( s_nodes , source_coords , s_field_indexes );
 
-        std::vector<Real> w(s_nodes.size());
+        w.resize(s_nodes.size());
         pseudo_laplacian_weighted_linear_interpolation(s_nodes, t_node, w);
-
-        for (Uint idata=0; idata<target.row_size(); ++idata)
-          target[t_node_idx][idata] = 0;
-
-        for (Uint s_node_idx=0; s_node_idx<s_nodes.size(); ++s_node_idx)
-          for (Uint idata=0; idata<target.row_size(); ++idata)
-            target[t_node_idx][idata] += w[s_node_idx]*source[s_field_indexes[s_node_idx]][idata];
+        add_stencil(t_node_idx, s_field_indexes, w);
       }
     }
   }
   else if ( source.discontinuous() && target.continuous() )
   {
     const Field& target_coords = target.coordinates();
-    std::vector<Uint> s_field_indexes(0);
-    std::vector<RealVector> s_nodes(0);
     Handle< Component > component;
     for (Uint t_node_idx=0; t_node_idx<target.size(); ++t_node_idx)
     {
       to_vector(t_node,target_coords[t_node_idx]);
-      if (find_point_in_octtree(t_node,m_point_idx))
+      if (is_in_bounding_box(t_node))
       {
-        find_pointcloud(m_sufficient_nb_points);
+        find_element_cloud(t_node,m_sufficient_nb_points);
         s_field_indexes.resize(0);
         s_nodes.resize(0);
         boost_foreach(const Uint glb_elem_idx, m_element_cloud)
         {
-          boost::tie(component,s_elm_idx)=m_elements->location(glb_elem_idx);
+          boost::tie(component,s_elm_idx)=m_element_tree->elements().location(glb_elem_idx);
           Elements const& elements = dynamic_cast<Elements const&>(*component);
           RealMatrix space_coords = source.space(elements).compute_coordinates(s_elm_idx);
           boost_foreach ( const Uint state_idx, source.space(elements).connectivity()[s_elm_idx] )
@@ -142,18 +215,13 @@ void LinearInterpolator::interpolate_field_from_to(const Field& source, Field& t
             s_nodes.push_back(space_coords.row(i));
           }
         }
-        std::vector<Real> w(s_nodes.size());
+        w.resize(s_nodes.size());
         pseudo_laplacian_weighted_linear_interpolation(s_nodes, t_node, w);
-
-        for (Uint idata=0; idata<target.row_size(); ++idata)
-          target[t_node_idx][idata] = 0;
-
-        for (Uint e=0; e<s_nodes.size(); ++e)
-          for (Uint idata=0; idata<target.row_size(); ++idata)
-            target[t_node_idx][idata] += w[e] * source[s_field_indexes[e]][idata];
+        add_stencil(t_node_idx, s_field_indexes, w);
       }
       else
       {
+        clear_stencils();
         std::stringstream ss; ss << "could not find node " << t_node.transpose();
         throw ValueNotFound(FromHere(),ss.str());
       }
@@ -161,7 +229,6 @@ void LinearInterpolator::interpolate_field_from_to(const Field& source, Field& t
   }
   else if ( source.continuous() && target.discontinuous() )
   {
-    Uint s_elm_idx;
     RealMatrix elem_coordinates;
     const Field& source_coords = source.coordinates();
 
@@ -179,22 +246,15 @@ void LinearInterpolator::interpolate_field_from_to(const Field& source, Field& t
           boost::tie(s_elements,s_elm_idx) = find_element(t_node);
           if (is_not_null(s_elements))
           {
-            Connectivity::ConstRow s_field_indexes = source.space(*s_elements).connectivity()[s_elm_idx];
-            std::vector<RealVector> s_nodes(s_field_indexes.size(),RealVector(m_dim));
+            Connectivity::ConstRow s_row = source.space(*s_elements).connectivity()[s_elm_idx];
+            s_field_indexes.assign(s_row.begin(),s_row.end());
+            s_nodes.assign(s_field_indexes.size(),RealVector(m_dim));
 
             fill( s_nodes , source_coords , s_field_indexes );
 
-            std::vector<Real> w(s_nodes.size());
+            w.resize(s_nodes.size());
             pseudo_laplacian_weighted_linear_interpolation(s_nodes, t_node, w);
-
-
-            for (Uint idata=0; idata<target.row_size(); ++idata)
-              target[t_field_indexes[t_elm_point_idx]][idata] = 0;
-
-
-            for (Uint s_node_idx=0; s_node_idx<s_nodes.size(); ++s_node_idx)
-              for (Uint idata=0; idata<target.row_size(); ++idata)
-                target[t_field_indexes[t_elm_point_idx]][idata] += w[s_node_idx]*source[s_field_indexes[s_node_idx]][idata];
+            add_stencil(t_field_indexes[t_elm_point_idx], s_field_indexes, w);
           }
         }
       }
@@ -202,17 +262,12 @@ void LinearInterpolator::interpolate_field_from_to(const Field& source, Field& t
   }
   else if ( source.discontinuous() && target.discontinuous() )
   {
-    Uint s_elm_idx;
-    //Uint t_elm_idx;
     RealMatrix elem_coordinates;
-    std::vector<Uint> s_field_indexes(0);
-    std::vector<RealVector> s_nodes;
     Handle< Component > component;
     boost_foreach( const Handle<Space>& t_space_handle, target.spaces() )
     {
       const Space& t_space = *t_space_handle;
       t_space.allocate_coordinates(elem_coordinates);
-      RealVector t_node(m_dim);  t_node.setZero();
       for (Uint t_elm_idx=0; t_elm_idx<t_space.size(); ++t_elm_idx)
       {
         Connectivity::ConstRow t_field_indexes = t_space.connectivity()[t_elm_idx];
@@ -223,15 +278,15 @@ void LinearInterpolator::interpolate_field_from_to(const Field& source, Field& t
             t_node[d] = elem_coordinates(t_elm_point_idx,d);
 
 
-          if (find_point_in_octtree(t_node,m_point_idx))
+          if (is_in_bounding_box(t_node))
           {
-            find_pointcloud(m_sufficient_nb_points);
+            find_element_cloud(t_node,m_sufficient_nb_points);
 
             s_field_indexes.resize(0);
             s_nodes.resize(0);
             boost_foreach(const Uint glb_elem_idx, m_element_cloud)
             {
-              boost::tie(component,s_elm_idx)=m_elements->location(glb_elem_idx);
+              boost::tie(component,s_elm_idx)=m_element_tree->elements().location(glb_elem_idx);
               Elements const& elements = dynamic_cast<Elements const&>(*component);
               RealMatrix space_coords = source.space(elements).get_coordinates(s_elm_idx);
               boost_foreach ( const Uint state_idx, source.space(elements).connectivity()[s_elm_idx] )
@@ -244,19 +299,13 @@ void LinearInterpolator::interpolate_field_from_to(const Field& source, Field& t
               }
             }
 
-            std::vector<Real> w(s_nodes.size());
+            w.resize(s_nodes.size());
             pseudo_laplacian_weighted_linear_interpolation(s_nodes, t_node, w);
-
-            for (Uint idata=0; idata<target.row_size(); ++idata)
-              target[t_field_indexes[t_elm_point_idx]][idata] = 0;
-
-
-            for (Uint s_node_idx=0; s_node_idx<s_nodes.size(); ++s_node_idx)
-              for (Uint idata=0; idata<target.row_size(); ++idata)
-                target[t_field_indexes[t_elm_point_idx]][idata] += w[s_node_idx]*source[s_field_indexes[s_node_idx]][idata];
+            add_stencil(t_field_indexes[t_elm_point_idx], s_field_indexes, w);
           }
           else
           {
+            clear_stencils();
             throw ValueNotFound(FromHere(),"could not find node");
           }
         }
@@ -265,6 +314,7 @@ void LinearInterpolator::interpolate_field_from_to(const Field& source, Field& t
   }
   else
   {
+    clear_stencils();
     throw ShouldNotBeHere(FromHere(), "Field::basis() should return NODE_BASED or ELEMENT_BASED");
   }
 }
@@ -291,216 +341,36 @@ void LinearInterpolator::create_bounding_box()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void LinearInterpolator::create_octtree()
+bool LinearInterpolator::is_in_bounding_box(const RealVector& coordinate) const
 {
-  std::vector<Real> L(3);
-
-  Real V=1;
-  for (Uint d=0; d<m_dim; ++d)
-  {
-    L[d] = m_bounding[MAX][d] - m_bounding[MIN][d];
-    V*=L[d];
-  }
-
-  m_nb_elems = m_source_mesh->properties().value<Uint>("nb_cells");
-
-  if (options().option("Divisions").value<std::vector<Uint> >().size() > 0)
-  {
-    m_N = options().option("Divisions").value<std::vector<Uint> >();
-    for (Uint d=0; d<m_dim; ++d)
-      m_D[d] = (L[d])/static_cast<Real>(m_N[d]);
-  }
-  else
-  {
-    Real V1 = V/m_nb_elems;
-    Real D1 = std::pow(V1,1./m_dim)*options().option("ApproximateNbElementsPerCell").value<Uint>();
-
-    for (Uint d=0; d<m_dim; ++d)
-    {
-      m_N[d] = (Uint) std::ceil(L[d]/D1);
-      m_D[d] = (L[d])/static_cast<Real>(m_N[d]);
-    }
-  }
-
-  CFinfo << "Honeycomb:" << CFendl;
-  CFinfo << "----------" << CFendl;
-  for (Uint d=0; d<m_dim; ++d)
-  {
-    CFinfo << "range["<<d<<"] :   L = " << L[d] << "    N = " << m_N[d] << "    D = " << m_D[d] << CFendl;
-  }
-  CFinfo << "V = " << V << CFendl;
-
-  // initialize the honeycomb
-  m_honeycomb.resize(boost::extents[std::max(Uint(1),m_N[0])][std::max(Uint(1),m_N[1])][std::max(Uint(1),m_N[2])]);
-
-  boost_foreach(Elements& elements, find_components_recursively_with_filter<Elements>(*m_source_mesh,IsElementsVolume()))
-    m_elements->add(elements);
-
-  Uint glb_elem_idx=0;
-  RealVector centroid(m_dim);
-  boost_foreach(const Elements& elements, find_components_recursively_with_filter<Elements>(*m_source_mesh,IsElementsVolume()))
-  {
-    Uint nb_nodes_per_element = elements.geometry_space().connectivity().row_size();
-    RealMatrix coordinates;
-    elements.geometry_space().allocate_coordinates(coordinates);
-
-    for (Uint elem_idx=0; elem_idx<elements.size(); ++elem_idx)
-    {
-      elements.geometry_space().put_coordinates(coordinates,elem_idx);
-      elements.element_type().compute_centroid(coordinates,centroid);
-      for (Uint d=0; d<m_dim; ++d)
-        m_point_idx[d]=std::min((Uint) std::floor( (centroid[d] - m_bounding[MIN][d])/m_D[d]), m_N[d]-1 );
-      m_honeycomb[m_point_idx[0]][m_point_idx[1]][m_point_idx[2]].push_back(glb_elem_idx);
-      ++glb_elem_idx;
-    }
-  }
-
-
-  Uint total=0;
-
-  switch (m_dim)
-  {
-    case DIM_2D:
-      for (Uint i=0; i<m_N[0]; ++i)
-        for (Uint j=0; j<m_N[1]; ++j)
-        {
-          Uint k=0;
-          // CFinfo << "("<<i<<","<<j<<") has elems ";
-          // if (m_honeycomb[i][j][k].size())
-          //   CFinfo << mesh::to_vector(m_honeycomb[i][j][k]).transpose() << CFendl;
-          // else
-          //   CFinfo << CFendl;
-          total += m_honeycomb[i][j][k].size();
-        }
-      break;
-    case DIM_3D:
-      for (Uint i=0; i<m_N[0]; ++i)
-        for (Uint j=0; j<m_N[1]; ++j)
-          for (Uint k=0; k<m_N[2]; ++k)
-          {
-            // CFinfo << "("<<i<<","<<j<<","<<k<<") has elems ";
-            // if (m_honeycomb[i][j][k].size())
-            //   CFinfo << mesh::to_vector(m_honeycomb[i][j][k]).transpose() << CFendl;
-            // else
-            //   CFinfo << CFendl;
-            total += m_honeycomb[i][j][k].size();
-          }
-      break;
-    default:
-      break;
-  }
-
-  CFinfo << "total = " << total << " of " << m_nb_elems << CFendl;
-
-  m_sufficient_nb_points = static_cast<Uint>(std::pow(3.,(int)m_dim));
-
-}
-
-
-//////////////////////////////////////////////////////////////////////////////
-
-bool LinearInterpolator::find_point_in_octtree(const RealVector& coordinate, std::vector<Uint>& point_idx)
-{
-  //CFinfo << "point " << coordinate << CFflush;
+  static const Real tolerance = 100*math::Consts::eps();
   cf3_assert(coordinate.size() == static_cast<int>(m_dim));
 
   for (Uint d=0; d<m_dim; ++d)
   {
-    if ( (coordinate[d] - m_bounding[MIN][d])/m_D[d] > m_N[d])
-    {
-      //CFinfo << "coord["<<d<<"] = " << coordinate[d] <<" is not inside bounding box" << CFendl;
-      //CFinfo << (coordinate[d] - m_ranges[d][0])/m_D[d] << " > " << m_N[d] << CFendl;
-      return false; // no index found
-    }
-    point_idx[d] = std::min((Uint) std::floor( (coordinate[d] - m_bounding[MIN][d])/m_D[d]), m_N[d]-1 );
+    if ( (coordinate[d] > m_bounding[MAX][d] + tolerance) ||
+         (coordinate[d] < m_bounding[MIN][d] - tolerance) )
+      return false;
   }
-
-  //CFinfo << " should be in box ("<<m_point_idx[0]<<","<<m_point_idx[1]<<","<<m_point_idx[2]<<")" << CFendl;
   return true;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-void LinearInterpolator::find_pointcloud(Uint nb_points)
+void LinearInterpolator::find_element_cloud(const RealVector& coordinate, const Uint nb_elems)
 {
-  m_element_cloud.resize(0);
-  Uint r=1;
-  int i(0), j(0), k(0);
-  int imin, jmin, kmin;
-  int imax, jmax, kmax;
-
-  if (m_honeycomb[m_point_idx[0]][m_point_idx[1]][m_point_idx[2]].size() <= nb_points)
-    r=0;
-
-  while (m_element_cloud.size() < nb_points && m_element_cloud.size() < m_nb_elems)
-  {
-    ++r;
-    m_element_cloud.resize(0);
-
-    switch (m_dim)
-    {
-      case DIM_3D:
-        imin = std::max(int(m_point_idx[0])-int(r), 0);  imax = std::min(int(m_point_idx[0])+int(r),int(m_N[0])-1);
-        jmin = std::max(int(m_point_idx[1])-int(r), 0);  jmax = std::min(int(m_point_idx[1])+int(r),int(m_N[1])-1);
-        kmin = std::max(int(m_point_idx[2])-int(r), 0);  kmax = std::min(int(m_point_idx[2])+int(r),int(m_N[2])-1);
-        for (i = imin; i <= imax; ++i)
-          for (j = jmin; j <= jmax; ++j)
-            for (k = kmin; k <= kmax; ++k)
-            {
-              boost_foreach(const Uint glb_elem_idx, m_honeycomb[i][j][k])
-              m_element_cloud.push_back(glb_elem_idx);
-              //CFinfo << "   ("<<i<<","<<j<<","<<k<<")" <<  CFendl;
-            }
-        break;
-      case DIM_2D:
-        imin = std::max(int(m_point_idx[0])-int(r), 0);  imax = std::min(int(m_point_idx[0])+int(r),int(m_N[0])-1);
-        jmin = std::max(int(m_point_idx[1])-int(r), 0);  jmax = std::min(int(m_point_idx[1])+int(r),int(m_N[1])-1);
-        for (i = imin; i <= imax; ++i)
-          for (j = jmin; j <= jmax; ++j)
-          {
-            boost_foreach(const Uint glb_elem_idx, m_honeycomb[i][j][k])
-            m_element_cloud.push_back(glb_elem_idx);
-            //CFinfo << "   ("<<i<<","<<j<<","<<k<<")" <<  CFendl;
-          }
-        break;
-      case DIM_1D:
-        imin = std::max(int(m_point_idx[0])-int(r), 0);  imax = std::min(int(m_point_idx[0])+int(r),int(m_N[0])-1);
-        for (i = imin; i <= imax; ++i)
-        {
-          boost_foreach(const Uint glb_elem_idx, m_honeycomb[i][j][k])
-          m_element_cloud.push_back(glb_elem_idx);
-          //CFinfo << "   ("<<i<<","<<j<<","<<k<<")" <<  CFendl;
-        }
-        break;
-    }
-  }
-
-  //CFinfo << m_pointcloud.size() << " points in the pointcloud " << CFendl;
-
+  m_element_tree->find_nearest_elements(coordinate,nb_elems,m_element_cloud);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 boost::tuple<Handle< Elements const >,Uint> LinearInterpolator::find_element(const RealVector& target_coord)
 {
-  if (find_point_in_octtree(target_coord,m_point_idx))
-  {
-    find_pointcloud(1);
-
-    Handle< Component > component;
-    Uint elem_idx;
-    boost_foreach(const Uint glb_elem_idx, m_element_cloud)
-    {
-      boost::tie(component,elem_idx)=m_elements->location(glb_elem_idx);
-      Elements const& elements = dynamic_cast<Elements const&>(*component);
-      RealMatrix elem_coordinates = elements.geometry_space().get_coordinates(elem_idx);
-      if (elements.element_type().is_coord_in_element(target_coord,elem_coordinates))
-      {
-        return boost::make_tuple(Handle<Elements const>(elements.handle()),elem_idx);
-      }
-    }
-  }
-  return boost::make_tuple(Handle< Elements >(), 0u);
+  Handle< Elements > elements;
+  Uint elem_idx;
+  if (m_element_tree->find_element(target_coord,elements,elem_idx))
+    return boost::make_tuple(Handle<Elements const>(elements),elem_idx);
+  return boost::make_tuple(Handle< Elements const >(), 0u);
 }
 
 //////////////////////////////////////////////////////////////////////
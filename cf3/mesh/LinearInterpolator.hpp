@@ -21,6 +21,8 @@ namespace cf3 {
 namespace mesh {
 
   class UnifiedData;
+  class ElementTree;
+  class Dictionary;
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -33,12 +35,6 @@ public: // typedefs
   
   
 
-private: // typedefs
-
-  typedef std::pair<const Elements*,Uint> Point;
-  typedef boost::multi_array<std::vector<Uint> ,3> Honeycomb;
-  typedef std::vector<const Point*> Pointcloud;
-
 public: // functions
   /// constructor
   LinearInterpolator( const std::string& name );
@@ -52,26 +48,35 @@ private: // functions
   /// @param source [in] the mesh from which interpolation will occur
   virtual void construct_internal_storage(Mesh& source);
 
-  /// Interpolate from one source field to target field
+  /// Interpolate from one source field to target field.
+  /// With the option "store", the stencils and weights are computed once for the dictionaries
+  /// of the fields, and reused for all their fields until one of them or the mesh changes.
   /// @param source [in] the source field
   /// @param target [out] the target field
   virtual void interpolate_field_from_to(const Field& source, Field& target);
 
-  /// Create the octtree for fast searching in which element a coordinate can be found
-  void create_bounding_box();
+  /// Compute the stencil and weights of every row of the target that is found in the source mesh
+  void compute_stencils(const Field& source, const Field& target);
+
+  /// Store the stencil and weights of one row of the target
+  void add_stencil(const Uint target_row, const std::vector<Uint>& source_rows, const std::vector<Real>& weights);
+
+  /// Forget the stored stencils
+  void clear_stencils();
 
-  void create_octtree();
+  /// Forget the stored stencils when a mesh changes
+  void on_mesh_changed_event( common::SignalArgs& args );
 
-  /// Given a coordinate, find which box in the octtree it is located in
-  /// @param coordinate [in]  The coordinate to look for
-  /// @param point_idx  [out] box location in the octtree (i,j,k)
-  /// @return true if the coordinate is found inside the honeycomb
-  bool find_point_in_octtree(const RealVector& coordinate, std::vector<Uint>& point_idx);
+  /// Compute the bounding box of the source mesh
+  void create_bounding_box();
+
+  /// @return true if the coordinate is inside the bounding box of the source mesh
+  bool is_in_bounding_box(const RealVector& coordinate) const;
 
-  /// Find the pointcloud of minimum "nb_points" points
-  /// It is assumed that first "find_comb_idx(coordinate)" is called
-  /// @param nb_points [in] the minimum number of points in the point cloud
-  void find_pointcloud(Uint nb_points);
+  /// Find the cloud of the "nb_elems" elements nearest to a coordinate, in m_element_cloud
+  /// @param coordinate [in] the coordinate
+  /// @param nb_elems   [in] the number of elements in the cloud
+  void find_element_cloud(const RealVector& coordinate, const Uint nb_elems);
 
   /// Find one single element in which the given coordinate resides.
   /// @param target_coord [in] the given coordinate
@@ -99,24 +104,30 @@ private: // data
 
   Handle< Mesh > m_source_mesh;
 
-  Pointcloud m_pointcloud;
-  Honeycomb m_honeycomb;
-
   Uint m_dim;
   enum {MIN=0,MAX=1};
   std::vector< RealVector3, Eigen::aligned_allocator<RealVector3> > m_bounding;
-  std::vector<Uint> m_N;
-  std::vector<Real> m_D;
-  std::vector<Uint> m_point_idx;
-
-  Uint m_nb_elems;
 
   Uint m_sufficient_nb_points;
 
-  Handle<UnifiedData> m_elements;
+  /// Adaptive tree over the elements of the source mesh
+  Handle<ElementTree> m_element_tree;
 
   std::vector<Uint> m_element_cloud;
 
+  /// Dictionaries the stencils were computed for, and their sizes at that time
+  Handle< Dictionary const > m_stencil_source;
+  Handle< Dictionary const > m_stencil_target;
+  Uint m_stencil_source_size;
+  Uint m_stencil_target_size;
+
+  /// Stencils in compressed row storage: the target rows, and for every one
+  /// the source rows from m_stencil_offsets[i] to m_stencil_offsets[i+1] with their weights
+  std::vector<Uint> m_stencil_targets;
+  std::vector<Uint> m_stencil_offsets;
+  std::vector<Uint> m_stencil_sources;
+  std::vector<Real> m_stencil_weights;
+
 }; // end LinearInterpolator
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -71,7 +71,8 @@ void LoadMesh::update_list_of_available_readers()
   const std::vector<std::string> known_readers = boost::assign::list_of
     ("cf3.mesh.CGNS.Reader")
     ("cf3.mesh.gmsh.Reader")
-    ("cf3.mesh.neu.Reader");
+    ("cf3.mesh.neu.Reader")
+    ("cf3.mesh.native.Reader");
 
   boost_foreach(const std::string& reader_name, known_readers)
   {
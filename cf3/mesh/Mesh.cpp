@@ -444,5 +444,16 @@ void Mesh::raise_mesh_loaded()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Mesh::raise_mesh_about_to_change()
+{
+  SignalOptions options;
+  options.add_option("mesh_uri", uri());
+
+  SignalArgs f= options.create_frame();
+  Core::instance().event_handler().raise_event( "mesh_about_to_change", f );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
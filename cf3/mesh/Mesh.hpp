@@ -95,6 +95,10 @@ public: // functions
 
   void raise_mesh_loaded();
 
+  /// Raise the event "mesh_about_to_change", so that components still reading the mesh,
+  /// such as asynchronous mesh writers, finish before it is modified
+  void raise_mesh_about_to_change();
+
 private: // data
 
   Uint m_dimension;
@@ -181,6 +181,7 @@ MeshAdaptor::~MeshAdaptor()
 
 void MeshAdaptor::prepare()
 {
+  m_mesh->raise_mesh_about_to_change();
 //  std::cout << PERank << "preparing mesh_adaptor" << std::endl;
 //  make_element_node_connectivity_global();
 //  std::cout << PERank << "  - node_connectivity_global" << std::endl;
@@ -874,41 +875,7 @@ void MeshAdaptor::move_elements(const std::vector< std::vector< std::vector<Uint
 
   // 6) Remove unused nodes
   //PECheckArrivePoint(100,"removing unused nodes");
-
-  for (Uint dict_idx=0; dict_idx<nb_dicts; ++dict_idx)
-  {
-    //std::cout << PERank << "removing unused nodes " << std::endl;
-
-    Dictionary& dict = *m_mesh->dictionaries()[dict_idx];
-
-    // Assemble set of used nodes, that will be checked for later
-    std::set<boost::uint64_t> used_nodes;
-
-    // check in dict.entities_range(), in case perhaps other meshes use the same dictionary (future?)
-    cf3_assert(dict.entities_range().size() != 0);
-    boost_foreach (const Handle<Entities>& entities, dict.entities_range())
-    {
-      //std::cout << entities->uri() << std::endl;
-      Space& space = entities->space(dict);
-      for (Uint elem=0; elem<space.size(); ++elem)
-      {
-        // Element-node connectivity tables must be GLOBAL
-        boost_foreach( Uint glb_node, space.connectivity()[elem] )
-        {
-          used_nodes.insert(glb_node);
-        }
-      }
-    }
-
-    // Remove unused nodes
-    for (Uint node_idx=0; node_idx<dict.size(); ++node_idx)
-    {
-      if ( used_nodes.count(dict.glb_idx()[node_idx]) == 0 )
-      {
-        remove_node(dict_idx,node_idx);
-      }
-    }
-  }
+  remove_unused_nodes();
 
   // 7) Flush nodes and rebuild glb_to_loc map
 //  CFdebug << "Flush nodes and rebuild glb_to_loc map" << CFendl;
@@ -980,6 +947,69 @@ void MeshAdaptor::move_elements(const std::vector< std::vector< std::vector<Uint
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void MeshAdaptor::remove_unused_nodes()
+{
+  cf3_assert(is_node_connectivity_global);
+  for (Uint dict_idx=0; dict_idx<m_mesh->dictionaries().size(); ++dict_idx)
+  {
+    //std::cout << PERank << "removing unused nodes " << std::endl;
+
+    Dictionary& dict = *m_mesh->dictionaries()[dict_idx];
+
+    // Assemble set of used nodes, that will be checked for later
+    std::set<boost::uint64_t> used_nodes;
+
+    // check in dict.entities_range(), in case perhaps other meshes use the same dictionary (future?)
+    cf3_assert(dict.entities_range().size() != 0);
+    boost_foreach (const Handle<Entities>& entities, dict.entities_range())
+    {
+      //std::cout << entities->uri() << std::endl;
+      Space& space = entities->space(dict);
+      for (Uint elem=0; elem<space.size(); ++elem)
+      {
+        // Element-node connectivity tables must be GLOBAL
+        boost_foreach( Uint glb_node, space.connectivity()[elem] )
+        {
+          used_nodes.insert(glb_node);
+        }
+      }
+    }
+
+    // Remove unused nodes
+    for (Uint node_idx=0; node_idx<dict.size(); ++node_idx)
+    {
+      if ( used_nodes.count(dict.glb_idx()[node_idx]) == 0 )
+      {
+        remove_node(dict_idx,node_idx);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MeshAdaptor::remove_overlap()
+{
+  // Procedure:
+  // 1) make element-node connectivity global, as nodes will be removed
+  // 2) remove ghost elements, flush elements
+  // 3) remove nodes that are no longer used by any element
+  // 4) flush nodes
+  // 5) fix rank of nodes: lowest rank that is found is assigned
+
+  make_element_node_connectivity_global();
+
+  remove_ghost_elements();
+  flush_elements();
+
+  remove_unused_nodes();
+  flush_nodes();
+
+  fix_node_ranks();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void MeshAdaptor::fix_node_ranks()
 {
   CFdebug << "MeshAdaptor: fix node ranks" << CFendl;
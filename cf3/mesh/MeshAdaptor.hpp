@@ -16,7 +16,7 @@
 
 #include "common/List.hpp"
 #include "common/Table.hpp"
-#include "common/DynTable.hpp"
+#include "common/CompressedTable.hpp"
 
 namespace cf3 {
 namespace mesh {
@@ -157,6 +157,15 @@ public:
   ///       Call finish() to notify the mesh of updates.
   void grow_overlap();
 
+  /// @brief Remove the overlap between pid's, leaving only the owned elements,
+  /// and the nodes they use
+  ///
+  /// This brings a load-balanced mesh back to the state it had before grow_overlap(),
+  /// so that it can be partitioned again.
+  /// @post nodes and elements are flushed, and node-ranks are uniquely defined in all pid's.
+  ///       Call finish() to notify the mesh of updates.
+  void remove_overlap();
+
   //@}
 
   /// @name Low-level API
@@ -193,6 +202,11 @@ public:
   /// @post Elements are not flushed yet, so additional operations can be performed
   void remove_ghost_elements();
 
+  /// @brief remove nodes that are not used by any element
+  /// @pre Element-node connectivity must be global, and removed elements flushed
+  /// @post Nodes are not flushed yet, so additional operations can be performed
+  void remove_unused_nodes();
+
   // @}
 
 
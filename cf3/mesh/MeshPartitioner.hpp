@@ -14,7 +14,7 @@
 #include "common/FindComponents.hpp"
 #include "common/Map.hpp"
 #include "common/Foreach.hpp"
-#include "common/DynTable.hpp"
+#include "common/CompressedTable.hpp"
 #include "common/Table.hpp"
 #include "common/List.hpp"
 
@@ -100,6 +100,18 @@ public: // functions
   template <typename VectorT>
   void list_of_connected_procs_in_part(const Uint part, VectorT& proc_per_neighbor) const;
 
+  /// Weight of every owned object: 1 for nodes, and the weight of the Entities component for elements
+  template <typename VectorT>
+  void list_of_object_weights_in_part(const Uint part, VectorT& weights) const;
+
+  /// Set the relative compute cost of one element of every Entities component,
+  /// in the order of Mesh::elements(). The partitioner then balances the total weight
+  /// per partition instead of the number of objects. An empty vector disables the weights.
+  void set_element_weights(const std::vector<Uint>& weights) { m_element_weights = weights; }
+
+  /// @return true if element weights were set
+  bool has_weights() const { return !m_element_weights.empty(); }
+
 
 public: // functions
 
@@ -164,6 +176,9 @@ private: // data
 
   Handle< UnifiedData > m_lookup;
 
+  /// weight of one element, per Entities component of the mesh
+  std::vector<Uint> m_element_weights;
+
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -204,7 +219,7 @@ Uint MeshPartitioner::nb_connected_objects_in_part(const Uint part, VectorT& nb_
 
       if (Handle< Dictionary > nodes = Handle<Dictionary>(comp))
       {
-        const common::DynTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
+        const common::CompressedTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
         nb_connections_per_obj[idx] = node_to_glb_elm.row_size(loc_idx);
       }
       else if (Handle< Elements > elements = Handle<Elements>(comp))
@@ -237,7 +252,7 @@ void MeshPartitioner::list_of_connected_objects_in_part(const Uint part, VectorT
       boost::tie(comp,loc_idx) = m_lookup->location(loc_obj);
       if (Handle< Dictionary > nodes = Handle<Dictionary>(comp))
       {
-        const common::DynTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
+        const common::CompressedTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
         boost_foreach (const Uint glb_elm , node_to_glb_elm[loc_idx])
           connected_objects[idx++] = glb_elm;
       }
@@ -273,7 +288,7 @@ void MeshPartitioner::list_of_connected_procs_in_part(const Uint part, VectorT&
       boost::tie(comp,loc_idx) = m_lookup->location(loc_obj);
       if (Handle< Dictionary > nodes = Handle<Dictionary>(comp))
       {
-        const common::DynTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
+        const common::CompressedTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
         boost_foreach (const Uint glb_elm , node_to_glb_elm[loc_idx])
           connected_procs[idx++] = part_of_obj(glb_elm); /// @todo should be proc of obj, not part!!!
       }
@@ -292,6 +307,34 @@ void MeshPartitioner::list_of_connected_procs_in_part(const Uint part, VectorT&
 
 //////////////////////////////////////////////////////////////////////////////
 
+template <typename VectorT>
+void MeshPartitioner::list_of_object_weights_in_part(const Uint part, VectorT& weights) const
+{
+  // declaration for boost::tie
+  Uint comp_idx;
+  Uint loc_idx;
+
+  Uint idx = 0;
+  foreach_container((const Uint glb_obj)(const Uint loc_obj),*m_global_to_local)
+  {
+    if (part_of_obj(glb_obj) == part)
+    {
+      boost::tie(comp_idx,loc_idx) = m_lookup->location_idx(loc_obj);
+      // component 0 of the lookup holds the nodes, the others follow Mesh::elements()
+      if (comp_idx == 0 || m_element_weights.empty())
+        weights[idx++] = 1;
+      else
+      {
+        cf3_assert(comp_idx-1 < m_element_weights.size());
+        weights[idx++] = m_element_weights[comp_idx-1];
+      }
+    }
+  }
+  cf3_assert( idx == nb_objects_owned_by_part(part) );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
 
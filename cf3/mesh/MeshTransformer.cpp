@@ -77,6 +77,7 @@ void MeshTransformer::transform(Handle< Mesh > mesh)
 
 void MeshTransformer::transform(Mesh& mesh)
 {
+  mesh.raise_mesh_about_to_change();
   set_mesh(mesh);
   execute();
 }
@@ -4,6 +4,14 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <deque>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
 #include "common/Log.hpp"
 #include "common/Signal.hpp"
 #include "common/OptionURI.hpp"
@@ -14,6 +22,8 @@
 #include "common/Environment.hpp"
 #include "common/Core.hpp"
 #include "common/FindComponents.hpp"
+#include "common/EventHandler.hpp"
+#include "common/StringConversion.hpp"
 
 #include "mesh/MeshWriter.hpp"
 #include "mesh/MeshMetadata.hpp"
@@ -24,6 +34,7 @@
 #include "mesh/Cells.hpp"
 #include "mesh/Faces.hpp"
 #include "mesh/CellFaces.hpp"
+#include "mesh/Functions.hpp"
 
 namespace cf3 {
 namespace mesh {
@@ -32,8 +43,69 @@ using namespace common;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Buffer writers holding the snapshots, and the thread writing them in the order they were queued
+class MeshWriter::AsynchronousQueue
+{
+public:
+
+  AsynchronousQueue() : nb_buffers(0), stop(false) {}
+
+  /// Write the queued buffers until stop is set and the queue is empty
+  void run()
+  {
+    while (true)
+    {
+      Handle<MeshWriter> buffer;
+      {
+        boost::mutex::scoped_lock lock(mutex);
+        while (pending_buffers.empty() && !stop)
+          condition.wait(lock);
+        if (pending_buffers.empty())
+          return;
+        buffer = pending_buffers.front();
+      }
+
+      std::string error;
+      try
+      {
+        buffer->write();
+      }
+      catch (std::exception& e)
+      {
+        error = buffer->m_file_path.path() + ": " + e.what();
+      }
+
+      {
+        boost::mutex::scoped_lock lock(mutex);
+        if (!error.empty())
+          errors.push_back(error);
+        pending_buffers.pop_front();
+        free_buffers.push_back(buffer);
+      }
+      condition.notify_all();
+    }
+  }
+
+  /// Buffers that are not queued
+  std::deque< Handle<MeshWriter> > free_buffers;
+  /// Queued buffers, the front one is being written
+  std::deque< Handle<MeshWriter> > pending_buffers;
+  /// Number of buffers created
+  Uint nb_buffers;
+  /// Errors of the writes that failed, reported by flush()
+  std::vector<std::string> errors;
+  bool stop;
+
+  boost::mutex mutex;
+  boost::condition_variable condition;
+  boost::scoped_ptr<boost::thread> thread;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 MeshWriter::MeshWriter ( const std::string& name  ) :
-  Action ( name )
+  Action ( name ),
+  m_queue( new AsynchronousQueue() )
 {
   mark_basic();
 
@@ -101,6 +173,22 @@ MeshWriter::MeshWriter ( const std::string& name  ) :
       .mark_basic()
       .link_to(&m_region_filter  .enable_interior_faces)
       .link_to(&m_entities_filter.enable_interior_faces);
+
+  options().add_option("asynchronous", false)
+      .pretty_name("Asynchronous")
+      .description("Write the file in the background, from a snapshot of the fields. "
+                   "Ignored by writers that don't support it.");
+
+  options().add_option("nb_buffers", 2u)
+      .pretty_name("Number of Buffers")
+      .description("Maximum number of snapshots waiting to be written in the background");
+
+  regist_signal( "flush" )
+      .connect( boost::bind( &MeshWriter::signal_flush, this, _1 ) )
+      .description("Wait until all files are written by the background thread")
+      .pretty_name("Flush");
+
+  Core::instance().event_handler().connect_to_event("mesh_about_to_change", this, &MeshWriter::on_mesh_about_to_change_event);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -142,8 +230,37 @@ void MeshWriter::config_regions()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void MeshWriter::config_entities()
+{
+  // Configure the fields to write
+  config_fields();
+
+  // Configure the regions to write
+  config_regions();
+
+  m_filtered_entities.clear();
+  boost_foreach(const Handle<Region const>& region, m_regions)
+    boost_foreach(const Entities& entities, find_components_recursively_with_filter<Entities>(*region,m_entities_filter))
+      m_filtered_entities.push_back(entities.handle<Entities>());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 MeshWriter::~MeshWriter()
 {
+  if (!m_queue->thread)
+    return;
+
+  // The thread writes the queued buffers before it stops
+  {
+    boost::mutex::scoped_lock lock(m_queue->mutex);
+    m_queue->stop = true;
+  }
+  m_queue->condition.notify_all();
+  m_queue->thread->join();
+
+  boost_foreach(const std::string& error, m_queue->errors)
+    CFerror << "Asynchronous write failed: " << error << CFendl;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -154,25 +271,185 @@ void MeshWriter::execute()
   if (is_null(m_mesh))
     throw SetupError(FromHere(),"Mesh was not configured in mesh-writer ["+uri().string()+"]");
 
-  CFinfo << "Writing mesh " << m_file_path << CFendl;
+  if (options().option("asynchronous").value<bool>() && supports_asynchronous_write())
+  {
+    CFinfo << "Writing mesh " << m_file_path << " in the background" << CFendl;
+    execute_asynchronously();
+    return;
+  }
 
-  // Configure the fields to write
-  config_fields();
+  CFinfo << "Writing mesh " << m_file_path << CFendl;
 
-  // Configure the regions to write
-  config_regions();
+  // Earlier writes to the same file have to finish first
+  flush();
 
-  m_filtered_entities.clear();
-  boost_foreach(const Handle<Region const>& region, m_regions)
-    boost_foreach(const Entities& entities, find_components_recursively_with_filter<Entities>(*region,m_entities_filter))
-      m_filtered_entities.push_back(entities.handle<Entities>());
+  config_entities();
+  build_used_nodes();
 
-  // Call implementation
+  // Call implementation on the values of the fields
+  m_snapshots.clear();
   write();
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
+void MeshWriter::execute_asynchronously()
+{
+  const Uint nb_buffers = std::max(options().option("nb_buffers").value<Uint>(), 1u);
+
+  // Take a free buffer, or create one, or wait for the oldest write to finish
+  Handle<MeshWriter> buffer;
+  {
+    boost::mutex::scoped_lock lock(m_queue->mutex);
+    while (m_queue->free_buffers.empty() && m_queue->nb_buffers >= nb_buffers)
+      m_queue->condition.wait(lock);
+    if (!m_queue->free_buffers.empty())
+    {
+      buffer = m_queue->free_buffers.front();
+      m_queue->free_buffers.pop_front();
+    }
+  }
+  if (is_null(buffer))
+  {
+    buffer = Handle<MeshWriter>(create_component("buffer_"+to_str(m_queue->nb_buffers), derived_type_name()));
+    ++m_queue->nb_buffers;
+  }
+
+  // The buffer writes synchronously with the same configuration
+  boost_foreach(const OptionList::OptionStorage_t::value_type& option, options())
+  {
+    if (option.first != "asynchronous" && buffer->options().check(option.first))
+      buffer->options().configure_option(option.first, option.second->value());
+  }
+
+  buffer->config_entities();
+  buffer->take_snapshot();
+  buffer->build_used_nodes();
+
+  {
+    boost::mutex::scoped_lock lock(m_queue->mutex);
+    m_queue->pending_buffers.push_back(buffer);
+  }
+  m_queue->condition.notify_all();
+
+  if (!m_queue->thread)
+    m_queue->thread.reset(new boost::thread(boost::bind(&AsynchronousQueue::run, m_queue.get())));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void MeshWriter::take_snapshot()
+{
+  std::vector<const Field*> fields(1, &m_mesh->geometry_fields().coordinates());
+  boost_foreach(const Handle<Field const>& field, m_fields)
+    fields.push_back(field.get());
+
+  // Remove the snapshots of fields that are not written anymore
+  std::map<const Field*, TableArray<Real>::type>::iterator it = m_snapshots.begin();
+  while (it != m_snapshots.end())
+  {
+    if (std::find(fields.begin(), fields.end(), it->first) == fields.end())
+      m_snapshots.erase(it++);
+    else
+      ++it;
+  }
+
+  // Copy the values, reusing the memory of the previous snapshot
+  boost_foreach(const Field* field, fields)
+  {
+    const TableArray<Real>::type& values = field->array();
+    TableArray<Real>::type& snapshot = m_snapshots[field];
+    if (snapshot.shape()[0] != values.shape()[0] || snapshot.shape()[1] != values.shape()[1])
+      snapshot.resize(boost::extents[values.shape()[0]][values.shape()[1]]);
+    snapshot = values;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void MeshWriter::build_used_nodes()
+{
+  const Dictionary& geometry = m_mesh->geometry_fields();
+  m_used_nodes = build_used_nodes_list(m_filtered_entities, geometry, m_enable_overlap);
+  m_entities_used_nodes.clear();
+  boost_foreach(const Handle<Entities const>& entities, m_filtered_entities)
+    m_entities_used_nodes[entities.get()] = build_used_nodes_list(*entities, geometry, m_enable_overlap);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+const List<Uint>& MeshWriter::used_nodes() const
+{
+  cf3_assert(is_not_null(m_used_nodes));
+  return *m_used_nodes;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+const List<Uint>& MeshWriter::used_nodes(const Entities& entities) const
+{
+  std::map<const Entities*, boost::shared_ptr< List<Uint> > >::const_iterator it = m_entities_used_nodes.find(&entities);
+  if (it == m_entities_used_nodes.end())
+    throw ValueNotFound(FromHere(), "Entities ["+entities.uri().string()+"] are not written by mesh-writer ["+uri().string()+"]");
+  return *it->second;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+const TableArray<Real>::type& MeshWriter::field_values(const Field& field) const
+{
+  std::map<const Field*, TableArray<Real>::type>::const_iterator it = m_snapshots.find(&field);
+  if (it != m_snapshots.end())
+    return it->second;
+  return field.array();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void MeshWriter::flush()
+{
+  std::vector<std::string> errors;
+  {
+    boost::mutex::scoped_lock lock(m_queue->mutex);
+    while (!m_queue->pending_buffers.empty())
+      m_queue->condition.wait(lock);
+    errors.swap(m_queue->errors);
+  }
+
+  if (errors.size())
+  {
+    std::string msg = "Asynchronous write failed in mesh-writer ["+uri().string()+"]:";
+    boost_foreach(const std::string& error, errors)
+      msg += "\n - " + error;
+    throw FileSystemError(FromHere(), msg);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void MeshWriter::signal_flush( SignalArgs& node )
+{
+  flush();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void MeshWriter::on_mesh_about_to_change_event( SignalArgs& args )
+{
+  // The mesh is about to be modified, the writes reading it have to finish first.
+  // Failed writes are reported here, as the modification should go on.
+  try
+  {
+    flush();
+  }
+  catch (FileSystemError& e)
+  {
+    CFerror << e.what() << CFendl;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void MeshWriter::write_from_to(const Mesh& mesh, const URI& file_path)
 {
   options().configure_option("mesh",mesh.handle<Mesh const>());
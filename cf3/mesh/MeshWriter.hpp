@@ -9,7 +9,14 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <map>
+
+#include <boost/multi_array.hpp>
+#include <boost/scoped_ptr.hpp>
+
 #include "common/Action.hpp"
+#include "common/Table_fwd.hpp"
+#include "common/List.hpp"
 #include "mesh/LibMesh.hpp"
 
 namespace cf3 {
@@ -26,6 +33,14 @@ namespace mesh {
 /// MeshWriter component class
 /// This class serves as a component that that will write
 /// the mesh to a file
+///
+/// With the option "asynchronous", execute() copies the values of the fields and coordinates
+/// to a snapshot, builds the lists of used nodes, and returns, while the file is written by a background thread.
+/// At most "nb_buffers" snapshots are kept; execute() waits for the oldest write to finish
+/// when all of them are in use. The background thread still reads the connectivity tables, global indices
+/// and ranks of the mesh, so these must not change while writes are pending: writes are flushed on the
+/// event "mesh_about_to_change", raised by MeshTransformer::transform() and MeshAdaptor::prepare()
+/// before they modify a mesh, by flush() and when the writer is destroyed.
 /// @author Willem Deconinck
 class Mesh_API MeshWriter : public common::Action {
 
@@ -43,6 +58,9 @@ public: // functions
 
   // --------- Signals ---------
 
+  /// signal to wait for the pending asynchronous writes
+  void signal_flush( common::SignalArgs& node );
+
   // --------- Direct access ---------
 
   virtual std::string get_format() = 0;
@@ -55,12 +73,46 @@ public: // functions
 
   virtual void write_from_to(const Mesh& mesh, const common::URI& file_path);
 
+  /// Wait until all pending asynchronous writes are finished
+  /// @throws common::FileSystemError if one of them failed
+  void flush();
+
+  /// @return true if write() only reads the field values through field_values(),
+  ///         so it can run in the background on a snapshot
+  virtual bool supports_asynchronous_write() const { return false; }
+
+protected: // functions
+
+  /// Values of a field to write: the snapshot of the field for an asynchronous write,
+  /// or the values of the field itself
+  const common::TableArray<Real>::type& field_values(const Field& field) const;
+
+  /// Nodes of the geometry used by all the filtered entities, built before write() is called
+  const common::List<Uint>& used_nodes() const;
+
+  /// Nodes of the geometry used by one of the filtered entities, built before write() is called
+  const common::List<Uint>& used_nodes(const Entities& entities) const;
+
 private: // functions
 
   virtual void write() {};
 
   void config_fields();  ///< configure fields from URI's
   void config_regions(); ///< configure regions from URI's
+  void config_entities(); ///< configure fields, regions and the filtered entities
+
+  /// Copy the values of the configured fields and of the coordinates
+  void take_snapshot();
+
+  /// Build the lists of used nodes of the filtered entities.
+  /// This allocates components, so it is done on the calling thread and not in the background.
+  void build_used_nodes();
+
+  /// Configure a buffer writer with a snapshot of the data to write, and queue it
+  void execute_asynchronously();
+
+  /// Triggered when the event mesh_about_to_change is raised, waits for the pending writes
+  void on_mesh_about_to_change_event( common::SignalArgs& args );
 
 private:
 
@@ -92,6 +144,21 @@ protected:
   std::vector<Handle<Entities const> > m_filtered_entities;  ///< Handle to selected entities
   bool                                 m_enable_overlap;     ///< If true, writing of overlap will be enabled
 
+private:
+
+  /// Snapshots of the field values, for a buffer of an asynchronous write
+  std::map<const Field*, common::TableArray<Real>::type> m_snapshots;
+
+  /// Nodes used by all the filtered entities
+  boost::shared_ptr< common::List<Uint> > m_used_nodes;
+
+  /// Nodes used by each of the filtered entities
+  std::map<const Entities*, boost::shared_ptr< common::List<Uint> > > m_entities_used_nodes;
+
+  /// Buffers and background thread of the asynchronous writes
+  class AsynchronousQueue;
+  boost::scoped_ptr<AsynchronousQueue> m_queue;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -9,7 +9,7 @@
 
 #include "mesh/FaceCellConnectivity.hpp"
 #include "mesh/UnifiedData.hpp"
-#include "common/DynTable.hpp"
+#include "common/CompressedTable.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -54,13 +54,13 @@ public:
   void setup(Region& region);
 
   /// Build the connectivity table
-  /// Build the connectivity table as a DynTable<Uint>
+  /// Build the connectivity table as a CompressedTable<Face2Cell>
   /// @pre set_nodes() and set_elements() must have been called
   void build_connectivity();
 
   /// const access to the node to element connectivity table in unified indices
-  common::DynTable<Face2Cell>& connectivity() { return *m_connectivity; }
-  const common::DynTable<Face2Cell>& connectivity() const { return *m_connectivity; }
+  common::CompressedTable<Face2Cell>& connectivity() { return *m_connectivity; }
+  const common::CompressedTable<Face2Cell>& connectivity() const { return *m_connectivity; }
 
   Uint size() const { return connectivity().size(); }
 //private: //functions
@@ -82,7 +82,7 @@ private: // data
   Handle<common::Link> m_nodes;
 
   /// Actual connectivity table
-  Handle< common::DynTable<Face2Cell> > m_connectivity;
+  Handle< common::CompressedTable<Face2Cell> > m_connectivity;
 
 }; // Node2FaceCellConnectivity
 
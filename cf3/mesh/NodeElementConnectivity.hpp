@@ -9,7 +9,7 @@
 
 #include "mesh/Elements.hpp"
 #include "mesh/UnifiedData.hpp"
-#include "common/DynTable.hpp"
+#include "common/CompressedTable.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -54,7 +54,7 @@ public:
   void setup(Region& region);
 
   /// Build the connectivity table
-  /// Build the connectivity table as a DynTable<Uint>
+  /// Build the connectivity table as a CompressedTable<Uint>
   /// @pre set_nodes() and set_elements() must have been called
   void build_connectivity();
 
@@ -63,8 +63,8 @@ public:
 
 
   /// const access to the node to element connectivity table in unified indices
-  common::DynTable<Uint>& connectivity() { return *m_connectivity; }
-  const common::DynTable<Uint>& connectivity() const { return *m_connectivity; }
+  common::CompressedTable<Uint>& connectivity() { return *m_connectivity; }
+  const common::CompressedTable<Uint>& connectivity() const { return *m_connectivity; }
 
 private: //functions
 
@@ -81,7 +81,7 @@ private: // data
   Handle< UnifiedData > m_elements;
 
   /// Actual connectivity table
-  Handle< common::DynTable<Uint> > m_connectivity;
+  Handle< common::CompressedTable<Uint> > m_connectivity;
 
 }; // NodeElementConnectivity
 
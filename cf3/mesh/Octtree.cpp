@@ -24,6 +24,7 @@
 
 #include "mesh/UnifiedData.hpp"
 #include "mesh/Octtree.hpp"
+#include "mesh/ElementTree.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/Region.hpp"
 #include "mesh/Elements.hpp"
@@ -70,6 +71,7 @@ Octtree::Octtree( const std::string& name )
 
   m_elements = create_component<UnifiedData>("elements");
   m_bounding_box = create_component<BoundingBox>("bounding_box");
+  m_element_tree = create_component<ElementTree>("element_tree");
 }
 
 
@@ -149,6 +151,9 @@ void Octtree::create_octtree()
     }
   }
 
+  m_element_tree->options().configure_option("mesh",m_mesh);
+  m_element_tree->build();
+
 
   // Uint total=0;
   //
@@ -194,17 +199,14 @@ void Octtree::find_cell_ranks( const boost::multi_array<Real,2>& coordinates, st
 {
   ranks.resize(coordinates.size());
 
-  Handle< Elements > element_component;
-  Uint element_idx;
   std::deque<Uint> missing_cells;
 
-  RealVector dummy(m_dim);
+  std::vector<Uint> found;
+  find_elements(coordinates,found);
 
   for(Uint i=0; i<coordinates.size(); ++i)
   {
-    for (Uint d=0; d<m_dim; ++d)
-      dummy[d] = coordinates[i][d];
-    if( find_element(dummy,element_component,element_idx) )
+    if( found[i] != math::Consts::uint_max() )
     {
       ranks[i] = Comm::instance().rank();
     }
@@ -236,9 +238,7 @@ void Octtree::find_cell_ranks( const boost::multi_array<Real,2>& coordinates, st
 
     if (root!=Comm::instance().rank())
     {
-      std::vector<RealVector> recv_coordinates(recv_coords.size()/m_dim) ;
-      boost_foreach(RealVector& realvec, recv_coordinates)
-          realvec.resize(m_dim);
+      boost::multi_array<Real,2> recv_coordinates(boost::extents[recv_coords.size()/m_dim][m_dim]);
 
       c=0;
       for (Uint i=0; i<recv_coordinates.size(); ++i)
@@ -247,10 +247,12 @@ void Octtree::find_cell_ranks( const boost::multi_array<Real,2>& coordinates, st
           recv_coordinates[i][d]=recv_coords[c++];
       }
 
+      find_elements(recv_coordinates,found);
+
       send_found.resize(recv_coordinates.size());
       for (Uint i=0; i<recv_coordinates.size(); ++i)
       {
-        if( find_element(recv_coordinates[i],element_component,element_idx) )
+        if( found[i] != math::Consts::uint_max() )
         {
           send_found[i] = Comm::instance().rank();
         }
@@ -407,55 +409,23 @@ boost::tuple<Handle< Elements >,Uint> Octtree::find_element(const RealVector& ta
 
 bool Octtree::find_element(const RealVector& target_coord, Handle< Elements >& element_component, Uint& element_idx)
 {
-  if (m_octtree.num_elements() == 0)
-    create_octtree();
-  if (find_octtree_cell(target_coord,m_octtree_idx))
-  {
-    std::vector<Uint> unified_elements(0); unified_elements.reserve(16);
-
-    Handle< Component > component;
-    Uint elem_idx;
-
-    gather_elements_around_idx(m_octtree_idx,0,unified_elements);
+  return element_tree().find_element(target_coord,element_component,element_idx);
+}
 
-    boost_foreach(const Uint unif_elem_idx, unified_elements)
-    {
-      boost::tie(component,elem_idx)=m_elements->location(unif_elem_idx);
-      Elements& elements = dynamic_cast<Elements&>(*component);
-      const RealMatrix elem_coordinates = elements.geometry_space().get_coordinates(elem_idx);
-      if (elements.element_type().is_coord_in_element(target_coord,elem_coordinates))
-      {
-        element_component = Handle<Elements>(elements.handle<Component>());
-        element_idx = elem_idx;
-        cf3_assert(is_not_null(element_component));
-        return true;
-      }
-    }
+////////////////////////////////////////////////////////////////////////////////
 
-    // if arrived here, it means no element has been found. Enlarge the search with one more ring, for possible misses.
-    unified_elements.resize(0); unified_elements.reserve(16);
-    gather_elements_around_idx(m_octtree_idx,1,unified_elements);
+void Octtree::find_elements(const boost::multi_array<Real,2>& coordinates, std::vector<Uint>& unified_elems)
+{
+  element_tree().find_elements(coordinates,unified_elems);
+}
 
-    boost_foreach(const Uint unif_elem_idx, unified_elements)
-    {
-      boost::tie(component,elem_idx)=m_elements->location(unif_elem_idx);
-      Elements& elements = dynamic_cast<Elements&>(*component);
-      const RealMatrix elem_coordinates = elements.geometry_space().get_coordinates(elem_idx);
-      if (elements.element_type().is_coord_in_element(target_coord,elem_coordinates))
-      {
-        element_component = Handle<Elements>(elements.handle<Component>());
-        element_idx = elem_idx;
-        cf3_assert(is_not_null(element_component));
-        return true;
-      }
-    }
+////////////////////////////////////////////////////////////////////////////////
 
-  }
-  // if arrived here, it means no element has been found. Give up.
-  element_component.reset();
-  cf3_assert(is_null(element_component));
-  CFdebug << "coord " << target_coord.transpose() << " has not been found in any cell registered in the bounding box" << CFendl;
-  return false;
+const ElementTree& Octtree::element_tree()
+{
+  if (m_octtree.num_elements() == 0)
+    create_octtree();
+  return *m_element_tree;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -22,6 +22,7 @@ namespace mesh {
 
   class Mesh;
   class UnifiedData;
+  class ElementTree;
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -57,6 +58,16 @@ public: // functions
 
   bool find_element(const RealVector& target_coord, Handle< Elements >& element_component, Uint& element_idx);
 
+  /// Find the elements in which many coordinates reside, in one pass over the element tree
+  /// @param coordinates   [in]  the coordinates, one per row
+  /// @param unified_elems [out] unified index of the element of every coordinate, or math::Consts::uint_max() if not found
+  /// @see element_tree() for the numbering of the elements
+  void find_elements(const boost::multi_array<Real,2>& coordinates, std::vector<Uint>& unified_elems);
+
+  /// The adaptive tree over the element bounding boxes, used to locate coordinates.
+  /// The uniform cells of the octtree only serve find_octtree_cell() and gather_elements_around_idx().
+  const ElementTree& element_tree();
+
   /// Given a coordinate, find which box in the octtree it is located in
   /// @param coordinate  [in]  The coordinate to look for
   /// @param octtree_idx [out] location of the box (i,j,k) in which the coordinate sits
@@ -102,6 +113,8 @@ private: // data
   Handle<UnifiedData> m_elements;
   Handle<Mesh> m_mesh;
 
+  Handle<ElementTree> m_element_tree;
+
   std::vector<Uint> m_octtree_idx;
 
 }; // end Octtree
@@ -23,6 +23,7 @@
 #include "mesh/Field.hpp"
 #include "mesh/Space.hpp"
 #include "mesh/Octtree.hpp"
+#include "mesh/ElementTree.hpp"
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -65,7 +66,6 @@ void StencilComputerOcttree::configure_mesh()
 
 void StencilComputerOcttree::compute_stencil(const Uint unified_elem_idx, std::vector<Uint>& stencil)
 {
-  std::vector<Uint> octtree_cell(3);
   RealVector centroid(m_dim);
   Handle< Component > component;
   Uint elem_idx;
@@ -73,16 +73,9 @@ void StencilComputerOcttree::compute_stencil(const Uint unified_elem_idx, std::v
   Elements& elements = dynamic_cast<Elements&>(*component);
   RealMatrix coordinates = elements.geometry_space().get_coordinates(elem_idx);
   elements.element_type().compute_centroid(coordinates,centroid);
-  stencil.resize(0);
-  if (m_octtree->find_octtree_cell(centroid,octtree_cell))
-  {
-    for (Uint ring=0; stencil.size() < m_min_stencil_size; ++ring)
-    {
-      m_octtree->gather_elements_around_idx(octtree_cell,ring,stencil);
-      if (stencil.size() >= m_nb_elems_in_mesh )
-        return;
-    }
-  }
+
+  // The element tree numbers the elements as unified_elements()
+  m_octtree->element_tree().find_nearest_elements(centroid,m_min_stencil_size,stencil);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
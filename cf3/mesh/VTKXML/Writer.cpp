@@ -19,6 +19,7 @@
 #include "common/Foreach.hpp"
 #include "common/Log.hpp"
 #include "common/PE/Comm.hpp"
+#include "common/PE/Aggregation.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
 #include "common/Builder.hpp"
@@ -192,6 +193,18 @@ namespace detail
     }
   }
 
+  // Recursively add a shift to the offsets of the appended data arrays
+  void shift_offsets(XmlNode& node, const Uint shift)
+  {
+    if(node.content->first_attribute("offset"))
+      node.set_attribute("offset", to_str(from_str<Uint>(node.attribute_value("offset")) + shift));
+    XmlNode child;
+    for (child.content = node.content->first_node(); child.is_valid() ; child.content = child.content->next_sibling() )
+    {
+      shift_offsets(child, shift);
+    }
+  }
+
 } // namespace detail
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -206,6 +219,19 @@ Writer::Writer( const std::string& name )
     options().add_option("distributed_files", false)
     .pretty_name("Distributed Files")
     .description("Indicate if the filesystem is local to each note. When true, the pvtu file is written on each node.");
+
+    options().add_option("nb_aggregators", 0u)
+    .pretty_name("Number of Aggregators")
+    .description("Number of vtu files, each one written by a process with the pieces of a group of consecutive processes. "
+                 "0 means every process writes its own file.");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool Writer::supports_asynchronous_write() const
+{
+  // aggregation communicates between the processes
+  return options().option("nb_aggregators").value<Uint>() == 0;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -222,11 +248,14 @@ std::vector<std::string> Writer::get_extensions()
 
 void Writer::write()
 {
-  // Path for the file written by the current node
+  // Processes are grouped per file, every file is written by the first process of its group
+  const PE::Aggregation aggregation(options().option("nb_aggregators").value<Uint>());
+
+  // Path for the file of the group of the current node, which is the rank without aggregation
   URI my_path(m_file_path.path());
   const URI my_dir = my_path.base_path();
   const std::string basename = my_path.base_name();
-  my_path = my_dir / (basename + "_P" + to_str(PE::Comm::instance().rank()) + ".vtu");
+  my_path = my_dir / (basename + "_P" + to_str(aggregation.group()) + ".vtu");
 
   XmlDoc doc("1.0", "ISO-8859-1");
 
@@ -239,9 +268,10 @@ void Writer::write()
 
   XmlNode unstructured_grid = vtkfile.add_node("UnstructuredGrid");
 
-  const Field& coords = m_mesh->geometry_fields().coordinates();
-  const Uint npoints = coords.size();
-  const Uint dim = coords.row_size();
+  const Field& coords_field = m_mesh->geometry_fields().coordinates();
+  const common::TableArray<Real>::type& coords = field_values(coords_field);
+  const Uint npoints = coords_field.size();
+  const Uint dim = coords_field.row_size();
 
   // map for element types
   std::map<GeoShape::Type,int> etype_map = boost::assign::map_list_of
@@ -365,6 +395,7 @@ void Writer::write()
   boost_foreach(Handle<Field const> field_ptr, m_fields)
   {
     const Field& field = *field_ptr;
+    const common::TableArray<Real>::type& values = field_values(field);
 
     if(!added_fields.insert(field.uri().string()).second)
       continue;
@@ -397,7 +428,7 @@ void Writer::write()
           {
             for(Uint j = var_begin; j != var_end; ++j)
             {
-              appended_data.push_back(field[i][j]);
+              appended_data.push_back(values[i][j]);
             }
             appended_data.push_back(0.);
           }
@@ -406,7 +437,7 @@ void Writer::write()
         {
           for(Uint i = 0; i != field_size; ++i)
             for(Uint j = var_begin; j != var_end; ++j)
-              appended_data.push_back(field[i][j]);
+              appended_data.push_back(values[i][j]);
         }
       }
       else
@@ -424,7 +455,7 @@ void Writer::write()
                 for(Uint j = var_begin; j != var_end; ++j)
                 {
                   /// @bug the field values of the space should be interpolated to the cell-centre, similar to the tecplot writer
-                  appended_data.push_back(field[field_connectivity[i][0]][j]);
+                  appended_data.push_back(values[field_connectivity[i][0]][j]);
                 }
                 appended_data.push_back(0.);
               }
@@ -436,7 +467,7 @@ void Writer::write()
                 for(Uint j = var_begin; j != var_end; ++j)
                 {
                   /// @bug the field values of the space should be interpolated to the cell-centre, similar to the tecplot writer
-                  appended_data.push_back(field[field_connectivity[i][0]][j]);
+                  appended_data.push_back(values[field_connectivity[i][0]][j]);
                 }
               }
             }
@@ -448,25 +479,68 @@ void Writer::write()
     }
   }
 
-  // Write to file, inserting the binary data at the end
-  std::cout << "writing file " << my_path.path() << std::endl;
-  boost::filesystem::fstream fout(my_path.path(), std::ios_base::out | std::ios_base::binary);
+  // The appended data of a group is concatenated, so offsets are shifted past the data of the previous processes
+  if(aggregation.is_aggregating())
+  {
+    std::vector<Uint> data_sizes;
+    PE::Comm::instance().all_gather(appended_data.offset(), data_sizes);
+    Uint shift = 0;
+    for(Uint i = aggregation.group_begin(aggregation.group()); i != PE::Comm::instance().rank(); ++i)
+      shift += data_sizes[i];
+    detail::shift_offsets(piece, shift);
+  }
+
+  if(aggregation.is_aggregator())
+  {
+    const Uint group_end = aggregation.group_end(aggregation.group());
+
+    // Write to file, inserting the binary data at the end
+    std::cout << "writing file " << my_path.path() << std::endl;
+    boost::filesystem::fstream fout(my_path.path(), std::ios_base::out | std::ios_base::binary);
+
+    // Remove the closing tags, to add the pieces of the other processes of the group
+    std::string xml_string;
+    to_string(doc, xml_string);
+    boost::algorithm::erase_last(xml_string, "</VTKFile>");
+    boost::algorithm::trim_right(xml_string);
+    boost::algorithm::erase_last(xml_string, "</UnstructuredGrid>");
+    boost::algorithm::trim_right(xml_string);
+
+    // Write XML meta data
+    fout << xml_string;
+
+    std::string piece_string;
+    for(Uint i = PE::Comm::instance().rank() + 1; i < group_end; ++i)
+    {
+      aggregation.receive(i, piece_string);
+      fout << "\n" << piece_string;
+    }
+    fout << "\n</UnstructuredGrid>";
 
-  // Remove the closing tag
-  std::string xml_string;
-  to_string(doc, xml_string);
-  boost::algorithm::erase_last(xml_string, "</VTKFile>");
-  boost::algorithm::trim_right(xml_string);
+    // Append  compressed data
+    fout << "\n<AppendedData encoding=\"raw\">\n";
+    fout << appended_data.data_stream.rdbuf();
 
-  // Write XML meta data
-  fout << xml_string;
+    std::vector<char> data;
+    for(Uint i = PE::Comm::instance().rank() + 1; i < group_end; ++i)
+    {
+      aggregation.receive(i, data);
+      fout.write(data.empty() ? 0 : &data[0], data.size());
+    }
+    fout << "\n</AppendedData>\n</VTKFile>\n";
 
-  // Append  compressed data
-  fout << "\n<AppendedData encoding=\"raw\">\n";
-  fout << appended_data.data_stream.rdbuf();
-  fout << "\n</AppendedData>\n</VTKFile>\n";
+    fout.close();
+  }
+  else
+  {
+    // Send the piece and the appended data, without the leading _, to the aggregator
+    std::string piece_string;
+    to_string(piece, piece_string);
+    aggregation.send(piece_string);
 
-  fout.close();
+    const std::string data = appended_data.data_stream.str();
+    aggregation.send(data.data() + 1, data.size() - 1);
+  }
 
   // Write the parallel header, if needed
   if(PE::Comm::instance().rank() == 0 || options().option("distributed_files").value<bool>())
@@ -488,7 +562,7 @@ void Writer::write()
     detail::make_pvtu(punstruc);
     punstruc.set_attribute("GhostLevel", "0");
 
-    for(Uint i = 0; i != PE::Comm::instance().size(); ++i)
+    for(Uint i = 0; i != aggregation.nb_groups(); ++i)
     {
       const std::string piece_path = basename + "_P" + to_str(i) + ".vtu";
       punstruc.add_node("Piece").set_attribute("Source", piece_path);
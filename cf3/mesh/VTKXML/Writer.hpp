@@ -24,6 +24,9 @@ namespace VTKXML {
 //////////////////////////////////////////////////////////////////////////////
 
 /// This class defines VTKXML mesh format writer
+/// Every process writes a piece in its own vtu file, listed in a pvtu file.
+/// With the option "nb_aggregators", the pieces of a group of processes are gathered in one vtu file,
+/// written by the first process of the group.
 /// @author Bart Janssens
 class VTKXML_API Writer : public MeshWriter
 {
@@ -45,6 +48,9 @@ public: // functions
   virtual std::string get_format() { return "VTKXML"; }
 
   virtual std::vector<std::string> get_extensions();
+
+  /// @return false when aggregating, which communicates between the processes
+  virtual bool supports_asynchronous_write() const;
 }; // end Writer
 
 
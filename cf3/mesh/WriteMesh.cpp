@@ -73,6 +73,11 @@ WriteMesh::WriteMesh ( const std::string& name  ) :
       .mark_basic()
       .link_to(&m_fields);
 
+  options().add_option("asynchronous", false)
+      .description("Write the files of supporting formats in the background, from a snapshot of the fields")
+      .pretty_name("Asynchronous")
+      .mark_basic();
+
 
   // signals
 
@@ -82,6 +87,11 @@ WriteMesh::WriteMesh ( const std::string& name  ) :
       .connect ( boost::bind ( &WriteMesh::signal_write_mesh, this, _1 ) )
       .signature(boost::bind(&WriteMesh::signature_write_mesh, this, _1));
 
+  regist_signal ( "flush" )
+      .description( "Wait until all files are written by the background threads of the writers" )
+      .pretty_name("Flush" )
+      .connect ( boost::bind ( &WriteMesh::signal_flush, this, _1 ) );
+
   signal("create_component")->hidden(true);
   signal("rename_component")->hidden(true);
   signal("delete_component")->hidden(true);
@@ -106,24 +116,29 @@ void WriteMesh::update_list_of_available_writers()
     ("cf3.mesh.CGNS.Writer")
     ("cf3.mesh.gmsh.Writer")
     ("cf3.mesh.neu.Writer")
+    ("cf3.mesh.native.Writer")
     ("cf3.mesh.tecplot.Writer")
     ("cf3.mesh.VTKLegacy.Writer")
     ("cf3.mesh.VTKXML.Writer");
 
   boost_foreach(const std::string& writer_name, known_writers)
   {
-    if(is_not_null(get_child(writer_name)))
-      remove_component(writer_name);
-    
-    boost::shared_ptr<MeshWriter> writer = boost::dynamic_pointer_cast<MeshWriter>(build_component_nothrow(writer_name, writer_name));
-    
+    // existing writers are kept, as they may still be writing in the background
+    Handle<MeshWriter> writer(get_child(writer_name));
+
     if(is_null(writer))
-      continue;
-    
-    add_component(writer);
-  
+    {
+      boost::shared_ptr<MeshWriter> new_writer = boost::dynamic_pointer_cast<MeshWriter>(build_component_nothrow(writer_name, writer_name));
+
+      if(is_null(new_writer))
+        continue;
+
+      add_component(new_writer);
+      writer = new_writer->handle<MeshWriter>();
+    }
+
     boost_foreach(const std::string& extension, writer->get_extensions())
-      m_extensions_to_writers[extension].push_back(writer->handle<MeshWriter>());
+      m_extensions_to_writers[extension].push_back(writer);
   }
 }
 
@@ -232,6 +247,7 @@ void WriteMesh::write_mesh( const Mesh& mesh, const URI& file, const std::vector
   writer->options().configure_option("fields",fields);
   writer->options().configure_option("mesh",mesh.handle<Mesh>());
   writer->options().configure_option("file", filepath);
+  writer->options().configure_option("asynchronous", options().option("asynchronous").value<bool>());
 
   writer->execute();
 
@@ -240,6 +256,21 @@ void WriteMesh::write_mesh( const Mesh& mesh, const URI& file, const std::vector
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void WriteMesh::flush()
+{
+  boost_foreach(MeshWriter& writer, find_components<MeshWriter>(*this))
+    writer.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void WriteMesh::signal_flush ( common::SignalArgs& node )
+{
+  flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void WriteMesh::signal_write_mesh ( common::SignalArgs& node )
 {
   SignalOptions options( node );
@@ -49,6 +49,8 @@ public: // functions
   void signal_write_mesh ( common::SignalArgs& node );
   /// signature of signal to write the mesh
   void signature_write_mesh ( common::SignalArgs& node);
+  /// signal to wait for the files written in the background
+  void signal_flush ( common::SignalArgs& node );
 
   //@} END SIGNALS
 
@@ -60,6 +62,9 @@ public: // functions
   /// writes all the fields on the mesh
   void write_mesh( const Mesh&, const common::URI& file);
 
+  /// wait until the writers finished writing in the background
+  void flush();
+
   virtual void execute();
 
 protected: // helper functions
@@ -0,0 +1,286 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cmath>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/bind.hpp>
+
+#include "common/Builder.hpp"
+#include "common/Core.hpp"
+#include "common/EventHandler.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Signal.hpp"
+#include "common/TimedComponent.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "common/XML/SignalOptions.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/MeshAdaptor.hpp"
+
+#include "mesh/actions/DynamicLoadBalance.hpp"
+#include "mesh/actions/LoadBalance.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+using namespace common;
+using namespace common::PE;
+using namespace common::XML;
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < DynamicLoadBalance, MeshTransformer, mesh::actions::LibActions> DynamicLoadBalance_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+DynamicLoadBalance::DynamicLoadBalance( const std::string& name ) :
+  MeshTransformer(name)
+{
+  properties()["brief"] = std::string("Load balance the mesh again, weighted with the measured compute cost");
+  std::string desc;
+  desc =
+    "  Usage: DynamicLoadBalance timed_actions:array[uri]=action1,action2 imbalance_threshold:real=0.1\n\n"
+    "The time spent in the timed actions is attributed to the elements they loop over on every rank.\n"
+    "When the slowest rank spends more time than the mean by more than the threshold,\n"
+    "the mesh is partitioned again with these costs as element weights, and migrated with all its fields.\n"
+    "The timed actions should not communicate, the time of the SynchronizeFields actions in them is not counted.\n";
+  properties()["description"] = desc;
+
+  properties().add_property("imbalance", Real(0.));
+
+  options().add_option("timed_actions", std::vector<URI>())
+      .description("Actions whose timings measure the compute cost of the elements they loop over")
+      .pretty_name("Timed Actions")
+      .attach_trigger(boost::bind(&DynamicLoadBalance::reset_measurements, this))
+      .mark_basic();
+
+  options().add_option("imbalance_threshold", 0.1)
+      .description("Load balance again when the time of the slowest rank exceeds the mean by this fraction")
+      .pretty_name("Imbalance Threshold")
+      .mark_basic();
+
+  m_load_balance = create_static_component<LoadBalance>("load_balance");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void DynamicLoadBalance::reset_measurements()
+{
+  m_previous_times.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void DynamicLoadBalance::elements_of_action(Component& action, std::vector<bool>& covered) const
+{
+  const Mesh& mesh = *m_mesh;
+
+  std::vector<URI> element_uris;
+  if (action.options().check("regions"))
+  {
+    const boost::any regions = action.options().option("regions").value();
+    if (const std::vector<URI>* uris = boost::any_cast< std::vector<URI> >(&regions))
+      element_uris = *uris;
+  }
+  if (element_uris.empty() && action.options().check("elements"))
+  {
+    const boost::any elements = action.options().option("elements").value();
+    if (const URI* uri = boost::any_cast<URI>(&elements))
+      element_uris.push_back(*uri);
+  }
+
+  bool found = false;
+  boost_foreach (const URI& element_uri, element_uris)
+  {
+    Handle<Component> comp = action.access_component(element_uri);
+    if (is_null(comp))
+      continue;
+
+    for (Uint c=0; c<mesh.elements().size(); ++c)
+    {
+      const Entities& entities = *mesh.elements()[c];
+      // the elements are covered if they are the component, or one of its children
+      if (&entities == comp.get() || boost::algorithm::starts_with(entities.uri().path(), comp->uri().path()+"/") )
+      {
+        covered[c] = true;
+        found = true;
+      }
+    }
+  }
+
+  // actions without regions are assumed to loop over all elements
+  if (!found)
+    covered.assign(mesh.elements().size(), true);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Real DynamicLoadBalance::total_time(const Component& action)
+{
+  const Uint count = action.properties().value<Uint>("timer_count");
+  return count ? action.properties().value<Real>("timer_mean") * count : 0.;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Real DynamicLoadBalance::synchronization_time(Component& action, const bool warn) const
+{
+  // SynchronizeFields is in the solver library, which depends on this one
+  Real time = 0.;
+  boost_foreach (Component& child, find_components_recursively(action))
+  {
+    if (child.derived_type_name() != "cf3.solver.actions.SynchronizeFields" || !child.properties().check("timer_count"))
+      continue;
+    time += total_time(child);
+    if (warn)
+      CFwarn << "Timed action " << action.uri().string() << " synchronizes fields in " << child.uri().string()
+             << ": its time is not counted as compute cost" << CFendl;
+  }
+  return time;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void DynamicLoadBalance::execute()
+{
+  Mesh& mesh = *m_mesh;
+
+  // only a distributed mesh can be balanced
+  if ( !Comm::instance().is_active() || Comm::instance().size() == 1 )
+    return;
+
+  const std::vector<URI> action_uris = options()["timed_actions"].value< std::vector<URI> >();
+  if (action_uris.empty())
+    throw SetupError(FromHere(), "Option \"timed_actions\" of " + uri().string() + " is not configured");
+
+  std::vector< Handle<Component> > actions;
+  actions.reserve(action_uris.size());
+  boost_foreach (const URI& action_uri, action_uris)
+  {
+    Handle<Component> action = access_component(action_uri);
+    if (is_null(action))
+      throw ValueNotFound(FromHere(), "Timed action " + action_uri.string() + " does not exist");
+
+    store_timings(*action);
+    if (!action->properties().check("timer_count"))
+    {
+      CFwarn << "Action " << action->uri().string() << " is not timed: dynamic load balancing requires CF3_ENABLE_COMPONENT_TIMING" << CFendl;
+      return;
+    }
+    actions.push_back(action);
+  }
+
+  // the measurements start again, warn once about the synchronizations in the timed actions
+  const bool first_measurement = m_previous_times.size() != actions.size();
+  if (first_measurement)
+    m_previous_times.assign(actions.size(), 0.);
+
+  const Uint nb_actions = actions.size();
+  const Uint nb_entities = mesh.elements().size();
+
+  // Time of every action since the previous execution, spread over the elements it covers on this rank.
+  // Elements that take longer on this rank get a higher cost, so that the slowest rank gives away elements.
+  // The time of the synchronizations is removed: ranks waiting for the slowest one would look slow too.
+  std::vector<Real> cost(nb_entities, 0.);
+  Real loc_time = 0.;
+  std::vector<bool> covered(nb_entities);
+  for (Uint a=0; a<nb_actions; ++a)
+  {
+    const Real compute_time = total_time(*actions[a]) - synchronization_time(*actions[a], first_measurement);
+    const Real time = std::max(0., compute_time - m_previous_times[a]);
+    m_previous_times[a] = compute_time;
+    loc_time += time;
+
+    covered.assign(nb_entities, false);
+    elements_of_action(*actions[a], covered);
+    Uint nb_elems = 0;
+    for (Uint c=0; c<nb_entities; ++c)
+    {
+      if (covered[c])
+        nb_elems += mesh.elements()[c]->size();
+    }
+    if (nb_elems == 0)
+      continue;
+
+    const Real cost_per_elem = time / static_cast<Real>(nb_elems);
+    for (Uint c=0; c<nb_entities; ++c)
+    {
+      if (covered[c])
+        cost[c] += cost_per_elem;
+    }
+  }
+
+  Real glb_time;
+  Comm::instance().all_reduce(PE::plus(), &loc_time, 1, &glb_time);
+  Real max_rank_time;
+  Comm::instance().all_reduce(PE::max(), &loc_time, 1, &max_rank_time);
+
+  // Imbalance as the excess of the slowest rank over the mean
+  const Real mean_rank_time = glb_time / static_cast<Real>(Comm::instance().size());
+  const Real imbalance = mean_rank_time > 0. ? max_rank_time / mean_rank_time - 1. : 0.;
+  properties()["imbalance"] = imbalance;
+
+  CFinfo << "load imbalance of mesh " << mesh.uri().string() << ": " << 100.*imbalance << "%" << CFendl;
+  if (imbalance <= options()["imbalance_threshold"].value<Real>())
+    return;
+
+  // Partitioners take integer weights: scale such that an element of mean cost has weight 100.
+  // Nodes have weight 1, so that they hardly contribute.
+  Real loc_cost_and_size[2] = {0., 0.};
+  for (Uint c=0; c<nb_entities; ++c)
+  {
+    loc_cost_and_size[0] += cost[c] * mesh.elements()[c]->size();
+    loc_cost_and_size[1] += mesh.elements()[c]->size();
+  }
+  Real glb_cost_and_size[2];
+  Comm::instance().all_reduce(PE::plus(), loc_cost_and_size, 2, glb_cost_and_size);
+  const Real mean_cost = glb_cost_and_size[1] > 0. ? glb_cost_and_size[0] / glb_cost_and_size[1] : 0.;
+
+  std::vector<Uint> weights(nb_entities, 1u);
+  if (mean_cost > 0.)
+  {
+    for (Uint c=0; c<nb_entities; ++c)
+      weights[c] = std::max(1u, static_cast<Uint>(std::floor(100. * cost[c] / mean_cost + 0.5)));
+  }
+
+  CFinfo << "rebalancing mesh " << mesh.uri().string() << CFendl;
+
+  // Only owned elements are partitioned, the overlap is grown again after migration
+  CFinfo << "  + removing overlap layer ..." << CFendl;
+  MeshAdaptor mesh_adaptor(mesh);
+  mesh_adaptor.prepare();
+  mesh_adaptor.remove_overlap();
+  mesh_adaptor.finish();
+  CFinfo << "  + removing overlap layer ... done" << CFendl;
+
+  m_load_balance->set_element_weights(weights);
+  m_load_balance->transform(mesh);
+  m_load_balance->set_element_weights(std::vector<Uint>());
+
+  // raise an event to indicate that the mesh was rebalanced (changed)
+  SignalOptions event_options;
+  event_options.add_option("mesh_uri", mesh.uri());
+  event_options.add_option("mesh_rebalanced", true);
+  SignalArgs args = event_options.create_frame();
+  Core::instance().event_handler().raise_event( "mesh_changed", args);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
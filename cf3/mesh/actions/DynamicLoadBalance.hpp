@@ -0,0 +1,89 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_actions_DynamicLoadBalance_hpp
+#define cf3_mesh_actions_DynamicLoadBalance_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshTransformer.hpp"
+
+#include "mesh/actions/LibActions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+  class LoadBalance;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Load balance a distributed mesh again during a run, using the measured compute cost
+///
+/// The compute cost is measured with the timings of the actions given in "timed_actions",
+/// which are only available when compiled with CF3_ENABLE_COMPONENT_TIMING.
+/// The time spent in an action since the previous execution is attributed to the elements
+/// the action loops over, given by its option "regions" or "elements", or to all elements
+/// of the mesh if it has neither. This gives a cost per element of every Entities component
+/// on every rank, which is higher on the ranks that are slow to process their elements.
+/// The timed actions must not communicate: a rank waiting for a slower one in a collective
+/// operation or a synchronization measures the time of the slower rank, which hides the imbalance.
+/// The time of the SynchronizeFields actions inside a timed action is subtracted, with a warning,
+/// but other communication (e.g. Field::synchronize() or reductions called directly) can't be detected.
+///
+/// If the time spent on the slowest rank exceeds the mean over all ranks by more than
+/// "imbalance_threshold", the overlap is removed, and the mesh is partitioned again with
+/// the costs as element weights. Elements and nodes are migrated together with the values
+/// of all fields, the overlap is grown again, and the "mesh_changed" event is raised.
+/// The measured imbalance is stored in the property "imbalance".
+class mesh_actions_API DynamicLoadBalance : public MeshTransformer
+{
+public: // functions
+
+  /// constructor
+  DynamicLoadBalance( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "DynamicLoadBalance"; }
+
+  virtual void execute();
+
+private: // functions
+
+  /// Mark the Entities components of the mesh an action loops over
+  /// @param [out] covered  flag per Entities component, in the order of Mesh::elements()
+  void elements_of_action(common::Component& action, std::vector<bool>& covered) const;
+
+  /// Total time spent in a timed action
+  static Real total_time(const common::Component& action);
+
+  /// Total time spent in the SynchronizeFields actions below a timed action
+  /// @param [in] warn  warn about every synchronization action that is found
+  Real synchronization_time(common::Component& action, const bool warn) const;
+
+  /// Start measuring again when the timed actions change
+  void reset_measurements();
+
+private: // data
+
+  Handle<LoadBalance> m_load_balance;
+
+  /// Time spent in every timed action at the previous execution, without the synchronizations
+  std::vector<Real> m_previous_times;
+
+}; // end DynamicLoadBalance
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_actions_DynamicLoadBalance_hpp
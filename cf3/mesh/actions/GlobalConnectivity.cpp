@@ -8,6 +8,7 @@
 #include <boost/static_assert.hpp>
 
 #include "common/Log.hpp"
+#include "common/CompressedTable.hpp"
 #include "common/Builder.hpp"
 
 #include "common/FindComponents.hpp"
@@ -141,7 +142,7 @@ void GlobalConnectivity::execute()
     {
       ghostnode_glb_idx[cnt] = nodes_glb_idx[i];
 
-      DynTable<Uint>::ConstRow elems = node2elem.connectivity()[i];
+      CompressedTable<Uint>::ConstRow elems = node2elem.connectivity()[i];
       boost_foreach(const Uint e, elems)
       {
         boost::tie(elem_comp,elem_idx) = node2elem.elements().location(e);
@@ -191,32 +192,30 @@ void GlobalConnectivity::execute()
   }
 
 
-  DynTable<Uint>& nodes_glb_elem_connectivity = mesh.geometry_fields().glb_elem_connectivity();
+  CompressedTable<Uint>& nodes_glb_elem_connectivity = mesh.geometry_fields().glb_elem_connectivity();
 //  CFinfo << "nodes_glb_elem_connectivity = " << nodes_glb_elem_connectivity.uri() << CFendl;
-  nodes_glb_elem_connectivity.resize(glb_elem_connectivity.size());
+  cf3_assert(glb_elem_connectivity.size() == node2elem.connectivity().size());
+  nodes_glb_elem_connectivity.start_build(glb_elem_connectivity.size());
+  for (Uint i=0; i<glb_elem_connectivity.size(); ++i)
+    nodes_glb_elem_connectivity.count(i, glb_elem_connectivity[i].size() + node2elem.connectivity().row_size(i));
+  nodes_glb_elem_connectivity.allocate();
   for (Uint i=0; i<glb_elem_connectivity.size(); ++i)
   {
 //    CFinfo << "i = " << i << CFendl;
-    cf3_assert(i<node2elem.connectivity().size());
-    DynTable<Uint>::ConstRow elems = node2elem.connectivity()[i];
-    cf3_assert(i<nodes_glb_elem_connectivity.size());
-    cf3_assert(i<glb_elem_connectivity.size());
-    nodes_glb_elem_connectivity[i].resize(glb_elem_connectivity[i].size() + elems.size());
-    cnt = 0;
-    boost_foreach(const Uint e, elems)
+    boost_foreach(const Uint e, node2elem.connectivity()[i])
     {
       cf3_assert(e<node2elem.elements().size());
       boost::tie(elem_comp,elem_idx) = node2elem.elements().location(e);
       cf3_assert(elem_idx < Handle<Elements>(elem_comp)->glb_idx().size());
-      nodes_glb_elem_connectivity[i][cnt++] = Handle<Elements>(elem_comp)->glb_idx()[elem_idx];
+      nodes_glb_elem_connectivity.push_back(i, Handle<Elements>(elem_comp)->glb_idx()[elem_idx]);
     }
     for (Uint j=0; j<glb_elem_connectivity[i].size(); ++j)
     {
-      cf3_assert(cnt < nodes_glb_elem_connectivity[i].size());
-      nodes_glb_elem_connectivity[i][cnt++] = glb_elem_connectivity[i][j];
+      nodes_glb_elem_connectivity.push_back(i, glb_elem_connectivity[i][j]);
     }
 
   }
+  nodes_glb_elem_connectivity.finish_build();
 
 }
 
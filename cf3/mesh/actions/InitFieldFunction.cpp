@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
 
@@ -61,6 +63,10 @@ InitFieldFunction::InitFieldFunction( const std::string& name )
       .attach_trigger ( boost::bind ( &InitFieldFunction::config_function, this ) )
       .mark_basic();
 
+  options().add_option("nb_threads", 1u)
+      .pretty_name("Number of Threads")
+      .description("Number of OpenMP threads evaluating the functions");
+
   m_function.variables("x,y,z");
 
 }
@@ -88,29 +94,40 @@ void InitFieldFunction::execute()
 
   Field& field = *m_field;
 
-  std::vector<Real> vars(3,0.);
+  const Uint nb_vars = m_function.nbvars();
+  const Uint nb_funcs = m_function.nbfuncs();
+  const Uint row_size = field.row_size();
+  if (nb_funcs > row_size)
+    throw BadValue(FromHere(), "["+uri().path()+"] has more functions than field ["+field.uri().path()+"] has variables");
+  const Uint nb_threads = options()["nb_threads"].value<Uint>();
 
-  RealVector return_val(field.row_size());
+  // Points are evaluated in chunks, to keep the copies of their coordinates small
+  const Uint chunk_size = 65536;
+  std::vector<Real> vars;
 
   if (field.continuous())
   {
     const Uint nb_pts = field.size();
     Field& coordinates = field.coordinates();
-    for ( Uint idx=0; idx!=nb_pts; ++idx)
+    for ( Uint begin=0; begin<nb_pts; begin+=chunk_size)
     {
-      Field::ConstRow coords = coordinates[idx];
-      for (Uint i=0; i<coords.size(); ++i)
-        vars[i] = coords[i];
-
-      m_function.evaluate(vars,return_val);
+      const Uint nb_chunk_pts = std::min(chunk_size, nb_pts-begin);
+      vars.assign(nb_chunk_pts*nb_vars, 0.);
+      for ( Uint pt=0; pt!=nb_chunk_pts; ++pt)
+      {
+        Field::ConstRow coords = coordinates[begin+pt];
+        for (Uint i=0; i<coords.size(); ++i)
+          vars[pt*nb_vars+i] = coords[i];
+      }
 
-      Field::Row field_row = field[idx];
-      for (Uint i=0; i<field_row.size(); ++i)
-        field_row[i] = return_val[i];
+      // the rows of the field are contiguous, so the results are stored in place
+      m_function.evaluate_batch(nb_chunk_pts, &vars[0], nb_vars, field.array().data()+begin*row_size, row_size, nb_threads);
     }
   }
   else
   {
+    std::vector<Real> values;
+    std::vector<Uint> points;
     boost_foreach( const Handle<Entities>& elements_handle, field.entities_range() )
     {
       Entities& elements = *elements_handle;
@@ -118,19 +135,36 @@ void InitFieldFunction::execute()
       RealMatrix coordinates;
       space.allocate_coordinates(coordinates);
       const Connectivity& field_connectivity = space.connectivity();
-      for (Uint elem_idx = 0; elem_idx<elements.size(); ++elem_idx)
+      const Uint nb_states = space.shape_function().nb_nodes();
+      const Uint nb_chunk_elems = std::max(1u, chunk_size/nb_states);
+      for (Uint begin = 0; begin<elements.size(); begin+=nb_chunk_elems)
       {
-        coordinates = space.compute_coordinates(elem_idx);
-        /// for each state of the field shape function
-        for (Uint iState=0; iState<space.shape_function().nb_nodes(); ++iState)
+        const Uint end = std::min(begin+nb_chunk_elems, elements.size());
+        const Uint nb_chunk_pts = (end-begin)*nb_states;
+        vars.assign(nb_chunk_pts*nb_vars, 0.);
+        points.resize(nb_chunk_pts);
+        Uint pt = 0;
+        for (Uint elem_idx = begin; elem_idx<end; ++elem_idx)
+        {
+          coordinates = space.compute_coordinates(elem_idx);
+          /// for each state of the field shape function, the physical coordinates
+          for (Uint iState=0; iState<nb_states; ++iState, ++pt)
+          {
+            for (Uint d=0; d<coordinates.cols(); ++d)
+              vars[pt*nb_vars+d] = coordinates.row(iState)[d];
+            points[pt] = field_connectivity[elem_idx][iState];
+          }
+        }
+
+        /// evaluate the function for the whole chunk
+        values.resize(nb_chunk_pts*nb_funcs);
+        m_function.evaluate_batch(nb_chunk_pts, &vars[0], nb_vars, &values[0], nb_funcs, nb_threads);
+
+        /// put the return values in the field
+        for (pt=0; pt<nb_chunk_pts; ++pt)
         {
-          /// evaluate the function using the physical coordinates
-          for (Uint d=0; d<coordinates.cols(); ++d)
-            vars[d] = coordinates.row(iState)[d];
-          m_function.evaluate(vars,return_val);
-          /// put the return values in the field
-          for (Uint i=0; i<field.row_size(); ++i)
-            field[field_connectivity[elem_idx][iState]][i] = return_val[i];
+          for (Uint i=0; i<nb_funcs; ++i)
+            field[points[pt]][i] = values[pt*nb_funcs+i];
         }
       }
     }
@@ -20,7 +20,7 @@
 #include "mesh/Space.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/ShapeFunction.hpp"
-#include "mesh/Octtree.hpp"
+#include "mesh/InterpolationOperator.hpp"
 #include "mesh/Connectivity.hpp"
 
 #include "mesh/actions/Interpolate.hpp"
@@ -155,193 +155,14 @@ void Interpolate::interpolate(const Field& source, const common::Table<Real>& co
     target.resize(coordinates.size());
   }
 
-  Mesh& source_mesh = find_parent_component<Mesh>(source);
+  if ( is_null(m_operator) )
+    m_operator = create_component<InterpolationOperator>("operator");
 
-  if ( is_null(m_octtree) )
-    m_octtree = create_component<Octtree>("octtree");
+  if ( !m_operator->is_built_for(source.dict(),coordinates) )
+    m_operator->build(source.dict(),coordinates);
 
-  if ( m_octtree->options().option("mesh").value< Handle<Mesh> >() != source_mesh.handle<Mesh>() )
-  {
-    m_octtree->options().configure_option("mesh",source_mesh.handle<Mesh>());
-    m_octtree->create_octtree();
-  }
-  const Uint dimension = source_mesh.dimension();
-  const Uint nb_vars = source.row_size();
   m_source = Handle<Field const>(source.handle<Component>());
-
-  Handle< Elements > element_component;
-  Uint element_idx;
-  std::deque<Uint> missing_cells;
-
-  RealVector coord(dimension); coord.setZero();
-  const Uint target_dim = coordinates.row_size();
-
-  for(Uint i=0; i<coordinates.size(); ++i)
-  {
-    for (Uint d=0; d<target_dim; ++d)
-      coord[d] = coordinates[i][d];
-    if( m_octtree->find_element(coord,element_component,element_idx) )
-    {
-      cf3_assert(is_not_null(element_component));
-      interpolate_coordinate( coord, *element_component, element_idx, target[i] );
-//      std::cout<< PERank << "interpolate for coord (" << coord.transpose() << ") in " << element_component->uri().path() << "["<<element_idx<<"] ... done" << std::endl;
-    }
-    else
-    {
-//      std::cout << PERank<< "coord " << coord.transpose() << " not found " << std::endl;
-      for (Uint v=0; v<nb_vars; ++v)
-        target[i][v] = math::Consts::real_max();
-      missing_cells.push_back(i);
-    }
-  }
-
-  std::vector<Real> send_coords(target_dim*missing_cells.size());
-  std::vector<Real> recv_coords;
-
-  Uint c(0);
-  boost_foreach(const Uint i, missing_cells)
-  {
-    for(Uint d=0; d<target_dim; ++d)
-      send_coords[c++]=coordinates[i][d];
-  }
-
-  for (Uint root=0; root<PE::Comm::instance().size(); ++root)
-  {
-
-//    if (root == PE::Comm::instance().rank())
-//    {
-//      std::cout << PERank << "send coords = ";
-//      for(Uint i=0; i<send_coords.size(); ++i)
-//         std::cout << send_coords[i] << " ";
-//      std::cout << std::endl;
-//    }
-    recv_coords.resize(0);
-    PE::Comm::instance().broadcast(send_coords,recv_coords,root,target_dim);
-
-//    if (root != PE::Comm::instance().rank())
-//    {
-//      std::cout << PERank << "recv coords = ";
-//      for(Uint i=0; i<recv_coords.size(); ++i)
-//         std::cout << recv_coords[i] << " ";
-//      std::cout << std::endl;
-//    }
-
-
-    // size is only because it doesn't get resized for this rank
-    std::vector<Real> send_target_rows(nb_vars*missing_cells.size(),math::Consts::uint_max());
-
-    if (root!=Comm::instance().rank())
-    {
-      std::vector<RealVector> recv_coordinates(recv_coords.size()/target_dim) ;
-      boost_foreach(RealVector& realvec, recv_coordinates)
-          realvec.resize(target_dim);
-
-      c=0;
-      for (Uint i=0; i<recv_coordinates.size(); ++i)
-      {
-        for(Uint d=0; d<target_dim; ++d)
-          recv_coordinates[i][d]=recv_coords[c++];
-      }
-
-      send_target_rows.resize(recv_coordinates.size()*nb_vars);
-      for (Uint i=0; i<recv_coordinates.size(); ++i)
-      {
-        for (Uint d=0; d<target_dim; ++d)
-          coord[d] = recv_coordinates[i][d];
-
-        if( m_octtree->find_element(coord,element_component,element_idx) )
-        {
-//          std::cout<< PERank << " send to " << root << ": interpolate for coord (" << coord.transpose() << ") in " << element_component->uri().path() << "["<<element_idx<<"]" << std::endl;
-          boost::multi_array<Real,2> target_row(boost::extents[1][nb_vars]);
-          interpolate_coordinate( coord, *element_component, element_idx, target_row[0] );
-          for (Uint v=0; v<nb_vars; ++v)
-            send_target_rows[i*nb_vars+v] = target_row[0][v];
-        }
-        else
-        {
-//          std::cout << PERank<< " send to " << root << ": coord " << coord.transpose() << " not found " << std::endl;
-          for (Uint v=0; v<nb_vars; ++v)
-            send_target_rows[i*nb_vars+v] = math::Consts::real_max();
-        }
-      }
-    }
-
-    std::vector<Real> recv_target_rows(nb_vars*missing_cells.size()*Comm::instance().size());
-    PE::Comm::instance().gather(send_target_rows,recv_target_rows,root);
-
-    if( root==Comm::instance().rank())
-    {
-      const Uint nb_cells = missing_cells.size();
-      for (Uint i=0; i<missing_cells.size(); ++i)
-      {
-        for(Uint p=0; p<Comm::instance().size(); ++p)
-        {
-          for(Uint v=0; v<nb_vars;  ++v)
-            target[missing_cells[i]][v] = std::min(recv_target_rows[v+nb_vars*(i+p*nb_cells)] , target[missing_cells[i]][v]);
-        }
-      }
-    } // endif root==rank
-  } // end foreach root
-
-
-  missing_cells.clear();
-  for (Uint i=0; i<target.size(); ++i)
-  {
-    bool found = true;
-    for (Uint v=0; v<target.row_size(); ++v)
-    {
-      if (target[i][v] == math::Consts::uint_max())
-      {
-        target[i][v] = 0.;
-        found &= false;
-      }
-    }
-    if (!found)
-      missing_cells.push_back(i);
-  }
-  if(missing_cells.size())
-  {
-    std::cout << PERank << "could not interpolate " << missing_cells.size() << " coordinates because point was not found on source mesh. Values set to zero for coordinates : ";
-    for(Uint i=0; i<missing_cells.size(); ++i)
-    {
-      std::cout << "(";
-      for(Uint d=0; d<target_dim; ++d)
-      {
-        if (d!=0) std::cout << " ";
-        std::cout << coordinates[missing_cells[i]][d];
-      }
-      std::cout << ")  ";
-    }
-    std::cout << std::endl;
-  }
-
-}
-
-//////////////////////////////////////////////////////////////////////////////
-
-void Interpolate::interpolate_coordinate(const RealVector& target_coord, const Elements& element_component, const Uint element_idx, Field::Row target_row)
-{
-  cf3_assert(is_null(m_source) == false);
-  const Field& source = *m_source;
-  const Space& source_space = source.space(element_component);
-  const ShapeFunction& sf = source_space.shape_function();
-
-  RealMatrix source_nodes(element_component.element_type().nb_nodes(),element_component.element_type().dimension());
-  element_component.geometry_space().put_coordinates(source_nodes,element_idx);
-  RealVector local_coord(sf.dimensionality());
-  element_component.element_type().compute_mapped_coordinate(target_coord,source_nodes,local_coord);
-  RealRowVector sf_value(sf.nb_nodes());
-  sf.compute_value(local_coord,sf_value);
-
-  Connectivity::ConstRow source_indexes = source_space.connectivity()[element_idx];
-  for(Uint v=0; v<target_row.size(); ++v)
-  {
-    target_row[v]=0.;
-    for(Uint i=0; i<source_indexes.size(); ++i)
-    {
-      target_row[v] += source[source_indexes[i]][v] * sf_value[i];
-    }
-  }
+  m_operator->apply(source,target);
 }
 
 //////////////////////////////////////////////////////////////////////////////
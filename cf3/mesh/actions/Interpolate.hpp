@@ -20,7 +20,7 @@
 namespace cf3 {
 namespace mesh {
 
-  class Octtree;
+  class InterpolationOperator;
   class Field;
   class Elements;
 
@@ -56,6 +56,8 @@ public: // functions
   /// @post target is resized: row-size from source, nb_rows from coordinates
   /// @note MPI communication is used if coordinates are not found on this rank. Other ranks
   ///       then interpolate and send result back
+  /// @note The donors and weights are computed the first time, and reused as long as the
+  ///       dictionary of source and the coordinates don't change (see InterpolationOperator)
   void interpolate(const Field& source, const common::Table<Real>& coordinates, common::Table<Real>& target);
 
   void signal_interpolate ( common::SignalArgs& node);
@@ -69,10 +71,8 @@ private:
   /// target field
   Handle<Field> m_target;
 
-  /// source octtree
-  Handle<Octtree> m_octtree;
-
-  void interpolate_coordinate(const RealVector& target_coord, const Elements& element_component, const Uint element_idx, Field::Row target_row);
+  /// precomputed weights from the source dictionary to the coordinates
+  Handle<InterpolationOperator> m_operator;
 
 
 }; // end Interpolate
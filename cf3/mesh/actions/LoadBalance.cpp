@@ -15,6 +15,7 @@
 
 #include "mesh/actions/LoadBalance.hpp"
 #include "mesh/Mesh.hpp"
+#include "mesh/MeshPartitioner.hpp"
 #include "mesh/Region.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -131,6 +132,15 @@ void LoadBalance::execute()
 
 //////////////////////////////////////////////////////////////////////////////
 
+void LoadBalance::set_element_weights(const std::vector<Uint>& weights)
+{
+  Handle<MeshPartitioner> partitioner(m_partitioner);
+  if ( is_not_null(partitioner) )
+    partitioner->set_element_weights(weights);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 
 } // actions
 } // mesh
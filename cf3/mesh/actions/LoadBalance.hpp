@@ -42,6 +42,10 @@ public: // functions
 
   virtual void execute();
 
+  /// Set the relative compute cost of one element of every Entities component of the mesh,
+  /// in the order of Mesh::elements(). The partitioner balances the total cost per partition.
+  void set_element_weights(const std::vector<Uint>& weights);
+
 private:
 
   Handle<MeshTransformer> m_partitioner;
@@ -0,0 +1,321 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "common/Builder.hpp"
+#include "common/CompressedTable.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/List.hpp"
+#include "common/Log.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Table.hpp"
+
+#include "common/PE/CommPattern.hpp"
+
+#include "math/Hilbert.hpp"
+
+#include "mesh/actions/Renumber.hpp"
+#include "mesh/BoundingBox.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/NodeElementConnectivity.hpp"
+#include "mesh/Space.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < Renumber, MeshTransformer, mesh::actions::LibActions> Renumber_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+
+/// Sorting key of a row: owned rows first, then along the space filling curve
+struct RowKey
+{
+  RowKey() {}
+  RowKey(const bool ghost_, const boost::uint64_t key_, const Uint idx_) : ghost(ghost_), key(key_), idx(idx_) {}
+
+  bool operator<(const RowKey& other) const
+  {
+    if (ghost != other.ghost)
+      return other.ghost;
+    if (key != other.key)
+      return key < other.key;
+    return idx < other.idx;
+  }
+
+  bool ghost;
+  boost::uint64_t key;
+  Uint idx;
+};
+
+/// Sort the keys, and return for each new row the old row
+std::vector<Uint> sorted_order(std::vector<RowKey>& keys)
+{
+  std::sort(keys.begin(),keys.end());
+  std::vector<Uint> new_to_old(keys.size());
+  for (Uint i=0; i<keys.size(); ++i)
+    new_to_old[i] = keys[i].idx;
+  return new_to_old;
+}
+
+/// All spaces of the mesh defined in a dictionary, in order of the mesh elements
+std::vector< Handle<Space> > spaces_in_dict(const Mesh& mesh, const Dictionary& dict)
+{
+  std::vector< Handle<Space> > spaces;
+  boost_foreach(const Handle<Entities>& entities, mesh.elements())
+  {
+    boost_foreach(const Handle<Space>& space, entities->spaces())
+    {
+      if (&space->dict() == &dict)
+        spaces.push_back(space);
+    }
+  }
+  return spaces;
+}
+
+bool is_identity(const std::vector<Uint>& new_to_old)
+{
+  for (Uint i=0; i<new_to_old.size(); ++i)
+    if (new_to_old[i] != i)
+      return false;
+  return true;
+}
+
+/// Reorder the rows of a table
+template <typename T>
+void permute_rows(common::Table<T>& table, const std::vector<Uint>& new_to_old)
+{
+  cf3_assert(table.size() == new_to_old.size());
+  const Uint row_size = table.row_size();
+  if (table.size() == 0 || row_size == 0)
+    return;
+  T* data = table.array().data();
+  const std::vector<T> old_data(data, data+table.size()*row_size);
+  for (Uint i=0; i<new_to_old.size(); ++i)
+    std::copy(old_data.begin()+new_to_old[i]*row_size, old_data.begin()+(new_to_old[i]+1)*row_size, data+i*row_size);
+}
+
+/// Reorder the entries of a list
+template <typename T>
+void permute_rows(common::List<T>& list, const std::vector<Uint>& new_to_old)
+{
+  cf3_assert(list.size() == new_to_old.size());
+  if (list.size() == 0)
+    return;
+  T* data = list.array().data();
+  const std::vector<T> old_data(data, data+list.size());
+  for (Uint i=0; i<new_to_old.size(); ++i)
+    data[i] = old_data[new_to_old[i]];
+}
+
+/// Reorder the rows of a compressed table
+template <typename T>
+void permute_rows(common::CompressedTable<T>& table, const std::vector<Uint>& new_to_old)
+{
+  cf3_assert(table.size() == new_to_old.size());
+  const std::vector<Uint> old_offsets = table.offsets();
+  const std::vector<T> old_values = table.values();
+  table.start_build(new_to_old.size());
+  for (Uint i=0; i<new_to_old.size(); ++i)
+    table.count(i,old_offsets[new_to_old[i]+1]-old_offsets[new_to_old[i]]);
+  table.allocate();
+  for (Uint i=0; i<new_to_old.size(); ++i)
+    for (Uint j=old_offsets[new_to_old[i]]; j<old_offsets[new_to_old[i]+1]; ++j)
+      table.push_back(i,old_values[j]);
+  table.finish_build();
+}
+
+} // detail
+
+//////////////////////////////////////////////////////////////////////////////
+
+Renumber::Renumber( const std::string& name ) :
+  MeshTransformer(name)
+{
+  properties()["brief"] = std::string("Reorder nodes and elements along a Hilbert space filling curve");
+  std::string desc;
+  desc =
+    "  Usage: Renumber\n\n"
+    "  Sorts the elements of every Entities component and the nodes of the geometry along\n"
+    "  a Hilbert space filling curve, owned rows before ghost rows. Nodes of other dictionaries\n"
+    "  follow the order of the elements. Global indices are not changed.\n";
+  properties()["description"] = desc;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Renumber::execute()
+{
+  Mesh& mesh = *m_mesh;
+
+  if ( find_components_recursively<FaceCellConnectivity>(mesh).size() )
+    throw SetupError(FromHere(), "Mesh "+mesh.uri().string()+" has face-cell connectivities, which can not be renumbered. "
+                                 "Renumber the mesh before building faces.");
+
+  mesh.update_structures();
+
+  Dictionary& geometry = mesh.geometry_fields();
+  const Field& coordinates = geometry.coordinates();
+  if (coordinates.size() == 0)
+    return;
+
+  boost::shared_ptr<BoundingBox> bounding_box = allocate_component<BoundingBox>("bounding_box");
+  bounding_box->build(coordinates);
+  math::Hilbert hilbert(*bounding_box,20);
+
+  // 1) Elements, sorted by centroid
+  boost_foreach(const Handle<Entities>& entities_handle, mesh.elements())
+  {
+    Entities& entities = *entities_handle;
+    const ElementType& etype = entities.element_type();
+    RealMatrix element_coordinates(etype.nb_nodes(),coordinates.row_size());
+    RealVector centroid(etype.dimension());
+
+    std::vector<detail::RowKey> keys(entities.size());
+    for (Uint e=0; e<entities.size(); ++e)
+    {
+      entities.geometry_space().put_coordinates(element_coordinates,e);
+      etype.compute_centroid(element_coordinates,centroid);
+      keys[e] = detail::RowKey(entities.is_ghost(e),hilbert(centroid),e);
+    }
+    const std::vector<Uint> new_to_old = detail::sorted_order(keys);
+    if ( !detail::is_identity(new_to_old) )
+      renumber_elements(entities,new_to_old);
+  }
+
+  // 2) Geometry nodes, sorted by coordinates
+  {
+    RealVector point(coordinates.row_size());
+    std::vector<detail::RowKey> keys(geometry.size());
+    for (Uint n=0; n<geometry.size(); ++n)
+    {
+      for (Uint d=0; d<coordinates.row_size(); ++d)
+        point[d] = coordinates[n][d];
+      keys[n] = detail::RowKey(geometry.is_ghost(n),hilbert(point),n);
+    }
+    const std::vector<Uint> new_to_old = detail::sorted_order(keys);
+    if ( !detail::is_identity(new_to_old) )
+      renumber_nodes(geometry,new_to_old);
+  }
+
+  // 3) Nodes of other dictionaries, in order of first visit by the elements
+  boost_foreach(const Handle<Dictionary>& dict_handle, mesh.dictionaries())
+  {
+    Dictionary& dict = *dict_handle;
+    if (&dict == &geometry)
+      continue;
+
+    const Uint not_visited = dict.size();
+    std::vector<Uint> first_visit(dict.size(),not_visited);
+    Uint visit=0;
+    boost_foreach(const Handle<Space>& space, detail::spaces_in_dict(mesh,dict))
+    {
+      boost_foreach(Connectivity::ConstRow nodes, space->connectivity().array())
+      {
+        boost_foreach(const Uint node, nodes)
+        {
+          if (first_visit[node] == not_visited)
+            first_visit[node] = visit++;
+        }
+      }
+    }
+
+    std::vector<detail::RowKey> keys(dict.size());
+    for (Uint n=0; n<dict.size(); ++n)
+      keys[n] = detail::RowKey(dict.is_ghost(n),first_visit[n],n);
+    const std::vector<Uint> new_to_old = detail::sorted_order(keys);
+    if ( !detail::is_identity(new_to_old) )
+      renumber_nodes(dict,new_to_old);
+  }
+
+  // 4) Node to element connectivities
+  boost_foreach(const Handle<Dictionary>& dict, mesh.dictionaries())
+    dict->rebuild_node_to_element_connectivity();
+  boost_foreach(NodeElementConnectivity& node2elem, find_components_recursively<NodeElementConnectivity>(mesh))
+    node2elem.build_connectivity();
+
+  mesh.update_structures();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Renumber::renumber_elements(Entities& entities, const std::vector<Uint>& new_to_old)
+{
+  detail::permute_rows(entities.glb_idx(),new_to_old);
+  detail::permute_rows(entities.rank(),new_to_old);
+  boost_foreach(const Handle<Space>& space, entities.spaces())
+    detail::permute_rows(space->connectivity(),new_to_old);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Renumber::renumber_nodes(Dictionary& dict, const std::vector<Uint>& new_to_old)
+{
+  std::vector<Uint> old_to_new(new_to_old.size());
+  for (Uint i=0; i<new_to_old.size(); ++i)
+    old_to_new[new_to_old[i]] = i;
+
+  // Remember which fields were parallelized, before the comm pattern is removed
+  std::vector< Handle<Field> > parallel_fields;
+  if (Handle<PE::CommPattern> comm_pattern = Handle<PE::CommPattern>(dict.get_child("CommPattern")))
+  {
+    boost_foreach(Field& field, find_components<Field>(dict))
+    {
+      if (is_not_null(comm_pattern->get_child(field.name())))
+        parallel_fields.push_back(field.handle<Field>());
+    }
+    dict.remove_component("CommPattern");
+  }
+
+  detail::permute_rows(dict.glb_idx(),new_to_old);
+  detail::permute_rows(dict.rank(),new_to_old);
+  boost_foreach(Field& field, find_components<Field>(dict))
+    detail::permute_rows(field,new_to_old);
+  if (Handle< CompressedTable<Uint> > glb_elem_connectivity = Handle< CompressedTable<Uint> >(dict.get_child("glb_elem_connectivity")))
+    detail::permute_rows(*glb_elem_connectivity,new_to_old);
+
+  boost_foreach(const Handle<Space>& space, detail::spaces_in_dict(*m_mesh,dict))
+  {
+    Connectivity& connectivity = space->connectivity();
+    Uint* nodes = connectivity.array().data();
+    const Uint nb_entries = connectivity.size()*connectivity.row_size();
+    for (Uint i=0; i<nb_entries; ++i)
+      nodes[i] = old_to_new[nodes[i]];
+  }
+
+  dict.rebuild_map_glb_to_loc();
+
+  boost_foreach(const Handle<Field>& field, parallel_fields)
+    field->parallelize();
+
+  CFdebug << "Renumbered " << dict.size() << " nodes of " << dict.uri() << CFendl;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
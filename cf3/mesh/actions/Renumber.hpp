@@ -0,0 +1,70 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_actions_Renumber_hpp
+#define cf3_mesh_actions_Renumber_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshTransformer.hpp"
+#include "mesh/actions/LibActions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+  class Dictionary;
+  class Entities;
+namespace actions {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Reorder the local storage of nodes and elements for memory locality
+///
+/// Elements within each Entities component, and the nodes of the geometry
+/// dictionary, are sorted along a Hilbert space filling curve through their
+/// centroid and coordinates. The nodes of all other dictionaries are numbered
+/// in the order they are first visited by the reordered elements.
+/// Owned rows are placed before ghost rows.
+///
+/// Global indices are not changed. All connectivity tables, fields,
+/// global-to-local maps and node-to-element tables are updated. Comm patterns
+/// are rebuilt, and fields that were parallelized are parallelized again.
+///
+/// @pre The faces must not have been built yet, as face-cell connectivities are not updated
+class mesh_actions_API Renumber : public MeshTransformer
+{
+public: // functions
+
+  /// constructor
+  Renumber( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Renumber"; }
+
+  virtual void execute();
+
+private: // functions
+
+  /// Reorder the rows of one Entities component
+  /// @param [in] new_to_old  for each new row, the old row
+  void renumber_elements(Entities& entities, const std::vector<Uint>& new_to_old);
+
+  /// Reorder the rows of a dictionary, and update all spaces referring to it
+  /// @param [in] new_to_old  for each new row, the old row
+  void renumber_nodes(Dictionary& dict, const std::vector<Uint>& new_to_old);
+
+}; // end Renumber
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_actions_Renumber_hpp
@@ -4,30 +4,37 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <boost/cstdint.hpp>
 #include <boost/foreach.hpp>
 #include <boost/tokenizer.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 
 #include "common/Log.hpp"
+#include "common/BoostFilesystem.hpp"
 #include "common/Builder.hpp"
 #include "common/FindComponents.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
 #include "common/PropertyList.hpp"
-#include "common/StreamHelpers.hpp"
 #include "common/StringConversion.hpp"
 #include "common/Table.hpp"
 #include "common/List.hpp"
-#include "common/DynTable.hpp"
+
+#include "math/Consts.hpp"
 
 #include "mesh/Region.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/MeshElements.hpp"
-#include "mesh/ConnectivityData.hpp"
 #include "mesh/MergedParallelDistribution.hpp"
 #include "mesh/ParallelDistribution.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
 #include "mesh/Cells.hpp"
 
 #include "mesh/gmsh/Reader.hpp"
@@ -45,11 +52,339 @@ namespace gmsh {
 
 cf3::common::ComponentBuilder < gmsh::Reader, MeshReader, LibGmsh> aGmshReader_Builder;
 
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+
+/// Reads ASCII tokens and binary values in place from a memory buffer
+class Tokenizer
+{
+public:
+
+  Tokenizer(const char* begin, const char* end, const std::string& filename, const bool swap_bytes=false) :
+    m_pos(begin), m_end(end), m_filename(filename), m_swap_bytes(swap_bytes)
+  {
+  }
+
+  const char* position() const { return m_pos; }
+
+  void set_swap_bytes(const bool swap_bytes) { m_swap_bytes = swap_bytes; }
+
+  bool at_end() const { return m_pos >= m_end; }
+
+  /// Move to the start of the next line
+  void skip_line()
+  {
+    const char* eol = static_cast<const char*>(std::memchr(m_pos, '\n', m_end-m_pos));
+    m_pos = eol ? eol+1 : m_end;
+  }
+
+  /// Move to the line following the first line that starts with the given keyword
+  void skip_to_line(const std::string& keyword)
+  {
+    while (m_pos < m_end)
+    {
+      const bool found = *m_pos == '$' && Uint(m_end-m_pos) >= keyword.size() && std::strncmp(m_pos, keyword.c_str(), keyword.size()) == 0;
+      skip_line();
+      if (found)
+        return;
+    }
+    throw ParsingFailed(FromHere(), m_filename + ": " + keyword + " not found");
+  }
+
+  /// @return the remainder of the current line, without line ending, and move to the next line
+  std::string next_line()
+  {
+    const char* begin = m_pos;
+    skip_line();
+    const char* end = m_pos;
+    while (end != begin && is_space(end[-1]))
+      --end;
+    return std::string(begin, end);
+  }
+
+  /// @return the next whitespace separated token, with surrounding quotes removed
+  std::string next_string()
+  {
+    skip_whitespace();
+    const char* begin = m_pos;
+    if (m_pos < m_end && *m_pos == '"')
+    {
+      const char* end = static_cast<const char*>(std::memchr(begin+1, '"', m_end-begin-1));
+      if (!end)
+        error("unterminated string");
+      m_pos = end+1;
+      return std::string(begin+1, end);
+    }
+    while (m_pos < m_end && !is_space(*m_pos))
+      ++m_pos;
+    return std::string(begin, m_pos);
+  }
+
+  Uint next_uint()
+  {
+    skip_whitespace();
+    if (m_pos < m_end && *m_pos == '+')
+      ++m_pos;
+    if (m_pos == m_end || !is_digit(*m_pos))
+      error("expected an unsigned integer");
+    Uint value = 0;
+    while (m_pos < m_end && is_digit(*m_pos))
+      value = 10*value + Uint(*m_pos++ - '0');
+    return value;
+  }
+
+  int next_int()
+  {
+    skip_whitespace();
+    const bool negative = m_pos < m_end && *m_pos == '-';
+    if (negative)
+      ++m_pos;
+    const int value = static_cast<int>(next_uint());
+    return negative ? -value : value;
+  }
+
+  /// Parse a floating point number. Numbers with at most 15 significant digits and a
+  /// decimal exponent within [-22,22] are exactly representable as a mantissa and a power of 10,
+  /// and are rounded correctly with a single multiplication or division. Others go through strtod.
+  Real next_real()
+  {
+    static const double powers_of_10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                           1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    skip_whitespace();
+    const char* begin = m_pos;
+    const char* p = m_pos;
+
+    const bool negative = p < m_end && *p == '-';
+    if (p < m_end && (*p == '-' || *p == '+'))
+      ++p;
+
+    boost::uint64_t mantissa = 0;
+    Uint nb_digits = 0;
+    int exponent = 0;
+    bool has_digits = false;
+    for ( ; p < m_end && is_digit(*p); ++p)
+    {
+      has_digits = true;
+      if (nb_digits < 16)
+      {
+        mantissa = 10*mantissa + Uint(*p - '0');
+        if (mantissa)
+          ++nb_digits;
+      }
+      else
+      {
+        ++nb_digits;
+        ++exponent;
+      }
+    }
+    if (p < m_end && *p == '.')
+    {
+      for (++p ; p < m_end && is_digit(*p); ++p)
+      {
+        has_digits = true;
+        if (nb_digits < 16)
+        {
+          mantissa = 10*mantissa + Uint(*p - '0');
+          if (mantissa)
+            ++nb_digits;
+          --exponent;
+        }
+        else
+        {
+          ++nb_digits;
+        }
+      }
+    }
+    if (has_digits && p < m_end && (*p == 'e' || *p == 'E'))
+    {
+      const char* exponent_begin = p++;
+      const bool negative_exponent = p < m_end && *p == '-';
+      if (p < m_end && (*p == '-' || *p == '+'))
+        ++p;
+      if (p < m_end && is_digit(*p))
+      {
+        int exponent_value = 0;
+        for ( ; p < m_end && is_digit(*p); ++p)
+          if (exponent_value < 10000)
+            exponent_value = 10*exponent_value + (*p - '0');
+        exponent += negative_exponent ? -exponent_value : exponent_value;
+      }
+      else
+      {
+        p = exponent_begin;
+      }
+    }
+
+    if (has_digits && nb_digits <= 15 && exponent >= -22 && exponent <= 22 && (p == m_end || is_space(*p)))
+    {
+      m_pos = p;
+      double value = static_cast<double>(mantissa);
+      value = exponent < 0 ? value / powers_of_10[-exponent] : value * powers_of_10[exponent];
+      return static_cast<Real>(negative ? -value : value);
+    }
+
+    // Slow path, also handles nan and inf
+    while (p < m_end && !is_space(*p))
+      ++p;
+    const std::string token(begin, p);
+    char* token_end;
+    const double value = std::strtod(token.c_str(), &token_end);
+    if (token.empty() || token_end != token.c_str() + token.size())
+      error("expected a real number");
+    m_pos = p;
+    return static_cast<Real>(value);
+  }
+
+  /// @return a value stored in binary form, converting its endianness if needed
+  template <typename T>
+  T next_binary()
+  {
+    if (Uint(m_end-m_pos) < sizeof(T))
+      error("unexpected end of file");
+    T value;
+    char* bytes = reinterpret_cast<char*>(&value);
+    std::memcpy(bytes, m_pos, sizeof(T));
+    if (m_swap_bytes)
+      std::reverse(bytes, bytes+sizeof(T));
+    m_pos += sizeof(T);
+    return value;
+  }
+
+  /// @return a 4 byte integer stored in binary form, converted to an unsigned integer
+  Uint next_binary_uint()
+  {
+    const boost::int32_t value = next_binary<boost::int32_t>();
+    if (value < 0)
+      error("expected an unsigned integer");
+    return static_cast<Uint>(value);
+  }
+
+  void skip_bytes(const boost::uint64_t nb_bytes)
+  {
+    if (Uint(m_end-m_pos) < nb_bytes)
+      error("unexpected end of file");
+    m_pos += nb_bytes;
+  }
+
+private:
+
+  static bool is_space(const char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+  static bool is_digit(const char c) { return c >= '0' && c <= '9'; }
+
+  void skip_whitespace()
+  {
+    while (m_pos < m_end && is_space(*m_pos))
+      ++m_pos;
+  }
+
+  void error(const std::string& msg) const
+  {
+    throw ParsingFailed(FromHere(), m_filename + ": " + msg);
+  }
+
+  const char* m_pos;
+  const char* m_end;
+  const std::string& m_filename;
+  bool m_swap_bytes;
+};
+
+/// Header of a $NodeData, $ElementData or $ElementNodeData section
+struct VariableHeader
+{
+  std::string var_name;
+  std::string field_name;
+  Real time;
+  Uint time_step;
+  Uint var_type;
+  Uint nb_entries;
+};
+
+/// Read the header of a data section. This header is always in ASCII, and leaves
+/// the tokenizer at the start of the data.
+void read_variable_header(Tokenizer& tokens, VariableHeader& header)
+{
+  header.var_name = "var";
+  header.field_name = "field";
+  header.time = 0.;
+  header.time_step = 0;
+  header.var_type = 0;
+  header.nb_entries = 0;
+
+  // string tags
+  const Uint nb_string_tags = tokens.next_uint();
+  if (nb_string_tags > 0)
+  {
+    header.var_name = tokens.next_string();
+    header.field_name = header.var_name;
+  }
+  if (nb_string_tags > 1)
+    header.field_name = tokens.next_string();
+  for (Uint i=2; i<nb_string_tags; ++i)
+    tokens.next_string();
+
+  // real tags
+  const Uint nb_real_tags = tokens.next_uint();
+  if (nb_real_tags > 0)
+  {
+    if (nb_real_tags != 1)
+      throw ParsingFailed(FromHere(),"Data cannot have more than 1 real tag (time)");
+
+    header.time = tokens.next_real();
+  }
+
+  // integer tags
+  const Uint nb_integer_tags = tokens.next_uint();
+  if (nb_integer_tags > 0)
+  {
+    if (nb_integer_tags < 3)
+      throw ParsingFailed(FromHere(),"Data must have 3 integer tags (time_step, variable_type, nb_entries)");
+
+    header.time_step = tokens.next_uint();
+    header.var_type = tokens.next_uint();
+    header.nb_entries = tokens.next_uint();
+    for (Uint i=3; i<nb_integer_tags; ++i)
+      tokens.next_int();
+  }
+  tokens.skip_line(); // finish line
+}
+
+/// Objects of a ParallelDistribution are assigned to processes in contiguous blocks,
+/// so the range owned by this process is found by bisection rather than by a query per object
+void owned_range(const ParallelDistribution& hash, const Uint nb_obj, Uint& begin, Uint& end)
+{
+  const Uint rank = PE::Comm::instance().rank();
+  Uint lo=0, hi=nb_obj;
+  while (lo < hi)
+  {
+    const Uint mid = lo + (hi-lo)/2;
+    if (hash.proc_of_obj(mid) < rank) lo = mid+1;
+    else hi = mid;
+  }
+  begin = lo;
+  hi = nb_obj;
+  while (lo < hi)
+  {
+    const Uint mid = lo + (hi-lo)/2;
+    if (hash.proc_of_obj(mid) <= rank) lo = mid+1;
+    else hi = mid;
+  }
+  end = lo;
+}
+
+} // detail
+
 //////////////////////////////////////////////////////////////////////////////
 
 Reader::Reader( const std::string& name )
 : MeshReader(name),
-  Shared()
+  Shared(),
+  m_file_begin(0),
+  m_file_end(0),
+  m_binary(false),
+  m_swap_bytes(false)
 {
 
   // options
@@ -74,12 +409,11 @@ Reader::Reader( const std::string& name )
   std::string desc;
   desc += "This component can read in parallel.\n";
   desc += "It can also read multiple files in serial, combining them in one large mesh.\n";
+  desc += "Both ASCII and binary files of the gmsh 2.x format are supported.\n";
   desc += "Available coolfluid-element types are:\n";
   boost_foreach(const std::string& supported_type, m_supported_types)
   desc += "  - " + supported_type + "\n";
   properties()["description"] = desc;
-
-  IO_rank = 1;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -98,16 +432,21 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
 
   // if the file is present open it
   boost::filesystem::path fp (file.path());
-  if( boost::filesystem::exists(fp) )
-  {
-    CFinfo <<  "Opening file " <<  fp.string() << CFendl;
-    m_file.open(fp,std::ios_base::in); // exists so open it
-  }
-  else // doesnt exist so throw exception
+  if( !boost::filesystem::exists(fp) )
   {
      throw boost::filesystem::filesystem_error( fp.string() + " does not exist", boost::system::error_code() );
   }
 
+  CFinfo <<  "Opening file " <<  fp.string() << CFendl;
+
+  // The whole file is mapped in memory, and parsed in place
+  boost::iostreams::mapped_file_source file_map;
+  if (boost::filesystem::file_size(fp))
+    file_map.open(fp.string());
+  m_file_begin = file_map.data();
+  m_file_end = m_file_begin + file_map.size();
+  m_filename = fp.string();
+
   m_file_basename = boost::filesystem::basename(fp);
 
   // set the internal mesh pointer
@@ -117,13 +456,12 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   // NOTE: since gmsh contains several 'physical entities' in one mesh, we create one region per physical entity
   m_region = Handle<Region>(m_mesh->topology().handle<Component>());
 
-  // Read file once and store positions
+  // Scan the file once and store the positions of the sections
   get_file_positions();
 
   m_mesh->initialize_nodes(0, m_mesh_dimension);
 
-
-  find_used_nodes();
+  read_elements();
 
   read_coordinates();
 
@@ -138,125 +476,181 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
     read_node_data();
   }
 
-  m_node_idx_gmsh_to_cf.clear();
-  m_elem_idx_gmsh_to_cf.clear();
-
   m_mesh->update_statistics();
   m_mesh->update_structures();
 
   // clean-up
-  m_ghost_nodes.clear();
-  m_used_nodes.clear();
-  m_node_idx_gmsh_to_cf.clear();
+  std::vector< std::vector<ElementBucket> >().swap(m_buckets);
+  std::vector<bool>().swap(m_used_nodes);
+  std::vector<Uint>().swap(m_node_idx_gmsh_to_cf);
+  std::vector< std::pair<Uint,Uint> >().swap(m_elem_idx_gmsh_to_cf);
+  m_entities.clear();
   if (is_not_null(m_hash))
     remove_component(*m_hash);
 
   // close the file
-  m_file.close();
-
+  file_map.close();
+  m_file_begin = 0;
+  m_file_end = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void Reader::get_file_positions()
 {
-
-  std::string region_names("$PhysicalNames");
-  std::string nodes("$Nodes");
-  std::string elements("$Elements");
-  std::string element_data("$ElementData");
-  std::string node_data("$NodeData");
-  std::string element_node_data("$ElementNodeData");
-
+  m_binary = false;
+  m_swap_bytes = false;
+  m_nb_regions = 0;
+  m_region_list.clear();
+  m_mesh_dimension = DIM_1D;
+  m_total_nb_nodes = 0;
+  m_total_nb_elements = 0;
+  m_coordinates_position = 0;
+  m_elements_position = 0;
   m_element_data_positions.clear();
   m_node_data_positions.clear();
   m_element_node_data_positions.clear();
 
-  int p;
-  std::string line;
-  while (!m_file.eof())
+  detail::Tokenizer tokens(m_file_begin, m_file_end, m_filename);
+  while (!tokens.at_end())
   {
-    p = m_file.tellg();
-    getline(m_file,line);
-    if (line.find(region_names)!=std::string::npos) {
-      m_region_names_position=p;
-      m_file >> m_nb_regions;
-      m_region_list.resize(m_nb_regions);
+    const std::string line = tokens.next_line();
+    if (line.empty() || line[0] != '$')
+      continue;
+    const std::string section = line.substr(1);
 
-      m_nb_gmsh_elem_in_region.resize(m_nb_regions);
-      for(Uint ir = 0; ir < m_nb_regions; ++ir)
+    if (section == "MeshFormat")
+    {
+      const Real version = tokens.next_real();
+      const Uint file_type = tokens.next_uint();
+      const Uint data_size = tokens.next_uint();
+      if (version < 2. || version >= 3.)
+        throw FileFormatError(FromHere(), m_filename + " has gmsh format version " + to_str(version) + ", only version 2.x is supported");
+      m_binary = (file_type == 1);
+      if (m_binary)
       {
-        m_nb_gmsh_elem_in_region[ir].resize(Shared::nb_gmsh_types);
-        for(Uint type = 0; type < Shared::nb_gmsh_types; ++ type)
-           (m_nb_gmsh_elem_in_region[ir])[type] = 0;
+        if (data_size != sizeof(double))
+          throw FileFormatError(FromHere(), m_filename + " stores reals of " + to_str(data_size) + " bytes, only " + to_str(Uint(sizeof(double))) + " is supported");
+        // The integer 1, written in binary to detect the endianness
+        tokens.skip_line();
+        const boost::int32_t one = tokens.next_binary<boost::int32_t>();
+        if (one != 1)
+        {
+          detail::Tokenizer swapped(tokens.position()-sizeof(boost::int32_t), m_file_end, m_filename, true);
+          if (swapped.next_binary<boost::int32_t>() != 1)
+            throw FileFormatError(FromHere(), m_filename + " has an invalid binary header");
+          m_swap_bytes = true;
+        }
+        tokens.set_swap_bytes(m_swap_bytes);
       }
+      tokens.skip_to_line("$EndMeshFormat");
+    }
+    else if (section == "PhysicalNames")
+    {
+      m_nb_regions = tokens.next_uint();
+      m_region_list.resize(m_nb_regions);
 
-      m_mesh_dimension = DIM_1D;
       for(Uint ir = 0; ir < m_nb_regions; ++ir)
       {
-        Uint phys_group_dimensionality;
-        Uint phys_group_index;
-        std::string phys_group_name;
-        m_file >> phys_group_dimensionality >> phys_group_index >> phys_group_name;
-        m_region_list[phys_group_index-1].dim=phys_group_dimensionality;
-        m_region_list[phys_group_index-1].index=phys_group_index;
-        //The original name of the region in the mesh file has quotes, we want to strip them off
-        m_region_list[phys_group_index-1].name=phys_group_name.substr(1,phys_group_name.length()-2);
-        m_region_list[phys_group_index-1].region = create_region(m_region_list[phys_group_index-1].name);
-        m_mesh_dimension = std::max(m_region_list[phys_group_index-1].dim,m_mesh_dimension);
+        const Uint phys_group_dimensionality = tokens.next_uint();
+        const Uint phys_group_index = tokens.next_uint();
+        //The original name of the region in the mesh file has quotes, they are stripped off
+        const std::string phys_group_name = tokens.next_string();
+        if (phys_group_index == 0 || phys_group_index > m_nb_regions)
+          throw ParsingFailed(FromHere(), m_filename + ": physical group " + phys_group_name + " has index " + to_str(phys_group_index)
+                              + ", while indices must be in the range [1," + to_str(m_nb_regions) + "]");
+        RegionData& region_data = m_region_list[phys_group_index-1];
+        region_data.dim=phys_group_dimensionality;
+        region_data.index=phys_group_index;
+        region_data.name=phys_group_name;
+        region_data.region = create_region(region_data.name);
+        m_mesh_dimension = std::max(region_data.dim,m_mesh_dimension);
       }
+      tokens.skip_to_line("$EndPhysicalNames");
     }
-    else if (line.find(nodes)!=std::string::npos) {
-      m_coordinates_position=p;
-      m_file >> m_total_nb_nodes;
-      //CFinfo << "The total number of nodes is " << m_total_nb_nodes << CFendl;
+    else if (section == "Nodes")
+    {
+      m_total_nb_nodes = tokens.next_uint();
+      tokens.skip_line();
+      m_coordinates_position = tokens.position();
+      // node-number(int) x(double) y(double) z(double)
+      if (m_binary)
+        tokens.skip_bytes(boost::uint64_t(m_total_nb_nodes)*(sizeof(boost::int32_t)+3*sizeof(double)));
+      tokens.skip_to_line("$EndNodes");
     }
-    else if (line.find(elements)!=std::string::npos)
+    else if (section == "Elements")
     {
-      m_elements_position = p;
-      m_file >> m_total_nb_elements;
-      //CFinfo << "The total number of elements is " << m_total_nb_elements << CFendl;
-
-      //Create a hash
-      m_hash = create_component<MergedParallelDistribution>("hash");
-      std::vector<Uint> num_obj(2);
-      num_obj[0] = m_total_nb_nodes;
-      num_obj[1] = m_total_nb_elements;
-      m_hash->options().configure_option("nb_parts",options().option("nb_parts").value<Uint>());
-      m_hash->options().configure_option("nb_obj",num_obj);
-
-
-      Uint elem_idx, elem_type, nb_tags, phys_tag;
-
-      //Let's count how many elements of each type are present
-      for(Uint ie = 0; ie < m_total_nb_elements; ++ie)
+      m_total_nb_elements = tokens.next_uint();
+      tokens.skip_line();
+      m_elements_position = tokens.position();
+      // Binary elements are stored in blocks of one type, each block starting with
+      // elm-type(int) nb-elm-in-block(int) nb-tags(int), followed for each element by
+      // elm-number(int) tags(int[nb-tags]) nodes(int[nb-nodes])
+      if (m_binary)
       {
-          m_file >> elem_idx;
-          m_file >> elem_type;
-          m_file >> nb_tags;
-          m_file >> phys_tag;
-          cf3_assert(phys_tag > 0);
-          getline(m_file,line);
-          if (m_hash->subhash(ELEMS).owns(ie))
-            (m_nb_gmsh_elem_in_region[phys_tag-1])[elem_type]++;
-          m_region_list[phys_tag-1].element_types.insert(elem_type);
+        for (Uint nb_read=0; nb_read < m_total_nb_elements; )
+        {
+          const Uint elem_type = tokens.next_binary_uint();
+          const Uint nb_in_block = tokens.next_binary_uint();
+          const Uint nb_tags = tokens.next_binary_uint();
+          if (elem_type == 0 || elem_type >= Shared::nb_gmsh_types)
+            throw ParsingFailed(FromHere(), m_filename + ": unsupported element type " + to_str(elem_type));
+          tokens.skip_bytes(boost::uint64_t(nb_in_block)*(1+nb_tags+Shared::m_nodes_in_gmsh_elem[elem_type])*sizeof(boost::int32_t));
+          nb_read += nb_in_block;
+        }
       }
+      tokens.skip_to_line("$EndElements");
     }
-    else if (line.find(element_data)!=std::string::npos)
-    {
-      m_element_data_positions.push_back(p);
-    }
-    else if (line.find(node_data)!=std::string::npos)
+    else if (section == "ElementData" || section == "NodeData" || section == "ElementNodeData")
     {
-      m_node_data_positions.push_back(p);
+      if (section == "ElementData")
+        m_element_data_positions.push_back(tokens.position());
+      else if (section == "NodeData")
+        m_node_data_positions.push_back(tokens.position());
+      else
+        m_element_node_data_positions.push_back(tokens.position());
+
+      if (m_binary)
+      {
+        detail::VariableHeader header;
+        detail::read_variable_header(tokens, header);
+        if (section == "ElementNodeData")
+        {
+          // elm-number(int) nb-nodes(int) values(double[nb-nodes*var-type])
+          for (Uint e=0; e<header.nb_entries; ++e)
+          {
+            tokens.skip_bytes(sizeof(boost::int32_t));
+            const Uint nb_nodes = tokens.next_binary_uint();
+            tokens.skip_bytes(boost::uint64_t(nb_nodes)*header.var_type*sizeof(double));
+          }
+        }
+        else
+        {
+          // number(int) values(double[var-type])
+          tokens.skip_bytes(boost::uint64_t(header.nb_entries)*(sizeof(boost::int32_t)+header.var_type*sizeof(double)));
+        }
+      }
+      tokens.skip_to_line("$End"+section);
     }
-    else if (line.find(element_data)!=std::string::npos)
+    else if (section.compare(0, 3, "End") != 0)
     {
-      m_element_node_data_positions.push_back(p);
+      // Sections that are not used by this reader, e.g. $Periodic
+      tokens.skip_to_line("$End"+section);
     }
-
   }
-  m_file.clear();
+
+  if (is_null(m_coordinates_position) || is_null(m_elements_position))
+    throw FileFormatError(FromHere(), m_filename + " has no $Nodes or no $Elements section");
+  if (m_nb_regions == 0)
+    throw FileFormatError(FromHere(), m_filename + " has no $PhysicalNames section, which is needed to create the regions");
+
+  //Create a hash
+  m_hash = create_component<MergedParallelDistribution>("hash");
+  std::vector<Uint> num_obj(2);
+  num_obj[0] = m_total_nb_nodes;
+  num_obj[1] = m_total_nb_elements;
+  m_hash->options().configure_option("nb_parts",options().option("nb_parts").value<Uint>());
+  m_hash->options().configure_option("nb_obj",num_obj);
 
   if (m_element_node_data_positions.size())
     CFwarn << "ElementNodeData record(s) found. The gmsh reader has not implemented reading this record yet. They will be ignored" << CFendl;
@@ -283,372 +677,223 @@ Handle< Region > Reader::create_region(std::string const& relative_path)
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Reader::find_used_nodes()
+void Reader::read_elements()
 {
+  // Single pass over the elements: the owned elements are stored in buckets per region and
+  // element type, and the nodes they use are flagged
+  Uint owned_begin, owned_end;
+  detail::owned_range(m_hash->subhash(ELEMS), m_total_nb_elements, owned_begin, owned_end);
+
+  m_buckets.assign(m_nb_regions, std::vector<ElementBucket>(Shared::nb_gmsh_types));
   m_used_nodes.clear();
-  std::string line;
-
-  m_file.seekg(m_elements_position,std::ios::beg);
-  // skip next line
-  getline(m_file,line);
-//  if (PE::Comm::instance().rank()==IO_rank)
-//    std::cout << "header = " << line << std::endl;
-  //Skip the line containing the actual number of elements
-  getline(m_file,line);
-//  if (PE::Comm::instance().rank()==IO_rank)
-//    std::cout << "nb_elems = " << line << std::endl;
-
-  // read every line and store the connectivity in the correct region through the buffer
-  Uint elementNumber, elementType, nbElementNodes;
-  Uint gmsh_node_number, nb_tags, phys_tag, other_tag;
-
-  std::set<Uint>::iterator it=m_used_nodes.begin();
-
-//  if (PE::Comm::instance().rank()==IO_rank)
-//  {
-//    std::cout << "nb_obj = "   << m_hash->subhash(ELEMS).options()["nb_obj"].value<Uint>() << std::endl;
-//    std::cout << "nb_parts = " <<m_hash->subhash(ELEMS).options()["nb_parts"].value<Uint>() << std::endl;
-//  }
+
+  // Element types present in each region, on any process
+  std::vector< std::vector<bool> > region_types(m_nb_regions, std::vector<bool>(Shared::nb_gmsh_types, false));
+
+  detail::Tokenizer tokens(m_elements_position, m_file_end, m_filename, m_swap_bytes);
+
+  Uint elem_type(0), nb_tags(0), nb_in_block(0);
   for (Uint i=0; i<m_total_nb_elements; ++i)
   {
-    if (m_total_nb_elements > 100000)
+    Uint elem_number, phys_tag;
+    if (m_binary)
     {
-      if(i%(m_total_nb_elements/20)==0)
-        CFinfo << 100*i/m_total_nb_elements << "% " << CFflush;
-    }
-
-    if (m_hash->subhash(ELEMS).owns(i))
-    {
-      // element description
-      m_file >> elementNumber >> elementType;
-      nbElementNodes = Shared::m_nodes_in_gmsh_elem[elementType];
-
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << i << ":  elem["<<m_hash->subhash(ELEMS).part_of_obj(i)<<"] " << elementNumber << " :    ";
-      m_file >> nb_tags;
-      m_file >> phys_tag;
-      for(Uint itag = 0; itag < (nb_tags-1); ++itag)
-          m_file >> other_tag;
-
-      for (Uint j=0; j<nbElementNodes; ++j)
+      if (nb_in_block == 0)
       {
-        m_file >> gmsh_node_number;
-        it = m_used_nodes.insert(it,gmsh_node_number);
-//        if (PE::Comm::instance().rank()==IO_rank)
-//          std::cout << "  " << gmsh_node_number;
+        elem_type = tokens.next_binary_uint();
+        nb_in_block = tokens.next_binary_uint();
+        nb_tags = tokens.next_binary_uint();
       }
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << "\n";
+      --nb_in_block;
+      elem_number = tokens.next_binary_uint();
+      phys_tag = nb_tags ? tokens.next_binary_uint() : 0u;
+      if (nb_tags > 1)
+        tokens.skip_bytes((nb_tags-1)*sizeof(boost::int32_t));
+    }
+    else
+    {
+      elem_number = tokens.next_uint();
+      elem_type = tokens.next_uint();
+      nb_tags = tokens.next_uint();
+      phys_tag = nb_tags ? tokens.next_uint() : 0u;
+      for(Uint itag = 1; itag < nb_tags; ++itag)
+        tokens.next_int();
     }
-    getline(m_file,line); // finnish the line
-  }
 
-  // Now we have all nodes, used by the elements
+    if (elem_type == 0 || elem_type >= Shared::nb_gmsh_types || Shared::m_nodes_in_gmsh_elem[elem_type] == 0)
+      throw ParsingFailed(FromHere(), m_filename + ": element " + to_str(elem_number) + " has unsupported type " + to_str(elem_type));
+    if (phys_tag == 0 || phys_tag > m_nb_regions)
+      throw ParsingFailed(FromHere(), m_filename + ": element " + to_str(elem_number) + " has physical tag " + to_str(phys_tag)
+                          + ", which is not defined in $PhysicalNames");
 
-  // Now add owned nodes
-  m_file.seekg(m_coordinates_position,std::ios::beg);
-  //Skip the line with keyword '$Nodes':
-  getline(m_file,line);
-//  if (PE::Comm::instance().rank()==IO_rank)
-//    std::cout << "header = " << line << std::endl;
-  // skip one line, which says how many (total) nodes are  present in the mesh
-  getline(m_file,line);
-//  if (PE::Comm::instance().rank()==IO_rank)
-//    std::cout << "nb_nodes = " << line << std::endl;
+    region_types[phys_tag-1][elem_type] = true;
 
-  for (Uint node_idx=0; node_idx<m_total_nb_nodes; ++node_idx)
-  {
-    if (m_total_nb_nodes > 100000)
+    const Uint nb_element_nodes = Shared::m_nodes_in_gmsh_elem[elem_type];
+    if (i >= owned_begin && i < owned_end)
     {
-      if(node_idx%(m_total_nb_nodes/20)==0)
-        CFinfo << 100*node_idx/m_total_nb_nodes << "% " << CFflush;
-      if (node_idx == m_total_nb_nodes-1)
-        CFinfo << CFendl;
+      ElementBucket& bucket = m_buckets[phys_tag-1][elem_type];
+      bucket.gmsh_idx.push_back(elem_number);
+      for (Uint j=0; j<nb_element_nodes; ++j)
+      {
+        const Uint gmsh_node_number = m_binary ? tokens.next_binary_uint() : tokens.next_uint();
+        bucket.gmsh_nodes.push_back(gmsh_node_number);
+        if (gmsh_node_number >= m_used_nodes.size())
+          m_used_nodes.resize(std::max(gmsh_node_number+1, 2*static_cast<Uint>(m_used_nodes.size())), false);
+        m_used_nodes[gmsh_node_number] = true;
+      }
     }
-    getline(m_file,line);
-
-    std::stringstream ss(line);
-    ss >> gmsh_node_number;
-    getline(ss,line);
-    if (m_hash->subhash(NODES).owns(node_idx))
+    else if (m_binary)
     {
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << "node " << gmsh_node_number << "\n";
-
-      it = m_used_nodes.insert(it,gmsh_node_number);
+      tokens.skip_bytes(nb_element_nodes*sizeof(boost::int32_t));
     }
     else
     {
-      it = m_used_nodes.find(gmsh_node_number);
-      if (it != m_used_nodes.end())
-      {
-        m_ghost_nodes.insert(node_idx);
-//        if (PE::Comm::instance().rank()==IO_rank)
-//          std::cout << "ghostnode " << gmsh_node_number << "\n";
-      }
+      tokens.skip_line();
     }
   }
-//  if (PE::Comm::instance().rank()==IO_rank)
-//    std::cout << std::flush;
+
+  for(Uint ir = 0; ir < m_nb_regions; ++ir)
+    for(Uint etype = 0; etype < Shared::nb_gmsh_types; ++etype)
+      if (region_types[ir][etype])
+        m_region_list[ir].element_types.insert(etype);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void Reader::read_coordinates()
 {
+  Uint owned_begin, owned_end;
+  detail::owned_range(m_hash->subhash(NODES), m_total_nb_nodes, owned_begin, owned_end);
 
-  m_file.seekg(m_coordinates_position,std::ios::beg);
-
-  // Find the region which has the highest dimensionality present in the mesh:
-  Uint master_region = 0;
-  while((m_region_list[master_region].dim != m_mesh_dimension) && (master_region < m_nb_regions))
-  {
-     master_region++;
-  }
+  const Uint part = options().option("part").value<Uint>();
 
+  // Upper bound of the number of nodes: the owned nodes, and the nodes used by the owned elements
   Dictionary& nodes = m_mesh->geometry_fields();
-  nodes.resize(m_used_nodes.size());
-  m_used_nodes.clear();
-
-  Uint part = options().option("part").value<Uint>();
-
-  std::string line;
-  //Skip the line with keyword '$Nodes':
-  getline(m_file,line);
-  // skip one line, which says how many (total) nodes are  present in the mesh
-  getline(m_file,line);
-
+  nodes.resize(owned_end - owned_begin + static_cast<Uint>(std::count(m_used_nodes.begin(), m_used_nodes.end(), true)));
+  m_node_idx_gmsh_to_cf.assign(m_used_nodes.size(), math::Consts::uint_max());
 
-  // declare and allocate one coordinate row
-//  std::vector<Real> rowVector(m_mesh_dimension);
-
-  std::set<Uint>::const_iterator it;
+  detail::Tokenizer tokens(m_coordinates_position, m_file_end, m_filename, m_swap_bytes);
 
   Uint coord_idx=0;
-  Uint gmsh_node_number;
-
+  Real coords[3];
   for (Uint node_idx=0; node_idx<m_total_nb_nodes; ++node_idx)
   {
-    if (m_total_nb_nodes > 100000)
-    {
-      if(node_idx%(m_total_nb_nodes/20)==0)
-        CFinfo << 100*node_idx/m_total_nb_nodes << "% " << CFendl;
-    }
-    getline(m_file,line);
-
-    if (m_hash->subhash(NODES).owns(node_idx))
-    {
-      std::stringstream ss(line);
-      ss >> gmsh_node_number;
-      m_node_idx_gmsh_to_cf[gmsh_node_number]=coord_idx;
-
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << gmsh_node_number << " --> " << coord_idx << std::endl;
+    const bool owned = node_idx >= owned_begin && node_idx < owned_end;
+    const Uint gmsh_node_number = m_binary ? tokens.next_binary_uint() : tokens.next_uint();
+    const bool used = gmsh_node_number < m_used_nodes.size() && m_used_nodes[gmsh_node_number];
 
-      for (Uint dim=0; dim<m_mesh_dimension; ++dim)
-        ss >> nodes.coordinates()[coord_idx][dim];
-      if(m_mesh_dimension < DIM_3D) getline(ss,line); //Gmsh always stores 3 coordinates, even for 2D meshes
-
-      nodes.rank()[coord_idx] = part;
-      nodes.glb_idx()[coord_idx] = gmsh_node_number-1;
-
-      coord_idx++;
-    }
-    else
+    if (!owned && !used)
     {
-      it = m_ghost_nodes.find(node_idx);
-      if (it != m_ghost_nodes.end())
-      {
-        std::stringstream ss(line);
-        ss >> gmsh_node_number;
-        m_node_idx_gmsh_to_cf[gmsh_node_number]=coord_idx;
-
-//        if (PE::Comm::instance().rank()==IO_rank)
-//          std::cout << gmsh_node_number << " --> " << coord_idx << std::endl;
-
-        for (Uint dim=0; dim<m_mesh_dimension; ++dim)
-        ss >> nodes.coordinates()[coord_idx][dim];
-        if(m_mesh_dimension < DIM_3D) getline(ss, line);
-
-        nodes.rank()[coord_idx] = m_hash->subhash(NODES).part_of_obj(node_idx);
-        nodes.glb_idx()[coord_idx] = gmsh_node_number-1;
-
-        coord_idx++;
-      }
+      if (m_binary)
+        tokens.skip_bytes(3*sizeof(double));
+      else
+        tokens.skip_line();
+      continue;
     }
 
+    //Gmsh always stores 3 coordinates, even for 2D meshes
+    for (Uint d=0; d<3; ++d)
+      coords[d] = m_binary ? static_cast<Real>(tokens.next_binary<double>()) : tokens.next_real();
 
-  } //loop over nodes
+    if (gmsh_node_number >= m_node_idx_gmsh_to_cf.size())
+      m_node_idx_gmsh_to_cf.resize(std::max(gmsh_node_number+1, 2*static_cast<Uint>(m_node_idx_gmsh_to_cf.size())), math::Consts::uint_max());
+    m_node_idx_gmsh_to_cf[gmsh_node_number]=coord_idx;
 
+    for (Uint d=0; d<m_mesh_dimension; ++d)
+      nodes.coordinates()[coord_idx][d] = coords[d];
 
+    nodes.rank()[coord_idx] = owned ? part : m_hash->subhash(NODES).part_of_obj(node_idx);
+    nodes.glb_idx()[coord_idx] = gmsh_node_number-1;
 
-  /*
-  CFinfo << "Printing all nodal coordinates:" << CFendl;
-  for(Uint i = 0; i < m_total_nb_nodes; ++i)
-  {
-      CFinfo << "\t";
-      for(Uint dim = 0; dim < m_mesh_dimension; ++dim)
-        {
-            CFinfo << nodes.coordinates()[i][dim] << " ";
-        }
-      CFinfo << CFendl;
+    coord_idx++;
   }
-  */
 
-  getline(m_file,line);
+  nodes.resize(coord_idx);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void Reader::read_connectivity()
 {
-
   Dictionary& nodes = m_mesh->geometry_fields();
 
+  const Uint part = options().option("part").value<Uint>();
 
-  Uint part = options().option("part").value<Uint>();
-
-  //Each entry of this vector holds a map (gmsh_type_idx, pointer to connectivity table of this gmsh type).
- //Each row corresponds to one region of the mesh
- std::vector<std::map<Uint, Entities* > > conn_table_idx;
- conn_table_idx.resize(m_nb_regions);
- for(Uint ir = 0; ir < m_nb_regions; ++ir)
- {
-    conn_table_idx[ir].clear();
- }
-
- std::map<Uint, Entities*>::iterator elem_table_iter;
-
-// std::vector<std::map<std::string,Handle< Elements > > > elements(m_nb_regions);
-// std::vector<std::map<std::string,Handle< Connectivity::Buffer > > > buffer(m_nb_regions);
-
-
- m_elem_idx_gmsh_to_cf.clear();
- //Loop over all regions and allocate a connectivity table of proper size for each element type that
- //is present in each region. Counting of elements was done during the first pass in the function
- //get_file_positions
- for(Uint ir = 0; ir < m_nb_regions; ++ir)
- {
-   // create new region
-   Handle< Region > region = m_region_list[ir].region;
-
-//   elements[ir] = create_cells_in_region(*region,m_mesh->geometry_fields(),m_supported_types);
-//   buffer[ir] = create_connectivity_buffermap(elements[ir]);
-
-
-   // Take the gmsh element types present in this region and generate new names of elements which correspond
-   // to coolfuid naming:
-   for(Uint etype = 0; etype < Shared::nb_gmsh_types; ++etype)
-   {
-     if(m_region_list[ir].element_types.find(etype) !=  m_region_list[ir].element_types.end())
-     {
-       const std::string cf_elem_name = Shared::gmsh_name_to_cf_name(m_mesh_dimension,etype);
-
-       boost::shared_ptr< ElementType > allocated_type = build_component_abstract_type<ElementType>(cf_elem_name,"tmp");
-       boost::shared_ptr< Entities > elements;
-       if (allocated_type->dimensionality() == allocated_type->dimension()-1)
-         elements = build_component_abstract_type<Entities>("cf3.mesh.Faces",allocated_type->shape_name());
-       else if(allocated_type->dimensionality() == allocated_type->dimension())
-         elements = build_component_abstract_type<Entities>("cf3.mesh.Cells",allocated_type->shape_name());
-       else
-         elements = build_component_abstract_type<Entities>("cf3.mesh.Elements",allocated_type->shape_name());
-      region->add_component(elements);
-      elements->initialize(cf_elem_name,nodes);
+  // The element numbers are only needed to read element data
+  const bool map_elements = options().option("read_fields").value<bool>() && m_element_data_positions.size();
 
-       Connectivity& elem_table = Handle<Elements>(elements)->geometry_space().connectivity();
-       elem_table.set_row_size(Shared::m_nodes_in_gmsh_elem[etype]);
-       elem_table.resize((m_nb_gmsh_elem_in_region[ir])[etype]);
-       elements->rank().resize(m_nb_gmsh_elem_in_region[ir][etype]);
-       elements->glb_idx().resize(m_nb_gmsh_elem_in_region[ir][etype]);
-       conn_table_idx[ir].insert(std::pair<Uint,Entities*>(etype,elements.get()));
-     }
-   }
- }
-
-   std::string etype_CF;
-   std::set<Uint>::const_iterator it;
-   std::vector<Uint> cf_element;
-   Uint element_number, gmsh_element_type, nb_element_nodes;
-   Uint gmsh_node_number, nb_tags, phys_tag, other_tag;
-   Uint cf_node_number;
-   Uint cf_idx;
-
-   m_file.seekg(m_elements_position,std::ios::beg);
-   // skip next line
-   std::string line;
-   //Re-read the line that contains the keyword '$Elements':
-   getline(m_file,line);
-   //Parse the following line (containing the actual number of elements)
-   getline(m_file,line);
-
-   for(Uint ir = 0; ir < m_nb_regions; ++ir)
-     for(Uint etype = 0; etype < Shared::nb_gmsh_types; ++etype)
-      (m_nb_gmsh_elem_in_region[ir])[etype] = 0;
+  m_entities.clear();
+  m_elem_idx_gmsh_to_cf.clear();
 
-  for (Uint i=0; i<m_total_nb_elements; ++i)
+  //Loop over all regions and allocate a connectivity table of proper size for each element type that
+  //is present in each region. The elements were bucketed by region and type in read_elements()
+  for(Uint ir = 0; ir < m_nb_regions; ++ir)
   {
-    if (m_total_nb_elements > 100000)
-    {
-      if(i%(m_total_nb_elements/20)==0)
-        CFinfo << 100*i/m_total_nb_elements << "% " << CFendl;
-    }
+    Handle< Region > region = m_region_list[ir].region;
 
-    // element description
-    m_file >> element_number >> gmsh_element_type;
-
-    nb_element_nodes = Shared::m_nodes_in_gmsh_elem[gmsh_element_type];
-
-    // get element nodes
-    if (m_hash->subhash(ELEMS).owns(i))
+    // Take the gmsh element types present in this region and generate new names of elements which correspond
+    // to coolfuid naming:
+    boost_foreach(const Uint etype, m_region_list[ir].element_types)
     {
-      m_file >> nb_tags;
-      m_file >> phys_tag;
-      for(Uint itag = 0; itag < (nb_tags-1); ++itag)
-          m_file >> other_tag;
+      const std::string cf_elem_name = Shared::gmsh_name_to_cf_name(m_mesh_dimension,etype);
+
+      boost::shared_ptr< ElementType > allocated_type = build_component_abstract_type<ElementType>(cf_elem_name,"tmp");
+      boost::shared_ptr< Entities > elements;
+      if (allocated_type->dimensionality() == allocated_type->dimension()-1)
+        elements = build_component_abstract_type<Entities>("cf3.mesh.Faces",allocated_type->shape_name());
+      else if(allocated_type->dimensionality() == allocated_type->dimension())
+        elements = build_component_abstract_type<Entities>("cf3.mesh.Cells",allocated_type->shape_name());
+      else
+        elements = build_component_abstract_type<Entities>("cf3.mesh.Elements",allocated_type->shape_name());
+      region->add_component(elements);
+      elements->initialize(cf_elem_name,nodes);
 
-//      CFinfo << "Reading element " << element_number << " of type " << gmsh_element_type;
-//      CFinfo << " in region " << phys_tag << " with " << nb_element_nodes << " nodes " << CFendl;
+      ElementBucket& bucket = m_buckets[ir][etype];
+      const Uint nb_elems = bucket.gmsh_idx.size();
+      const Uint nb_element_nodes = Shared::m_nodes_in_gmsh_elem[etype];
+      const std::vector<Uint>& node_order = m_nodes_gmsh_to_cf[etype];
+      if (node_order.size() != nb_element_nodes)
+        throw NotSupported(FromHere(), "The node numbering of gmsh element type " + to_str(etype) + " is not defined");
 
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << element_number << "   -->   ";
+      Connectivity& elem_table = elements->geometry_space().connectivity();
+      elem_table.set_row_size(nb_element_nodes);
+      elem_table.resize(nb_elems);
+      elements->rank().resize(nb_elems);
+      elements->glb_idx().resize(nb_elems);
 
-      cf_element.resize(nb_element_nodes);
-      for (Uint j=0; j<nb_element_nodes; ++j)
+      for (Uint e=0; e<nb_elems; ++e)
       {
-        cf_idx = m_nodes_gmsh_to_cf[gmsh_element_type][j];
-        m_file >> gmsh_node_number;
-        cf_node_number = m_node_idx_gmsh_to_cf[gmsh_node_number];
-        cf_element[cf_idx] = cf_node_number;
-//        if (PE::Comm::instance().rank()==IO_rank)
-//          std::cout << "  " << gmsh_node_number << "("<<m_node_idx_gmsh_to_cf[gmsh_node_number]<<")";
+        Connectivity::Row element_nodes = elem_table[e];
+        for (Uint j=0; j<nb_element_nodes; ++j)
+        {
+          const Uint gmsh_node_number = bucket.gmsh_nodes[e*nb_element_nodes+j];
+          const Uint cf_node_number = gmsh_node_number < m_node_idx_gmsh_to_cf.size() ? m_node_idx_gmsh_to_cf[gmsh_node_number] : math::Consts::uint_max();
+          if (cf_node_number == math::Consts::uint_max())
+            throw ParsingFailed(FromHere(), m_filename + ": element " + to_str(bucket.gmsh_idx[e]) + " uses node " + to_str(gmsh_node_number) + ", which is not defined in $Nodes");
+          element_nodes[node_order[j]] = cf_node_number;
+        }
+        elements->rank()[e] = part;
+        elements->glb_idx()[e] = bucket.gmsh_idx[e]-1;
       }
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << std::endl;
-
-      elem_table_iter = conn_table_idx[phys_tag-1].find(gmsh_element_type);
-      const Uint row_idx = (m_nb_gmsh_elem_in_region[phys_tag-1])[gmsh_element_type];
 
-      Handle< Elements > elements_region = Handle<Elements>(elem_table_iter->second->handle<Component>());
-      Connectivity::Row element_nodes = elements_region->geometry_space().connectivity()[row_idx];
-
-      m_elem_idx_gmsh_to_cf[element_number] = boost::make_tuple( elements_region , row_idx);
-
-      for(Uint node = 0; node < nb_element_nodes; ++node)
+      if (map_elements)
       {
-         element_nodes[node] = cf_element[node];
+        for (Uint e=0; e<nb_elems; ++e)
+        {
+          const Uint gmsh_elem_idx = bucket.gmsh_idx[e];
+          if (gmsh_elem_idx >= m_elem_idx_gmsh_to_cf.size())
+            m_elem_idx_gmsh_to_cf.resize(std::max(gmsh_elem_idx+1, 2*static_cast<Uint>(m_elem_idx_gmsh_to_cf.size())),
+                                         std::make_pair(math::Consts::uint_max(), math::Consts::uint_max()));
+          m_elem_idx_gmsh_to_cf[gmsh_elem_idx] = std::make_pair(static_cast<Uint>(m_entities.size()), e);
+        }
       }
+      m_entities.push_back(elements->handle<Entities>());
 
-      elements_region->rank()[row_idx] = part;
-      elements_region->glb_idx()[row_idx] = element_number-1;
-
-      (m_nb_gmsh_elem_in_region[phys_tag-1])[gmsh_element_type]++;
-
+      // The bucket is not needed anymore
+      std::vector<Uint>().swap(bucket.gmsh_idx);
+      std::vector<Uint>().swap(bucket.gmsh_nodes);
     }
-
-    // finish the line
-    getline(m_file,line);
   }
-  getline(m_file,line);  // ENDOFSECTION
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -674,10 +919,9 @@ void Reader::read_element_data()
 
   std::map<std::string,Reader::Field> fields;
 
-  boost_foreach(Uint element_data_position, m_element_data_positions)
+  boost_foreach(const char* element_data_position, m_element_data_positions)
   {
-    m_file.seekg(element_data_position,std::ios::beg);
-    read_variable_header(fields);
+    read_variable_header(element_data_position, fields);
   }
 
   if (fields.size())
@@ -699,27 +943,25 @@ void Reader::read_element_data()
         CFdebug << "Reading " << field.name() << "/" << field.var_name(i) <<"["<<static_cast<Uint>(field.var_length(i))<<"]" << CFendl;
         Uint var_begin = field.var_index(i);
         Uint var_end = var_begin + static_cast<Uint>(field.var_length(i));
-        m_file.seekg(gmsh_field.file_data_positions[i]);
 
+        detail::Tokenizer tokens(gmsh_field.file_data_positions[i], m_file_end, m_filename, m_swap_bytes);
 
         Uint gmsh_elem_idx;
-        Uint cf_idx;
-        Handle< Elements > elements;
         Uint d;
         std::vector<Real> data(gmsh_field.var_types[i]);
 
         for (Uint e=0; e<gmsh_field.nb_entries; ++e)
         {
-          m_file >> gmsh_elem_idx;
+          gmsh_elem_idx = m_binary ? tokens.next_binary_uint() : tokens.next_uint();
           for (d=0; d<data.size(); ++d)
-            m_file >> data[d];
+            data[d] = m_binary ? static_cast<Real>(tokens.next_binary<double>()) : tokens.next_real();
 
-          std::map<Uint, boost::tuple<Handle< Elements >,Uint> >::iterator it = m_elem_idx_gmsh_to_cf.find(gmsh_elem_idx);
-          if (it != m_elem_idx_gmsh_to_cf.end())
+          if (gmsh_elem_idx < m_elem_idx_gmsh_to_cf.size() && m_elem_idx_gmsh_to_cf[gmsh_elem_idx].first != math::Consts::uint_max())
           {
-            boost::tie(elements,cf_idx) = it->second;
+            const Entities& elements = *m_entities[m_elem_idx_gmsh_to_cf[gmsh_elem_idx].first];
+            const Uint cf_idx = m_elem_idx_gmsh_to_cf[gmsh_elem_idx].second;
 
-            mesh::Field::Row field_data = field[field.space(*elements).connectivity()[cf_idx][0]] ;
+            mesh::Field::Row field_data = field[field.space(elements).connectivity()[cf_idx][0]] ;
 
             d=0;
             for(Uint v=var_begin; v<var_end; ++v)
@@ -755,10 +997,9 @@ void Reader::read_node_data()
 
   std::map<std::string,Field> fields;
 
-  boost_foreach(Uint node_data_position, m_node_data_positions)
+  boost_foreach(const char* node_data_position, m_node_data_positions)
   {
-    m_file.seekg(node_data_position,std::ios::beg);
-    read_variable_header(fields);
+    read_variable_header(node_data_position, fields);
   }
 
   foreach_container((const std::string& name) (Field& gmsh_field) , fields)
@@ -770,31 +1011,28 @@ void Reader::read_node_data()
     mesh::Field& field = m_mesh->geometry_fields().create_field(gmsh_field.name);
     field.options().configure_option("var_names",gmsh_field.var_names);
     field.options().configure_option("var_types",var_types_str);
-    field.resize(gmsh_field.nb_entries);
 
     for (Uint i=0; i<field.nb_vars(); ++i)
     {
       CFdebug << "Reading " << field.name() << "/" << field.var_name(i) <<"["<<static_cast<Uint>(field.var_length(i))<<"]" << CFendl;
       Uint var_begin = field.var_index(i);
       Uint var_end = var_begin + static_cast<Uint>(field.var_length(i));
-      m_file.seekg(gmsh_field.file_data_positions[i]);
+
+      detail::Tokenizer tokens(gmsh_field.file_data_positions[i], m_file_end, m_filename, m_swap_bytes);
 
       Uint gmsh_node_idx;
-      Uint cf_idx;
       Uint d;
       std::vector<Real> data(gmsh_field.var_types[i]);
 
       for (Uint e=0; e<gmsh_field.nb_entries; ++e)
       {
-        m_file >> gmsh_node_idx;
+        gmsh_node_idx = m_binary ? tokens.next_binary_uint() : tokens.next_uint();
         for (d=0; d<data.size(); ++d)
-          m_file >> data[d];
+          data[d] = m_binary ? static_cast<Real>(tokens.next_binary<double>()) : tokens.next_real();
 
-        std::map<Uint, Uint>::iterator it = m_node_idx_gmsh_to_cf.find(gmsh_node_idx);
-        if (it != m_node_idx_gmsh_to_cf.end())
+        if (gmsh_node_idx < m_node_idx_gmsh_to_cf.size() && m_node_idx_gmsh_to_cf[gmsh_node_idx] != math::Consts::uint_max())
         {
-          cf_idx = it->second;
-          mesh::Field::Row field_data = field[cf_idx];
+          mesh::Field::Row field_data = field[m_node_idx_gmsh_to_cf[gmsh_node_idx]];
 
           d=0;
           for(Uint v=var_begin; v<var_end; ++v)
@@ -807,75 +1045,20 @@ void Reader::read_node_data()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Reader::read_variable_header(std::map<std::string,Field>& fields)
+void Reader::read_variable_header(const char* position, std::map<std::string,Field>& fields)
 {
-  std::string line;
-  std::string dummy;
-
-  Uint nb_string_tags(0);
-  std::string var_name("var");
-  std::string field_name("field");
-  Uint nb_real_tags(0);
-  Real field_time(0.);
-  Uint nb_integer_tags(0);
-  Uint field_time_step(0);
-  Uint var_type(0);
-  Uint nb_entries(0);
-
-  //Re-read the line that contains the keyword '$Elements':
-  getline(m_file,line);
-
-  // string tags
-  m_file >> nb_string_tags;
-  if (nb_string_tags > 0)
-  {
-    m_file >> var_name;
-    var_name = var_name.substr(1,var_name.length()-2);
-
-    field_name = var_name;
-    if (nb_string_tags > 1)
-    {
-      m_file >> field_name;
-      field_name = field_name.substr(1,field_name.length()-2);
-    }
-    if (nb_string_tags > 2)
-    {
-      for (Uint i=1; i<nb_string_tags; ++i)
-        m_file >> dummy;
-    }
-  }
-
-  // real tags
-  m_file >> nb_real_tags;
-  if (nb_real_tags > 0)
-  {
-    if (nb_real_tags != 1)
-      throw ParsingFailed(FromHere(),"Data cannot have more than 1 real tag (time)");
-
-    m_file >> field_time;
-  }
-
-  // integer tags
-  m_file >> nb_integer_tags;
-  if (nb_integer_tags > 0)
-  {
-    if (nb_integer_tags >= 3)
-    {
-      m_file >> field_time_step >> var_type >> nb_entries;
-    }
-    if (nb_integer_tags < 3)
-      throw ParsingFailed(FromHere(),"Data must have 3 integer tags (time_step, variable_type, nb_entries)");
-  }
-  getline(m_file,line); // finish line
-
-  Field& field = fields[field_name];
-  field.name=field_name;
-  field.var_names.push_back(var_name);
-  field.var_types.push_back(var_type);
-  field.time=field_time;
-  field.time_step=field_time_step;
-  field.nb_entries=nb_entries;
-  field.file_data_positions.push_back(m_file.tellg());
+  detail::Tokenizer tokens(position, m_file_end, m_filename);
+  detail::VariableHeader header;
+  detail::read_variable_header(tokens, header);
+
+  Field& field = fields[header.field_name];
+  field.name=header.field_name;
+  field.var_names.push_back(header.var_name);
+  field.var_types.push_back(header.var_type);
+  field.time=header.time;
+  field.time_step=header.time_step;
+  field.nb_entries=header.nb_entries;
+  field.file_data_positions.push_back(tokens.position());
 }
 
 
@@ -23,6 +23,7 @@ namespace cf3 {
 namespace mesh {
 
 class Elements;
+class Entities;
 class Region;
 class MergedParallelDistribution;
 class Dictionary;
@@ -34,6 +35,8 @@ namespace gmsh {
 //////////////////////////////////////////////////////////////////////////////
 
 /// This class defines gmsh mesh format reader
+/// Both the ASCII and the binary variant of the gmsh 2.x format are read.
+/// The file is memory mapped and parsed in place, reading the elements in one pass.
 /// @author Willem Deconinck
 /// @author Martin Vymazal
 class gmsh_API Reader : public MeshReader, public Shared
@@ -58,13 +61,13 @@ public: // functions
 
 private: // functions
 
+  void read_mesh_format();
+
   void get_file_positions();
 
   Handle<Region> create_region(std::string const& relative_path);
 
-  void find_used_nodes();
-
-//  void find_ghost_nodes();
+  void read_elements();
 
   void read_coordinates();
 
@@ -81,11 +84,16 @@ private: // data
   enum HashType { NODES=0, ELEMS=1 };
   Handle<MergedParallelDistribution> m_hash;
 
-  // map< gmsh index , pair< elements, index in elements > >
-  std::map<Uint, boost::tuple<Handle<Elements>,Uint> > m_elem_idx_gmsh_to_cf;
-  std::map<Uint, Uint> m_node_idx_gmsh_to_cf;
+  /// Memory mapped file contents
+  const char* m_file_begin;
+  const char* m_file_end;
+  std::string m_filename;
+
+  /// True if the file is in the binary variant of the format
+  bool m_binary;
+  /// True if the binary data was written with a different endianness
+  bool m_swap_bytes;
 
-  boost::filesystem::fstream m_file;
   Handle<Mesh> m_mesh;
   Handle<Region> m_region;
 
@@ -104,25 +112,37 @@ private: // data
                      // gmsh terminology
   Uint m_mesh_dimension;
 
-
   std::vector<RegionData> m_region_list;
 
-  std::set<Uint> m_ghost_nodes;
-  //std::set<Uint> m_ghost_elems;
-  std::set<Uint> m_used_nodes;
-  
-  std::vector<std::set<Uint> > m_node_to_glb_elements;
+  /// Owned elements of one gmsh type in one region, in order of appearance in the file
+  struct ElementBucket
+  {
+    std::vector<Uint> gmsh_idx;
+    std::vector<Uint> gmsh_nodes;
+  };
 
-  //Markers for important places in the file to be read
-  Uint m_region_names_position;
-  Uint m_coordinates_position;
-  Uint m_elements_position;
-  std::vector<Uint> m_element_data_positions;
-  std::vector<Uint> m_node_data_positions;
-  std::vector<Uint> m_element_node_data_positions;
+  /// Element buckets, indexed by region and gmsh element type
+  std::vector< std::vector<ElementBucket> > m_buckets;
+
+  /// Flags for the gmsh node numbers used by the owned elements
+  std::vector<bool> m_used_nodes;
+
+  /// Node index for every gmsh node number, math::Consts::uint_max() if the node is not read
+  std::vector<Uint> m_node_idx_gmsh_to_cf;
 
+  /// Entities created for every bucket that contains elements
+  std::vector< Handle<Entities> > m_entities;
+
+  /// (index in m_entities, index in entities) for every gmsh element number
+  std::vector< std::pair<Uint,Uint> > m_elem_idx_gmsh_to_cf;
+
+  //Markers for important places in the file to be read
+  const char* m_coordinates_position;
+  const char* m_elements_position;
+  std::vector<const char*> m_element_data_positions;
+  std::vector<const char*> m_node_data_positions;
+  std::vector<const char*> m_element_node_data_positions;
 
-  std::vector<std::vector<Uint> > m_nb_gmsh_elem_in_region;
   Uint m_total_nb_elements;
   Uint m_total_nb_nodes;
 
@@ -134,16 +154,15 @@ private: // data
     Uint time_step;
     std::vector<Uint> var_types;
     Uint nb_entries;
-    std::vector<Uint> file_data_positions;
+    std::vector<const char*> file_data_positions;
   };
 
   void fix_negative_volumes(Mesh& mesh);
 
-  void read_variable_header(std::map<std::string,Field>& fields);
+  void read_variable_header(const char* position, std::map<std::string,Field>& fields);
 
   std::string var_type_gmsh_to_cf(const Uint& var_type_gmsh);
 
-  Uint IO_rank;
 }; // end Reader
 
 ////////////////////////////////////////////////////////////////////////////////
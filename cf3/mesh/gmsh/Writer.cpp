@@ -217,8 +217,7 @@ void Writer::write_coordinates(std::fstream& file)
   file.precision(8);
 
   // Assemble a list of all the coordinates that are used in this mesh
-  const boost::shared_ptr< common::List<Uint> > used_nodes_ptr = build_used_nodes_list(m_filtered_entities,m_mesh->geometry_fields(),m_enable_overlap);
-  const common::List<Uint>& used_nodes = *used_nodes_ptr;
+  const common::List<Uint>& used_nodes = MeshWriter::used_nodes();
 
   // Create a mapping between the actual node-numbering in the mesh, and the node-numbering to be written
   const Uint nb_nodes = used_nodes.size();
@@ -229,7 +228,7 @@ void Writer::write_coordinates(std::fstream& file)
   const Uint nb_dim = m_mesh->dimension();
   Uint node_number=0;
   const Dictionary& geometry = m_mesh->geometry_fields();
-  const common::Table<Real>& coordinates = geometry.coordinates();
+  const common::TableArray<Real>::type& coordinates = field_values(geometry.coordinates());
   Uint gmsh_node = 1;
   boost_foreach( const Uint node, used_nodes.array())
   {
@@ -332,6 +331,7 @@ void Writer::write_elem_nodal_data(std::fstream& file)
   {
     cf3_assert(is_null(field_h) == false);
     const Field& field = *field_h;
+    const common::TableArray<Real>::type& values = field_values(field);
 //    if (field.basis() == Dictionary::Basis::ELEMENT_BASED ||
 //        field.basis() == Dictionary::Basis::CELL_BASED    ||
 //        field.basis() == Dictionary::Basis::FACE_BASED    )
@@ -414,7 +414,7 @@ void Writer::write_elem_nodal_data(std::fstream& file)
                 for (Uint iState=0; iState<nb_states; ++iState)
                 {
                   for (Uint j=0; j<var_type; ++j)
-                    field_data(iState,j) = field[field_indexes[iState]][row_idx+j];
+                    field_data(iState,j) = values[field_indexes[iState]][row_idx+j];
                 }
 
                 for (Uint iNode=0; iNode<nb_nodes; ++iNode)
@@ -42,6 +42,8 @@ public: // functions
 
   virtual std::vector<std::string> get_extensions();
 
+  virtual bool supports_asynchronous_write() const { return true; }
+
 private: // functions
 
   virtual void write();
@@ -0,0 +1,19 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/RegistLibrary.hpp"
+
+#include "mesh/native/LibNative.hpp"
+
+namespace cf3 {
+namespace mesh {
+namespace native {
+
+cf3::common::RegistLibrary<LibNative> libNative;
+
+} // native
+} // mesh
+} // cf3
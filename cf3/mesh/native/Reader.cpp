@@ -0,0 +1,342 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cstring>
+#include <map>
+
+#include <boost/tokenizer.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "common/Log.hpp"
+#include "common/BoostFilesystem.hpp"
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/StringConversion.hpp"
+#include "common/Table.hpp"
+#include "common/List.hpp"
+
+#include "mesh/native/Reader.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3::common;
+
+namespace cf3 {
+namespace mesh {
+namespace native {
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < native::Reader, MeshReader, LibNative > aNativeReader_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+
+/// Iterates over the blocks of a partition in a memory mapped file
+class BlockReader
+{
+public:
+
+  /// A block, pointing directly into the mapped memory
+  struct Block
+  {
+    const Shared::BlockHeader* header;
+    std::string name;
+    std::string description;
+    const char* data;
+  };
+
+  BlockReader(const char* begin, const char* end, const std::string& file) :
+    m_current(begin),
+    m_end(end),
+    m_file(file)
+  {
+  }
+
+  /// Move to the next block
+  /// @return false if there are no more blocks
+  bool next(Block& block)
+  {
+    if (m_current == m_end)
+      return false;
+
+    block.header = reinterpret_cast<const Shared::BlockHeader*>(advance(sizeof(Shared::BlockHeader)));
+    block.name.assign(advance(block.header->name_size), block.header->name_size);
+    block.description.assign(advance(block.header->description_size), block.header->description_size);
+    block.data = advance(block.header->data_size);
+    return true;
+  }
+
+private:
+
+  const char* advance(const boost::uint64_t nb_bytes)
+  {
+    const boost::uint64_t padded = Shared::padded_size(nb_bytes);
+    if (boost::uint64_t(m_end - m_current) < padded)
+      throw FileFormatError(FromHere(), m_file + " is truncated or corrupt");
+    const char* begin = m_current;
+    m_current += padded;
+    return begin;
+  }
+
+  const char* m_current;
+  const char* m_end;
+  const std::string m_file;
+};
+
+/// Copy the data of a block into an array with the same size
+template <typename ArrayT>
+void copy_block(const BlockReader::Block& block, ArrayT& array, const std::string& file)
+{
+  typedef typename ArrayT::element ValueT;
+  if (block.header->data_size != array.num_elements()*sizeof(ValueT))
+    throw FileFormatError(FromHere(), file + ": block \"" + block.name + "\" has "+to_str(Uint(block.header->data_size))
+                          +" bytes, but "+to_str(Uint(array.num_elements()*sizeof(ValueT)))+" bytes were expected");
+  if (block.header->data_size)
+    std::memcpy(array.data(), block.data, block.header->data_size);
+}
+
+/// Compute for every row in the file the matching row in the dictionary, using the global indices.
+/// The map is left empty if the rows are in the same order.
+void build_row_map(const BlockReader::Block& block, const Dictionary& dict, std::vector<Uint>& row_map, const std::string& file)
+{
+  row_map.clear();
+  const Uint nb_rows = block.header->nb_rows;
+  if (nb_rows != dict.size() || block.header->data_size != nb_rows*sizeof(Uint))
+    throw FileFormatError(FromHere(), file + ": dictionary \"" + dict.name() + "\" has " + to_str(dict.size())
+                          + " rows, but " + to_str(nb_rows) + " rows were written");
+
+  const Uint* file_glb_idx = reinterpret_cast<const Uint*>(block.data);
+  if (nb_rows == 0 || std::memcmp(file_glb_idx, dict.glb_idx().array().data(), nb_rows*sizeof(Uint)) == 0)
+    return;
+
+  std::map<Uint,Uint> glb_to_loc;
+  for (Uint i=0; i<nb_rows; ++i)
+    glb_to_loc[dict.glb_idx()[i]] = i;
+  if (glb_to_loc.size() != nb_rows)
+    throw FileFormatError(FromHere(), file + ": rows of dictionary \"" + dict.name() + "\" can't be matched, because its global indices are not unique");
+
+  row_map.resize(nb_rows);
+  for (Uint i=0; i<nb_rows; ++i)
+  {
+    std::map<Uint,Uint>::const_iterator it = glb_to_loc.find(file_glb_idx[i]);
+    if (it == glb_to_loc.end())
+      throw FileFormatError(FromHere(), file + ": global index " + to_str(file_glb_idx[i]) + " not found in dictionary \"" + dict.name() + "\"");
+    row_map[i] = it->second;
+  }
+}
+
+} // detail
+
+//////////////////////////////////////////////////////////////////////////////
+
+Reader::Reader( const std::string& name )
+: MeshReader(name)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> Reader::get_extensions()
+{
+  std::vector<std::string> extensions;
+  extensions.push_back(".cf3mesh");
+  return extensions;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
+{
+  boost::filesystem::path fp (file.path());
+  if( !boost::filesystem::exists(fp) )
+  {
+     throw boost::filesystem::filesystem_error( fp.string() + " does not exist", boost::system::error_code() );
+  }
+  const std::string path = fp.string();
+
+  CFinfo << "Opening file " <<  path << CFendl;
+
+  // set the internal mesh pointer
+  m_mesh = Handle<Mesh>(mesh.handle<Component>());
+
+  const bool parallel = PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1;
+  const Uint nb_procs = parallel ? PE::Comm::instance().size() : 1u;
+  const Uint partition = parallel ? PE::Comm::instance().rank() : 0u;
+
+  // Read the header and the location of the partition of this process
+  FileHeader header;
+  PartitionIndex index;
+  {
+    boost::filesystem::fstream header_file;
+    header_file.open(fp, std::ios_base::in | std::ios_base::binary);
+    header_file.read(reinterpret_cast<char*>(&header), sizeof(FileHeader));
+    if (!header_file || std::strncmp(header.magic, magic(), sizeof(header.magic)) != 0)
+      throw FileFormatError(FromHere(), path + " is not a native mesh file");
+    if (header.version != version)
+      throw FileFormatError(FromHere(), path + " has version " + to_str(header.version) + ", while version " + to_str(version) + " is supported");
+    if (header.real_size != sizeof(Real) || header.uint_size != sizeof(Uint))
+      throw FileFormatError(FromHere(), path + " was written with different sizes of Real or Uint");
+    if (header.nb_partitions != nb_procs)
+      throw FileFormatError(FromHere(), path + " contains " + to_str(header.nb_partitions) + " partitions, but is read by "
+                            + to_str(nb_procs) + " processes. It must be read by as many processes as it was written with.");
+
+    header_file.seekg(sizeof(FileHeader) + partition*sizeof(PartitionIndex));
+    header_file.read(reinterpret_cast<char*>(&index), sizeof(PartitionIndex));
+    if (!header_file)
+      throw FileFormatError(FromHere(), path + " is truncated or corrupt");
+  }
+
+  // Map only the partition of this process, starting from a properly aligned offset
+  const boost::uint64_t map_alignment = boost::iostreams::mapped_file_source::alignment();
+  const boost::uint64_t map_offset = (index.offset / map_alignment) * map_alignment;
+  boost::iostreams::mapped_file_source partition_map(path, index.size + (index.offset - map_offset), map_offset);
+  const char* begin = partition_map.data() + (index.offset - map_offset);
+  detail::BlockReader blocks(begin, begin + index.size, path);
+
+  Dictionary& geometry = m_mesh->geometry_fields();
+  std::vector< Handle<Entities> > entities;
+  Handle<Dictionary> dict = geometry.handle<Dictionary>();
+  std::vector<Uint> row_map;
+
+  detail::BlockReader::Block block;
+  while (blocks.next(block))
+  {
+    switch (block.header->type)
+    {
+      case NODES:
+        m_mesh->initialize_nodes(block.header->nb_rows, block.header->nb_cols);
+        detail::copy_block(block, geometry.coordinates().array(), path);
+        break;
+
+      case NODES_GLB_IDX:
+        detail::copy_block(block, geometry.glb_idx().array(), path);
+        break;
+
+      case NODES_RANK:
+        detail::copy_block(block, geometry.rank().array(), path);
+        break;
+
+      case ELEMENTS:
+      {
+        const std::string::size_type sep = block.name.find_last_of('/');
+        Region& region = sep == std::string::npos ? m_mesh->topology() : create_region(block.name.substr(0, sep));
+        const std::string name = sep == std::string::npos ? block.name : block.name.substr(sep+1);
+
+        boost::shared_ptr<Entities> new_entities = build_component_abstract_type<Entities>(entities_builder_name(EntitiesKind(block.header->flags)), name);
+        region.add_component(new_entities);
+        new_entities->initialize(block.description, geometry);
+        new_entities->resize(block.header->nb_rows);
+        detail::copy_block(block, new_entities->geometry_space().connectivity().array(), path);
+        entities.push_back(new_entities->handle<Entities>());
+        break;
+      }
+
+      case ELEMENTS_GLB_IDX:
+        if (entities.empty())
+          throw FileFormatError(FromHere(), path + ": element global indices found before any elements");
+        detail::copy_block(block, entities.back()->glb_idx().array(), path);
+        break;
+
+      case ELEMENTS_RANK:
+        if (entities.empty())
+          throw FileFormatError(FromHere(), path + ": element ranks found before any elements");
+        detail::copy_block(block, entities.back()->rank().array(), path);
+        break;
+
+      case DICTIONARY:
+      {
+        const Uint nb_entities = block.header->nb_rows;
+        if (block.header->data_size != nb_entities*sizeof(Uint))
+          throw FileFormatError(FromHere(), path + ": dictionary \"" + block.name + "\" is corrupt");
+        const Uint* entities_idx = reinterpret_cast<const Uint*>(block.data);
+        std::vector< Handle<Entities> > dict_entities(nb_entities);
+        for (Uint e=0; e<nb_entities; ++e)
+        {
+          if (entities_idx[e] >= entities.size())
+            throw FileFormatError(FromHere(), path + ": dictionary \"" + block.name + "\" refers to unknown elements");
+          dict_entities[e] = entities[entities_idx[e]];
+        }
+
+        if (block.header->flags == CONTINUOUS)
+          dict = m_mesh->create_continuous_space(block.name, block.description, dict_entities).handle<Dictionary>();
+        else
+          dict = m_mesh->create_discontinuous_space(block.name, block.description, dict_entities).handle<Dictionary>();
+        row_map.clear();
+        break;
+      }
+
+      case DICTIONARY_GLB_IDX:
+        detail::build_row_map(block, *dict, row_map, path);
+        break;
+
+      case FIELD:
+      {
+        Field& field = dict->create_field(block.name, block.description);
+        if (field.row_size() != block.header->nb_cols)
+          throw FileFormatError(FromHere(), path + ": field \"" + block.name + "\" has " + to_str(Uint(block.header->nb_cols))
+                                + " columns, but its variables require " + to_str(field.row_size()));
+        if (row_map.empty())
+        {
+          detail::copy_block(block, field.array(), path);
+        }
+        else
+        {
+          if (block.header->nb_rows != row_map.size() || block.header->data_size != block.header->nb_rows*block.header->nb_cols*sizeof(Real))
+            throw FileFormatError(FromHere(), path + ": field \"" + block.name + "\" is corrupt");
+          const Uint row_size = field.row_size();
+          const Real* data = reinterpret_cast<const Real*>(block.data);
+          for (Uint i=0; i<row_map.size(); ++i)
+            std::memcpy(&field[row_map[i]][0], data + i*row_size, row_size*sizeof(Real));
+        }
+        break;
+      }
+
+      default: // unknown blocks are skipped
+        break;
+    }
+  }
+
+  partition_map.close();
+
+  m_mesh->update_statistics();
+  m_mesh->update_structures();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Region& Reader::create_region(const std::string& relative_path)
+{
+  typedef boost::tokenizer<boost::char_separator<char> > Tokenizer;
+  boost::char_separator<char> sep("/");
+  Tokenizer tokens(relative_path, sep);
+
+  Handle< Region > region = m_mesh->topology().handle<Region>();
+  for (Tokenizer::iterator tok_iter = tokens.begin(); tok_iter != tokens.end(); ++tok_iter)
+  {
+    std::string name = *tok_iter;
+    Handle< Component > new_region = region->get_child(name);
+    if (is_null(new_region))  region->create_component<Region>(name);
+    region = Handle<Region>(region->get_child(name));
+  }
+  return *region;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
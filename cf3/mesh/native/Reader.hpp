@@ -0,0 +1,62 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_native_Reader_hpp
+#define cf3_mesh_native_Reader_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshReader.hpp"
+
+#include "mesh/native/LibNative.hpp"
+#include "mesh/native/Shared.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+class Region;
+
+namespace native {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class defines the native binary mesh format reader
+/// The file is memory mapped, and every process only maps and reads its own partition.
+/// The file must therefore be read by as many processes as it was written with.
+class native_API Reader : public MeshReader, public native::Shared
+{
+public: // functions
+
+  /// constructor
+  Reader( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Reader"; }
+
+  virtual std::string get_format() { return "native"; }
+
+  virtual std::vector<std::string> get_extensions();
+
+private: // functions
+
+  virtual void do_read_mesh_into(const common::URI& fp, Mesh& mesh);
+
+  /// Get or create the region with given path, relative to the topology
+  Region& create_region(const std::string& relative_path);
+
+}; // end Reader
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_native_Reader_hpp
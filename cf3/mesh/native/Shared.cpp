@@ -0,0 +1,47 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/BasicExceptions.hpp"
+#include "common/StringConversion.hpp"
+
+#include "mesh/Cells.hpp"
+#include "mesh/Faces.hpp"
+#include "mesh/CellFaces.hpp"
+
+#include "mesh/native/Shared.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace native {
+
+//////////////////////////////////////////////////////////////////////////////
+
+const boost::uint32_t Shared::version;
+const boost::uint64_t Shared::alignment;
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::string Shared::entities_builder_name(const EntitiesKind kind)
+{
+  switch (kind)
+  {
+    case CELLS:
+      return "cf3.mesh."+Cells::type_name();
+    case FACES:
+      return "cf3.mesh."+Faces::type_name();
+    case CELLFACES:
+      return "cf3.mesh."+CellFaces::type_name();
+  }
+  throw common::FileFormatError(FromHere(), "Unknown kind of entities: "+common::to_str(Uint(kind)));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
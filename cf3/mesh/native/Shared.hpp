@@ -0,0 +1,125 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_native_Shared_hpp
+#define cf3_mesh_native_Shared_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/cstdint.hpp>
+
+#include "mesh/native/LibNative.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace native {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class defines the layout of the native binary mesh format
+/// @code
+/// FileHeader                        magic string, version, sizeof(Real), sizeof(Uint), number of partitions
+/// PartitionIndex[nb_partitions]     byte offset and byte size of each partition
+/// partition 0                       sequence of blocks
+/// ...
+/// partition nb_partitions-1
+/// @endcode
+/// A partition contains the complete mesh of one process, including its ghost nodes and elements.
+/// Every block consists of a BlockHeader followed by its name, its description and its data,
+/// each padded to a multiple of 8 bytes, so that the data of all blocks is aligned in a memory mapped file.
+/// The blocks of a partition appear in this order:
+/// - NODES, NODES_GLB_IDX, NODES_RANK: coordinates, global indices and ranks of the geometry nodes
+/// - FIELD: fields of the geometry dictionary
+/// - ELEMENTS, ELEMENTS_GLB_IDX, ELEMENTS_RANK, for every Entities:
+///   the name is the path relative to the topology, the description the element type, the data the node connectivity
+/// - DICTIONARY, DICTIONARY_GLB_IDX, for every other dictionary with fields:
+///   the description is the space library, the data the indices of the ELEMENTS blocks the dictionary is defined on
+/// - FIELD: fields of the preceding dictionary
+class native_API Shared
+{
+public:
+
+  /// Gets the Class name
+  static std::string type_name() { return "Shared"; }
+
+  /// Types of the blocks in a partition
+  enum BlockType { NODES=1,      NODES_GLB_IDX=2,      NODES_RANK=3,
+                   ELEMENTS=4,   ELEMENTS_GLB_IDX=5,   ELEMENTS_RANK=6,
+                   DICTIONARY=7, DICTIONARY_GLB_IDX=8,
+                   FIELD=9 };
+
+  /// Flags of an ELEMENTS block, defining the kind of entities
+  enum EntitiesKind { CELLS=0, FACES=1, CELLFACES=2 };
+
+  /// Flags of a DICTIONARY block
+  enum DictionaryKind { DISCONTINUOUS=0, CONTINUOUS=1 };
+
+  /// Header at the start of the file
+  struct FileHeader
+  {
+    char            magic[8];
+    boost::uint32_t version;
+    boost::uint32_t real_size;
+    boost::uint32_t uint_size;
+    boost::uint32_t nb_partitions;
+  };
+
+  /// Location of a partition in the file
+  struct PartitionIndex
+  {
+    boost::uint64_t offset;
+    boost::uint64_t size;
+  };
+
+  /// Header of each block in a partition
+  struct BlockHeader
+  {
+    boost::uint32_t type;
+    boost::uint32_t flags;
+    boost::uint64_t nb_rows;
+    boost::uint64_t nb_cols;
+    boost::uint32_t name_size;
+    boost::uint32_t description_size;
+    boost::uint64_t data_size;
+  };
+
+  /// String identifying the format, including the terminating null character
+  static const char* magic() { return "CF3MESH"; }
+
+  /// Version of the format
+  static const boost::uint32_t version = 1;
+
+  /// Byte alignment of all headers, strings and data in the file
+  static const boost::uint64_t alignment = 8;
+
+  /// @return nb_bytes rounded up to a multiple of the alignment
+  static boost::uint64_t padded_size(const boost::uint64_t nb_bytes)
+  {
+    return ((nb_bytes + alignment - 1) / alignment) * alignment;
+  }
+
+  /// @return the size of the file header, including the partition index
+  static boost::uint64_t header_size(const Uint nb_partitions)
+  {
+    return padded_size(sizeof(FileHeader) + nb_partitions*sizeof(PartitionIndex));
+  }
+
+  /// @return the name of the builder for the given kind of entities
+  static std::string entities_builder_name(const EntitiesKind kind);
+
+}; // end Shared
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_native_Shared_hpp
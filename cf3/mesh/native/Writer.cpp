@@ -0,0 +1,348 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include <boost/algorithm/string/replace.hpp>
+
+#include "common/Log.hpp"
+#include "common/BoostFilesystem.hpp"
+#include "common/Foreach.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/Aggregation.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/StringConversion.hpp"
+
+#include "math/VariablesDescriptor.hpp"
+
+#include "mesh/native/Writer.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/Faces.hpp"
+#include "mesh/CellFaces.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ShapeFunction.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3::common;
+
+namespace cf3 {
+namespace mesh {
+namespace native {
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < native::Writer, MeshWriter, LibNative> aNativeWriter_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+
+/// Writes blocks to a stream, or only counts their size if no stream is given
+class BlockStream
+{
+public:
+
+  BlockStream(std::ostream* out) : m_out(out), m_size(0) {}
+
+  /// write a block with the given raw data
+  void write_block(const Shared::BlockType type, const Uint flags, const Uint nb_rows, const Uint nb_cols,
+                   const std::string& name, const std::string& description,
+                   const void* data, const boost::uint64_t data_size)
+  {
+    Shared::BlockHeader header;
+    std::memset(&header, 0, sizeof(Shared::BlockHeader));
+    header.type = type;
+    header.flags = flags;
+    header.nb_rows = nb_rows;
+    header.nb_cols = nb_cols;
+    header.name_size = name.size();
+    header.description_size = description.size();
+    header.data_size = data_size;
+
+    write_bytes(&header, sizeof(Shared::BlockHeader));
+    write_bytes(name.data(), name.size());
+    write_bytes(description.data(), description.size());
+    write_bytes(data, data_size);
+  }
+
+  /// write a block with the contents of a table
+  template <typename T>
+  void write_table(const Shared::BlockType type, const Uint flags, const std::string& name, const std::string& description,
+                   const boost::multi_array<T,2>& array)
+  {
+    const Uint nb_rows = array.shape()[0];
+    const Uint nb_cols = array.shape()[1];
+    write_block(type, flags, nb_rows, nb_cols, name, description, array.data(), boost::uint64_t(nb_rows)*nb_cols*sizeof(T));
+  }
+
+  /// write a block with the contents of a list
+  template <typename T>
+  void write_list(const Shared::BlockType type, const Uint flags, const std::string& name, const std::string& description,
+                  const boost::multi_array<T,1>& list)
+  {
+    const Uint nb_rows = list.size();
+    write_block(type, flags, nb_rows, 1, name, description, list.data(), boost::uint64_t(nb_rows)*sizeof(T));
+  }
+
+  /// write a block with the contents of a vector
+  template <typename T>
+  void write_list(const Shared::BlockType type, const Uint flags, const std::string& name, const std::string& description,
+                  const std::vector<T>& list)
+  {
+    const Uint nb_rows = list.size();
+    write_block(type, flags, nb_rows, 1, name, description, list.empty() ? 0 : &list[0], boost::uint64_t(nb_rows)*sizeof(T));
+  }
+
+  /// @return number of bytes written so far
+  boost::uint64_t size() const { return m_size; }
+
+private:
+
+  void write_bytes(const void* data, const boost::uint64_t nb_bytes)
+  {
+    const boost::uint64_t padded = Shared::padded_size(nb_bytes);
+    if (m_out)
+    {
+      if (nb_bytes)
+        m_out->write(static_cast<const char*>(data), nb_bytes);
+      static const char zeros[Shared::alignment] = {0};
+      m_out->write(zeros, padded-nb_bytes);
+    }
+    m_size += padded;
+  }
+
+  std::ostream* m_out;
+  boost::uint64_t m_size;
+};
+
+} // detail
+
+//////////////////////////////////////////////////////////////////////////////
+
+Writer::Writer( const std::string& name )
+: MeshWriter(name)
+{
+  options().add_option("nb_aggregators", 0u)
+      .pretty_name("Number of Aggregators")
+      .description("Number of processes that write to the file, each one the partitions of a group of consecutive processes. "
+                   "0 means all processes write their own partition.");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> Writer::get_extensions()
+{
+  std::vector<std::string> extensions;
+  extensions.push_back(".cf3mesh");
+  return extensions;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write()
+{
+  const bool parallel = PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1;
+  const Uint nb_partitions = parallel ? PE::Comm::instance().size() : 1u;
+  const Uint partition = parallel ? PE::Comm::instance().rank() : 0u;
+  const PE::Aggregation aggregation(options().option("nb_aggregators").value<Uint>());
+
+  // Compute the size of the partition of this process, without writing anything
+  detail::BlockStream counter(0);
+  write_partition(counter);
+
+  std::vector<boost::uint64_t> partition_sizes(1, counter.size());
+  if (parallel)
+    PE::Comm::instance().all_gather(counter.size(), partition_sizes);
+
+  std::vector<PartitionIndex> index(nb_partitions);
+  boost::uint64_t offset = header_size(nb_partitions);
+  for (Uint p=0; p<nb_partitions; ++p)
+  {
+    index[p].offset = offset;
+    index[p].size = partition_sizes[p];
+    offset += partition_sizes[p];
+  }
+
+  boost::filesystem::path path (m_file_path.path());
+  boost::filesystem::fstream file;
+
+  // The first process creates the file and writes the header
+  if (partition == 0)
+  {
+    file.open(path, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+    if (!file) // didn't open so throw exception
+    {
+       throw boost::filesystem::filesystem_error( path.string() + " failed to open",
+                                                  boost::system::error_code() );
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(FileHeader));
+    std::strcpy(header.magic, magic());
+    header.version = version;
+    header.real_size = sizeof(Real);
+    header.uint_size = sizeof(Uint);
+    header.nb_partitions = nb_partitions;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+    file.write(reinterpret_cast<const char*>(&index[0]), nb_partitions*sizeof(PartitionIndex));
+  }
+
+  if (parallel)
+    PE::Comm::instance().barrier();
+
+  // All other aggregators open the created file, and write the partitions of their group,
+  // which are contiguous, starting at the offset of their own partition
+  if (aggregation.is_aggregator())
+  {
+    if (partition != 0)
+    {
+      file.open(path, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+      if (!file) // didn't open so throw exception
+      {
+         throw boost::filesystem::filesystem_error( path.string() + " failed to open",
+                                                    boost::system::error_code() );
+      }
+    }
+
+    file.seekp(index[partition].offset);
+    detail::BlockStream stream(&file);
+    write_partition(stream);
+    cf3_assert(stream.size() == index[partition].size);
+
+    std::vector<char> buffer;
+    for (Uint p=partition+1; p<aggregation.group_end(aggregation.group()); ++p)
+    {
+      aggregation.receive(p, buffer);
+      cf3_assert(buffer.size() == index[p].size);
+      file.write(buffer.empty() ? 0 : &buffer[0], buffer.size());
+    }
+
+    file.close();
+  }
+  // Processes that are not aggregators send their partition to the aggregator of their group
+  else
+  {
+    std::ostringstream buffer(std::ios_base::out | std::ios_base::binary);
+    detail::BlockStream stream(&buffer);
+    write_partition(stream);
+    cf3_assert(stream.size() == index[partition].size);
+    aggregation.send(buffer.str());
+  }
+
+  // The file is only complete when all processes wrote their partition
+  if (parallel)
+    PE::Comm::instance().barrier();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_partition(detail::BlockStream& stream)
+{
+  const Mesh& mesh = *m_mesh;
+  const Dictionary& geometry = mesh.geometry_fields();
+
+  // Nodes
+  stream.write_table(NODES, 0, geometry.name(), "", geometry.coordinates().array());
+  stream.write_list(NODES_GLB_IDX, 0, "", "", geometry.glb_idx().array());
+  stream.write_list(NODES_RANK, 0, "", "", geometry.rank().array());
+
+  // Fields defined in the geometry dictionary, other dictionaries in order of appearance
+  std::vector< Handle<Dictionary const> > dictionaries;
+  boost_foreach(const Handle<Field const>& field, m_fields)
+  {
+    if (&field->dict() == &geometry)
+    {
+      if (field.get() != &geometry.coordinates())
+        stream.write_table(FIELD, 0, field->name(), field->descriptor().description(), field->array());
+    }
+    else if (std::find(dictionaries.begin(), dictionaries.end(), field->dict().handle<Dictionary const>()) == dictionaries.end())
+    {
+      dictionaries.push_back(field->dict().handle<Dictionary const>());
+    }
+  }
+
+  // Elements: all entities in the topology, regardless of the region filters
+  const std::string topology_path = mesh.topology().uri().path() + "/";
+  std::map<const Entities*, Uint> entities_index;
+  boost_foreach(const Entities& entities, find_components_recursively<Entities>(mesh.topology()))
+  {
+    EntitiesKind kind = CELLS;
+    if (is_not_null(dynamic_cast<const CellFaces*>(&entities)))
+      kind = CELLFACES;
+    else if (is_not_null(dynamic_cast<const Faces*>(&entities)))
+      kind = FACES;
+    else if (is_null(dynamic_cast<const Cells*>(&entities)))
+    {
+      CFwarn << "Entities " << entities.uri() << " of type " << entities.derived_type_name()
+             << " can't be written in the native format, and are skipped" << CFendl;
+      continue;
+    }
+
+    std::string path = entities.uri().path();
+    boost::algorithm::replace_first(path, topology_path, "");
+
+    const Uint idx = entities_index.size();
+    entities_index[&entities] = idx;
+    stream.write_table(ELEMENTS, kind, path, entities.element_type().derived_type_name(), entities.geometry_space().connectivity().array());
+    stream.write_list(ELEMENTS_GLB_IDX, 0, "", "", entities.glb_idx().array());
+    stream.write_list(ELEMENTS_RANK, 0, "", "", entities.rank().array());
+  }
+
+  // Other dictionaries, followed by their fields
+  boost_foreach(const Handle<Dictionary const>& dict, dictionaries)
+  {
+    std::vector<Uint> dict_entities(dict->entities_range().size());
+    Uint e=0;
+    std::string space_lib_name;
+    boost_foreach(const Handle<Entities>& entities, dict->entities_range())
+    {
+      std::map<const Entities*, Uint>::const_iterator it = entities_index.find(entities.get());
+      if (it == entities_index.end())
+      {
+        space_lib_name.clear();
+        break;
+      }
+      dict_entities[e++] = it->second;
+      const std::string shape_function_name = dict->space(*entities).shape_function().derived_type_name();
+      space_lib_name = shape_function_name.substr(0, shape_function_name.find_last_of('.'));
+    }
+
+    if (space_lib_name.empty())
+    {
+      CFwarn << "Dictionary " << dict->uri() << " is not defined on the written entities, its fields are skipped" << CFendl;
+      continue;
+    }
+
+    stream.write_list(DICTIONARY, dict->continuous() ? CONTINUOUS : DISCONTINUOUS, dict->name(), space_lib_name, dict_entities);
+    stream.write_list(DICTIONARY_GLB_IDX, 0, "", "", dict->glb_idx().array());
+
+    boost_foreach(const Handle<Field const>& field, m_fields)
+    {
+      if (&field->dict() == dict.get())
+        stream.write_table(FIELD, 0, field->name(), field->descriptor().description(), field->array());
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
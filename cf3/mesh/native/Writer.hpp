@@ -0,0 +1,66 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_native_Writer_hpp
+#define cf3_mesh_native_Writer_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshWriter.hpp"
+
+#include "mesh/native/LibNative.hpp"
+#include "mesh/native/Shared.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace native {
+
+namespace detail { class BlockStream; }
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class defines the native binary mesh format writer
+/// All processes write their partition, including the ghost nodes and elements,
+/// at a precomputed offset in a single file, so that the mesh can be restored exactly by the Reader.
+/// With the option "nb_aggregators", only that many processes open the file, writing the partitions
+/// of their group of processes after receiving them.
+/// Options that filter regions or the overlap are ignored.
+class native_API Writer : public MeshWriter, public native::Shared
+{
+
+public: // functions
+
+  /// constructor
+  Writer( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Writer"; }
+
+  virtual std::string get_format() { return "native"; }
+
+  virtual std::vector<std::string> get_extensions();
+
+private: // functions
+
+  virtual void write();
+
+  /// write all blocks of the partition of this process
+  void write_partition(detail::BlockStream& stream);
+
+}; // end Writer
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_native_Writer_hpp
@@ -67,6 +67,7 @@ private: // functions
   SCOTCH_Num edgelocsiz;
   std::vector<SCOTCH_Num> vertloctab;
   std::vector<SCOTCH_Num> edgeloctab;
+  std::vector<SCOTCH_Num> veloloctab;
   std::vector<SCOTCH_Num> edgegsttab;
   std::vector<SCOTCH_Num> partloctab;
   std::vector<SCOTCH_Num> proccnttab;// number of vertices per processor
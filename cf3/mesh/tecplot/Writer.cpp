@@ -166,8 +166,7 @@ void Writer::write_file(std::fstream& file)
 
     zone_id[elements.handle<Component>()] = zone_idx++;
 
-    boost::shared_ptr< common::List<Uint> > used_nodes_ptr = mesh::build_used_nodes_list(elements,m_mesh->geometry_fields(),m_enable_overlap);
-    common::List<Uint>& used_nodes = *used_nodes_ptr;
+    const common::List<Uint>& used_nodes = MeshWriter::used_nodes(elements);
     std::map<Uint,Uint> zone_node_idx;
     for (Uint n=0; n<used_nodes.size(); ++n)
       zone_node_idx[ used_nodes[n] ] = n+1;
@@ -203,7 +202,7 @@ void Writer::write_file(std::fstream& file)
     file.precision(12);
 
     // loop over coordinates
-    const common::Table<Real>& coordinates = m_mesh->geometry_fields().coordinates();
+    const common::TableArray<Real>::type& coordinates = field_values(m_mesh->geometry_fields().coordinates());
     for (Uint d = 0; d < dimension; ++d)
     {
       file << "\n### variable x" << d << "\n\n"; // var name in comment
@@ -221,6 +220,7 @@ void Writer::write_file(std::fstream& file)
     boost_foreach(Handle<Field const> field_ptr, m_fields)
     {
       const Field& field = *field_ptr;
+      const common::TableArray<Real>::type& values = field_values(field);
       Uint var_idx(0);
       for (Uint iVar=0; iVar<field.nb_vars(); ++iVar)
       {
@@ -237,7 +237,7 @@ void Writer::write_file(std::fstream& file)
             {
               boost_foreach(Uint n, used_nodes.array())
               {
-                file << field[n][var_idx] << " ";
+                file << values[n][var_idx] << " ";
                 CF3_BREAK_LINE(file,n);
               }
               file << "\n";
@@ -272,7 +272,7 @@ void Writer::write_file(std::fstream& file)
                     /// set field data
                     for (Uint iState=0; iState<field_space.shape_function().nb_nodes(); ++iState)
                     {
-                      field_data[iState] = field[field_index[iState]][var_idx];
+                      field_data[iState] = values[field_index[iState]][var_idx];
                     }
 
                     /// evaluate field shape function in P0 space
@@ -309,7 +309,9 @@ void Writer::write_file(std::fstream& file)
 
               if (options().option("cell_centred").value<bool>())
               {
-                boost::shared_ptr< ShapeFunction > P0_cell_centred = boost::dynamic_pointer_cast<ShapeFunction>(build_component("cf3.mesh.LagrangeP1."+to_str(elements.element_type().shape_name()),"tmp_shape_func"));
+                // The element type is P1, checked above. Its shape function is used instead of building one,
+                // as this can run in the background thread of an asynchronous write
+                const ShapeFunction& P1_shape_function = elements.element_type().shape_function();
 
                 for (Uint e=0; e<elements.size(); ++e)
                 {
@@ -319,11 +321,11 @@ void Writer::write_file(std::fstream& file)
                     /// set field data
                     for (Uint iState=0; iState<field_space.shape_function().nb_nodes(); ++iState)
                     {
-                      field_data[iState] = field[field_index[iState]][var_idx];
+                      field_data[iState] = values[field_index[iState]][var_idx];
                     }
 
                     /// get cell-centred local coordinates
-                    RealVector local_coords = P0_cell_centred->local_coordinates().row(0);
+                    RealVector local_coords = P1_shape_function.local_coordinates().row(0);
 
                     /// evaluate field shape function in P0 space
                     Real cell_centred_data = field_space.shape_function().value(local_coords)*field_data;
@@ -355,7 +357,7 @@ void Writer::write_file(std::fstream& file)
                   /// set field data
                   for (Uint iState=0; iState<field_space.shape_function().nb_nodes(); ++iState)
                   {
-                    field_data[iState] = field[field_index[iState]][var_idx];
+                    field_data[iState] = values[field_index[iState]][var_idx];
                   }
 
                   /// evaluate field shape function in P0 space
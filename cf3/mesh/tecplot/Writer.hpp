@@ -46,6 +46,8 @@ public: // functions
 
   virtual std::vector<std::string> get_extensions();
 
+  virtual bool supports_asynchronous_write() const { return true; }
+
 private: // functions
 
   void write_file(std::fstream& file);
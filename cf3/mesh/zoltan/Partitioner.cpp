@@ -180,6 +180,10 @@ void Partitioner::set_partitioning_params()
   zoltan_handle().Set_Param( "NUM_GLOBAL_PARTS", to_str( options()["nb_parts"].value<Uint>() ));
   // The total number of parts to be generated by a call to Zoltan_LB_Partition.
 
+  zoltan_handle().Set_Param( "OBJ_WEIGHT_DIM", has_weights() ? "1" : "0" );
+  // The number of weights (to be supplied by the user in a query function) associated with an object.
+  // If this parameter is zero, all objects have equal weight.
+
 
   /// zoltan graph parameters
 
@@ -242,6 +246,11 @@ void Partitioner::query_list_of_objects(void *data, int sizeGID, int sizeLID,
 
   p.list_of_objects_owned_by_part(PE::Comm::instance().rank(),globalID);
 
+  if (wgt_dim > 0)
+  {
+    cf3_assert(wgt_dim == 1);
+    p.list_of_object_weights_in_part(PE::Comm::instance().rank(),obj_wgts);
+  }
 
   // for debugging
 #if 0
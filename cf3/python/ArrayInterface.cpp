@@ -0,0 +1,119 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "python/BoostPython.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/Component.hpp"
+
+#include "python/ArrayInterface.hpp"
+#include "python/ComponentWrapper.hpp"
+
+namespace cf3 {
+namespace python {
+
+using namespace boost::python;
+
+/// Holds the __array_interface__ dictionary that numpy reads to create an array on existing memory,
+/// together with the component that owns the memory. numpy keeps this object as the base of the array,
+/// so the owner is not destroyed while the array exists, even if it is removed from the component tree.
+struct ArrayInterface
+{
+  typedef boost::function<void* (Uint&, Uint&)> StorageT;
+
+  ArrayInterface(const dict& interface, const common::Component& owner, const StorageT& storage, void* data, const Uint nb_rows, const Uint nb_cols) :
+    m_interface(interface),
+    m_owner(owner.handle().lock()),
+    m_storage(storage),
+    m_data(data),
+    m_nb_rows(nb_rows),
+    m_nb_cols(nb_cols)
+  {
+  }
+
+  /// True if the owner still has the storage the array was created on
+  bool valid() const
+  {
+    Uint nb_rows, nb_cols;
+    void* data = m_storage(nb_rows, nb_cols);
+    return data == m_data && nb_rows == m_nb_rows && nb_cols == m_nb_cols;
+  }
+
+  dict get_interface() const
+  {
+    if(!valid())
+      throw common::SetupError(FromHere(), "The storage of " + m_owner->uri().string() + " was resized or moved since the array was created");
+
+    return m_interface;
+  }
+
+  /// The component owning the memory, wrapped for python
+  object owner() const
+  {
+    return wrap_component(Handle<common::Component>(boost::const_pointer_cast<common::Component>(m_owner)));
+  }
+
+  dict m_interface;
+  boost::shared_ptr<common::Component const> m_owner;
+  StorageT m_storage;
+  void* m_data;
+  Uint m_nb_rows;
+  Uint m_nb_cols;
+};
+
+namespace detail
+{
+  /// Type string of the numpy array interface, e.g. "<f8"
+  template<typename ValueT>
+  std::string typestr(const char kind)
+  {
+    const Uint one = 1;
+    const char byteorder = *reinterpret_cast<const char*>(&one) == 1 ? '<' : '>';
+    return std::string(1, byteorder) + kind + boost::lexical_cast<std::string>(sizeof(ValueT));
+  }
+
+  /// Kind of the values in the type string
+  inline char kind(const Real*) { return 'f'; }
+  inline char kind(const Uint*) { return 'u'; }
+}
+
+template<typename ValueT>
+object numpy_array(const common::Component& owner, const boost::function<ValueT* (Uint&, Uint&)>& storage)
+{
+  object numpy = import("numpy");
+
+  Uint nb_rows, nb_cols;
+  ValueT* data = storage(nb_rows, nb_cols);
+  const std::string typestr = detail::typestr<ValueT>(detail::kind(data));
+
+  // numpy does not accept a null pointer, which is what empty storage may have
+  if(nb_rows == 0 || nb_cols == 0)
+    return numpy.attr("zeros")(make_tuple(nb_rows, nb_cols), typestr);
+
+  dict interface;
+  interface["version"] = 3;
+  interface["shape"] = make_tuple(nb_rows, nb_cols);
+  interface["typestr"] = typestr;
+  interface["data"] = make_tuple(reinterpret_cast<std::size_t>(data), false);
+
+  return numpy.attr("asarray")(ArrayInterface(interface, owner, storage, data, nb_rows, nb_cols));
+}
+
+template object numpy_array<Real>(const common::Component&, const boost::function<Real* (Uint&, Uint&)>&);
+template object numpy_array<Uint>(const common::Component&, const boost::function<Uint* (Uint&, Uint&)>&);
+
+void def_array_interface()
+{
+  class_<ArrayInterface>("ArrayInterface", "Passes C++ storage to numpy without copying", no_init)
+    .add_property("__array_interface__", &ArrayInterface::get_interface)
+    .add_property("valid", &ArrayInterface::valid, "True if the component owning the memory did not resize or move it")
+    .add_property("owner", &ArrayInterface::owner, "The component owning the memory, kept alive by the array");
+}
+
+} // python
+} // cf3
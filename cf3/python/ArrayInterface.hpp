@@ -0,0 +1,40 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF3_Python_ArrayInterface_hpp
+#define CF3_Python_ArrayInterface_hpp
+
+#include <boost/function.hpp>
+#include <boost/python/object_fwd.hpp>
+
+#include "common/CF.hpp"
+
+namespace cf3 {
+namespace common { class Component; }
+namespace python {
+
+/// Wrap contiguous C++ storage of a component in a NumPy array that shares its memory, without copying.
+/// The array is built through the numpy array interface, so numpy is only needed at runtime.
+/// The base of the array (array.base) shares ownership of the owner, exposed as array.base.owner,
+/// so destroying or removing the component does not free the memory of a live array.
+/// Its property "valid" tells if the owner still has the same storage, and its "__array_interface__" throws if not.
+/// @attention Resizing the storage (or creating it again) invalidates all existing arrays on it, as the old memory
+/// is freed. numpy does not check this when accessing the elements: check array.base.valid, or create a new array.
+/// @param owner Component that owns the storage
+/// @param storage Returns the current start of the storage, in row-major order, and sets its number of rows and columns
+/// @return a 2D numpy array of shape (nb_rows, nb_cols)
+template<typename ValueT>
+boost::python::object numpy_array(const common::Component& owner, const boost::function<ValueT* (Uint&, Uint&)>& storage);
+
+/// Define the python type used to pass the array interface to numpy
+void def_array_interface();
+
+} // python
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF3_Python_ArrayInterface_hpp
@@ -28,6 +28,7 @@
 #include "common/XML/FileOperations.hpp"
 
 #include "python/ComponentWrapper.hpp"
+#include "python/LSSWrapper.hpp"
 #include "python/TableWrapper.hpp"
 
 namespace cf3 {
@@ -423,6 +424,7 @@ boost::python::object wrap_component(const Handle<common::Component>& component)
 
   // Add extra functionality for derved classes
   add_ctable_methods(wrapped, result);
+  add_lss_methods(wrapped, result);
 
   return result;
 }
@@ -0,0 +1,64 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "python/BoostPython.hpp"
+
+#include <boost/bind.hpp>
+
+#include "common/Log.hpp"
+
+#include "math/LSS/Native/NativeVector.hpp"
+
+#include "mesh/Dictionary.hpp"
+
+#include "python/ArrayInterface.hpp"
+#include "python/ComponentWrapper.hpp"
+#include "python/LSSWrapper.hpp"
+#include "python/Utility.hpp"
+
+namespace cf3 {
+namespace python {
+
+using namespace boost::python;
+
+/// Extra methods for the vectors of the native linear system, which store their values contiguously
+struct NativeVectorMethods
+{
+  static Real* storage(math::LSS::NativeVector& vector, Uint& nb_rows, Uint& nb_cols)
+  {
+    nb_rows = vector.blockrow_size();
+    nb_cols = vector.neq();
+    return vector.data().empty() ? NULL : &vector.data()[0];
+  }
+
+  static object array(ComponentWrapper& wrapped)
+  {
+    math::LSS::NativeVector& vector = wrapped.component<math::LSS::NativeVector>();
+    if(!vector.is_created())
+      throw common::SetupError(FromHere(), "Vector " + vector.uri().string() + " was not created");
+
+    return numpy_array<Real>(vector, boost::bind(&NativeVectorMethods::storage, boost::ref(vector), _1, _2));
+  }
+
+  static void create(ComponentWrapper& wrapped, ComponentWrapper& dictionary, const Uint neq)
+  {
+    wrapped.component<math::LSS::NativeVector>().create(dictionary.component<mesh::Dictionary>().comm_pattern(), neq);
+  }
+};
+
+void add_lss_methods(ComponentWrapper& wrapped, boost::python::api::object& py_obj)
+{
+  if(dynamic_cast<const math::LSS::NativeVector*>(&wrapped.component()))
+  {
+    CFdebug << "adding custom methods for " << math::LSS::NativeVector::type_name() << CFendl;
+
+    add_function(py_obj, NativeVectorMethods::create, "create", "Create the vector with one block row per entry of a dictionary, and the given number of equations");
+    add_function(py_obj, NativeVectorMethods::array, "array", "Return a numpy array sharing the memory of the vector, with one row per block row. It keeps the vector alive, and is invalid after the vector is created again, which array.base.valid tells");
+  }
+}
+
+} // python
+} // cf3
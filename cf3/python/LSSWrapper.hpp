@@ -0,0 +1,25 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef CF3_Python_LSSWrapper_hpp
+#define CF3_Python_LSSWrapper_hpp
+
+#include <boost/python/object_fwd.hpp>
+
+namespace cf3 {
+namespace python {
+
+class ComponentWrapper;
+
+/// Python wrapping for the linear system vectors
+void add_lss_methods(ComponentWrapper& wrapped, boost::python::api::object& py_obj);
+
+} // python
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF3_Python_LSSWrapper_hpp
@@ -6,6 +6,7 @@
 
 #include "python/BoostPython.hpp"
 
+#include "python/ArrayInterface.hpp"
 #include "python/ComponentWrapper.hpp"
 #include "python/CoreWrapper.hpp"
 #include "python/TableWrapper.hpp"
@@ -23,6 +24,7 @@ BOOST_PYTHON_MODULE(libcoolfluid_python)
   def_component();
   def_core();
   def_ctable_types();
+  def_array_interface();
   def_matrix_types();
   def_uri();
   scope().attr("__doc__") = "Provides access to the Coolfluid API from python";
@@ -8,6 +8,7 @@
 
 #include <sstream>
 
+#include <boost/bind.hpp>
 #include <boost/weak_ptr.hpp>
 
 #include "common/Log.hpp"
@@ -15,6 +16,7 @@
 
 #include "common/Table.hpp"
 
+#include "python/ArrayInterface.hpp"
 #include "python/ComponentWrapper.hpp"
 #include "python/TableWrapper.hpp"
 #include "python/Utility.hpp"
@@ -125,6 +127,19 @@ struct TableMethods
   {
     wrapped.component< common::Table<ValueT> >().set_row_size(nb_cols);
   }
+
+  static ValueT* storage(common::Table<ValueT>& table, Uint& nb_rows, Uint& nb_cols)
+  {
+    nb_rows = table.size();
+    nb_cols = table.row_size();
+    return table.array().data();
+  }
+
+  static object array(ComponentWrapper& wrapped)
+  {
+    common::Table<ValueT>& table = wrapped.component< common::Table<ValueT> >();
+    return numpy_array<ValueT>(table, boost::bind(&TableMethods::storage, boost::ref(table), _1, _2));
+  }
 };
 
 template<typename ValueT>
@@ -143,6 +158,7 @@ void add_ctable_methods(ComponentWrapper& wrapped, boost::python::api::object& p
     add_function(py_obj, ExtraMethodsT::row_size, "row_size", "Return the number of columns the table can hold");
     add_function(py_obj, ExtraMethodsT::resize, "resize", "Set the size of the table, i.e. the number of rows");
     add_function(py_obj, ExtraMethodsT::set_row_size, "set_row_size", "Set the size of a row, i.e. the number of columns in the table");
+    add_function(py_obj, ExtraMethodsT::array, "array", "Return a numpy array sharing the memory of the table. It keeps the table alive, and is invalid after a resize of the table, which array.base.valid tells");
   }
 }
 
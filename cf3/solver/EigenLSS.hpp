@@ -30,6 +30,8 @@ namespace solver {
 
 /// EigenLSS component class
 /// This class stores a linear system for use by proto expressions
+/// It is not a math::LSS::Matrix: there is no solver_reuse option, and every solve builds
+/// the solver and the preconditioner from scratch.
 /// @author Bart Janssens
 class solver_API EigenLSS : public common::Component {
 
@@ -48,6 +48,11 @@ PeriodicWriteMesh::PeriodicWriteMesh ( const std::string& name ) : solver::Actio
   options().add_option( "filepath", URI() )
       .pretty_name("File Path")
       .description("Path where to save the mesh");
+
+  options().add_option( "asynchronous", false )
+      .pretty_name("Asynchronous")
+      .description("Write the files in the background, from a snapshot of the fields, "
+                   "so the iterations continue while the files are written");
 }
 
 
@@ -74,6 +79,7 @@ void PeriodicWriteMesh::execute()
       state_fields.push_back(field.uri());
     }
 
+    m_writer.options().configure_option( "asynchronous", options().option("asynchronous").value<bool>() );
     m_writer.write_mesh( mesh(), filepath, state_fields );
 
 
@@ -125,7 +125,18 @@ struct BlockAssignmentOp<SystemMatrixTag, OpTagT>
         block_accumulator.mat(block_row, block_col) = rhs(row, col);
       }
     }
-    do_assign_op_matrix(OpTagT(), lss.matrix(), block_accumulator);
+    // Elements of the same color share no nodes, so reentrant backends can scatter concurrently.
+    // Other backends are only safe when the threads scatter one at a time.
+    math::LSS::Matrix& lss_matrix = lss.matrix();
+#ifdef CF3_HAVE_OPENMP
+    if(!lss_matrix.is_reentrant())
+    {
+      #pragma omp critical (cf3_proto_lss_scatter)
+      do_assign_op_matrix(OpTagT(), lss_matrix, block_accumulator);
+      return;
+    }
+#endif
+    do_assign_op_matrix(OpTagT(), lss_matrix, block_accumulator);
   }
 };
 
@@ -146,7 +157,16 @@ struct BlockAssignmentOp<SystemRHSTag, OpTagT>
       block_accumulator.rhs[block_idx] = rhs[i];
     }
 
-    do_assign_op_rhs(OpTagT(), lss.rhs(), block_accumulator);
+    math::LSS::Vector& lss_rhs = lss.rhs();
+#ifdef CF3_HAVE_OPENMP
+    if(!lss_rhs.is_reentrant())
+    {
+      #pragma omp critical (cf3_proto_lss_scatter)
+      do_assign_op_rhs(OpTagT(), lss_rhs, block_accumulator);
+      return;
+    }
+#endif
+    do_assign_op_rhs(OpTagT(), lss_rhs, block_accumulator);
   }
 };
 
@@ -7,6 +7,8 @@
 #ifndef cf3_solver_actions_Proto_ElementLooper_hpp
 #define cf3_solver_actions_Proto_ElementLooper_hpp
 
+#include <vector>
+
 #include <boost/fusion/algorithm/iteration/for_each.hpp>
 #include <boost/fusion/adapted/mpl.hpp>
 #include <boost/fusion/mpl.hpp>
@@ -20,10 +22,17 @@
 #include "ElementExpressionWrapper.hpp"
 #include "ElementGrammar.hpp"
 
+#include "coolfluid-config.hpp"
+
+#include "mesh/Functions.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/Space.hpp"
 #include "mesh/ElementTypePredicates.hpp"
 
+#ifdef CF3_HAVE_OPENMP
+  #include <omp.h>
+#endif
+
 namespace cf3 {
 namespace solver {
 namespace actions {
@@ -60,7 +69,7 @@ struct CheckSameEtype
 template<typename ElementTypesT, typename ExprT, typename SupportETYPE, typename VariablesT, typename VariablesEtypesT, typename NbVarsT, typename VarIdxT>
 struct ExpressionRunner
 {
-  ExpressionRunner(VariablesT& vars, const ExprT& expr, mesh::Elements& elems) : variables(vars), expression(expr), elements(elems), m_nb_tests(0), m_found(false) {}
+  ExpressionRunner(VariablesT& vars, const ExprT& expr, mesh::Elements& elems, const Uint threads = 1) : variables(vars), expression(expr), elements(elems), nb_threads(threads), m_nb_tests(0), m_found(false) {}
 
   typedef typename boost::remove_reference<typename boost::fusion::result_of::at<VariablesT, VarIdxT>::type>::type VarT;
 
@@ -89,7 +98,7 @@ struct ExpressionRunner
       NewVariablesEtypesT,
       NbVarsT,
       NextIdxT
-    >(variables, expression, elements).run();
+    >(variables, expression, elements, nb_threads).run();
   }
 
   // Chosen otherwise
@@ -141,12 +150,13 @@ struct ExpressionRunner
       NewVariablesEtypesT,
       NbVarsT,
       NextIdxT
-    >(variables, expression, elements).run();
+    >(variables, expression, elements, nb_threads).run();
   }
 
   VariablesT& variables;
   const ExprT& expression;
   mesh::Elements& elements;
+  const Uint nb_threads;
   // Number of times we tried a shape function
   mutable Uint m_nb_tests;
   mutable bool m_found;
@@ -165,6 +175,41 @@ struct ElementLooperImpl
     run(WrapExpression()(expr, mapped_coords, data), data, nb_elems);
   }
 
+  /// Loop over the elements using nb_threads shared-memory threads. Elements are grouped in colors, so that the elements in a color share no nodes
+  /// and can be assembled concurrently. Each thread works on its own copy of the element data and the wrapped expression.
+  template<typename ExprT, typename VariablesT>
+  void operator()(const ExprT& expr, VariablesT& variables, mesh::Elements& elements, const Uint nb_threads) const
+  {
+#ifdef CF3_HAVE_OPENMP
+    if(nb_threads > 1)
+    {
+      std::vector< std::vector<Uint> > colors;
+      mesh::build_element_colors(elements.geometry_space().connectivity(), elements.geometry_fields().size(), colors);
+
+      // Data is created up-front, since its construction looks up components
+      std::vector< boost::shared_ptr<DataT> > thread_data(nb_threads);
+      for(Uint i = 0; i != nb_threads; ++i)
+        thread_data[i].reset(new DataT(variables, elements));
+
+      bool failed = false;
+      std::string error_message;
+      #pragma omp parallel num_threads(nb_threads)
+      {
+        DataT& data = *thread_data[omp_get_thread_num()];
+        const typename DataT::SupportShapeFunction::MappedCoordsT mapped_coords;
+        run_colored(WrapExpression()(expr, mapped_coords, data), data, colors, failed, error_message);
+      }
+
+      if(failed)
+        throw common::ParallelError(FromHere(), "Error in threaded element loop over " + elements.uri().string() + ": " + error_message);
+
+      return;
+    }
+#endif
+    DataT data(variables, elements);
+    (*this)(expr, data, elements.size());
+  }
+
 private:
   template<typename FilteredExprT>
   void run(const FilteredExprT& expr, DataT& data, const Uint nb_elems) const
@@ -178,13 +223,57 @@ private:
       grammar(expr, elem, data);
     }
   }
+
+#ifdef CF3_HAVE_OPENMP
+  /// Run the part of each color assigned to the calling thread. Must be called from within an OpenMP parallel region.
+  /// The implied barrier at the end of each color ensures no two threads ever touch the same node at the same time.
+  /// Scattering into a linear system is serialized separately, since the LSS backends are not reentrant (see BlockAssignmentOp).
+  /// Exceptions can't leave the parallel region, so the first error is stored and the remaining elements are skipped
+  template<typename FilteredExprT>
+  void run_colored(const FilteredExprT& expr, DataT& data, const std::vector< std::vector<Uint> >& colors, bool& failed, std::string& error_message) const
+  {
+    ElementGrammar grammar;
+    const Uint nb_colors = colors.size();
+    for(Uint color_idx = 0; color_idx != nb_colors; ++color_idx)
+    {
+      const std::vector<Uint>& color = colors[color_idx];
+      const int nb_color_elems = static_cast<int>(color.size());
+      #pragma omp for schedule(static)
+      for(int i = 0; i < nb_color_elems; ++i)
+      {
+        bool stop;
+        #pragma omp atomic read
+        stop = failed;
+        if(stop)
+          continue;
+
+        const Uint elem = color[i];
+        try
+        {
+          data.set_element(elem);
+          grammar(expr, elem, data);
+        }
+        catch(std::exception& e)
+        {
+          #pragma omp critical (cf3_proto_element_looper)
+          {
+            if(error_message.empty())
+              error_message = e.what();
+            #pragma omp atomic write
+            failed = true;
+          }
+        }
+      }
+    }
+  }
+#endif
 };
 
 /// When we recursed to the last variable, actually run the expression
 template<typename ElementTypesT, typename ExprT, typename SupportETYPE, typename VariablesT, typename VariablesEtypesT, typename NbVarsT>
 struct ExpressionRunner<ElementTypesT, ExprT, SupportETYPE, VariablesT, VariablesEtypesT, NbVarsT, NbVarsT>
 {
-  ExpressionRunner(VariablesT& vars, const ExprT& expr, mesh::Elements& elems) : variables(vars), expression(expr), elements(elems) {}
+  ExpressionRunner(VariablesT& vars, const ExprT& expr, mesh::Elements& elems, const Uint threads = 1) : variables(vars), expression(expr), elements(elems), nb_threads(threads) {}
 
   typedef ElementData<VariablesT, VariablesEtypesT, SupportETYPE, typename EquationVariables<ExprT, NbVarsT>::type> DataT;
 
@@ -196,15 +285,14 @@ struct ExpressionRunner<ElementTypesT, ExprT, SupportETYPE, VariablesT, Variable
       INVALID_ELEMENT_EXPRESSION,
       (ElementGrammar));
 
-    DataT data(variables, elements);
-
-    ElementLooperImpl<DataT>()(expression, data, elements.size());
+    ElementLooperImpl<DataT>()(expression, variables, elements, nb_threads);
   }
 
 private:
   VariablesT& variables;
   const ExprT& expression;
   mesh::Elements& elements;
+  const Uint nb_threads;
 };
 
 /// mpl::for_each compatible functor to loop over elements, using the correct shape function for the geometry
@@ -215,10 +303,12 @@ struct ElementLooper
   // Type of a fusion vector that can contain a copy of each variable that is used in the expression
   typedef typename ExpressionProperties<ExprT>::VariablesT VariablesT;
 
-  ElementLooper(mesh::Elements& elements, const ExprT& expr, VariablesT& variables) :
+  /// @param nb_threads Number of shared-memory threads to use. Values larger than 1 only take effect when OpenMP is available
+  ElementLooper(mesh::Elements& elements, const ExprT& expr, VariablesT& variables, const Uint nb_threads = 1) :
     m_elements(elements),
     m_expr(expr),
-    m_variables(variables)
+    m_variables(variables),
+    m_nb_threads(nb_threads)
   {
   }
 
@@ -250,9 +340,7 @@ struct ElementLooper
     // Verify the types match, and throw an error if non-matchine fields are found
     boost::fusion::for_each(m_variables, CheckSameEtype<ETYPE>(m_elements));
 
-    DataT data(m_variables, m_elements);
-
-    ElementLooperImpl<DataT>()(m_expr, data, m_elements.size());
+    ElementLooperImpl<DataT>()(m_expr, m_variables, m_elements, m_nb_threads);
   }
 
   /// Static dispatch in case different ETYPE are possible
@@ -273,13 +361,14 @@ struct ElementLooper
       boost::mpl::vector0<>, // Start with an empty vector for the per-variable element types
       NbVarsT, // number of variables
       boost::mpl::int_<0> // Start index, as MPL integral constant
-    >(m_variables, m_expr, m_elements).run();
+    >(m_variables, m_expr, m_elements, m_nb_threads).run();
   }
 
 private:
   mesh::Elements& m_elements;
   const ExprT& m_expr;
   VariablesT& m_variables;
+  const Uint m_nb_threads;
 };
 
 template<typename ElementTypesT, typename ExprT>
@@ -221,7 +221,7 @@ class ElementsExpression : public ExpressionBase<ExprT>
   typedef ExpressionBase<ExprT> BaseT;
 public:
 
-  ElementsExpression(const ExprT& expr) : BaseT(expr)
+  ElementsExpression(const ExprT& expr) : BaseT(expr), m_nb_threads(1)
   {
   }
 
@@ -230,9 +230,22 @@ public:
     // Traverse all Elements under the region and evaluate the expression
     BOOST_FOREACH(mesh::Elements& elements, common::find_components_recursively<mesh::Elements>(region) )
     {
-      boost::mpl::for_each<boost::mpl::filter_view< ElementTypes, mesh::IsMinimalOrder<1> > >( ElementLooper<ElementTypes, typename BaseT::CopiedExprT>(elements, BaseT::m_expr, BaseT::m_variables) );
+      boost::mpl::for_each<boost::mpl::filter_view< ElementTypes, mesh::IsMinimalOrder<1> > >( ElementLooper<ElementTypes, typename BaseT::CopiedExprT>(elements, BaseT::m_expr, BaseT::m_variables, m_nb_threads) );
     }
   }
+
+  void add_options(common::OptionList& options)
+  {
+    BaseT::add_options(options);
+
+    common::Option& option = options.check("nb_threads") ? options.option("nb_threads") : options.add_option("nb_threads", m_nb_threads);
+    option.description("Number of shared memory threads used in the element loop. Only used if OpenMP is available, and the expression must be safe to evaluate concurrently on elements that don't share nodes");
+    option.link_to(&m_nb_threads);
+  }
+
+private:
+  /// Number of threads to use in the element loop
+  Uint m_nb_threads;
 };
 
 /// Expression for looping over nodes
@@ -0,0 +1,143 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cstring>
+#include <vector>
+
+#include "common/Builder.hpp"
+#include "common/BoostFilesystem.hpp"
+#include "common/Log.hpp"
+#include "common/OptionComponent.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionURI.hpp"
+#include "common/List.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/StringConversion.hpp"
+
+#include "math/VariablesDescriptor.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Dictionary.hpp"
+
+#include "solver/Time.hpp"
+#include "solver/Tags.hpp"
+#include "solver/actions/RestartFile.hpp"
+#include "solver/actions/ReadRestartFile.hpp"
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < ReadRestartFile, common::Action, LibActions > ReadRestartFile_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ReadRestartFile::ReadRestartFile ( const std::string& name ) : solver::Action(name)
+{
+  mark_basic();
+
+  options().add_option("file", URI("restart.cf3restart", URI::Scheme::FILE))
+      .supported_protocol(URI::Scheme::FILE)
+      .pretty_name("File")
+      .description("File to read. In parallel, \"_P<rank>\" is appended to the file name of each process")
+      .mark_basic();
+
+  options().add_option(Tags::time(), m_time)
+      .pretty_name("Time")
+      .description("Time tracking component to restore, optional")
+      .mark_basic()
+      .link_to(&m_time);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void ReadRestartFile::execute()
+{
+  const Uint nb_procs = PE::Comm::instance().is_active() ? PE::Comm::instance().size() : 1u;
+  const Uint rank = PE::Comm::instance().is_active() ? PE::Comm::instance().rank() : 0u;
+
+  boost::filesystem::path path (RestartFile::rank_file(options().option("file").value<URI>(), rank, nb_procs).path());
+  if( !boost::filesystem::exists(path) )
+  {
+     throw boost::filesystem::filesystem_error( path.string() + " does not exist", boost::system::error_code() );
+  }
+  const std::string filename = path.string();
+
+  boost::filesystem::fstream file;
+  file.open(path, std::ios_base::in | std::ios_base::binary);
+
+  RestartFile::Header header;
+  file.read(reinterpret_cast<char*>(&header), sizeof(RestartFile::Header));
+  if (!file || std::strncmp(header.magic, RestartFile::magic(), sizeof(header.magic)) != 0)
+    throw FileFormatError(FromHere(), filename + " is not a restart file");
+  if (header.version != RestartFile::version)
+    throw FileFormatError(FromHere(), filename + " has version " + to_str(header.version) + ", while version " + to_str(RestartFile::version) + " is supported");
+  if (header.real_size != sizeof(Real))
+    throw FileFormatError(FromHere(), filename + " was written with a different size of Real");
+  if (header.nb_procs != nb_procs || header.rank != rank)
+    throw FileFormatError(FromHere(), filename + " was written by rank " + to_str(header.rank) + " of " + to_str(header.nb_procs)
+                          + " processes, but is read by rank " + to_str(rank) + " of " + to_str(nb_procs));
+
+  std::vector<char> buffer;
+  for (Uint f=0; f<header.nb_fields; ++f)
+  {
+    RestartFile::FieldHeader field_header;
+    file.read(reinterpret_cast<char*>(&field_header), sizeof(RestartFile::FieldHeader));
+    buffer.resize(field_header.path_size + field_header.description_size);
+    if (!buffer.empty())
+      file.read(&buffer[0], buffer.size());
+    if (!file)
+      throw FileFormatError(FromHere(), filename + " is truncated or corrupt");
+    const std::string field_path(buffer.begin(), buffer.begin() + field_header.path_size);
+    const std::string description(buffer.begin() + field_header.path_size, buffer.end());
+
+    Handle<Field> field(mesh().access_component(URI("./" + field_path)));
+    if (is_null(field))
+      throw ValueNotFound(FromHere(), "Field " + field_path + " from " + filename + " does not exist in mesh " + mesh().uri().string());
+
+    boost::uint64_t glb_idx_checksum = 0;
+    const common::List<Uint>& glb_idx = field->dict().glb_idx();
+    for (Uint i=0; i<glb_idx.size(); ++i)
+      glb_idx_checksum += glb_idx[i];
+
+    if (field_header.nb_rows != field->size() || field_header.row_size != field->row_size() || field_header.glb_idx_checksum != glb_idx_checksum)
+      throw FileFormatError(FromHere(), "Field " + field->uri().string() + " with " + to_str(field->size()) + " rows of size " + to_str(field->row_size())
+                            + " doesn't match the data in " + filename + ", with " + to_str(Uint(field_header.nb_rows)) + " rows of size " + to_str(Uint(field_header.row_size))
+                            + ". The mesh must be partitioned as when the restart file was written.");
+
+    if (description != field->descriptor().description())
+      CFwarn << "Variables of field " << field->uri() << " are \"" << field->descriptor().description() << "\", but were \"" << description << "\" in " << filename << CFendl;
+
+    // Read straight into the field table
+    if (field->size() && field->row_size())
+      file.read(reinterpret_cast<char*>(field->array().data()), field->size()*field->row_size()*sizeof(Real));
+    if (!file)
+      throw FileFormatError(FromHere(), filename + " is truncated or corrupt");
+  }
+
+  file.close();
+
+  if (is_not_null(m_time) && header.has_time)
+  {
+    m_time->options().configure_option("iteration", Uint(header.iteration));
+    m_time->options().configure_option("current_time", Real(header.current_time));
+    m_time->options().configure_option("time_step", Real(header.time_step));
+  }
+
+  CFinfo << "Restart file " << options().option("file").value<URI>().path() << " read with " << header.nb_fields << " fields" << CFendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
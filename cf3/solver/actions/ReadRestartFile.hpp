@@ -0,0 +1,51 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_ReadRestartFile_hpp
+#define cf3_solver_actions_ReadRestartFile_hpp
+
+#include "solver/actions/LibActions.hpp"
+#include "solver/Action.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace solver {
+class Time;
+namespace actions {
+
+/// Restore the fields of the mesh and the time state from the files written by WriteRestartFile.
+/// Every process reads its own file straight into the tables of the existing fields, without any repartitioning,
+/// so the mesh must be partitioned as when the files were written, and all fields must exist.
+class solver_actions_API ReadRestartFile : public solver::Action {
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  ReadRestartFile ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~ReadRestartFile() {}
+
+  /// Get the class name
+  static std::string type_name () { return "ReadRestartFile"; }
+
+  /// execute the action
+  virtual void execute ();
+
+private: // data
+
+  Handle<Time> m_time; ///< time to restore, optional
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+#endif // cf3_solver_actions_ReadRestartFile_hpp
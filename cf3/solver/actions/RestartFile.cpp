@@ -0,0 +1,36 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/BoostFilesystem.hpp"
+#include "common/StringConversion.hpp"
+
+#include "solver/actions/RestartFile.hpp"
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////
+
+const boost::uint32_t RestartFile::version;
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::URI RestartFile::rank_file(const common::URI& file, const Uint rank, const Uint nb_procs)
+{
+  if (nb_procs == 1)
+    return file;
+
+  const boost::filesystem::path path(file.path());
+  const boost::filesystem::path rank_path = path.parent_path() / (path.stem().string() + "_P" + common::to_str(rank) + path.extension().string());
+  return common::URI(rank_path.string(), common::URI::Scheme::FILE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
@@ -0,0 +1,78 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_RestartFile_hpp
+#define cf3_solver_actions_RestartFile_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/cstdint.hpp>
+
+#include "common/URI.hpp"
+
+#include "solver/actions/LibActions.hpp"
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Binary layout of the restart files written by WriteRestartFile and read by ReadRestartFile.
+/// Every process writes its own file, containing its rows of the fields, including the ghost rows:
+/// @code
+/// RestartFile::Header
+/// for every field:
+///   RestartFile::FieldHeader
+///   path of the field relative to the mesh (path_size bytes)
+///   description of the variables (description_size bytes)
+///   field data, nb_rows x row_size Real values, row by row
+/// @endcode
+struct solver_actions_API RestartFile
+{
+  struct Header
+  {
+    char            magic[8];
+    boost::uint32_t version;
+    boost::uint32_t real_size;
+    boost::uint32_t rank;
+    boost::uint32_t nb_procs;
+    boost::uint32_t nb_fields;
+    boost::uint32_t has_time;
+    boost::uint32_t iteration;
+    boost::uint32_t reserved;
+    double          current_time;
+    double          time_step;
+  };
+
+  struct FieldHeader
+  {
+    boost::uint32_t path_size;
+    boost::uint32_t description_size;
+    boost::uint64_t nb_rows;
+    boost::uint64_t row_size;
+    boost::uint64_t glb_idx_checksum; ///< sum of the global indices of the rows, to detect a different partitioning
+  };
+
+  /// String identifying the format, including the terminating null character
+  static const char* magic() { return "CF3RSTR"; }
+
+  /// Version of the format
+  static const boost::uint32_t version = 1;
+
+  /// @return the file of the given rank, with "_P<rank>" appended to the file name when running in parallel
+  static common::URI rank_file(const common::URI& file, const Uint rank, const Uint nb_procs);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_solver_actions_RestartFile_hpp
@@ -4,12 +4,16 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 
 #include "common/Builder.hpp"
 #include "common/OptionList.hpp"
 #include "common/Foreach.hpp"
+#include "common/PE/CommPattern.hpp"
+#include "common/PE/PersistentExchange.hpp"
 
 #include "mesh/Field.hpp"
 #include "mesh/Mesh.hpp"
@@ -31,7 +35,9 @@ common::ComponentBuilder < SynchronizeFields, common::Action, LibActions > Synch
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-SynchronizeFields::SynchronizeFields ( const std::string& name ) : solver::Action(name)
+SynchronizeFields::SynchronizeFields ( const std::string& name ) :
+  solver::Action(name),
+  m_exchanges_built(false)
 {
   mark_basic();
 
@@ -45,6 +51,11 @@ SynchronizeFields::SynchronizeFields ( const std::string& name ) : solver::Actio
 
 void SynchronizeFields::config_fields()
 {
+  m_fields.clear();
+  m_exchanges.clear();
+  m_field_comm_patterns.clear();
+  m_exchanges_built = false;
+
   std::vector<URI> vec = options().option("Fields").value< std::vector<URI> >();
 
   boost_foreach(const URI field_path, vec)
@@ -62,13 +73,97 @@ void SynchronizeFields::config_fields()
 
 
 
+void SynchronizeFields::setup_exchanges()
+{
+  m_exchanges.clear();
+  m_field_comm_patterns.clear();
+  boost_foreach(Handle<Field> ptr, m_fields)
+  {
+    m_field_comm_patterns.push_back( is_null(ptr) ? Handle<PE::CommPattern>() : ptr->comm_pattern() );
+  }
+
+  // Group the fields per comm pattern, fields that are not parallelized need no synchronization
+  std::vector< Handle<PE::CommPattern> > comm_patterns;
+  std::vector< std::vector< Handle<PE::CommWrapper> > > wrappers;
+  boost_foreach(Handle<Field> ptr, m_fields)
+  {
+    if( is_null(ptr) || is_null(ptr->comm_pattern()) ) continue;
+
+    const Uint idx = std::find(comm_patterns.begin(), comm_patterns.end(), ptr->comm_pattern()) - comm_patterns.begin();
+    if(idx == comm_patterns.size())
+    {
+      comm_patterns.push_back(ptr->comm_pattern());
+      wrappers.push_back(std::vector< Handle<PE::CommWrapper> >());
+    }
+    wrappers[idx].push_back(Handle<PE::CommWrapper>(ptr->comm_pattern()->get_child(ptr->name())));
+  }
+
+  const Uint nb_exchanges = comm_patterns.size();
+  for(Uint i = 0; i != nb_exchanges; ++i)
+  {
+    m_exchanges.push_back(allocate_component<PE::PersistentExchange>("Exchange"));
+    m_exchanges.back()->setup(*comm_patterns[i], wrappers[i]);
+  }
+  m_exchanges_built = true;
+}
+
+
+
+bool SynchronizeFields::exchanges_valid() const
+{
+  if(!m_exchanges_built)
+    return false;
+
+  // Fields may be parallelized, or change comm pattern, after the exchanges were built
+  const Uint nb_fields = m_fields.size();
+  cf3_assert(m_field_comm_patterns.size() == nb_fields);
+  for(Uint i = 0; i != nb_fields; ++i)
+  {
+    const Handle<PE::CommPattern> comm_pattern = is_null(m_fields[i]) ? Handle<PE::CommPattern>() : m_fields[i]->comm_pattern();
+    if(comm_pattern != m_field_comm_patterns[i])
+      return false;
+  }
+
+  boost_foreach(const boost::shared_ptr<PE::PersistentExchange>& exchange, m_exchanges)
+  {
+    if(!exchange->is_valid())
+      return false;
+  }
+  return true;
+}
+
+
+
 void SynchronizeFields::execute()
 {
+  if(!exchanges_valid())
+    setup_exchanges();
+
+  // The exchanges work on the tables, so fields in padded storage are packed first
+  std::vector< Handle<Field> > unpacked_fields;
   boost_foreach(Handle<Field> ptr, m_fields)
   {
-    if( is_null(ptr) ) continue; // skip if pointer invalid
+    if( is_not_null(ptr) && ptr->is_unpacked() )
+    {
+      ptr->pack();
+      unpacked_fields.push_back(ptr);
+    }
+  }
+
+  // Start all exchanges first, so the messages for the different comm patterns are in flight at the same time
+  boost_foreach(const boost::shared_ptr<PE::PersistentExchange>& exchange, m_exchanges)
+  {
+    exchange->start();
+  }
 
-    ptr->synchronize();
+  boost_foreach(const boost::shared_ptr<PE::PersistentExchange>& exchange, m_exchanges)
+  {
+    exchange->finish();
+  }
+
+  boost_foreach(Handle<Field> ptr, unpacked_fields)
+  {
+    ptr->unpack();
   }
 }
 
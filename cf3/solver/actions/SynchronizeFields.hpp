@@ -15,6 +15,7 @@
 
 namespace cf3 {
 	
+namespace common { namespace PE { class PersistentExchange; } }
 namespace mesh { class Field; }
 
 namespace solver {
@@ -46,10 +47,25 @@ private: // helper functions
 
   void config_fields();
 
+  /// (Re)build the persistent exchanges, one per comm pattern used by the fields
+  void setup_exchanges();
+
+  /// True if the exchanges were built for the current comm patterns of the fields, and are still valid
+  bool exchanges_valid() const;
+
 private: // data
 
   std::vector< Handle<mesh::Field> > m_fields;
 
+  /// Exchanges that send all fields sharing a comm pattern in a single message per neighbour
+  std::vector< boost::shared_ptr<common::PE::PersistentExchange> > m_exchanges;
+
+  /// Comm pattern of each field when the exchanges were built, null for fields that were not parallelized
+  std::vector< Handle<common::PE::CommPattern> > m_field_comm_patterns;
+
+  /// False until the exchanges are built for the configured fields. Stays true when none of the fields need an exchange
+  bool m_exchanges_built;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,157 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cstring>
+
+#include <boost/algorithm/string/replace.hpp>
+
+#include "common/Builder.hpp"
+#include "common/BoostFilesystem.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/OptionArray.hpp"
+#include "common/OptionComponent.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionURI.hpp"
+#include "common/List.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "math/VariablesDescriptor.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Dictionary.hpp"
+
+#include "solver/Time.hpp"
+#include "solver/Tags.hpp"
+#include "solver/actions/RestartFile.hpp"
+#include "solver/actions/WriteRestartFile.hpp"
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < WriteRestartFile, common::Action, LibActions > WriteRestartFile_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+WriteRestartFile::WriteRestartFile ( const std::string& name ) : solver::Action(name)
+{
+  mark_basic();
+
+  options().add_option("file", URI("restart.cf3restart", URI::Scheme::FILE))
+      .supported_protocol(URI::Scheme::FILE)
+      .pretty_name("File")
+      .description("File to write. In parallel, \"_P<rank>\" is appended to the file name of each process")
+      .mark_basic();
+
+  options().add_option("fields", std::vector<URI>())
+      .pretty_name("Fields")
+      .description("Fields to write. Default is all fields in the mesh")
+      .mark_basic();
+
+  options().add_option(Tags::time(), m_time)
+      .pretty_name("Time")
+      .description("Time tracking component to store, optional")
+      .mark_basic()
+      .link_to(&m_time);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void WriteRestartFile::execute()
+{
+  std::vector< Handle<Field const> > fields;
+  const std::vector<URI> field_uris = options().option("fields").value< std::vector<URI> >();
+  if (field_uris.empty())
+  {
+    boost_foreach(const Field& field, find_components_recursively<Field>(mesh()))
+      fields.push_back(field.handle<Field const>());
+  }
+  else
+  {
+    boost_foreach(const URI& field_uri, field_uris)
+    {
+      fields.push_back(Handle<Field const>(mesh().access_component_checked(field_uri)));
+      if (is_null(fields.back()))
+        throw ValueNotFound(FromHere(), "Invalid type of field URI [" + field_uri.string() + "]");
+    }
+  }
+
+  const Uint nb_procs = PE::Comm::instance().is_active() ? PE::Comm::instance().size() : 1u;
+  const Uint rank = PE::Comm::instance().is_active() ? PE::Comm::instance().rank() : 0u;
+
+  boost::filesystem::path path (RestartFile::rank_file(options().option("file").value<URI>(), rank, nb_procs).path());
+  boost::filesystem::fstream file;
+  file.open(path, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+  if (!file) // didn't open so throw exception
+  {
+     throw boost::filesystem::filesystem_error( path.string() + " failed to open",
+                                                boost::system::error_code() );
+  }
+
+  RestartFile::Header header;
+  std::memset(&header, 0, sizeof(RestartFile::Header));
+  std::strcpy(header.magic, RestartFile::magic());
+  header.version = RestartFile::version;
+  header.real_size = sizeof(Real);
+  header.rank = rank;
+  header.nb_procs = nb_procs;
+  header.nb_fields = fields.size();
+  if (is_not_null(m_time))
+  {
+    header.has_time = 1;
+    header.iteration = m_time->iter();
+    header.current_time = m_time->current_time();
+    header.time_step = m_time->dt();
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(RestartFile::Header));
+
+  const std::string mesh_path = mesh().uri().path() + "/";
+  boost_foreach(const Handle<Field const>& field, fields)
+  {
+    std::string field_path = field->uri().path();
+    boost::algorithm::replace_first(field_path, mesh_path, "");
+    const std::string description = field->descriptor().description();
+
+    RestartFile::FieldHeader field_header;
+    std::memset(&field_header, 0, sizeof(RestartFile::FieldHeader));
+    field_header.path_size = field_path.size();
+    field_header.description_size = description.size();
+    field_header.nb_rows = field->size();
+    field_header.row_size = field->row_size();
+    const common::List<Uint>& glb_idx = field->dict().glb_idx();
+    for (Uint i=0; i<glb_idx.size(); ++i)
+      field_header.glb_idx_checksum += glb_idx[i];
+
+    file.write(reinterpret_cast<const char*>(&field_header), sizeof(RestartFile::FieldHeader));
+    file.write(field_path.data(), field_path.size());
+    file.write(description.data(), description.size());
+    if (field->size() && field->row_size())
+      file.write(reinterpret_cast<const char*>(field->array().data()), field->size()*field->row_size()*sizeof(Real));
+  }
+
+  if (!file)
+  {
+     throw boost::filesystem::filesystem_error( "writing " + path.string() + " failed",
+                                                boost::system::error_code() );
+  }
+  file.close();
+
+  CFinfo << "Restart file " << options().option("file").value<URI>().path() << " written with " << fields.size() << " fields" << CFendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
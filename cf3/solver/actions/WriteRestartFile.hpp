@@ -0,0 +1,51 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_WriteRestartFile_hpp
+#define cf3_solver_actions_WriteRestartFile_hpp
+
+#include "solver/actions/LibActions.hpp"
+#include "solver/Action.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace solver {
+class Time;
+namespace actions {
+
+/// Write a checkpoint of the fields of the mesh and the time state, to restart a simulation with ReadRestartFile.
+/// Every process writes the raw data of its fields, including the ghost rows, to its own binary file,
+/// so the restart needs the same mesh partitioning. The layout of the files is described in RestartFile.
+class solver_actions_API WriteRestartFile : public solver::Action {
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  WriteRestartFile ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~WriteRestartFile() {}
+
+  /// Get the class name
+  static std::string type_name () { return "WriteRestartFile"; }
+
+  /// execute the action
+  virtual void execute ();
+
+private: // data
+
+  Handle<Time> m_time; ///< time to store, optional
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+#endif // cf3_solver_actions_WriteRestartFile_hpp
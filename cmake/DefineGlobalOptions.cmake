@@ -15,6 +15,8 @@ option( CF3_ENABLE_SANDBOX            "Enable build of sandbox projects"
 
 option( CF3_ENABLE_VECTORIZATION      "Enable floating point vectorization"            ON  )
 
+option( CF3_ENABLE_OPENMP             "Enable OpenMP shared memory parallelism (if available)" ON )
+
 option( CF3_ENABLE_GPU                "Enable GPU computing    (if available)"         OFF )
 
 option( CF3_ENABLE_CUDA               "Enable CUDA for GPGPU   (if available)"         ON  )
@@ -87,6 +87,20 @@ find_package(Trilinos)        # Trilinos sparse matrix library
 find_package(Gnuplot QUIET)   # Find gnuplot executable
 coolfluid_set_package(PACKAGE Gnuplot DESCRIPTION "Gnuplot executable")
 
+# openmp support
+if( CF3_ENABLE_OPENMP )
+  find_package(OpenMP QUIET)
+  coolfluid_log_file( "OPENMP_FOUND: [${OPENMP_FOUND}]" )
+  coolfluid_log_file( "  OpenMP_CXX_FLAGS: [${OpenMP_CXX_FLAGS}]" )
+  if( OPENMP_FOUND )
+    set( CMAKE_C_FLAGS   "${CMAKE_C_FLAGS} ${OpenMP_C_FLAGS}" )
+    set( CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${OpenMP_CXX_FLAGS}" )
+    set( CMAKE_EXE_LINKER_FLAGS    "${CMAKE_EXE_LINKER_FLAGS} ${OpenMP_CXX_FLAGS}" )
+    set( CMAKE_SHARED_LINKER_FLAGS "${CMAKE_SHARED_LINKER_FLAGS} ${OpenMP_CXX_FLAGS}" )
+  endif()
+  coolfluid_set_package( PACKAGE OpenMP DESCRIPTION "shared memory parallelism" VARS OPENMP_FOUND )
+endif()
+
 # opencl support
 if( CF3_ENABLE_OPENCL AND CF3_ENABLE_GPU )
   find_package(OpenCL)
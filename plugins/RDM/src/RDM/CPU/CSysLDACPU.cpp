@@ -0,0 +1,83 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+
+#include "mesh/Region.hpp"
+
+#include "physics/PhysModel.hpp"
+#include "physics/Variables.hpp"
+
+#include "RDM/Tags.hpp"
+#include "RDM/GPU/CellLoopGPU.hpp"
+#include "RDM/CPU/CSysLDACPU.hpp"
+#include "RDM/CPU/SchemeCSysLDACPU.hpp"
+
+#include "Physics/NavierStokes/Cons2D.hpp"      // supported physics
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace RDM {
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < CSysLDACPU, RDM::CellTerm, LibCPU > CSysLDACPU_Builder;
+
+common::ComponentBuilder < CellLoopGPU<CSysLDACPU,physics::NavierStokes::Cons2D>,
+                           RDM::CellLoop,
+                           LibCPU >
+                           CSysLDACPU_Euler2D_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+CSysLDACPU::CSysLDACPU ( const std::string& name ) : RDM::CellTerm(name)
+{
+  regist_typeinfo(this);
+
+  options().add_option("nb_threads", 1u)
+      .pretty_name("Number of Threads")
+      .description("Number of OpenMP threads running the kernel. Only used if OpenMP is available");
+}
+
+CSysLDACPU::~CSysLDACPU() {}
+
+void CSysLDACPU::execute()
+{
+  link_fields();
+
+  // get the element loop or create it if does not exist
+
+  Handle< ElementLoop > loop(get_child( "LOOP" ));
+  if( is_null( loop ) )
+  {
+    const std::string update_vars_type =
+        physical_model().get_child( RDM::Tags::update_vars() )
+                        ->handle<physics::Variables>()
+                        ->type();
+
+    loop = create_component<CellLoop>("LOOP", "CellLoopGPU<" + type_name() + "," + update_vars_type + ">");
+  }
+
+  // loop on all regions configured by the user
+
+  boost_foreach(Handle< mesh::Region >& region, m_loop_regions)
+  {
+    loop->select_region( region );
+
+    // all elements of this region are handed to the kernel at once
+
+    loop->execute();
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // RDM
+} // cf3
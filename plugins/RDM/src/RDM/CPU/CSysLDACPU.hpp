@@ -0,0 +1,57 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_RDM_CSysLDACPU_hpp
+#define cf3_RDM_CSysLDACPU_hpp
+
+#include "RDM/CellTerm.hpp"
+
+#include "RDM/CPU/LibCPU.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace RDM {
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+/// System LDA scheme with the N dissipation of CSysLDAGPU, running the same kernel on CPU threads.
+/// The elements of a block are processed all at once by CellLoopGPU: the kernel computes the nodal
+/// residuals of every element independently, and these are added to the nodes color by color,
+/// so that threads never write to the same node.
+class RDM_CPU_API CSysLDACPU : public RDM::CellTerm {
+
+public: // typedefs
+
+  /// the actual scheme implementation is a nested class
+  /// varyng with shape function (SF), quadrature rule (QD) and Physics (PHYS)
+  template < typename SF, typename QD, typename PHYS > class Term;
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  CSysLDACPU ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~CSysLDACPU();
+
+  /// Get the class name
+  static std::string type_name () { return "CSysLDACPU"; }
+
+  /// Execute the loop for all elements
+  virtual void execute();
+
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+} // RDM
+} // cf3
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_RDM_CSysLDACPU_hpp
@@ -0,0 +1,74 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_RDM_LibCPU_hpp
+#define cf3_RDM_LibCPU_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common/Library.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Define the macro RDM_CPU_API
+/// @note build system defines COOLFLUID_RDM_CPU_EXPORTS when compiling
+/// RDM CPU files
+#ifdef COOLFLUID_RDM_CPU_EXPORTS
+#   define RDM_CPU_API      CF3_EXPORT_API
+#   define RDM_CPU_TEMPLATE
+#else
+#   define RDM_CPU_API      CF3_IMPORT_API
+#   define RDM_CPU_TEMPLATE CF3_TEMPLATE_EXTERN
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace RDM {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Class defines the library of RDM terms that run the data-parallel
+/// kernels of the GPU terms on the threads of a multicore CPU
+class RDM_CPU_API LibCPU : public common::Library {
+
+public:
+
+  /// Constructor
+  LibCPU ( const std::string& name) : common::Library(name) {   }
+
+public: // functions
+
+  /// @return string of the library namespace
+  static std::string library_namespace() { return "cf3.RDM.CPU"; }
+
+  /// Static function that returns the library name.
+  /// Must be implemented for Library registration
+  /// @return name of the library
+  static std::string library_name() { return "CPU"; }
+
+  /// Static function that returns the description of the library.
+  /// Must be implemented for Library registration
+  /// @return description of the library
+
+  static std::string library_description()
+  {
+    return "This library implements RDM terms with the GPU kernels running on CPU threads.";
+  }
+
+  /// Gets the Class name
+  static std::string type_name() { return "LibCPU"; }
+
+}; // end LibCPU
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RDM
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_RDM_LibCPU_hpp
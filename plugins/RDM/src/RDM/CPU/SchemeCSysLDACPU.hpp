@@ -0,0 +1,213 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_RDM_SchemeCSysLDACPU_hpp
+#define cf3_RDM_SchemeCSysLDACPU_hpp
+
+#include "coolfluid-config.hpp"
+
+#include "mesh/Functions.hpp"
+
+#include "RDM/SchemeBase.hpp"
+#include "RDM/CPU/CSysLDACPU.hpp"
+#include "RDM/CPU/sysLDACPUkernel.hpp"
+
+#ifdef CF3_HAVE_OPENMP
+  #include <omp.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace RDM {
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+template < typename SF, typename QD, typename PHYS >
+class RDM_CPU_API CSysLDACPU::Term : public SchemeBase<SF,QD,PHYS> {
+
+public: // typedefs
+
+  /// base class type
+  typedef SchemeBase<SF,QD,PHYS> B;
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  Term ( const std::string& name ) : SchemeBase<SF,QD,PHYS>(name),
+    A_inter(SF::nb_nodes*QD::nb_points),
+    A_ksi(SF::nb_nodes*QD::nb_points),
+    A_eta(SF::nb_nodes*QD::nb_points),
+    weights(QD::nb_points)
+  {
+    // flatten the operators as for the GPU kernel
+
+    for( Uint q = 0; q < QD::nb_points; ++q )
+    {
+      for( Uint n = 0; n < SF::nb_nodes; ++n )
+      {
+        A_inter[q*SF::nb_nodes+n] = B::Ni(q,n);
+        A_ksi[q*SF::nb_nodes+n]   = B::dNdKSI[KSI](q,n);
+        A_eta[q*SF::nb_nodes+n]   = B::dNdKSI[ETA](q,n);
+      }
+      weights[q] = B::m_quadrature.weights[q];
+    }
+  }
+
+  /// Virtual destructor
+  virtual ~Term() {}
+
+  /// Get the class name
+  static std::string type_name () { return "CSysLDACPU.Scheme<" + SF::type_name() + ">"; }
+
+  /// execute the action for all elements
+  virtual void execute ();
+
+private: // functions
+
+  /// Add the contributions of the elements of one color to their nodes.
+  /// Shares the elements over the threads when called from within an OpenMP parallel region
+  void scatter( const std::vector<Uint>& color );
+
+private: // data
+
+  /// flattened operators
+  std::vector<Real> A_inter;
+  std::vector<Real> A_ksi;
+  std::vector<Real> A_eta;
+  std::vector<Real> weights;
+
+  /// flattened coordinates, solution and connectivity
+  std::vector<Real> X_node;
+  std::vector<Real> U_node;
+  std::vector<Uint> connectTable;
+
+  /// contributions of every element to its nodes
+  std::vector<Real> phi;
+  std::vector<Real> waveSpeed;
+
+  /// elements in colors that share no nodes, and the flattened connectivity they were computed for.
+  /// The contents are compared, as renumbering changes the connectivity table in place
+  std::vector< std::vector<Uint> > colors;
+  std::vector<Uint> colored_connectTable;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+template<typename SF,typename QD, typename PHYS>
+void CSysLDACPU::Term<SF,QD,PHYS>::execute()
+{
+  cf3_assert( PHYS::MODEL::_ndim == SysLDACPUKernel::dim );
+  cf3_assert( PHYS::MODEL::_neqs == SysLDACPUKernel::nEq );
+
+  const Uint dim      = SysLDACPUKernel::dim;
+  const Uint nEq      = SysLDACPUKernel::nEq;
+  const Uint shape    = SF::nb_nodes;
+  const Uint nodes    = B::coordinates->size();
+  const Uint elements = B::connectivity->size();
+
+  // flatten the data of the elements
+
+  X_node.resize(nodes*dim);
+  U_node.resize(nodes*nEq);
+  connectTable.resize(elements*shape);
+  phi.resize(elements*shape*nEq);
+  waveSpeed.resize(elements*shape);
+
+  for( Uint idx = 0; idx < elements; ++idx )
+    for( Uint idy = 0; idy < shape; ++idy )
+      connectTable[idx*shape+idy] = (*B::connectivity)[idx][idy];
+
+  for( Uint idx = 0; idx < nodes; ++idx )
+  {
+    for( Uint idy = 0; idy < dim; ++idy )
+      X_node[idx*dim+idy] = (*B::coordinates)[idx][idy];
+    for( Uint idy = 0; idy < nEq; ++idy )
+      U_node[idx*nEq+idy] = (*B::solution)[idx][idy];
+  }
+
+  if( colors.empty() || colored_connectTable != connectTable )
+  {
+    mesh::build_element_colors( *B::connectivity, nodes, colors );
+    colored_connectTable = connectTable;
+  }
+
+  const int nb_elems = static_cast<int>(elements);
+
+#ifdef CF3_HAVE_OPENMP
+  const Uint nb_threads = B::parent()->options().option("nb_threads").template value<Uint>();
+
+  #pragma omp parallel num_threads(nb_threads)
+  {
+    SysLDACPUKernel kernel( shape, QD::nb_points );
+
+    #pragma omp for schedule(static)
+    for( int e = 0; e < nb_elems; ++e )
+      kernel( e, &A_inter[0], &A_ksi[0], &A_eta[0], &weights[0], &X_node[0], &U_node[0], &connectTable[0], &phi[0], &waveSpeed[0] );
+
+    // the implicit barrier after every color keeps threads from adding to the same node
+
+    for( Uint c = 0; c < colors.size(); ++c )
+      scatter( colors[c] );
+  }
+#else
+  SysLDACPUKernel kernel( shape, QD::nb_points );
+
+  for( int e = 0; e < nb_elems; ++e )
+    kernel( e, &A_inter[0], &A_ksi[0], &A_eta[0], &weights[0], &X_node[0], &U_node[0], &connectTable[0], &phi[0], &waveSpeed[0] );
+
+  for( Uint c = 0; c < colors.size(); ++c )
+    scatter( colors[c] );
+#endif
+}
+
+template<typename SF,typename QD, typename PHYS>
+void CSysLDACPU::Term<SF,QD,PHYS>::scatter( const std::vector<Uint>& color )
+{
+  const Uint nEq   = SysLDACPUKernel::nEq;
+  const Uint shape = SF::nb_nodes;
+
+  mesh::Field& residual   = *B::residual;
+  mesh::Field& wave_speed = *B::wave_speed;
+
+  const int nb_color_elems = static_cast<int>(color.size());
+
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp for schedule(static)
+#endif
+  for( int i = 0; i < nb_color_elems; ++i )
+  {
+    const Uint idx = color[i];
+    for( Uint idy = 0; idy < shape; ++idy )
+    {
+      // same bounds on the contributions as CSysLDAGPU
+
+      const Uint adress = connectTable[idx*shape+idy];
+      Real wS = waveSpeed[idx*shape+idy];
+      if( wS <= 1e-7 ) wS = 1e-7;
+      wave_speed[adress][0] += wS;
+      for( Uint idz = 0; idz < nEq; ++idz )
+      {
+        Real res = phi[(idx*shape+idy)*nEq+idz];
+        if( res < 1e-7 && res >= 0.0 )
+          res = 1e-7;
+        if( res > -1e-7 && res < 0.0 )
+          res = -1e-7;
+        residual[adress][idz] += res;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+
+} // RDM
+} // cf3
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_RDM_SchemeCSysLDACPU_hpp
@@ -0,0 +1,208 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_RDM_sysLDACPUkernel_hpp
+#define cf3_RDM_sysLDACPUkernel_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "common/EigenAssertions.hpp"
+#include <Eigen/Dense>
+
+#include "common/CF.hpp"
+
+namespace cf3 {
+namespace RDM {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Kernel of CSysLDAGPU (sysLDAGPUkernel.hpp), for one element on a CPU thread.
+///
+/// Data is flattened as for the OpenCL kernel:
+///  - A_inter, A_ksi, A_eta: shape function values and derivatives, A[q*shape+n]
+///  - X_node[node*2+d], U_node[node*4+eq] and connectTable[elem*shape+n]
+///  - phi[(elem*shape+n)*4+eq] and waveSpeed[elem*shape+n]: contributions of every element to its nodes
+/// The kernel is written for the 2D Euler equations in conservative variables, as the OpenCL one,
+/// with the matrices of one quadrature point in fixed size Eigen types, which are vectorized.
+struct SysLDACPUKernel
+{
+  typedef Eigen::Matrix<Real, 4, 4, Eigen::RowMajor> MatrixT;
+  typedef Eigen::Matrix<Real, 4, 1>                  VectorT;
+
+  enum { dim = 2, nEq = 4 };
+
+  SysLDACPUKernel( const Uint nb_shape, const Uint nb_quad ) :
+    shape(nb_shape),
+    quad(nb_quad),
+    X_shape(nb_shape*dim),
+    U_shape(nb_shape*nEq),
+    Ki(nEq, nb_shape*nEq),
+    wS(nb_quad*nb_shape)
+  {
+  }
+
+  /// Compute the contributions of element tx
+  void operator() ( const Uint tx,
+                    const Real* A_inter, const Real* A_ksi, const Real* A_eta, const Real* weights,
+                    const Real* X_node, const Real* U_node, const Uint* connectTable,
+                    Real* phi, Real* waveSpeed )
+  {
+    const Real gamma = 1.4;
+
+    // connection data from the table to the real element
+
+    for( Uint j = 0; j < shape; ++j )
+    {
+      const Uint adress = connectTable[ tx * shape + j ];
+      for( Uint k = 0; k < dim; ++k )
+        X_shape[ j*dim + k ] = X_node[ adress*dim + k ];
+      for( Uint k = 0; k < nEq; ++k )
+        U_shape[ j*nEq + k ] = U_node[ adress*nEq + k ];
+    }
+
+    Real* phi_e = phi + tx*shape*nEq;
+    Real* ws_e  = waveSpeed + tx*shape;
+    std::fill( phi_e, phi_e + shape*nEq, 0. );
+    std::fill( ws_e, ws_e + shape, 0. );
+
+    for( Uint j = 0; j < quad; ++j )
+    {
+      // interpolation from the nodes to the quadrature point
+
+      Real X_ksi[dim] = { 0., 0. };
+      Real X_eta[dim] = { 0., 0. };
+      VectorT U_quad = VectorT::Zero();
+      for( Uint l = 0; l < shape; ++l )
+      {
+        const Uint elemA = j * shape + l;
+        for( Uint k = 0; k < dim; ++k )
+        {
+          X_ksi[k] += A_ksi[elemA] * X_shape[ l*dim + k ];
+          X_eta[k] += A_eta[elemA] * X_shape[ l*dim + k ];
+        }
+        U_quad += A_inter[elemA] * Eigen::Map<const VectorT>( &U_shape[l*nEq] );
+      }
+      const Real jq = X_ksi[0] * X_eta[1] - X_ksi[1] * X_eta[0];
+      const Real wq = weights[j] * jq;
+
+      // properties
+
+      const Real rho  = U_quad[0];
+      const Real u    = U_quad[1] / rho;
+      const Real v    = U_quad[2] / rho;
+      const Real rhoE = U_quad[3];
+      const Real uuvv = u*u + v*v;
+      const Real H = gamma * rhoE / rho - 0.5 * (gamma-1.0) * uuvv;
+      const Real a = std::sqrt((gamma-1.0)*(H-0.5*uuvv));
+      const Real half_gm1_v2 = 0.5 * (gamma - 1.0 ) * uuvv;
+
+      // upwind matrices Ki = R max(D,0) L for the gradient of every shape function
+
+      MatrixT sumLplus = MatrixT::Zero();
+      VectorT dudx = VectorT::Zero();
+      VectorT dudy = VectorT::Zero();
+      MatrixT Rv, Lv;
+      for( Uint k = 0; k < shape; ++k )
+      {
+        const Uint elemMatrix = j * shape + k;
+        const Real nx = (  A_ksi[elemMatrix] * X_eta[1] - A_eta[elemMatrix] * X_ksi[1] ) / jq; // gradX
+        const Real ny = ( -A_ksi[elemMatrix] * X_eta[0] + A_eta[elemMatrix] * X_ksi[0] ) / jq; // gradY
+
+        const Eigen::Map<const VectorT> U_k( &U_shape[k*nEq] );
+        dudx += nx * U_k;
+        dudy += ny * U_k;
+
+        const Real um = u * nx + v * ny;
+        const Real ra = 0.5 * rho / a;
+        const Real coeffM2 = half_gm1_v2 / (a*a);
+        const Real uDivA = (gamma -1.0) * u / a;
+        const Real vDivA = (gamma -1.0) * v / a;
+        const Real gm1_ov_rhoa = (gamma -1.0) / a;
+
+        Rv << 1.0,      0.0,             ra,               ra,
+              u,        rho*ny,          ra * (u+a*nx),    ra * (u-a*nx),
+              v,        -rho*nx,         ra * (v+a*ny),    ra * (v-a*ny),
+              0.5*uuvv, rho*(u*ny-v*nx), ra * (H+a*um),    ra * (H-a*um);
+
+        Lv << 1.0-coeffM2,                   uDivA / a,          vDivA / a,          -(gamma-1.0)/(a*a),
+              ( v*nx-u*ny ) / rho,           ny/rho,             -nx / rho,          0.0,
+              a / rho * (coeffM2 - um / a),  (nx-uDivA) / rho,   (ny-vDivA) / rho,   gm1_ov_rhoa,
+              a / rho * (coeffM2 + um / a),  -(nx+uDivA) / rho,  -(ny+vDivA) / rho,  gm1_ov_rhoa;
+
+        VectorT Dv;
+        Dv << std::max(um,0.), std::max(um,0.), std::max(um+a,0.), std::max(um-a,0.);
+
+        Ki.block<nEq,nEq>(0,k*nEq).noalias() = Rv * Dv.asDiagonal() * Lv;
+        sumLplus += Ki.block<nEq,nEq>(0,k*nEq);
+
+        const Real ax = std::max( Dv[0], Dv[1] );
+        const Real bx = Dv[0] >= Dv[1] ? Dv[2] : Dv[3];
+        wS[j*shape+k] = std::max( ax, bx ) * wq;
+      }
+
+      const MatrixT invKi = sumLplus.inverse();
+
+      // flux jacobians
+
+      MatrixT Af, Bf;
+      Af << 0.0,                1.0,                  0.0,                  0.0,
+            half_gm1_v2 -u*u,   -(gamma - 3.0)*u,     -(gamma-1.0)*v,       gamma - 1.0,
+            -u*v,               v,                    u,                    0.0,
+            (half_gm1_v2-H)*u,  -(gamma-1.0)*u*u +H,  -(gamma-1.0)*u*v,     gamma * u;
+
+      Bf << 0.0,                0.0,                  1.0,                  0.0,
+            -u*v,               v,                    u,                    0.0,
+            half_gm1_v2 -v*v,   -(gamma-1.0)*u,       -(gamma-3.0)*v,       gamma - 1.0,
+            (half_gm1_v2-H)*v,  -(gamma-1.0)*u*v,     -(gamma-1.0)*v*v +H,  gamma * v;
+
+      const VectorT LU = Af * dudx + Bf * dudy;
+      const VectorT LUwq = invKi * LU * wq;
+
+      for( Uint k = 0; k < shape; ++k )
+      {
+        // LDA part
+
+        const VectorT phiH = Ki.block<nEq,nEq>(0,k*nEq) * LUwq;
+
+        // N dissipation
+
+        const Eigen::Map<const VectorT> U_k( &U_shape[k*nEq] );
+        VectorT diss = VectorT::Zero();
+        for( Uint m = 0; m < shape; ++m )
+        {
+          if( k != m )
+            diss += Ki.block<nEq,nEq>(0,m*nEq) * ( U_k - Eigen::Map<const VectorT>( &U_shape[m*nEq] ) );
+        }
+        const VectorT phiHN = Ki.block<nEq,nEq>(0,k*nEq) * ( invKi * diss * wq );
+
+        Eigen::Map<VectorT>( phi_e + k*nEq ) += phiH + 0.001 * phiHN;
+        ws_e[k] += wS[j*shape+k];
+      }
+    }
+  }
+
+  const Uint shape;
+  const Uint quad;
+
+private:
+
+  /// coordinates and solution of the nodes of the element
+  std::vector<Real> X_shape;
+  std::vector<Real> U_shape;
+  /// upwind matrices of all shape functions, in one quadrature point
+  Eigen::Matrix<Real, nEq, Eigen::Dynamic> Ki;
+  /// wave speed contributions
+  std::vector<Real> wS;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RDM
+} // cf3
+
+#endif // cf3_RDM_sysLDACPUkernel_hpp
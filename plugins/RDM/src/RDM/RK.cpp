@@ -97,11 +97,15 @@ void RK::execute()
 
   // implementation of the RungeKutta update step
 
+  // flat loop over the contiguous field storage, so it vectorizes
   const Uint nbdofs = solution_k.size();
   const Uint nbvars = solution_k.row_size();
+  Real* u = solution_k.array().data();
+  const Real* r = residual.array().data();
+  const Real* area = dual_area.array().data();
   for ( Uint i=0; i< nbdofs; ++i )
     for ( Uint j=0; j< nbvars; ++j )
-      solution_k[i][j] += - residual[i][j] / dual_area[i][0];
+      u[i*nbvars+j] += - r[i*nbvars+j] / area[i];
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -7,7 +7,10 @@
 #ifndef cf3_RDM_SchemeBase_hpp
 #define cf3_RDM_SchemeBase_hpp
 
+#include <algorithm>
 #include <functional>
+#include <map>
+#include <vector>
 
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
@@ -20,6 +23,7 @@
 #include "common/Log.hpp"
 
 #include "common/Core.hpp"
+#include "common/EventHandler.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionComponent.hpp"
 #include "common/BasicExceptions.hpp"
@@ -70,9 +74,21 @@ public: // functions
   static std::string type_name () { return "SchemeBase<" + SF::type_name() + ">"; }
 
   /// interpolates the shape functions and gradient values
+  /// @pre nodes_idx is the connectivity row of the element idx()
   /// @post zeros the local residual matrix
   void interpolate ( const common::Table<Uint>::ConstRow& nodes_idx );
 
+  /// computes the geometric quantities X_n, X_q, dX, JM, JMinv, dNdX, jacob and wj of the element idx(),
+  /// or takes them from the geometry cache if the option "cache_geometry" is set
+  /// @pre nodes_idx is the connectivity row of the element idx()
+  void interpolate_geometry ( const common::Table<Uint>::ConstRow& nodes_idx );
+
+  /// interpolates the solution to the quadrature points of a batch of consecutive elements,
+  /// with one product of Ni with the solution of all nodes of the batch
+  /// @param [in] begin     first element of the batch
+  /// @param [in] nb_elems  number of elements in the batch
+  void interpolate_batch ( const Uint begin, const Uint nb_elems );
+
   void sol_gradients_at_qdpoint(const Uint q);
 
 protected: // helper functions
@@ -111,6 +127,24 @@ protected: // helper functions
     cf3_assert( is_not_null(connectivity) );
     cf3_assert( is_not_null(coordinates) );
 
+    // a new loop over the elements starts, so the solution of the last batch may be outdated
+
+    m_batch_begin = m_batch_end = 0;
+
+    // the geometry cache of these elements is rebuilt if they changed their nodes
+
+    GeometryCache& cache = m_geometry_cache[ elements().handle<mesh::Entities>() ];
+    if ( cache.connectivity != connectivity ||
+         cache.coordinates  != coordinates  ||
+         cache.nb_elems     != elements().size() )
+    {
+      cache.connectivity = connectivity;
+      cache.coordinates  = coordinates;
+      cache.nb_elems     = elements().size();
+      cache.built        = false;
+    }
+    m_geometry = &cache;
+
     CFinfo << "PPPPPPPPPPPPPP1: " << connectivity->uri().path() << CFendl;
     CFinfo << "PPPPPPPPPPPPPP2: " << coordinates->uri().path() << CFendl;
     CFinfo << "PPPPPPPPPPPPPP3: " << solution->uri().path() << CFendl;
@@ -118,6 +152,19 @@ protected: // helper functions
     CFinfo << "PPPPPPPPPPPPPP5: " << wave_speed->uri().path() << CFendl;
   }
 
+  /// computes X_q, dX, jacob, dNdX and wj from the node coordinates X_n
+  void compute_geometry();
+
+  /// computes and stores the geometry of all elements of the current Elements
+  void build_geometry_cache();
+
+  /// invalidates all geometry caches, as the nodes of the mesh may have moved
+  void on_mesh_changed_event( common::SignalArgs& args )
+  {
+    for( typename GeometryCacheMapT::iterator it = m_geometry_cache.begin(); it != m_geometry_cache.end(); ++it )
+      it->second.built = false;
+  }
+
 protected: // typedefs
 
   typedef typename SF::NodesT                                               NodeMT;
@@ -146,6 +193,24 @@ protected: // typedefs
 
   typedef Eigen::Matrix<Real, PHYS::MODEL::_neqs, PHYS::MODEL::_ndim>            QSolutionVT;
 
+  /// Geometric quantities of all elements of an Elements component, that are constant on a static mesh.
+  /// Per element are stored: dNdX for every dimension, jacob, wj, X_q and dX for every dimension
+  struct GeometryCache
+  {
+    GeometryCache() : nb_elems(0), built(false) {}
+
+    /// number of values stored per element
+    static Uint stride() { return PHYS::MODEL::_ndim * QD::nb_points * ( SF::nb_nodes + 1 + PHYS::MODEL::_ndim ) + 2 * QD::nb_points; }
+
+    Handle< mesh::Connectivity > connectivity; ///< connectivity the cache was built with
+    Handle< mesh::Field > coordinates;         ///< coordinates the cache was built with
+    Uint nb_elems;                             ///< number of elements the cache was built for
+    bool built;                                ///< false if the cache must be (re)computed
+    std::vector<Real> data;                    ///< values of all elements, stride() per element
+  };
+
+  typedef std::map< Handle<mesh::Entities>, GeometryCache > GeometryCacheMapT;
+
 protected: // data
 
   Handle< mesh::Field > csolution;   ///< solution field
@@ -216,6 +281,25 @@ protected:
   /// Inverse of the Jacobi matrix at each quadrature point
   JMT JMinv;
 
+private: // data
+
+  /// store the geometry of the elements instead of recomputing it every iteration
+  bool m_cache_geometry;
+  /// geometry per Elements component
+  GeometryCacheMapT m_geometry_cache;
+  /// geometry cache of the current elements
+  GeometryCache* m_geometry;
+
+  /// number of elements of which the solution is interpolated at once
+  Uint m_batch_size;
+  /// range of elements of the current batch
+  Uint m_batch_begin;
+  Uint m_batch_end;
+  /// solution in the nodes of the batch, PHYS::MODEL::_neqs columns per element
+  Eigen::Matrix<Real, SF::nb_nodes, Eigen::Dynamic> m_batch_U_n;
+  /// solution in the quadrature points of the batch, PHYS::MODEL::_neqs columns per element
+  Eigen::Matrix<Real, QD::nb_points, Eigen::Dynamic> m_batch_U_q;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -223,7 +307,12 @@ protected:
 template<typename SF, typename QD, typename PHYS>
 SchemeBase<SF,QD,PHYS>::SchemeBase ( const std::string& name ) :
   LoopOperation(name),
-  m_quadrature( QD::instance() )
+  m_quadrature( QD::instance() ),
+  m_cache_geometry(false),
+  m_geometry(NULL),
+  m_batch_size(1u),
+  m_batch_begin(0),
+  m_batch_end(0)
 {
   regist_typeinfo(this); // template class so must force type registration @ construction
 
@@ -234,9 +323,23 @@ SchemeBase<SF,QD,PHYS>::SchemeBase ( const std::string& name ) :
   options().add_option(RDM::Tags::residual(), cresidual).link_to(&cresidual);
 
 
+  options().add_option("cache_geometry", m_cache_geometry)
+      .description("Compute the shape function gradients and integration weights of every element once,\n"
+                   "and reuse them until the mesh changes")
+      .pretty_name("Cache Geometry")
+      .link_to(&m_cache_geometry);
+
+  options().add_option("batch_size", m_batch_size)
+      .description("Number of elements of which the solution is interpolated to the quadrature points at once")
+      .pretty_name("Batch Size")
+      .link_to(&m_batch_size);
+
   options()["elements"]
       .attach_trigger ( boost::bind ( &SchemeBase<SF,QD,PHYS>::change_elements, this ) );
 
+  common::Core::instance().event_handler().connect_to_event("mesh_changed", this, &SchemeBase<SF,QD,PHYS>::on_mesh_changed_event);
+  common::Core::instance().event_handler().connect_to_event("mesh_loaded",  this, &SchemeBase<SF,QD,PHYS>::on_mesh_changed_event);
+
   // initializations
 
   for(Uint d = 0; d < PHYS::MODEL::_ndim; ++d)
@@ -281,25 +384,120 @@ SchemeBase<SF,QD,PHYS>::SchemeBase ( const std::string& name ) :
 template<typename SF,typename QD, typename PHYS>
 void SchemeBase<SF, QD,PHYS>::interpolate( const common::Table<Uint>::ConstRow& nodes_idx )
 {
-  /// @todo must be tested for 3D
+  interpolate_geometry( nodes_idx );
 
-  // copy the coordinates from the large array to a small
+  if( m_batch_size > 1u )
+  {
+    // take the solution from the batch, interpolating the next batch when leaving it
+
+    const Uint elem = idx();
+    if( elem < m_batch_begin || elem >= m_batch_end )
+      interpolate_batch( elem, std::min( m_batch_size, elements().size() - elem ) );
+
+    const Uint col = (elem - m_batch_begin) * PHYS::MODEL::_neqs;
+    U_n = m_batch_U_n.template middleCols<PHYS::MODEL::_neqs>(col);
+    U_q = m_batch_U_q.template middleCols<PHYS::MODEL::_neqs>(col);
+  }
+  else
+  {
+    // copy the solution from the large array to a small
+
+    for(Uint n = 0; n < SF::nb_nodes; ++n)
+      for (Uint v=0; v < PHYS::MODEL::_neqs; ++v)
+        U_n(n,v) = (*solution)[ nodes_idx[n] ][v];
+
+    // solution at all quadrature points in physical space
+
+    U_q = Ni * U_n;
+  }
+
+  // solution derivatives in physical space at quadrature point
+
+  for(Uint dim = 0; dim < PHYS::MODEL::_ndim; ++dim)
+    dUdX[dim] = dNdX[dim] * U_n;
+
+  // zero element residuals
+
+  Phi_n.setZero();
+}
+
+
+template<typename SF,typename QD, typename PHYS>
+void SchemeBase<SF, QD,PHYS>::interpolate_geometry( const common::Table<Uint>::ConstRow& nodes_idx )
+{
+  if( !m_cache_geometry )
+  {
+    // copy the coordinates from the large array to a small
+
+    mesh::fill(X_n, *coordinates, nodes_idx );
+
+    compute_geometry();
+    return;
+  }
+
+  cf3_assert( m_geometry != NULL );
+  if( !m_geometry->built )
+    build_geometry_cache();
 
   mesh::fill(X_n, *coordinates, nodes_idx );
 
-  // copy the solution from the large array to a small
+  const Real* data = &m_geometry->data[ idx() * GeometryCache::stride() ];
+  for(Uint dim = 0; dim < PHYS::MODEL::_ndim; ++dim, data += QD::nb_points * SF::nb_nodes)
+    dNdX[dim] = Eigen::Map<const SFMatrixT>(data);
+  jacob = Eigen::Map<const WeightVT>(data);
+  data += QD::nb_points;
+  wj = Eigen::Map<const WeightVT>(data);
+  data += QD::nb_points;
+  X_q = Eigen::Map<const QCoordMT>(data);
+  data += QD::nb_points * PHYS::MODEL::_ndim;
+  for(Uint dim = 0; dim < PHYS::MODEL::_ndim; ++dim, data += QD::nb_points * PHYS::MODEL::_ndim)
+    dX[dim] = Eigen::Map<const QCoordMT>(data);
 
-  for(Uint n = 0; n < SF::nb_nodes; ++n)
-    for (Uint v=0; v < PHYS::MODEL::_neqs; ++v)
-      U_n(n,v) = (*solution)[ nodes_idx[n] ][v];
+  // JM and JMinv are left at the last quadrature point, as by compute_geometry()
 
-  // coordinates of quadrature points in physical space
+  for(Uint dimx = 0; dimx < PHYS::MODEL::_ndim; ++dimx)
+    for(Uint dimksi = 0; dimksi < PHYS::MODEL::_ndim; ++dimksi)
+      JM(dimksi,dimx) = dX[dimx](QD::nb_points-1,dimksi);
+  JMinv = JM.inverse();
+}
 
-  X_q  = Ni * X_n;
 
-  // solution at all quadrature points in physical space
+template<typename SF,typename QD, typename PHYS>
+void SchemeBase<SF, QD,PHYS>::interpolate_batch( const Uint begin, const Uint nb_elems )
+{
+  cf3_assert( begin + nb_elems <= elements().size() );
+
+  m_batch_U_n.resize( Eigen::NoChange, nb_elems * PHYS::MODEL::_neqs );
+
+  // copy the solution of all elements of the batch next to each other
+
+  const mesh::Field& sol = *solution;
+  for(Uint e = 0; e < nb_elems; ++e)
+  {
+    const mesh::Connectivity::ConstRow nodes_idx = (*connectivity)[begin + e];
+    const Uint col = e * PHYS::MODEL::_neqs;
+    for(Uint n = 0; n < SF::nb_nodes; ++n)
+      for (Uint v=0; v < PHYS::MODEL::_neqs; ++v)
+        m_batch_U_n(n,col+v) = sol[ nodes_idx[n] ][v];
+  }
+
+  // solution at all quadrature points of all elements
+
+  m_batch_U_q.noalias() = Ni * m_batch_U_n;
+
+  m_batch_begin = begin;
+  m_batch_end   = begin + nb_elems;
+}
+
 
-  U_q = Ni * U_n;
+template<typename SF,typename QD, typename PHYS>
+void SchemeBase<SF, QD,PHYS>::compute_geometry()
+{
+  /// @todo must be tested for 3D
+
+  // coordinates of quadrature points in physical space
+
+  X_q  = Ni * X_n;
 
   // Jacobian of transformation phys -> ref:
   //    |   dx/dksi    dx/deta    |
@@ -347,15 +545,46 @@ void SchemeBase<SF, QD,PHYS>::interpolate( const common::Table<Uint>::ConstRow&
 
   for(Uint q = 0; q < QD::nb_points; ++q)
     wj[q] = jacob[q] * m_quadrature.weights[q];
+}
 
-  // solution derivatives in physical space at quadrature point
 
-  for(Uint dim = 0; dim < PHYS::MODEL::_ndim; ++dim)
-    dUdX[dim] = dNdX[dim] * U_n;
+template<typename SF,typename QD, typename PHYS>
+void SchemeBase<SF, QD,PHYS>::build_geometry_cache()
+{
+  cf3_assert( m_geometry != NULL );
 
-  // zero element residuals
+  const Uint nb_elems = elements().size();
+  const Uint stride = GeometryCache::stride();
+  m_geometry->data.resize( nb_elems * stride );
 
-  Phi_n.setZero();
+  for(Uint elem = 0; elem < nb_elems; ++elem)
+  {
+    mesh::fill(X_n, *coordinates, (*connectivity)[elem] );
+    compute_geometry();
+
+    Real* data = &m_geometry->data[ elem * stride ];
+    for(Uint dim = 0; dim < PHYS::MODEL::_ndim; ++dim, data += QD::nb_points * SF::nb_nodes)
+    {
+      Eigen::Map<SFMatrixT> elem_dNdX(data);
+      elem_dNdX = dNdX[dim];
+    }
+    Eigen::Map<WeightVT> elem_jacob(data);
+    elem_jacob = jacob;
+    data += QD::nb_points;
+    Eigen::Map<WeightVT> elem_wj(data);
+    elem_wj = wj;
+    data += QD::nb_points;
+    Eigen::Map<QCoordMT> elem_X_q(data);
+    elem_X_q = X_q;
+    data += QD::nb_points * PHYS::MODEL::_ndim;
+    for(Uint dim = 0; dim < PHYS::MODEL::_ndim; ++dim, data += QD::nb_points * PHYS::MODEL::_ndim)
+    {
+      Eigen::Map<QCoordMT> elem_dX(data);
+      elem_dX = dX[dim];
+    }
+  }
+
+  m_geometry->built = true;
 }
 
 
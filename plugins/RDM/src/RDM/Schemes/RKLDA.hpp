@@ -232,56 +232,9 @@ void RKLDA::Term<SF,QD,PHYS>::execute()
       for (Uint eq = 0; eq < PHYS::MODEL::_neqs; ++eq)
         sols_l[l](n,eq) = (*ksolutions[l])[ nodes_idx[n] ][eq];
 
-  /// @todo must be tested for 3D
-
-  // copy the coordinates from the large array to a small
-
-  mesh::fill(B::X_n, *B::coordinates, nodes_idx );
-
-  // coordinates of quadrature points in physical space
-
-  B::X_q  = B::Ni * B::X_n;
-
-  // Jacobian of transformation phys -> ref:
-  //    |   dx/dksi    dx/deta    |
-  //    |   dy/dksi    dy/deta    |
-
-  // dX[XX].col(KSI) has the values of dx/dksi at all quadrature points
-  // dX[XX].col(ETA) has the values of dx/deta at all quadrature points
-
-  for(Uint dimx = 0; dimx < PHYS::MODEL::_ndim; ++dimx)
-    for(Uint dimksi = 0; dimksi < PHYS::MODEL::_ndim; ++dimksi)
-      B::dX[dimx].col(dimksi) = B::dNdKSI[dimksi] * B::X_n.col(dimx);
-
   // compute element-wise transformations that depend solely on geometry
 
-  for(Uint q = 0; q < QD::nb_points; ++q)
-  {
-    for(Uint dimx = 0; dimx < PHYS::MODEL::_ndim; ++dimx)
-      for(Uint dimksi = 0; dimksi < PHYS::MODEL::_ndim; ++dimksi)
-        B::JM(dimksi,dimx) = B::dX[dimx](q,dimksi);
-
-    // compute the gradients of of all shape functions in phys. space
-
-    B::jacob[q] = B::JM.determinant();
-    B::JMinv = B::JM.inverse();
-
-    for(Uint n = 0; n < SF::nb_nodes; ++n)
-    {
-      for(Uint dimksi = 0; dimksi < PHYS::MODEL::_ndim; ++ dimksi)
-        B::dNref[dimksi] = B::dNdKSI[dimksi](q,n);
-
-      B::dNphys = B::JMinv * B::dNref;
-
-      for(Uint dimx = 0; dimx < PHYS::MODEL::_ndim; ++ dimx)
-        B::dNdX[dimx](q,n) = B::dNphys[dimx];
-    }
-
-    // compute transformed integration weights (sum is element area)
-
-    B::wj[q] = B::jacob[q] * B::m_quadrature.weights[q];
-
-  } // loop quadrature points
+  B::interpolate_geometry( nodes_idx );
 
   // zero element residuals
 
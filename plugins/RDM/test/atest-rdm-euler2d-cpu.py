@@ -0,0 +1,115 @@
+#!/usr/bin/python
+
+import coolfluid as cf
+
+### Global settings
+
+root = cf.Core.root()
+env = cf.Core.environment()
+
+env.options().configure_option('assertion_throws', False)
+env.options().configure_option('assertion_backtrace', True)
+env.options().configure_option('exception_backtrace', True)
+env.options().configure_option('exception_aborts', True)
+env.options().configure_option('exception_outputs', True)
+env.options().configure_option('log_level', 3)
+env.options().configure_option('regist_signal_handlers', False)
+
+### create model
+
+wizard = root.create_component('Wizard',  'cf3.RDM.SteadyExplicit')
+
+wizard.create_model(model_name='Model', physical_model='cf3.physics.NavierStokes.NavierStokes2D')
+model = root.get_child('Model')
+
+### read mesh
+
+domain = model.get_child('Domain')
+domain.load_mesh(file=cf.URI('trapezium1x1-tg-p1-508.msh'), name='mesh')
+
+internal_regions = [cf.URI('//Model/Domain/mesh/topology/domain')]
+
+### solver
+
+solver = model.get_child('RDSolver')
+solver.options().configure_option('update_vars', 'Cons2D')
+
+solver.get_child('IterativeSolver').get_child('MaxIterations').options().configure_option('maxiter', 100)
+solver.get_child('IterativeSolver').get_child('Update').get_child('Step').options().configure_option('cfl', 0.25)
+
+### initial conditions
+
+iconds = solver.get_child('InitialConditions')
+iconds.create_initial_condition(name='INIT')
+iconds.get_child('INIT').options().configure_option('functions',
+     ['if(x>0.5,0.5,1.)',
+      '0.0',
+      'if(x>0.5,1.67332,2.83972)',
+      'if(x>0.5,3.425,6.532)'])
+iconds.get_child('INIT').options().configure_option('regions', internal_regions)
+
+### boundary conditions
+
+solver.get_child('BoundaryConditions').create_boundary_condition(name='INLET',type='cf3.RDM.BcDirichlet')
+solver.get_child('BoundaryConditions').get_child('INLET').options().configure_option('functions',
+     ['if(x>0.5,0.5,1.)',
+      '0.0',
+      'if(x>0.5,1.67332,2.83972)',
+      'if(x>0.5,3.425,6.532)'])
+
+### domain discretization, with the kernel of CSysLDAGPU running on CPU threads
+
+solver.get_child('DomainDiscretization').create_cell_term(name='INTERNAL', type='cf3.RDM.CPU.CSysLDACPU')
+solver.get_child('DomainDiscretization').get_child('CellTerms').get_child('INTERNAL').options().configure_option('regions', internal_regions)
+solver.get_child('DomainDiscretization').get_child('CellTerms').get_child('INTERNAL').options().configure_option('nb_threads', 2)
+
+### compare the residual of the initial solution with the one of the LDA scheme
+# The CPU kernel adds 0.001 times the N scheme distribution to the LDA one, and bounds the
+# contributions away from zero by 1e-7, as CSysLDAGPU does. It is therefore close to LDA, not equal.
+
+iconds.execute()
+
+residual = root.access_component('//Model/Domain/mesh/geometry/residual')
+
+def compute_residual(term):
+  for i in range(len(residual)):
+    residual[i] = [0.] * residual.row_size()
+  term.execute()
+  return [[residual[i][j] for j in range(residual.row_size())] for i in range(len(residual))]
+
+cell_terms = solver.get_child('DomainDiscretization').get_child('CellTerms')
+
+def compare_with_lda():
+  solver.get_child('DomainDiscretization').create_cell_term(name='REFERENCE', type='cf3.RDM.Schemes.LDA')
+  cell_terms.get_child('REFERENCE').options().configure_option('regions', internal_regions)
+
+  cpu_residual = compute_residual(cell_terms.get_child('INTERNAL'))
+  lda_residual = compute_residual(cell_terms.get_child('REFERENCE'))
+  cell_terms.get_child('REFERENCE').delete_component()
+
+  max_residual = max([abs(r) for row in lda_residual for r in row])
+  max_difference = max([abs(c - l) for cpu_row, lda_row in zip(cpu_residual, lda_residual) for c, l in zip(cpu_row, lda_row)])
+  print('max residual of LDA: ' + str(max_residual) + ', max difference with the CPU kernel: ' + str(max_difference))
+  if max_residual == 0. or max_difference > 1e-2 * max_residual:
+    raise Exception('Residual of CSysLDACPU differs from the LDA scheme by ' + str(max_difference) + ' for a residual of ' + str(max_residual))
+
+compare_with_lda()
+
+### renumber the mesh, which reorders the connectivity table in place
+# The element colors of the CPU kernel were computed for the old numbering, and must be recomputed
+
+renumber = root.create_component('renumber', 'cf3.mesh.actions.Renumber')
+renumber.options().configure_option('mesh', root.access_component('//Model/Domain/mesh'))
+renumber.execute()
+
+compare_with_lda()
+
+### simulate and write the result
+
+model.simulate()
+
+gmsh_writer = model.create_component('gmsh_writer','cf3.mesh.gmsh.Writer')
+gmsh_writer.options().configure_option('mesh',root.access_component('//Model/Domain/mesh'))
+gmsh_writer.options().configure_option('fields',[cf.URI('//Model/Domain/mesh/geometry/solution')])
+gmsh_writer.options().configure_option('file',cf.URI('file:atest-rdm-euler2d-cpu.msh'))
+gmsh_writer.execute()
@@ -0,0 +1,119 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Benchmark of the cf3::RDM::Schemes::LDA residual"
+
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/OptionList.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Domain.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/Region.hpp"
+
+#include "solver/Model.hpp"
+
+#include "RDM/CellTerm.hpp"
+#include "RDM/DomainDiscretization.hpp"
+#include "RDM/RDSolver.hpp"
+#include "RDM/SteadyExplicit.hpp"
+#include "RDM/Tags.hpp"
+
+#include "Tools/Testing/BenchmarkReport.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Arguments: number of cells in x and y, number of residual evaluations to time
+struct LDABenchmarkFixture
+{
+  LDABenchmarkFixture() :
+    m_argc(boost::unit_test::framework::master_test_suite().argc),
+    m_argv(boost::unit_test::framework::master_test_suite().argv)
+  {
+  }
+
+  Uint argument(const int i, const Uint default_value) const
+  {
+    return i < m_argc ? boost::lexical_cast<Uint>(m_argv[i]) : default_value;
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( LDABenchmarkSuite, LDABenchmarkFixture )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( lda_residual )
+{
+  std::vector<Uint> nb_cells(2);
+  nb_cells[XX] = argument(1, 500u);
+  nb_cells[YY] = argument(2, 500u);
+  const Uint nb_calls = argument(3, 10u);
+
+  boost::shared_ptr<RDM::SteadyExplicit> wizard = allocate_component<RDM::SteadyExplicit>("Wizard");
+  Model& model = wizard->create_model("Model", "cf3.physics.Scalar.Scalar2D");
+  RDM::RDSolver& solver = *Handle<RDM::RDSolver>(model.get_child("RDSolver"));
+  solver.options().configure_option(RDM::Tags::update_vars(), std::string("LinearAdv2D"));
+
+  Handle<Mesh> mesh = model.domain().create_component<Mesh>("mesh");
+  boost::shared_ptr< MeshGenerator > generate_mesh = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","meshgenerator");
+  generate_mesh->options().configure_option("nb_cells",nb_cells);
+  generate_mesh->options().configure_option("lengths",std::vector<Real>(2,1.));
+  generate_mesh->options().configure_option("mesh",mesh->uri());
+  generate_mesh->execute();
+
+  solver.options().configure_option(RDM::Tags::mesh(), mesh);
+
+  const std::vector<URI> regions(1, mesh->topology().get_child("interior")->uri());
+  RDM::CellTerm& lda = solver.domain_discretization().create_cell_term("cf3.RDM.Schemes.LDA", "INTERNAL", regions);
+
+  Tools::Testing::BenchmarkReport report("rdm-lda");
+  report.add_parameter("nb_cells_x",nb_cells[XX]);
+  report.add_parameter("nb_cells_y",nb_cells[YY]);
+
+  report.time("lda_residual", boost::bind(&RDM::CellTerm::execute, &lda), nb_calls);
+
+  report.write();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -7,10 +7,28 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Test module for cf3::RDM::Schemes::LDA"
 
+#include <cmath>
+
 #include <boost/test/unit_test.hpp>
 
 #include "common/Core.hpp"
+#include "common/Link.hpp"
+#include "common/OptionList.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Domain.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Field.hpp"
 
+#include "solver/Model.hpp"
+
+#include "RDM/RDSolver.hpp"
+#include "RDM/SteadyExplicit.hpp"
+#include "RDM/DomainDiscretization.hpp"
+#include "RDM/Tags.hpp"
 #include "RDM/Schemes/LDA.hpp"
 
 using namespace cf3;
@@ -52,4 +70,55 @@ BOOST_AUTO_TEST_CASE( const_solution )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// The residual does not depend on the geometry cache and the batched interpolation
+BOOST_AUTO_TEST_CASE( cache_geometry )
+{
+  using namespace boost::unit_test::framework;
+  PE::Comm::instance().init( master_test_suite().argc, master_test_suite().argv );
+
+  boost::shared_ptr<RDM::SteadyExplicit> wizard = allocate_component<RDM::SteadyExplicit>("Wizard");
+  Model& model = wizard->create_model("Model", "cf3.physics.Scalar.Scalar2D");
+  RDM::RDSolver& solver = *Handle<RDM::RDSolver>(model.get_child("RDSolver"));
+  solver.options().configure_option(RDM::Tags::update_vars(), std::string("LinearAdv2D"));
+
+  Handle<Mesh> mesh = model.domain().create_component<Mesh>("mesh");
+  boost::shared_ptr< MeshGenerator > generate_mesh = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","meshgenerator");
+  generate_mesh->options().configure_option("nb_cells",std::vector<Uint>(2,7u));
+  generate_mesh->options().configure_option("lengths",std::vector<Real>(2,1.));
+  generate_mesh->options().configure_option("mesh",mesh->uri());
+  generate_mesh->execute();
+
+  solver.options().configure_option(RDM::Tags::mesh(), mesh);
+
+  const std::vector<URI> regions(1, mesh->topology().get_child("interior")->uri());
+  RDM::CellTerm& lda = solver.domain_discretization().create_cell_term("cf3.RDM.Schemes.LDA", "INTERNAL", regions);
+
+  Field& solution   = *follow_link( solver.fields().get_child( RDM::Tags::solution() ) )->handle<Field>();
+  Field& residual   = *follow_link( solver.fields().get_child( RDM::Tags::residual() ) )->handle<Field>();
+  Field& wave_speed = *follow_link( solver.fields().get_child( RDM::Tags::wave_speed() ) )->handle<Field>();
+  for (Uint n=0; n<solution.size(); ++n)
+    solution[n][0] = std::sin(3.*solution.coordinates()[n][XX]) * std::cos(2.*solution.coordinates()[n][YY]);
+
+  residual = 0.;
+  wave_speed = 0.;
+  lda.execute();
+  const std::vector<Real> reference(residual.array().data(), residual.array().data()+residual.size());
+
+  // the 7 elements per batch don't divide the number of elements
+  lda.configure_option_recursively("cache_geometry", true);
+  lda.configure_option_recursively("batch_size", 7u);
+  for (Uint pass=0; pass<2; ++pass) // the cache is built in the first pass, and used in the second one
+  {
+    residual = 0.;
+    wave_speed = 0.;
+    lda.execute();
+    for (Uint n=0; n<residual.size(); ++n)
+      BOOST_CHECK_SMALL(residual[n][0]-reference[n], 1e-12);
+  }
+
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -45,17 +45,16 @@ public:
   virtual void compute_interface_flux(const RealVector& left, const RealVector& right, const RealVector& coords, const RealVector& normal,
                                       RealVector& flux);
 
-public:
-  Real M1(Real Mach, char chsign);
-  Real M2(Real Mach, char chsign);
-  Real M4(Real Mach, char chsign);
-
-  Real P5(Real Mach, Real alpha, char chsign);
+  virtual void compute_interface_fluxes(const Uint nb_faces, const Real* left, const Real* right, const Real* coords, const Real* normals,
+                                        Real* flux, Real* wave_speeds);
 
 private:
 
   void trigger_physical_model();
 
+  /// Flux of one face, and its wave speeds if the pointer is not null
+  void compute_face(const RealVector& left, const RealVector& right, const RealVector& normal, RealVector& flux, Real* wave_speeds);
+
 private:
 
   std::auto_ptr<physics::NavierStokes::NavierStokes2D::Properties> p_left;
@@ -63,22 +62,8 @@ private:
   std::auto_ptr<physics::NavierStokes::NavierStokes2D::Properties> p_avg;
   RealVector coord;
   RealMatrix grads;
-  RealMatrix f_left;
-  RealMatrix f_right;
-
-  RealVector eigenvalues;
-  RealMatrix left_eigenvectors;
-  RealMatrix right_eigenvectors;
-  RealMatrix abs_jacobian;
-
-
-  Real  m_fa, m_CoeffKu, m_CoeffKp, m_Coeffsigma, m_Machinf, m_Beta;
 
-  // Operator to calculate the absolute value
-  struct Abs : public physics::UnaryRealOp
-  {
-    virtual Real operator() ( const Real& r ) const { return std::abs(r); };
-  } abs;
+  Real  m_CoeffKu, m_CoeffKp, m_Coeffsigma, m_Machinf, m_Beta;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
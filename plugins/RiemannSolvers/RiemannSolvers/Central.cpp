@@ -8,6 +8,7 @@
 #include "common/PropertyList.hpp"
 #include "common/OptionComponent.hpp"
 
+#include "RiemannSolvers/EulerKernels.hpp"
 #include "RiemannSolvers/Central.hpp"
 
 namespace cf3 {
@@ -104,5 +105,26 @@ void Central::compute_interface_flux_and_wavespeeds(const RealVector& left, cons
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Central::compute_interface_fluxes(const Uint nb_faces, const Real* left, const Real* right, const Real* coords, const Real* normals,
+                                       Real* flux, Real* wave_speeds)
+{
+  switch(euler_kernel_dimension())
+  {
+  case 1:
+    EulerKernels<1>::central(nb_faces, euler_kernel_gamma(), left, right, normals, flux, wave_speeds);
+    break;
+  case 2:
+    EulerKernels<2>::central(nb_faces, euler_kernel_gamma(), left, right, normals, flux, wave_speeds);
+    break;
+  case 3:
+    EulerKernels<3>::central(nb_faces, euler_kernel_gamma(), left, right, normals, flux, wave_speeds);
+    break;
+  default:
+    RiemannSolver::compute_interface_fluxes(nb_faces, left, right, coords, normals, flux, wave_speeds);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // RiemannSolvers
 } // cf3
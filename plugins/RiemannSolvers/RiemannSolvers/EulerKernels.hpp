@@ -0,0 +1,342 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_RiemannSolvers_EulerKernels_hpp
+#define cf3_RiemannSolvers_EulerKernels_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/CF.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file EulerKernels.hpp Batched interface fluxes for the Euler equations in conservative variables
+
+  All functions work on a whole set of faces at once. Arrays are stored per component (structure of arrays),
+  so component i of face f is found at array[i*nb_faces + f]:
+    - left, right : NEQS x nb_faces conservative states (rho, rho*u_d, rho*E)
+    - normals     : NDIM x nb_faces unit normals, pointing from left to right
+    - flux        : NEQS x nb_faces interface fluxes
+    - wave_speeds : NEQS x nb_faces, ordered as the eigenvalues of physics::NavierStokes::Cons1D/2D/3D:
+                    NDIM times u.n, followed by u.n+a and u.n-a
+
+  The number of dimensions is a template parameter, so all loops over components have a fixed trip count
+  and are unrolled, leaving only the loop over the faces for the compiler to vectorize.
+**/
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace RiemannSolvers {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Coefficients of the AUSM+-up flux, see the options of AUSMplusUp
+struct AUSMplusUpCoefficients
+{
+  Real Ku;
+  Real Kp;
+  Real sigma;
+  Real machinf;
+  Real beta;
+};
+
+/// Pointwise Euler physics in conservative variables, for a fixed number of dimensions
+template<Uint NDIM>
+struct EulerKernels
+{
+  enum { NEQS = NDIM+2 };
+
+  /// Primitive quantities of a state
+  struct State
+  {
+    Real rho;
+    Real vel[NDIM];
+    Real p;
+    Real H;
+    Real a;
+    Real un;
+  };
+
+  /// Compute the primitive quantities from a conservative state, and the normal velocity for face f
+  static void primitives(const Real* U, const Real* normals, const Uint nb_faces, const Uint f, const Real gamma, State& s)
+  {
+    s.rho = U[0];
+    const Real inv_rho = 1. / s.rho;
+    Real q2 = 0.;
+    s.un = 0.;
+    for(Uint d = 0; d != NDIM; ++d)
+    {
+      s.vel[d] = U[d+1] * inv_rho;
+      q2 += s.vel[d]*s.vel[d];
+      s.un += s.vel[d]*normals[d*nb_faces + f];
+    }
+    s.p = (gamma-1.) * (U[NDIM+1] - 0.5*s.rho*q2);
+    s.H = (U[NDIM+1] + s.p) * inv_rho;
+    s.a = std::sqrt(gamma*s.p*inv_rho);
+  }
+
+  /// Load the state of face f from a SoA array, and compute the primitive quantities
+  static void load(const Real* U, const Real* normals, const Uint nb_faces, const Uint f, const Real gamma, State& s)
+  {
+    Real values[NEQS];
+    for(Uint i = 0; i != NEQS; ++i)
+      values[i] = U[i*nb_faces + f];
+    primitives(values, normals, nb_faces, f, gamma, s);
+  }
+
+  /// Physical flux projected on the normal
+  static void flux(const State& s, const Real* normals, const Uint nb_faces, const Uint f, Real* F)
+  {
+    const Real rhoun = s.rho*s.un;
+    F[0] = rhoun;
+    for(Uint d = 0; d != NDIM; ++d)
+      F[d+1] = rhoun*s.vel[d] + s.p*normals[d*nb_faces + f];
+    F[NDIM+1] = rhoun*s.H;
+  }
+
+  /// Eigenvalues of the flux jacobian projected on the normal
+  static void eigenvalues(const Real un, const Real a, Real* lambda)
+  {
+    for(Uint d = 0; d != NDIM; ++d)
+      lambda[d] = un;
+    lambda[NDIM]   = un + a;
+    lambda[NDIM+1] = un - a;
+  }
+
+  /// Store a NEQS vector for one face in a SoA array
+  static void store(const Real* values, const Uint nb_faces, const Uint f, Real* out)
+  {
+    for(Uint i = 0; i != NEQS; ++i)
+      out[i*nb_faces + f] = values[i];
+  }
+
+  /// Average of the normal fluxes. Wave speeds are the eigenvalues of the averaged state.
+  static void central(const Uint nb_faces, const Real gamma, const Real* left, const Real* right, const Real* normals,
+                      Real* flux_out, Real* wave_speeds)
+  {
+    for(Uint f = 0; f < nb_faces; ++f)
+    {
+      State sL, sR;
+      load(left, normals, nb_faces, f, gamma, sL);
+      load(right, normals, nb_faces, f, gamma, sR);
+
+      Real FL[NEQS], FR[NEQS], F[NEQS];
+      flux(sL, normals, nb_faces, f, FL);
+      flux(sR, normals, nb_faces, f, FR);
+      for(Uint i = 0; i != NEQS; ++i)
+        F[i] = 0.5*(FL[i] + FR[i]);
+      store(F, nb_faces, f, flux_out);
+
+      if(wave_speeds)
+      {
+        Real avg[NEQS];
+        for(Uint i = 0; i != NEQS; ++i)
+          avg[i] = 0.5*(left[i*nb_faces + f] + right[i*nb_faces + f]);
+        State s;
+        primitives(avg, normals, nb_faces, f, gamma, s);
+        Real lambda[NEQS];
+        eigenvalues(s.un, s.a, lambda);
+        store(lambda, nb_faces, f, wave_speeds);
+      }
+    }
+  }
+
+  /// Central flux with a dissipation per equation equal to the average of the absolute left and right eigenvalues,
+  /// as in LaxFriedrich::compute_interface_flux. Wave speeds are the average of the left and right eigenvalues.
+  static void laxfriedrich(const Uint nb_faces, const Real gamma, const Real* left, const Real* right, const Real* normals,
+                           Real* flux_out, Real* wave_speeds)
+  {
+    for(Uint f = 0; f < nb_faces; ++f)
+    {
+      State sL, sR;
+      load(left, normals, nb_faces, f, gamma, sL);
+      load(right, normals, nb_faces, f, gamma, sR);
+
+      Real FL[NEQS], FR[NEQS], lambdaL[NEQS], lambdaR[NEQS], F[NEQS];
+      flux(sL, normals, nb_faces, f, FL);
+      flux(sR, normals, nb_faces, f, FR);
+      eigenvalues(sL.un, sL.a, lambdaL);
+      eigenvalues(sR.un, sR.a, lambdaR);
+
+      for(Uint i = 0; i != NEQS; ++i)
+      {
+        const Real dissipation = 0.5*(std::abs(lambdaL[i]) + std::abs(lambdaR[i]));
+        F[i] = 0.5*(FL[i] + FR[i]) - dissipation*(right[i*nb_faces + f] - left[i*nb_faces + f]);
+      }
+      store(F, nb_faces, f, flux_out);
+
+      if(wave_speeds)
+      {
+        for(Uint i = 0; i != NEQS; ++i)
+          lambdaL[i] = 0.5*(lambdaL[i] + lambdaR[i]);
+        store(lambdaL, nb_faces, f, wave_speeds);
+      }
+    }
+  }
+
+  /// Roe flux. The dissipation |A|(UR-UL) is evaluated in closed form from the wave strengths
+  /// instead of assembling the eigenvector matrices. Wave speeds are the eigenvalues of the Roe-averaged state.
+  static void roe(const Uint nb_faces, const Real gamma, const Real* left, const Real* right, const Real* normals,
+                  Real* flux_out, Real* wave_speeds)
+  {
+    for(Uint f = 0; f < nb_faces; ++f)
+    {
+      State sL, sR;
+      load(left, normals, nb_faces, f, gamma, sL);
+      load(right, normals, nb_faces, f, gamma, sR);
+
+      Real FL[NEQS], FR[NEQS];
+      flux(sL, normals, nb_faces, f, FL);
+      flux(sR, normals, nb_faces, f, FR);
+
+      // Roe averages
+      const Real sqrt_rhoL = std::sqrt(sL.rho);
+      const Real sqrt_rhoR = std::sqrt(sR.rho);
+      const Real wL = sqrt_rhoL / (sqrt_rhoL + sqrt_rhoR);
+      const Real wR = 1. - wL;
+      const Real rho = sqrt_rhoL*sqrt_rhoR;
+      Real vel[NDIM], n[NDIM], dvel[NDIM];
+      Real q2 = 0., un = 0.;
+      for(Uint d = 0; d != NDIM; ++d)
+      {
+        n[d] = normals[d*nb_faces + f];
+        vel[d] = wL*sL.vel[d] + wR*sR.vel[d];
+        dvel[d] = sR.vel[d] - sL.vel[d];
+        q2 += vel[d]*vel[d];
+        un += vel[d]*n[d];
+      }
+      const Real H = wL*sL.H + wR*sR.H;
+      const Real a2 = (gamma-1.)*(H - 0.5*q2);
+      const Real a = std::sqrt(a2);
+
+      // Wave strengths
+      const Real drho = sR.rho - sL.rho;
+      const Real dp   = sR.p - sL.p;
+      const Real dun  = sR.un - sL.un;
+      const Real alpha_plus  = (dp + rho*a*dun) / (2.*a2);
+      const Real alpha_minus = (dp - rho*a*dun) / (2.*a2);
+      const Real alpha_entropy = drho - dp/a2;
+
+      const Real abs_un    = std::abs(un);
+      const Real abs_plus  = std::abs(un + a) * alpha_plus;
+      const Real abs_minus = std::abs(un - a) * alpha_minus;
+
+      // |A|(UR-UL): acoustic waves, entropy wave and shear waves
+      Real vel_dvel = 0.;
+      for(Uint d = 0; d != NDIM; ++d)
+        vel_dvel += vel[d]*dvel[d];
+
+      Real D[NEQS];
+      D[0] = abs_plus + abs_minus + abs_un*alpha_entropy;
+      for(Uint d = 0; d != NDIM; ++d)
+        D[d+1] = abs_plus*(vel[d] + a*n[d]) + abs_minus*(vel[d] - a*n[d])
+               + abs_un*(alpha_entropy*vel[d] + rho*(dvel[d] - dun*n[d]));
+      D[NDIM+1] = abs_plus*(H + a*un) + abs_minus*(H - a*un)
+                + abs_un*(alpha_entropy*0.5*q2 + rho*(vel_dvel - un*dun));
+
+      Real F[NEQS];
+      for(Uint i = 0; i != NEQS; ++i)
+        F[i] = 0.5*(FL[i] + FR[i]) - 0.5*D[i];
+      store(F, nb_faces, f, flux_out);
+
+      if(wave_speeds)
+      {
+        Real lambda[NEQS];
+        eigenvalues(un, a, lambda);
+        store(lambda, nb_faces, f, wave_speeds);
+      }
+    }
+  }
+
+  /// AUSM+-up flux of Liou (J. Comput. Phys. 214, 2006). Wave speeds are the eigenvalues of the averaged state,
+  /// using the interface speed of sound.
+  static void ausmplusup(const Uint nb_faces, const Real gamma, const AUSMplusUpCoefficients& c, const Real* left, const Real* right, const Real* normals,
+                         Real* flux_out, Real* wave_speeds)
+  {
+    for(Uint f = 0; f < nb_faces; ++f)
+    {
+      State sL, sR;
+      load(left, normals, nb_faces, f, gamma, sL);
+      load(right, normals, nb_faces, f, gamma, sR);
+
+      const Real a12 = 0.5*(sL.a + sR.a);
+      const Real ML = sL.un / a12;
+      const Real MR = sR.un / a12;
+      const Real Mbar2 = (sL.un*sL.un + sR.un*sR.un) / (2.*a12*a12);
+
+      // Scaling for low Mach numbers, bounded away from zero so flows at rest stay regular
+      const Real M02 = std::min(1., std::max(std::max(Mbar2, c.machinf*c.machinf), 1e-12));
+      const Real M0 = std::sqrt(M02);
+      const Real fa = M0*(2.-M0);
+      const Real alpha = 3./16.*(-4. + 5.*fa*fa);
+
+      const Real rho12 = 0.5*(sL.rho + sR.rho);
+
+      // Interface Mach number, with pressure diffusion
+      const Real M12 = M4(ML, 1., c.beta) + M4(MR, -1., c.beta)
+                     - c.Kp/fa * std::max(1. - c.sigma*Mbar2, 0.) * (sR.p - sL.p) / (rho12*a12*a12);
+
+      // Interface pressure, with velocity diffusion
+      const Real P5L = P5(ML, 1., alpha);
+      const Real P5R = P5(MR, -1., alpha);
+      const Real p12 = P5L*sL.p + P5R*sR.p - c.Ku*P5L*P5R*(sL.rho + sR.rho)*(fa*a12)*(sR.un - sL.un);
+
+      // Upwinded convective flux
+      const Real mdot = a12*M12*(M12 > 0. ? sL.rho : sR.rho);
+      const State& up = M12 > 0. ? sL : sR;
+
+      Real F[NEQS];
+      F[0] = mdot;
+      for(Uint d = 0; d != NDIM; ++d)
+        F[d+1] = mdot*up.vel[d] + p12*normals[d*nb_faces + f];
+      F[NDIM+1] = mdot*up.H;
+      store(F, nb_faces, f, flux_out);
+
+      if(wave_speeds)
+      {
+        Real lambda[NEQS];
+        eigenvalues(0.5*(sL.un + sR.un), a12, lambda);
+        store(lambda, nb_faces, f, wave_speeds);
+      }
+    }
+  }
+
+private:
+
+  /// Fourth order split Mach number, sign is +1 or -1
+  static Real M4(const Real M, const Real sign, const Real beta)
+  {
+    if(std::abs(M) >= 1.)
+      return 0.5*(M + sign*std::abs(M));
+    const Real M2 = sign*0.25*(M + sign)*(M + sign);
+    const Real M2_opposite = -sign*0.25*(M - sign)*(M - sign);
+    return M2*(1. - sign*16.*beta*M2_opposite);
+  }
+
+  /// Fifth order split pressure function, sign is +1 or -1
+  static Real P5(const Real M, const Real sign, const Real alpha)
+  {
+    if(std::abs(M) >= 1.)
+      return 0.5*(M + sign*std::abs(M)) / M;
+    const Real M2 = sign*0.25*(M + sign)*(M + sign);
+    const Real M2_opposite = -sign*0.25*(M - sign)*(M - sign);
+    return M2*((sign*2. - M) - sign*16.*alpha*M*M2_opposite);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RiemannSolvers
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_RiemannSolvers_EulerKernels_hpp
@@ -7,6 +7,7 @@
 #include "common/OptionComponent.hpp"
 #include "common/OptionList.hpp"
 
+#include "RiemannSolvers/EulerKernels.hpp"
 #include "RiemannSolvers/LaxFriedrich.hpp"
 
 
@@ -97,7 +98,7 @@ void LaxFriedrich::compute_interface_flux(const RealVector& left, const RealVect
   absA += eigenvalues_right.cwiseAbs().asDiagonal();
   absA *= 0.5;
 
-  flux = 0.5*(f_left + f_right)-absA*(right-left);
+  flux = 0.5*(f_left + f_right)*normal - absA*(right-left);
 
 }
 
@@ -112,5 +113,26 @@ void LaxFriedrich::compute_interface_flux_and_wavespeeds(const RealVector& left,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void LaxFriedrich::compute_interface_fluxes(const Uint nb_faces, const Real* left, const Real* right, const Real* coords, const Real* normals,
+                                            Real* flux, Real* wave_speeds)
+{
+  switch(euler_kernel_dimension())
+  {
+  case 1:
+    EulerKernels<1>::laxfriedrich(nb_faces, euler_kernel_gamma(), left, right, normals, flux, wave_speeds);
+    break;
+  case 2:
+    EulerKernels<2>::laxfriedrich(nb_faces, euler_kernel_gamma(), left, right, normals, flux, wave_speeds);
+    break;
+  case 3:
+    EulerKernels<3>::laxfriedrich(nb_faces, euler_kernel_gamma(), left, right, normals, flux, wave_speeds);
+    break;
+  default:
+    RiemannSolver::compute_interface_fluxes(nb_faces, left, right, coords, normals, flux, wave_speeds);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // RiemannSolvers
 } // cf3
@@ -45,6 +45,9 @@ public:
   virtual void compute_interface_flux(const RealVector& left, const RealVector& right, const RealVector& coords, const RealVector& normal,
                                       RealVector& flux);
 
+  virtual void compute_interface_fluxes(const Uint nb_faces, const Real* left, const Real* right, const Real* coords, const Real* normals,
+                                        Real* flux, Real* wave_speeds);
+
 private:
 
   void trigger_physical_model();
@@ -7,6 +7,9 @@
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
 
+#include "common/StringConversion.hpp"
+
+#include "physics/PhysModel.hpp"
 #include "physics/Variables.hpp"
 
 #include "RiemannSolvers/RiemannSolver.hpp"
@@ -43,5 +46,64 @@ RiemannSolver::~RiemannSolver()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void RiemannSolver::compute_interface_fluxes(const Uint nb_faces, const Real* left, const Real* right, const Real* coords, const Real* normals,
+                                             Real* flux, Real* wave_speeds)
+{
+  const Uint neqs = physical_model().neqs();
+  const Uint ndim = physical_model().ndim();
+  RealVector face_left(neqs), face_right(neqs), face_coords(ndim), face_normal(ndim);
+  RealVector face_flux(neqs), face_wave_speeds(neqs);
+  for(Uint f = 0; f != nb_faces; ++f)
+  {
+    for(Uint i = 0; i != neqs; ++i)
+    {
+      face_left[i]  = left[i*nb_faces + f];
+      face_right[i] = right[i*nb_faces + f];
+    }
+    for(Uint d = 0; d != ndim; ++d)
+    {
+      face_coords[d] = coords[d*nb_faces + f];
+      face_normal[d] = normals[d*nb_faces + f];
+    }
+
+    if(wave_speeds)
+    {
+      compute_interface_flux_and_wavespeeds(face_left, face_right, face_coords, face_normal, face_flux, face_wave_speeds);
+      for(Uint i = 0; i != neqs; ++i)
+        wave_speeds[i*nb_faces + f] = face_wave_speeds[i];
+    }
+    else
+    {
+      compute_interface_flux(face_left, face_right, face_coords, face_normal, face_flux);
+    }
+
+    for(Uint i = 0; i != neqs; ++i)
+      flux[i*nb_faces + f] = face_flux[i];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint RiemannSolver::euler_kernel_dimension() const
+{
+  if(is_null(m_physical_model) || is_null(m_solution_vars))
+    return 0;
+  if(physical_model().model_type() != "NavierStokes")
+    return 0;
+  const Uint ndim = physical_model().ndim();
+  if(solution_vars().type() != "Cons" + to_str(ndim) + "D")
+    return 0;
+  return ndim;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Real RiemannSolver::euler_kernel_gamma() const
+{
+  return physical_model().options().option("gamma").value<Real>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // RiemannSolvers
 } // cf3
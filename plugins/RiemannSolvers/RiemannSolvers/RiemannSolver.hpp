@@ -47,8 +47,22 @@ public: // functions
   virtual void compute_interface_flux(const RealVector& left, const RealVector& right, const RealVector& coords, const RealVector& normal,
                                       RealVector& flux) = 0;
 
+  /// Compute interface fluxes and wavespeeds for a set of faces at once.
+  /// All arrays are stored per component: component i of face f is at array[i*nb_faces + f] (see EulerKernels.hpp).
+  /// wave_speeds may be null if they are not needed.
+  /// The default implementation calls compute_interface_flux_and_wavespeeds for each face.
+  virtual void compute_interface_fluxes(const Uint nb_faces, const Real* left, const Real* right, const Real* coords, const Real* normals,
+                                        Real* flux, Real* wave_speeds);
+
 protected:
 
+  /// Number of dimensions if the physics are the Euler equations in conservative variables,
+  /// so the batched EulerKernels apply, or 0 otherwise
+  Uint euler_kernel_dimension() const;
+
+  /// Specific heat ratio to use in the EulerKernels
+  Real euler_kernel_gamma() const;
+
   physics::Variables& solution_vars() const { return *m_solution_vars; }
   physics::PhysModel& physical_model() const { return *m_physical_model; }
 
@@ -13,6 +13,7 @@
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
 
+#include "RiemannSolvers/EulerKernels.hpp"
 #include "RiemannSolvers/Roe.hpp"
 
 namespace cf3 {
@@ -146,5 +147,26 @@ void Roe::compute_interface_flux_and_wavespeeds(const RealVector& left, const Re
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Roe::compute_interface_fluxes(const Uint nb_faces, const Real* left, const Real* right, const Real* coords, const Real* normals,
+                                   Real* flux, Real* wave_speeds)
+{
+  switch(euler_kernel_dimension())
+  {
+  case 1:
+    EulerKernels<1>::roe(nb_faces, euler_kernel_gamma(), left, right, normals, flux, wave_speeds);
+    break;
+  case 2:
+    EulerKernels<2>::roe(nb_faces, euler_kernel_gamma(), left, right, normals, flux, wave_speeds);
+    break;
+  case 3:
+    EulerKernels<3>::roe(nb_faces, euler_kernel_gamma(), left, right, normals, flux, wave_speeds);
+    break;
+  default:
+    RiemannSolver::compute_interface_fluxes(nb_faces, left, right, coords, normals, flux, wave_speeds);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // RiemannSolvers
 } // cf3
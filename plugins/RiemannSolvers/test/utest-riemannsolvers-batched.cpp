@@ -0,0 +1,187 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the batched fluxes of cf3::RiemannSolvers"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Builder.hpp"
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/OptionList.hpp"
+
+#include "RiemannSolvers/RiemannSolver.hpp"
+#include "physics/PhysModel.hpp"
+#include "physics/Variables.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::RiemannSolvers;
+using namespace cf3::physics;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Compare the batched fluxes of a riemann solver with the face by face computation
+void check_batched_fluxes(RiemannSolver& riemann, PhysModel& physics)
+{
+  const Uint dim  = physics.ndim();
+  const Uint neqs = physics.neqs();
+  const Uint nb_faces = 13;
+  const Real g = 1.4;
+
+  std::vector<Real> left(neqs*nb_faces), right(neqs*nb_faces);
+  std::vector<Real> coords(dim*nb_faces, 0.), normals(dim*nb_faces);
+  for(Uint f = 0; f != nb_faces; ++f)
+  {
+    // Unit normals in all directions
+    const Real theta = 0.5*f;
+    const Real phi   = 0.3 + 0.2*f;
+    if(dim == 1)
+    {
+      normals[f] = f % 2 ? 1. : -1.;
+    }
+    else if(dim == 2)
+    {
+      normals[f] = std::cos(theta);
+      normals[nb_faces + f] = std::sin(theta);
+    }
+    else
+    {
+      normals[f] = std::cos(theta)*std::sin(phi);
+      normals[nb_faces + f] = std::sin(theta)*std::sin(phi);
+      normals[2*nb_faces + f] = std::cos(phi);
+    }
+
+    // Sub- and supersonic states
+    const Real r_L = 1.2 + 0.1*f;   const Real r_R = 0.9 + 0.05*f;
+    const Real p_L = 1e5*(1.+0.1*f); const Real p_R = 0.7e5;
+    Real q2_L = 0., q2_R = 0.;
+    for(Uint d = 0; d != dim; ++d)
+    {
+      const Real u_L = 40.*f - 100.*d;
+      const Real u_R = 30.*d - 10.*f;
+      left[(d+1)*nb_faces + f]  = r_L*u_L;
+      right[(d+1)*nb_faces + f] = r_R*u_R;
+      q2_L += u_L*u_L;
+      q2_R += u_R*u_R;
+    }
+    left[f]  = r_L;
+    right[f] = r_R;
+    left[(dim+1)*nb_faces + f]  = p_L/(g-1.) + 0.5*r_L*q2_L;
+    right[(dim+1)*nb_faces + f] = p_R/(g-1.) + 0.5*r_R*q2_R;
+  }
+
+  std::vector<Real> flux(neqs*nb_faces), wave_speeds(neqs*nb_faces);
+  std::vector<Real> ref_flux(neqs*nb_faces), ref_wave_speeds(neqs*nb_faces);
+  riemann.compute_interface_fluxes(nb_faces, &left[0], &right[0], &coords[0], &normals[0], &flux[0], &wave_speeds[0]);
+  riemann.RiemannSolver::compute_interface_fluxes(nb_faces, &left[0], &right[0], &coords[0], &normals[0], &ref_flux[0], &ref_wave_speeds[0]);
+
+  for(Uint i = 0; i != neqs*nb_faces; ++i)
+  {
+    BOOST_CHECK_SMALL(flux[i] - ref_flux[i], 1e-10*(1.+std::abs(ref_flux[i])));
+    BOOST_CHECK_SMALL(wave_speeds[i] - ref_wave_speeds[i], 1e-10*(1.+std::abs(ref_wave_speeds[i])));
+  }
+
+  // Fluxes only
+  std::vector<Real> flux_only(neqs*nb_faces);
+  riemann.compute_interface_fluxes(nb_faces, &left[0], &right[0], &coords[0], &normals[0], &flux_only[0], 0);
+  for(Uint i = 0; i != neqs*nb_faces; ++i)
+    BOOST_CHECK_EQUAL(flux_only[i], flux[i]);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( RiemannSolvers_Batched_Suite )
+
+BOOST_AUTO_TEST_CASE( NavierStokes2D_Roe )
+{
+  Component& model =  *Core::instance().root().create_component<Component>("model2D_Roe");
+
+  Handle<PhysModel> physics( model.create_component("navierstokes","cf3.physics.NavierStokes.NavierStokes2D") );
+  Handle<Variables> sol_vars( physics->create_variables("Cons2D","solution") );
+  Handle<Variables> roe_vars( physics->create_variables("Roe2D","roe") );
+
+  Handle<RiemannSolver> riemann( model.create_component("riemann","cf3.RiemannSolvers.Roe") );
+  riemann->options().configure_option("physical_model",physics);
+  riemann->options().configure_option("solution_vars",sol_vars);
+  riemann->options().configure_option("roe_vars",roe_vars);
+
+  check_batched_fluxes(*riemann, *physics);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( NavierStokes3D_Roe )
+{
+  Component& model =  *Core::instance().root().create_component<Component>("model3D_Roe");
+
+  Handle<PhysModel> physics( model.create_component("navierstokes","cf3.physics.NavierStokes.NavierStokes3D") );
+  Handle<Variables> sol_vars( physics->create_variables("Cons3D","solution") );
+  Handle<Variables> roe_vars( physics->create_variables("Roe3D","roe") );
+
+  Handle<RiemannSolver> riemann( model.create_component("riemann","cf3.RiemannSolvers.Roe") );
+  riemann->options().configure_option("physical_model",physics);
+  riemann->options().configure_option("solution_vars",sol_vars);
+  riemann->options().configure_option("roe_vars",roe_vars);
+
+  check_batched_fluxes(*riemann, *physics);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( NavierStokes2D_Central )
+{
+  Component& model =  *Core::instance().root().create_component<Component>("model2D_Central");
+
+  Handle<PhysModel> physics( model.create_component("navierstokes","cf3.physics.NavierStokes.NavierStokes2D") );
+  Handle<Variables> sol_vars( physics->create_variables("Cons2D","solution") );
+
+  Handle<RiemannSolver> riemann( model.create_component("riemann","cf3.RiemannSolvers.Central") );
+  riemann->options().configure_option("physical_model",physics);
+  riemann->options().configure_option("solution_vars",sol_vars);
+
+  check_batched_fluxes(*riemann, *physics);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( NavierStokes1D_LaxFriedrich )
+{
+  Component& model =  *Core::instance().root().create_component<Component>("model1D_LaxFriedrich");
+
+  Handle<PhysModel> physics( model.create_component("navierstokes","cf3.physics.NavierStokes.NavierStokes1D") );
+  Handle<Variables> sol_vars( physics->create_variables("Cons1D","solution") );
+
+  Handle<RiemannSolver> riemann( model.create_component("riemann","cf3.RiemannSolvers.LaxFriedrich") );
+  riemann->options().configure_option("physical_model",physics);
+  riemann->options().configure_option("solution_vars",sol_vars);
+
+  check_batched_fluxes(*riemann, *physics);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( NavierStokes2D_AUSMplusUp )
+{
+  Component& model =  *Core::instance().root().create_component<Component>("model2D_AUSMplusUp");
+
+  Handle<PhysModel> physics( model.create_component("navierstokes","cf3.physics.NavierStokes.NavierStokes2D") );
+  Handle<Variables> sol_vars( physics->create_variables("Cons2D","solution") );
+
+  Handle<RiemannSolver> riemann( model.create_component("riemann","cf3.RiemannSolvers.AUSMplusUp") );
+  riemann->options().configure_option("machinf", 0.1);
+  riemann->options().configure_option("physical_model",physics);
+  riemann->options().configure_option("solution_vars",sol_vars);
+
+  check_batched_fluxes(*riemann, *physics);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,179 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Benchmark of the UFEM heat conduction assembly and linear solve"
+
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+
+#define BOOST_PROTO_MAX_ARITY 10
+#ifdef BOOST_MPL_LIMIT_METAFUNCTION_ARITY
+ #undef BOOST_MPL_LIMIT_METAFUNCTION_ARITY
+ #define BOOST_MPL_LIMIT_METAFUNCTION_ARITY 10
+#endif
+
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+
+#include "math/LSS/System.hpp"
+
+#include "mesh/Domain.hpp"
+
+#include "mesh/LagrangeP1/Quad2D.hpp"
+#include "solver/Model.hpp"
+
+#include "solver/actions/SolveLSS.hpp"
+#include "solver/actions/Proto/ProtoAction.hpp"
+#include "solver/actions/Proto/Expression.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+#include "Tools/Testing/BenchmarkReport.hpp"
+
+#include "UFEM/LSSAction.hpp"
+#include "UFEM/Solver.hpp"
+#include "UFEM/Tags.hpp"
+
+using namespace cf3;
+using namespace cf3::solver;
+using namespace cf3::solver::actions;
+using namespace cf3::solver::actions::Proto;
+using namespace cf3::common;
+using namespace cf3::math::Consts;
+using namespace cf3::mesh;
+
+/// Arguments: LSS settings file, number of cells in x and y, number of timed calls and number of assembly threads
+struct HeatBenchmarkFixture
+{
+  HeatBenchmarkFixture() :
+    root( Core::instance().root() ),
+    m_argc(boost::unit_test::framework::master_test_suite().argc),
+    m_argv(boost::unit_test::framework::master_test_suite().argv)
+  {
+  }
+
+  Uint argument(const int i, const Uint default_value) const
+  {
+    return i < m_argc ? boost::lexical_cast<Uint>(m_argv[i]) : default_value;
+  }
+
+  Component& root;
+  int m_argc;
+  char** m_argv;
+};
+
+/// Solve from a zero initial guess, so each call does the same amount of iterations
+void solve(math::LSS::System& lss, common::Action& solve_lss)
+{
+  lss.solution()->reset(0.);
+  solve_lss.execute();
+}
+
+BOOST_FIXTURE_TEST_SUITE( HeatBenchmarkSuite, HeatBenchmarkFixture )
+
+BOOST_AUTO_TEST_CASE( InitMPI )
+{
+  common::PE::Comm::instance().init(m_argc, m_argv);
+}
+
+BOOST_AUTO_TEST_CASE( Heat2DBenchmark )
+{
+  BOOST_REQUIRE(m_argc > 1);
+  const std::string solver_config = m_argv[1];
+  const Uint x_segments = argument(2, 400u);
+  const Uint y_segments = argument(3, 400u);
+  const Uint nb_calls = argument(4, 10u);
+  const Uint nb_threads = argument(5, 1u);
+
+  const Real length = 5.;
+
+  // Setup a model
+  Model& model = *root.create_component<Model>("Model");
+  Domain& domain = model.create_domain("Domain");
+  UFEM::Solver& solver = *model.create_component<UFEM::Solver>("Solver");
+
+  Handle<UFEM::LSSAction> lss_action(solver.add_direct_solver("cf3.UFEM.LSSAction"));
+
+  MeshTerm<0, ScalarField> temperature("Temperature", UFEM::Tags::solution());
+  boost::mpl::vector1<mesh::LagrangeP1::Quad2D> allowed_elements;
+
+  boost::shared_ptr<UFEM::BoundaryConditions> bc = allocate_component<UFEM::BoundaryConditions>("BoundaryConditions");
+  boost::shared_ptr<ProtoAction> assembly = create_proto_action
+  (
+    "Assembly",
+    elements_expression
+    (
+      allowed_elements,
+      group
+      (
+        _A = _0,
+        element_quadrature( _A(temperature) += transpose(nabla(temperature)) * nabla(temperature) ),
+        lss_action->system_matrix += _A
+      )
+    )
+  );
+  boost::shared_ptr<SolveLSS> solve_lss = allocate_component<SolveLSS>("SolveLSS");
+
+  *lss_action
+    << assembly
+    << bc
+    << solve_lss
+    << create_proto_action("Increment", nodes_expression(temperature += lss_action->solution(temperature)));
+
+  model.create_physics("cf3.physics.DynamicModel");
+
+  // Setup mesh
+  Mesh& mesh = *domain.create_component<Mesh>("Mesh");
+  BlockMesh::BlockArrays& blocks = *domain.create_component<BlockMesh::BlockArrays>("blocks");
+
+  *blocks.create_points(2, 4) << 0. << 0. << length << 0. << length << length << 0. << length;
+  *blocks.create_blocks(1) << 0 << 1 << 2 << 3;
+  *blocks.create_block_subdivisions() << x_segments << y_segments;
+  *blocks.create_block_gradings() << 1. << 1. << 1. << 1.;
+
+  *blocks.create_patch("bottom", 1) << 0 << 1;
+  *blocks.create_patch("right", 1) << 1 << 2;
+  *blocks.create_patch("top", 1) << 2 << 3;
+  *blocks.create_patch("left", 1) << 3 << 0;
+
+  blocks.partition_blocks(PE::Comm::instance().size(), XX);
+  blocks.create_mesh(mesh);
+
+  math::LSS::System& lss = lss_action->create_lss("cf3.math.LSS.TrilinosFEVbrMatrix");
+  lss.matrix()->options().configure_option("settings_file", solver_config);
+
+  bc->add_constant_bc("left", "Temperature", 10.);
+  bc->add_constant_bc("right", "Temperature", 35.);
+
+  assembly->options().configure_option("nb_threads", nb_threads);
+
+  // Run once, so all lazily initialized data is built
+  model.simulate();
+
+  Tools::Testing::BenchmarkReport report("ufem-heat");
+  report.add_parameter("nb_cells_x", x_segments);
+  report.add_parameter("nb_cells_y", y_segments);
+  report.add_parameter("nb_threads", nb_threads);
+
+  // Solve first, since repeated assembly keeps adding to the system matrix
+  report.time("solve", boost::bind(&solve, boost::ref(lss), boost::ref(*solve_lss)), nb_calls);
+  report.time("assembly", boost::bind(&common::Action::execute, assembly.get()), nb_calls);
+
+  report.write();
+}
+
+BOOST_AUTO_TEST_CASE( FinalizeMPI )
+{
+  common::PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
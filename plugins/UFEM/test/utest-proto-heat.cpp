@@ -23,6 +23,7 @@
 #include "mesh/Domain.hpp"
 
 #include "mesh/LagrangeP1/Line1D.hpp"
+#include "mesh/LagrangeP1/Quad2D.hpp"
 #include "solver/Model.hpp"
 
 #include "solver/actions/SolveLSS.hpp"
@@ -151,6 +152,78 @@ BOOST_AUTO_TEST_CASE( Heat1DComponent )
   model.simulate();
 }
 
+/// Assembly using several threads must give the same system as the serial assembly
+BOOST_AUTO_TEST_CASE( ThreadedAssembly )
+{
+  Model& model = *root.create_component<Model>("ThreadedModel");
+  Domain& domain = model.create_domain("Domain");
+  UFEM::Solver& solver = *model.create_component<UFEM::Solver>("Solver");
+
+  Handle<UFEM::LSSAction> lss_action(solver.add_direct_solver("cf3.UFEM.LSSAction"));
+
+  MeshTerm<0, ScalarField> temperature("Temperature", UFEM::Tags::solution());
+
+  boost::mpl::vector1<mesh::LagrangeP1::Quad2D> allowed_elements;
+
+  *lss_action
+    << create_proto_action("Initialize", nodes_expression(temperature = coordinates(0,0)*coordinates(0,1) + 1.))
+    << create_proto_action
+    (
+      "Assembly",
+      elements_expression
+      (
+        allowed_elements,
+        group
+        (
+          _A = _0,
+          element_quadrature( _A(temperature) += transpose(nabla(temperature)) * nabla(temperature) + transpose(N(temperature)) * N(temperature) ),
+          lss_action->system_matrix += _A,
+          lss_action->system_rhs += -_A * _b
+        )
+      )
+    );
+
+  model.create_physics("cf3.UFEM.NavierStokesPhysics");
+
+  boost::shared_ptr<MeshGenerator> create_rectangle = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","create_rectangle");
+  create_rectangle->options().configure_option("mesh",domain.uri()/"Mesh");
+  create_rectangle->options().configure_option("lengths",std::vector<Real>(DIM_2D, 1.));
+  create_rectangle->options().configure_option("nb_cells",std::vector<Uint>(DIM_2D, 16u));
+  create_rectangle->generate();
+
+  math::LSS::System& lss = lss_action->create_lss("cf3.math.LSS.TrilinosFEVbrMatrix");
+  lss.matrix()->options().configure_option("settings_file", std::string(boost::unit_test::framework::master_test_suite().argv[1]));
+
+  // Serial assembly
+  model.simulate();
+
+  std::vector<Uint> serial_rows, serial_cols;
+  std::vector<Real> serial_matrix, serial_rhs;
+  lss.matrix()->debug_data(serial_rows, serial_cols, serial_matrix);
+  lss.rhs()->debug_data(serial_rhs);
+
+  // Threaded assembly into the same, cleared, system
+  lss.reset();
+  lss_action->get_child("Assembly")->options().configure_option("nb_threads", 4u);
+  lss_action->execute();
+
+  std::vector<Uint> threaded_rows, threaded_cols;
+  std::vector<Real> threaded_matrix, threaded_rhs;
+  lss.matrix()->debug_data(threaded_rows, threaded_cols, threaded_matrix);
+  lss.rhs()->debug_data(threaded_rhs);
+
+  // Elements are added in a different order, so values may differ by round-off
+  BOOST_REQUIRE_EQUAL(threaded_matrix.size(), serial_matrix.size());
+  BOOST_CHECK(threaded_rows == serial_rows);
+  BOOST_CHECK(threaded_cols == serial_cols);
+  for(Uint i = 0; i != serial_matrix.size(); ++i)
+    BOOST_CHECK_SMALL(threaded_matrix[i] - serial_matrix[i], 1e-12);
+
+  BOOST_REQUIRE_EQUAL(threaded_rhs.size(), serial_rhs.size());
+  for(Uint i = 0; i != serial_rhs.size(); ++i)
+    BOOST_CHECK_SMALL(threaded_rhs[i] - serial_rhs[i], 1e-12);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
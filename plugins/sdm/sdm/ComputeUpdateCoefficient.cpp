@@ -5,12 +5,16 @@
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
 #include "common/Builder.hpp"
+#include "common/Foreach.hpp"
 #include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
 #include "common/PE/Comm.hpp"
 
 #include "mesh/Field.hpp"
 #include "mesh/FieldManager.hpp"
 #include "mesh/Mesh.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
 
 #include "solver/Time.hpp"
 #include "solver/Model.hpp"
@@ -41,6 +45,8 @@ ComputeUpdateCoefficient::ComputeUpdateCoefficient ( const std::string& name ) :
   m_tolerance(1e-12)
 {
   mark_basic();
+
+  properties().add_property("nb_substeps", Uint(1));
   // options
   options().add_option("time_accurate", true)
     .description("Time Accurate")
@@ -54,6 +60,12 @@ ComputeUpdateCoefficient::ComputeUpdateCoefficient ( const std::string& name ) :
     .mark_basic()
     .add_tag("cfl");
 
+  options().add_option("nb_levels", 1u)
+    .description("Number of time step levels for multi-rate time stepping (only if time accurate).\n"
+                 "Elements get the largest time step min_dt*2^level (level < nb_levels) allowed by their CFL condition,\n"
+                 "and the time step becomes min_dt*2^(nb_levels-1). The update coefficient is then constant per element.")
+    .pretty_name("Number of Levels");
+
   options().add_option(sdm::Tags::update_coeff(), m_update_coeff)
     .description("Update coefficient to multiply with residual")
     .pretty_name("Update Coefficient")
@@ -114,27 +126,64 @@ void ComputeUpdateCoefficient::execute()
     PE::Comm::instance().all_reduce(PE::min(), &min_dt, 1, &glb_min_dt);
     dt = glb_min_dt;
 
-    /// - Make sure we reach milestones and final simulation time
+    /// - Multi-rate: the time step spans nb_substeps steps of the smallest element,
+    ///   as long as it does not pass the next milestone
     Real tf = limit_end_time(time.current_time(), time.options().option("end_time").value<Real>());
-    if( time.current_time() + dt + m_tolerance > tf )
-      dt = tf - time.current_time();
+    Uint nb_substeps = 1u << (std::max(options().option("nb_levels").value<Uint>(),1u)-1);
+    while ( nb_substeps > 1 && time.current_time() + nb_substeps*dt > tf + m_tolerance )
+      nb_substeps /= 2;
+
+    /// - Make sure we reach milestones and final simulation time
+    if( time.current_time() + nb_substeps*dt + m_tolerance > tf )
+      dt = (tf - time.current_time())/nb_substeps;
 
     /// Calculate the update_coefficient
     //  --------------------------------
     /// For Forward Euler: update_coefficient = @f$ \Delta t @f$.
     /// @f[ Q^{n+1} = Q^n + \Delta t \ R @f]
-    for (Uint i=0; i<update_coeff.size(); ++i)
+    if (nb_substeps == 1)
     {
-      update_coeff[i][0] = dt ;
+      for (Uint i=0; i<update_coeff.size(); ++i)
+      {
+        update_coeff[i][0] = dt ;
+      }
+    }
+    else
+    {
+      /// For multi-rate time stepping, every element gets the largest dt*2^level within its own CFL limit
+      boost_foreach(const Handle<Space>& space, update_coeff.spaces())
+      {
+        for (Uint elem=0; elem<space->size(); ++elem)
+        {
+          const Connectivity::ConstRow points = space->connectivity()[elem];
+          Real elem_dt = nb_substeps*dt;
+          boost_foreach(const Uint pt, points)
+          {
+            if (wave_speed[pt][0] > 0)
+              elem_dt = std::min(elem_dt, cfl/wave_speed[pt][0]);
+          }
+          Uint multiple = 1;
+          while (2*multiple <= nb_substeps && 2*multiple*dt <= elem_dt)
+            multiple *= 2;
+          boost_foreach(const Uint pt, points)
+          {
+            update_coeff[pt][0] = multiple*dt;
+          }
+        }
+      }
+      // Levels of ghost elements are needed by the owners of their neighbours
+      update_coeff.synchronize();
     }
 
     // Update the new time step
-    time.dt() = dt;
+    time.dt() = nb_substeps*dt;
+    properties().property("nb_substeps") = nb_substeps;
 
   }
   else // local time stepping
   {
     if (is_not_null(m_time))  m_time->dt() = 0.;
+    properties().property("nb_substeps") = Uint(1);
 
     // Calculate the update_coefficient = CFL/wave_speed
     RealVector ws(wave_speed.row_size());
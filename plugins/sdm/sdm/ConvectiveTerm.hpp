@@ -76,6 +76,21 @@ private: // functions
   /// @param [out] wave_speed    wave-speed in unit_normal direction
   virtual void compute_numerical_flux(PHYSDATA& left, PHYSDATA& right, const RealVectorNDIM& unit_normal, RealVectorNEQS& flux, Real& wave_speed) = 0;
 
+protected: // functions
+
+  /// @brief Compute numerical fluxes in all flux points of a face at once
+  ///
+  /// The default calls compute_numerical_flux for every point. Terms with a batched Riemann solver override this,
+  /// to evaluate all points of a face in one call. Arrays are stored per component, as in RiemannSolver::compute_interface_fluxes.
+  /// @param [in]  nb_pts        Number of flux points in the face
+  /// @param [in]  left          Physical data left of the interface, for every point
+  /// @param [in]  right         Physical data right of the interface, for every point
+  /// @param [in]  unit_normals  NDIM x nb_pts unit normals
+  /// @param [out] fluxes        NEQS x nb_pts computed fluxes, projected on the unit normals
+  /// @param [out] wave_speeds   wave-speed of every point in unit normal direction
+  virtual void compute_numerical_fluxes(const Uint nb_pts, std::vector<boost::shared_ptr< PHYSDATA > >& left, std::vector<boost::shared_ptr< PHYSDATA > >& right,
+                                        const Real* unit_normals, Real* fluxes, Real* wave_speeds);
+
 protected: // configuration
 
   /// @brief Initialize this term
@@ -90,6 +105,10 @@ protected: // configuration
   /// @brief Set caches for element with given index
   virtual void set_element(const Uint elem_idx);
 
+  /// @brief Reconstruct solution and coordinates in the flux points of all cells of the current Entities,
+  /// as one batch of the sum-factorized reconstruction. Does nothing if the shape function is not sum-factorized.
+  void reconstruct_cells();
+
   /// @brief Standard computation of solution and coordinates in flux point
   ///
   /// This function NEEDS to be overloaded for terms thar require more data to be set in phys_data
@@ -137,13 +156,31 @@ protected: // fast-access-data (for convenience no "m_" prefix)
   std::vector< RealVector1 >   flx_pt_wave_speed;               ///< Storage of wave speeds in flux points
   std::vector< std::vector<RealVector1> > sol_pt_wave_speed;   ///< Storage of wave speeds in solution points in every direction
 
+  // Solution and coordinates of this cell in all flux points, reconstructed at once
+  RealMatrix flx_pt_solution;                                   ///< Solution in flux points of this cell
+  RealMatrix flx_pt_coords;                                     ///< Coordinates of flux points of this cell
+  bool flx_pt_data_reconstructed;                               ///< True while flx_pt_solution and flx_pt_coords hold this cell
+
+  // Solution and coordinates in the flux points of all cells of the current Entities, see reconstruct_cells()
+  std::vector<Real> cells_sol_pt_values;                        ///< Gathered values in the solution points of all cells
+  std::vector<Real> cells_flx_pt_solution;                      ///< Solution per cell, per flux point, per variable
+  std::vector<Real> cells_flx_pt_coords;                        ///< Coordinates per cell, per flux point, per dimension
+  bool cells_reconstructed;                                     ///< True if the two above hold the current Entities
+
+  // Face flux points gathered for compute_numerical_fluxes
+  std::vector<Real> face_pt_unit_normals;                       ///< NDIM x nb face points unit normals
+  std::vector<Real> face_pt_fluxes;                             ///< NEQS x nb face points numerical fluxes
+  std::vector<Real> face_pt_wave_speeds;                        ///< Wave speed in every face point
+
 }; // end ConvectiveTerm
 
 ////////////////////////////////////////////////////////////////////////////////
 
 template <typename PHYSDATA>
 ConvectiveTerm<PHYSDATA>::ConvectiveTerm( const std::string& name )
-  : Term(name)
+  : Term(name),
+    flx_pt_data_reconstructed(false),
+    cells_reconstructed(false)
 {
   properties()["brief"] = std::string("Convective Spectral Difference term");
   properties()["description"] = std::string("Computes on a per cell basis the residual- and"
@@ -155,6 +192,26 @@ ConvectiveTerm<PHYSDATA>::ConvectiveTerm( const std::string& name )
 template <typename PHYSDATA>
 void ConvectiveTerm<PHYSDATA>::execute()
 {
+  /// 0) Solution and coordinates in all flux points of this cell, from the batch of all cells if available
+  if (cells_reconstructed)
+  {
+    const Uint nb_flx_pts = elem->get().sf->nb_flx_pts();
+    for (Uint pt=0; pt<nb_flx_pts; ++pt)
+    {
+      for (Uint var=0; var<NEQS; ++var)
+        flx_pt_solution(pt,var) = cells_flx_pt_solution[(m_elem_idx*nb_flx_pts+pt)*NEQS+var];
+      for (Uint dim=0; dim<NDIM; ++dim)
+        flx_pt_coords(pt,dim) = cells_flx_pt_coords[(m_elem_idx*nb_flx_pts+pt)*NDIM+dim];
+    }
+  }
+  else
+  {
+    mesh::Field::View cell_solution = solution_field().view(elem->get().space->connectivity()[m_elem_idx]);
+    mesh::Field::View cell_coords   = solution_field().dict().coordinates().view(elem->get().space->connectivity()[m_elem_idx]);
+    elem->get().reconstruct_from_solution_space_to_flux_points(cell_solution,flx_pt_solution);
+    elem->get().reconstruct_from_solution_space_to_flux_points(cell_coords,flx_pt_coords);
+  }
+  flx_pt_data_reconstructed = true;
 
   /// 1) Calculate flux in interior flux points
   boost_foreach(flx_pt, elem->get().sf->interior_flx_pts())
@@ -188,17 +245,29 @@ void ConvectiveTerm<PHYSDATA>::execute()
     /// * Case 2: face is inner-face or boundary-face --> compute numerical flux
     else
     {
-      for (Uint face_pt=0; face_pt<elem->get().sf->face_flx_pts(m_face_nb).size(); ++face_pt)
+      // all points of the face at once
+      const Uint nb_face_pts = elem->get().sf->face_flx_pts(m_face_nb).size();
+      for (Uint face_pt=0; face_pt<nb_face_pts; ++face_pt)
       {
         flx_pt = left_face_pt_idx[face_pt];
-        compute_numerical_flux(*left_face_data[face_pt],*right_face_data[face_pt],flx_pt_plane_jacobian_normal->get().plane_unit_normal[flx_pt] * elem->get().sf->flx_pt_sign(flx_pt),
-                               flx_pt_flux[flx_pt],flx_pt_wave_speed[flx_pt][0]);
+        for (Uint d=0; d<NDIM; ++d)
+          face_pt_unit_normals[d*nb_face_pts+face_pt] = flx_pt_plane_jacobian_normal->get().plane_unit_normal[flx_pt][d] * elem->get().sf->flx_pt_sign(flx_pt);
+      }
+      compute_numerical_fluxes(nb_face_pts,left_face_data,right_face_data,
+                               &face_pt_unit_normals[0],&face_pt_fluxes[0],&face_pt_wave_speeds[0]);
+      for (Uint face_pt=0; face_pt<nb_face_pts; ++face_pt)
+      {
+        flx_pt = left_face_pt_idx[face_pt];
+        for (Uint v=0; v<NEQS; ++v)
+          flx_pt_flux[flx_pt][v] = face_pt_fluxes[v*nb_face_pts+face_pt];
+        flx_pt_wave_speed[flx_pt][0] = face_pt_wave_speeds[face_pt];
         flx_pt_flux[flx_pt] *= elem->get().sf->flx_pt_sign(flx_pt) * flx_pt_plane_jacobian_normal->get().plane_jacobian[flx_pt];
         flx_pt_wave_speed[flx_pt] *= flx_pt_plane_jacobian_normal->get().plane_jacobian[flx_pt];
       }
     }
     neighbour_elem->get().unlock();
   }
+  flx_pt_data_reconstructed = false;
 
 
   /// 3) Compute flux divergence in solution points and store in this term's field
@@ -287,6 +356,27 @@ void ConvectiveTerm<PHYSDATA>::allocate_flx_pt_data()
     left_face_data[face_pt] = boost::shared_ptr< PHYSDATA >( new PHYSDATA );
     right_face_data[face_pt] = boost::shared_ptr< PHYSDATA >( new PHYSDATA );
   }
+  face_pt_unit_normals.resize(NDIM*left_face_data.size());
+  face_pt_fluxes.resize(NEQS*left_face_data.size());
+  face_pt_wave_speeds.resize(left_face_data.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename PHYSDATA>
+void ConvectiveTerm<PHYSDATA>::compute_numerical_fluxes(const Uint nb_pts, std::vector<boost::shared_ptr< PHYSDATA > >& left, std::vector<boost::shared_ptr< PHYSDATA > >& right,
+                                                        const Real* unit_normals, Real* fluxes, Real* wave_speeds)
+{
+  RealVectorNDIM unit_normal;
+  RealVectorNEQS flux;
+  for (Uint pt=0; pt<nb_pts; ++pt)
+  {
+    for (Uint d=0; d<NDIM; ++d)
+      unit_normal[d] = unit_normals[d*nb_pts+pt];
+    compute_numerical_flux(*left[pt],*right[pt],unit_normal,flux,wave_speeds[pt]);
+    for (Uint v=0; v<NEQS; ++v)
+      fluxes[v*nb_pts+pt] = flux[v];
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -302,8 +392,48 @@ void ConvectiveTerm<PHYSDATA>::set_entities(const mesh::Entities& entities)
   sol_pt_wave_speed.resize(NDIM,std::vector< RealVector1 >(elem->get().sf->nb_sol_pts()));
   flx_pt_wave_speed.resize(elem->get().sf->nb_flx_pts());
   flx_pt_flux.resize(elem->get().sf->nb_flx_pts());
+  flx_pt_solution.resize(elem->get().sf->nb_flx_pts(),NEQS);
+  flx_pt_coords.resize(elem->get().sf->nb_flx_pts(),NDIM);
 
   allocate_flx_pt_data();
+  reconstruct_cells();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename PHYSDATA>
+void ConvectiveTerm<PHYSDATA>::reconstruct_cells()
+{
+  cells_reconstructed = false;
+  const SumFactorization* sum_factorization = elem->get().reconstruct_from_solution_space_to_flux_points.sum_factorization();
+  if (sum_factorization == NULL)
+    return;
+
+  // The whole Entities is one batch. Cells that are not computed (ghosts, or inactive in DomainDiscretization)
+  // are reconstructed too, as neighbours use them and the batch is cheaper than reconstructing them one by one.
+  const mesh::Connectivity& connectivity = elem->get().space->connectivity();
+  const mesh::Field& coordinates = solution_field().dict().coordinates();
+  const Uint nb_elems = m_entities->size();
+  const Uint nb_sol_pts = sum_factorization->nb_sol_pts();
+  const Uint nb_flx_pts = sum_factorization->nb_flx_pts();
+
+  cells_sol_pt_values.resize(nb_elems*nb_sol_pts*NEQS);
+  for (Uint e=0; e<nb_elems; ++e)
+    for (Uint pt=0; pt<nb_sol_pts; ++pt)
+      for (Uint var=0; var<NEQS; ++var)
+        cells_sol_pt_values[(e*nb_sol_pts+pt)*NEQS+var] = solution_field()[connectivity[e][pt]][var];
+  cells_flx_pt_solution.resize(nb_elems*nb_flx_pts*NEQS);
+  sum_factorization->interpolate(nb_elems,NEQS,&cells_sol_pt_values[0],&cells_flx_pt_solution[0]);
+
+  cells_sol_pt_values.resize(nb_elems*nb_sol_pts*NDIM);
+  for (Uint e=0; e<nb_elems; ++e)
+    for (Uint pt=0; pt<nb_sol_pts; ++pt)
+      for (Uint dim=0; dim<NDIM; ++dim)
+        cells_sol_pt_values[(e*nb_sol_pts+pt)*NDIM+dim] = coordinates[connectivity[e][pt]][dim];
+  cells_flx_pt_coords.resize(nb_elems*nb_flx_pts*NDIM);
+  sum_factorization->interpolate(nb_elems,NDIM,&cells_sol_pt_values[0],&cells_flx_pt_coords[0]);
+
+  cells_reconstructed = nb_elems > 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -321,6 +451,23 @@ void ConvectiveTerm<PHYSDATA>::set_element(const Uint elem_idx)
 template <typename PHYSDATA>
 void ConvectiveTerm<PHYSDATA>::compute_flx_pt_phys_data(const SFDElement& elem, const Uint flx_pt, PHYSDATA& phys_data )
 {
+  if (flx_pt_data_reconstructed && &elem == &this->elem->get())
+  {
+    for (Uint var=0; var<NEQS; ++var)
+      phys_data.solution[var] = flx_pt_solution(flx_pt,var);
+    for (Uint dim=0; dim<NDIM; ++dim)
+      phys_data.coord[dim] = flx_pt_coords(flx_pt,dim);
+    return;
+  }
+  if (cells_reconstructed && elem.space == this->elem->get().space)
+  {
+    const Uint idx = elem.idx*elem.sf->nb_flx_pts()+flx_pt;
+    for (Uint var=0; var<NEQS; ++var)
+      phys_data.solution[var] = cells_flx_pt_solution[idx*NEQS+var];
+    for (Uint dim=0; dim<NDIM; ++dim)
+      phys_data.coord[dim] = cells_flx_pt_coords[idx*NDIM+dim];
+    return;
+  }
   mesh::Field::View sol_pt_solution = solution_field().view(elem.space->connectivity()[elem.idx]);
   mesh::Field::View sol_pt_coords   = solution_field().dict().coordinates().view(elem.space->connectivity()[elem.idx]);
   elem.reconstruct_from_solution_space_to_flux_points[flx_pt](sol_pt_solution,phys_data.solution);
@@ -82,13 +82,15 @@ void DomainDiscretization::execute()
     {
       boost_foreach( const Cells& cells, find_components_recursively<Cells>(*region) )
       {
+        const std::map< Handle<Entities const>, std::vector<bool> >::const_iterator active_it = m_active_elements.find(cells.handle<Entities>());
+        const std::vector<bool>* active = active_it != m_active_elements.end() ? &active_it->second : 0;
         boost_foreach( const Handle<Term>& term, terms)
         {
           term->set_entities(cells);
           CFdebug << "DomainDiscretization: executing " << term->name() << " for cells " << cells.uri() << CFendl;
           for (Uint elem_idx=0; elem_idx<cells.size(); ++elem_idx)
           {
-            if (cells.is_ghost(elem_idx)==false)
+            if (cells.is_ghost(elem_idx)==false && (is_null(active) || (*active)[elem_idx]))
             {
               term->set_element(elem_idx);
               term->execute();
@@ -42,6 +42,10 @@ public: // functions
                      const std::string& name,
                      const std::vector<common::URI>& regions = std::vector<common::URI>() );
 
+  /// Elements to compute the residual for, per set of cells. Cells without an entry are computed entirely.
+  /// Used by time integrators that only advance part of the elements at a time (see MultiRateTimeStepping).
+  std::map< Handle<mesh::Entities const>, std::vector<bool> >& active_elements() { return m_active_elements; }
+
   /// @name SIGNALS
   //@{
 
@@ -57,6 +61,8 @@ private:
   Handle< common::ActionDirector > m_terms;   ///< set of terms
   std::map< Handle<mesh::Region const> , std::vector< Handle<Term> > > m_terms_per_region;
 
+  std::map< Handle<mesh::Entities const>, std::vector<bool> > m_active_elements;
+
 };
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,578 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cmath>
+
+#include <boost/assign/list_of.hpp>
+
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/ActionDirector.hpp"
+#include "common/Link.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/CommPattern.hpp"
+
+#include "math/Consts.hpp"
+#include "math/VariablesDescriptor.hpp"
+#include "math/LSS/System.hpp"
+#include "math/LSS/Vector.hpp"
+#include "math/LSS/BlockAccumulator.hpp"
+#include "math/LSS/Native/NativeDetail.hpp"
+
+#include "solver/Time.hpp"
+#include "solver/Solver.hpp"
+
+#include "mesh/Cells.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/FieldManager.hpp"
+#include "mesh/Functions.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+
+#include "sdm/ImplicitNewtonKrylov.hpp"
+#include "sdm/DomainDiscretization.hpp"
+#include "sdm/Tags.hpp"
+#include "sdm/SDSolver.hpp"
+
+using namespace cf3::common;
+using namespace cf3::solver;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace sdm {
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < ImplicitNewtonKrylov, common::Action, LibSDM > ImplicitNewtonKrylov_Builder;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+/// Operations of the Newton correction system for the Krylov solver
+class NewtonKrylovOperator : public math::LSS::NativeOperator
+{
+public:
+  NewtonKrylovOperator(ImplicitNewtonKrylov& solver) : m_solver(solver) {}
+  virtual Uint size() const { return m_solver.m_state.size(); }
+  virtual void apply(const Real* x, Real* y) { m_solver.jacobian_product(x,y); }
+  virtual void precondition(const Real* r, Real* z) { m_solver.precondition(r,z); }
+  virtual Real dot(const Real* a, const Real* b) { return m_solver.dot(a,b); }
+private:
+  ImplicitNewtonKrylov& m_solver;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+ImplicitNewtonKrylov::ImplicitNewtonKrylov ( const std::string& name ) :
+  IterativeSolver(name),
+  m_alpha0(1.),
+  m_previous_dt(0.),
+  m_nb_steps(0)
+{
+  mark_basic();
+
+  const std::vector<boost::any> schemes = boost::assign::list_of
+    (boost::any(std::string("BackwardEuler")))
+    (boost::any(std::string("BDF2")));
+
+  const std::vector<boost::any> preconditioners = boost::assign::list_of
+    (boost::any(std::string("None")))
+    (boost::any(std::string("BlockJacobi")));
+
+  options().add_option("scheme", std::string("BackwardEuler"))
+      .description("Implicit time discretization. BDF2 is only used for time-accurate runs.")
+      .pretty_name("Scheme")
+      .mark_basic()
+      .restricted_list() = schemes;
+
+  options().add_option("max_newton_iterations", 1u)
+      .description("Maximum number of Newton iterations per time step.\n"
+                   "One iteration per step is enough for steady runs, time-accurate runs need more to converge each step.")
+      .pretty_name("Max Newton Iterations")
+      .mark_basic();
+
+  options().add_option("newton_tolerance", 1e-6)
+      .description("Reduction of the norm of the nonlinear residual at which the Newton iterations stop")
+      .pretty_name("Newton Tolerance");
+
+  options().add_option("krylov_tolerance", 1e-3)
+      .description("Reduction of the norm of the linear residual at which GMRES stops")
+      .pretty_name("Krylov Tolerance");
+
+  options().add_option("max_krylov_iterations", 100u)
+      .description("Maximum number of GMRES iterations per Newton iteration")
+      .pretty_name("Max Krylov Iterations");
+
+  options().add_option("gmres_restart", 30u)
+      .description("Number of GMRES iterations between restarts")
+      .pretty_name("GMRES Restart");
+
+  options().add_option("fd_epsilon", 1e-7)
+      .description("Relative perturbation of the finite difference Jacobian approximations")
+      .pretty_name("Finite Difference Epsilon");
+
+  options().add_option("preconditioner", std::string("BlockJacobi"))
+      .description("Preconditioner of the Krylov solver. BlockJacobi uses the Jacobians of each element with respect to its own solution.")
+      .pretty_name("Preconditioner")
+      .restricted_list() = preconditioners;
+
+  options().add_option("preconditioner_update_frequency", 1u)
+      .description("Number of time steps between recomputations of the preconditioner")
+      .pretty_name("Preconditioner Update Frequency");
+
+  options().add_option("matrix_builder", std::string("cf3.math.LSS.NativeMatrix"))
+      .description("Matrix builder of the linear system that stores and applies the preconditioner")
+      .pretty_name("Matrix Builder");
+
+  properties().add_property("newton_iterations", Uint(0));
+  properties().add_property("krylov_iterations", Uint(0));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ImplicitNewtonKrylov::link_field(Handle<Field>& field, const std::string& name, const std::string& prefix)
+{
+  if ( is_not_null(field) )
+    return;
+
+  if (Handle< Component > found_field = solver().field_manager().get_child( name ))
+  {
+    field = Handle<Field>( follow_link(found_field) );
+  }
+  else if ( Handle< Component > found_field = m_solution->dict().get_child( name ) )
+  {
+    solver().field_manager().create_component<Link>(name)->link_to(*found_field);
+    field = found_field->handle<Field>();
+  }
+  else
+  {
+    field = m_solution->dict().create_field(name, m_solution->descriptor().description()).handle<Field>();
+    field->descriptor().prefix_variable_names(prefix);
+    solver().field_manager().create_component<Link>(name)->link_to(*field);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ImplicitNewtonKrylov::link_fields()
+{
+  IterativeSolver::link_fields();
+
+  link_field(m_solution_previous,  "solution_previous",  "previous_");
+  if (options().option("scheme").value<std::string>() == "BDF2")
+    link_field(m_solution_previous2, "solution_previous2", "previous2_");
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ImplicitNewtonKrylov::setup()
+{
+  Field& U = *m_solution;
+  Dictionary& dict = U.dict();
+
+  m_points.clear();
+  std::vector< std::vector<Uint> > point_connectivity(dict.size());
+  boost_foreach(const Handle<Entities>& entities, U.entities_range())
+  {
+    if ( is_null(entities->handle<Cells>()) )
+      continue;
+    const Connectivity& connectivity = U.space(*entities).connectivity();
+    for (Uint elem=0; elem<entities->size(); ++elem)
+    {
+      boost_foreach(const Uint pt, connectivity[elem])
+      {
+        point_connectivity[pt].assign(connectivity[elem].begin(), connectivity[elem].end());
+        if (!entities->is_ghost(elem))
+          m_points.push_back(pt);
+      }
+    }
+  }
+
+  m_state.resize(m_points.size()*U.row_size());
+  m_state_residual.resize(m_state.size());
+
+  if (options().option("preconditioner").value<std::string>() == "None")
+    return;
+
+  if (is_null(m_lss))
+  {
+    m_lss = create_component<math::LSS::System>("LSS");
+    m_lss->options().configure_option("matrix_builder", options().option("matrix_builder").value<std::string>());
+  }
+  if (!m_lss->is_created())
+  {
+    // Every solution point is coupled to the solution points of its element
+    std::vector<Uint> node_connectivity, starting_indices(1,0);
+    starting_indices.reserve(dict.size()+1);
+    for (Uint pt=0; pt<dict.size(); ++pt)
+    {
+      node_connectivity.insert(node_connectivity.end(), point_connectivity[pt].begin(), point_connectivity[pt].end());
+      starting_indices.push_back(node_connectivity.size());
+    }
+    m_lss->create(dict.comm_pattern(), U.row_size(), node_connectivity, starting_indices);
+
+    // The preconditioner of the matrix is computed once per assembly, see assemble_preconditioner().
+    // The native matrix then only applies it in precondition(): ILU0 is exact for the element blocks.
+    math::LSS::Matrix& matrix = *m_lss->matrix();
+    matrix.options().configure_option("solver_reuse", std::string("interval"));
+    matrix.options().configure_option("rebuild_interval", math::Consts::uint_max());
+    if (matrix.solvertype() == "Native")
+    {
+      matrix.options().configure_option("solver", std::string("None"));
+      matrix.options().configure_option("preconditioner", std::string("ILU0"));
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ImplicitNewtonKrylov::compute_residual(const bool synchronize)
+{
+  post_update().execute();
+  if (synchronize)
+    m_solution->synchronize();
+  pre_update().execute();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ImplicitNewtonKrylov::assemble_preconditioner()
+{
+  Field& U = *m_solution;
+  Field& R = *m_residual;
+  const Field& H = *m_update_coeff;
+  const Uint nb_vars = U.row_size();
+  const Real fd_epsilon = options().option("fd_epsilon").value<Real>();
+
+  DomainDiscretization& domain_discretization = solver().handle<SDSolver>()->domain_discretization();
+  math::LSS::System& lss = *m_lss;
+  lss.reset();
+
+  // The residual of the unperturbed solution, in all points
+  const std::vector<Real> residual(R.array().data(), R.array().data()+R.size()*nb_vars);
+
+  // Points that are not in a cell (e.g. the boundary face points) get an identity block
+  std::vector<bool> in_cell(U.size(), false);
+  boost_foreach(const Handle<Entities>& entities, U.entities_range())
+  {
+    if ( is_null(entities->handle<Cells>()) )
+      continue;
+    const Connectivity& connectivity = U.space(*entities).connectivity();
+    for (Uint elem=0; elem<entities->size(); ++elem)
+      boost_foreach(const Uint pt, connectivity[elem])
+        in_cell[pt] = true;
+  }
+  math::LSS::BlockAccumulator identity;
+  identity.resize(1, nb_vars);
+  identity.reset(0.);
+  identity.mat.diagonal().setOnes();
+  for (Uint pt=0; pt<U.size(); ++pt)
+  {
+    if (in_cell[pt])
+      continue;
+    identity.indices[0] = pt;
+    lss.set_values(identity);
+  }
+
+  boost_foreach(const Handle<Entities>& entities, U.entities_range())
+  {
+    if ( is_null(entities->handle<Cells>()) )
+      continue;
+    const Connectivity& connectivity = U.space(*entities).connectivity();
+    const Uint nb_pts = connectivity.row_size();
+    const Uint block_size = nb_pts*nb_vars;
+
+    std::vector< std::vector<Uint> > colors;
+    build_element_colors(entities->geometry_space().connectivity(), entities->geometry_fields().size(), colors);
+
+    math::LSS::BlockAccumulator block;
+    block.resize(nb_pts, nb_vars);
+    boost_foreach(const std::vector<Uint>& color, colors)
+    {
+      // Only the elements of this color compute their residual
+      domain_discretization.active_elements().clear();
+      boost_foreach(const Handle<Entities>& other, U.entities_range())
+      {
+        if ( is_not_null(other->handle<Cells>()) )
+          domain_discretization.active_elements()[other].assign(other->size(), false);
+      }
+      std::vector<bool>& active = domain_discretization.active_elements()[entities];
+      std::vector<Uint> elems;
+      boost_foreach(const Uint elem, color)
+      {
+        if (entities->is_ghost(elem))
+          continue;
+        active[elem] = true;
+        elems.push_back(elem);
+      }
+      if (elems.empty())
+        continue;
+
+      std::vector<RealMatrix> jacobians(elems.size(), RealMatrix(block_size, block_size));
+      std::vector<Real> perturbation(elems.size());
+      for (Uint col_pt=0; col_pt<nb_pts; ++col_pt)
+      {
+        for (Uint col_var=0; col_var<nb_vars; ++col_var)
+        {
+          // Perturb one variable in one point of every element of the color
+          for (Uint e=0; e<elems.size(); ++e)
+          {
+            Real& u = U[connectivity[elems[e]][col_pt]][col_var];
+            perturbation[e] = fd_epsilon*(1.+std::abs(u));
+            u += perturbation[e];
+          }
+
+          // Ghost points are not perturbed, no need to synchronize
+          compute_residual(false);
+
+          const Uint col = col_pt*nb_vars+col_var;
+          for (Uint e=0; e<elems.size(); ++e)
+          {
+            for (Uint row_pt=0; row_pt<nb_pts; ++row_pt)
+            {
+              const Uint pt = connectivity[elems[e]][row_pt];
+              for (Uint row_var=0; row_var<nb_vars; ++row_var)
+                jacobians[e](row_pt*nb_vars+row_var, col) = -( R[pt][row_var] - residual[pt*nb_vars+row_var] ) / perturbation[e];
+            }
+            U[connectivity[elems[e]][col_pt]][col_var] -= perturbation[e];
+          }
+        }
+      }
+
+      // Add the time derivative and store the blocks
+      for (Uint e=0; e<elems.size(); ++e)
+      {
+        block.neighbour_indices(connectivity[elems[e]]);
+        for (Uint row_pt=0; row_pt<nb_pts; ++row_pt)
+        {
+          const Real diagonal = m_alpha0/H[connectivity[elems[e]][row_pt]][0];
+          for (Uint row_var=0; row_var<nb_vars; ++row_var)
+            jacobians[e](row_pt*nb_vars+row_var, row_pt*nb_vars+row_var) += diagonal;
+        }
+        block.mat = jacobians[e];
+        lss.set_values(block);
+      }
+    }
+  }
+
+  // Restore the state at which the Jacobian was evaluated
+  domain_discretization.active_elements().clear();
+  std::copy(residual.begin(), residual.end(), R.array().data());
+
+  // Factor the new blocks at the next solve only, and keep the factorization until the next assembly
+  lss.matrix()->request_recompute();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ImplicitNewtonKrylov::jacobian_product(const Real* x, Real* y)
+{
+  Field& U = *m_solution;
+  const Field& R = *m_residual;
+  const Field& H = *m_update_coeff;
+  const Uint nb_vars = U.row_size();
+
+  const Real x_norm = std::sqrt(dot(x,x));
+  if (x_norm == 0.)
+  {
+    std::fill(y, y+m_state.size(), 0.);
+    return;
+  }
+  const Real state_norm = std::sqrt(dot(&m_state[0],&m_state[0]));
+  const Real eps = options().option("fd_epsilon").value<Real>()*(1.+state_norm)/x_norm;
+
+  for (Uint i=0; i<m_points.size(); ++i)
+    for (Uint var=0; var<nb_vars; ++var)
+      U[m_points[i]][var] = m_state[i*nb_vars+var] + eps*x[i*nb_vars+var];
+
+  compute_residual(true);
+
+  for (Uint i=0; i<m_points.size(); ++i)
+  {
+    const Uint pt = m_points[i];
+    for (Uint var=0; var<nb_vars; ++var)
+    {
+      const Uint k = i*nb_vars+var;
+      y[k] = m_alpha0/H[pt][0]*x[k] - ( R[pt][var] - m_state_residual[k] ) / eps;
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ImplicitNewtonKrylov::precondition(const Real* r, Real* z)
+{
+  if (is_null(m_lss))
+  {
+    std::copy(r, r+m_state.size(), z);
+    return;
+  }
+
+  const Uint nb_vars = m_solution->row_size();
+  math::LSS::Vector& rhs = *m_lss->rhs();
+  math::LSS::Vector& solution = *m_lss->solution();
+  rhs.reset();
+  solution.reset();
+  for (Uint i=0; i<m_points.size(); ++i)
+    for (Uint var=0; var<nb_vars; ++var)
+      rhs.set_value(m_points[i], var, r[i*nb_vars+var]);
+
+  m_lss->solve();
+
+  for (Uint i=0; i<m_points.size(); ++i)
+    for (Uint var=0; var<nb_vars; ++var)
+      solution.get_value(m_points[i], var, z[i*nb_vars+var]);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+Real ImplicitNewtonKrylov::dot(const Real* a, const Real* b) const
+{
+  Real local = 0.;
+  for (Uint k=0; k<m_state.size(); ++k)
+    local += a[k]*b[k];
+  if (!PE::Comm::instance().is_active())
+    return local;
+  Real global = 0.;
+  PE::Comm::instance().all_reduce(PE::plus(), &local, 1, &global);
+  return global;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ImplicitNewtonKrylov::execute()
+{
+  configure_option_recursively( "iterator", handle<Component>() );
+
+  link_fields();
+  setup();
+
+  if (is_null(m_time))        throw SetupError(FromHere(), "Time was not set");
+  Time& time = *m_time;
+
+  Component& compute_update_coefficient = *solver().handle<SDSolver>()->actions().get_child("compute_update_coefficient");
+  const bool time_accurate = compute_update_coefficient.options().option("time_accurate").value<bool>();
+
+  const Uint max_newton_iterations = options().option("max_newton_iterations").value<Uint>();
+  const Real newton_tolerance = options().option("newton_tolerance").value<Real>();
+  const Real krylov_tolerance = options().option("krylov_tolerance").value<Real>();
+  const Uint max_krylov_iterations = options().option("max_krylov_iterations").value<Uint>();
+  const Uint gmres_restart = options().option("gmres_restart").value<Uint>();
+  const Uint update_frequency = std::max(options().option("preconditioner_update_frequency").value<Uint>(), 1u);
+
+  Field& U   = *m_solution;
+  Field& Un  = *m_solution_previous;
+  Field& R   = *m_residual;
+  Field& H   = *m_update_coeff;
+  const Uint nb_vars = U.row_size();
+
+  const Real T0 = time.current_time();
+
+  // Residual and wave speeds at the start of the step, then the time step
+  properties().property("iteration") = Uint(1);
+  pre_update().execute();
+  compute_update_coefficient.handle<common::Action>()->execute();
+  const Real dt = time.dt();
+
+  // Coefficients of the time discretization
+  Real alpha1 = -1.;
+  Real alpha2 = 0.;
+  m_alpha0 = 1.;
+  const bool bdf2 = time_accurate && is_not_null(m_solution_previous2) && m_previous_dt > 0.;
+  if (bdf2)
+  {
+    const Real omega = dt/m_previous_dt;
+    m_alpha0 = (1.+2.*omega)/(1.+omega);
+    alpha1 = -(1.+omega);
+    alpha2 = omega*omega/(1.+omega);
+    *m_solution_previous2 = Un;
+  }
+  Un = U;
+
+  if (time_accurate)
+    time.current_time() = T0 + dt;
+
+  NewtonKrylovOperator op(*this);
+  std::vector<Real> rhs(m_state.size());
+  std::vector<Real> correction(m_state.size());
+  Real initial_norm = 0.;
+  Uint krylov_iterations = 0;
+  Uint newton_iteration = 0;
+  for ( ; newton_iteration<max_newton_iterations; ++newton_iteration)
+  {
+    properties().property("iteration") = newton_iteration+1;
+
+    // The residual at t = T0 has been computed already for a steady first iteration
+    if (newton_iteration > 0 || time_accurate)
+      compute_residual(newton_iteration > 0);
+
+    // Nonlinear residual -G(U)
+    for (Uint i=0; i<m_points.size(); ++i)
+    {
+      const Uint pt = m_points[i];
+      for (Uint var=0; var<nb_vars; ++var)
+      {
+        const Uint k = i*nb_vars+var;
+        Real time_derivative = m_alpha0*U[pt][var] + alpha1*Un[pt][var];
+        if (bdf2)
+          time_derivative += alpha2*(*m_solution_previous2)[pt][var];
+        m_state[k] = U[pt][var];
+        m_state_residual[k] = R[pt][var];
+        rhs[k] = R[pt][var] - time_derivative/H[pt][0];
+      }
+    }
+
+    const Real norm = std::sqrt(dot(&rhs[0],&rhs[0]));
+    if (norm == 0.)
+      break;
+    if (newton_iteration == 0)
+      initial_norm = norm;
+    else if (norm <= newton_tolerance*initial_norm)
+      break;
+
+    if (newton_iteration == 0 && m_nb_steps % update_frequency == 0 && is_not_null(m_lss))
+      assemble_preconditioner();
+
+    std::fill(correction.begin(), correction.end(), 0.);
+    const math::LSS::KrylovResult result = math::LSS::solve_gmres(op, &rhs[0], &correction[0], krylov_tolerance, max_krylov_iterations, gmres_restart);
+    krylov_iterations += result.iterations;
+    CFdebug << uri().path() << ": Newton iteration " << newton_iteration+1 << ": |G| = " << norm
+            << ", " << result.iterations << " GMRES iterations, linear residual reduced to " << result.residual/result.initial_residual << CFendl;
+
+    // U = U + dU
+    for (Uint i=0; i<m_points.size(); ++i)
+      for (Uint var=0; var<nb_vars; ++var)
+        U[m_points[i]][var] = m_state[i*nb_vars+var] + correction[i*nb_vars+var];
+
+    // raise signal that iteration is done
+    raise_iteration_done();
+  }
+
+  properties().property("newton_iterations") = newton_iteration;
+  properties().property("krylov_iterations") = krylov_iterations;
+
+  // After a GMRES solve the residual field holds the residual of the last perturbed
+  // state U+eps*v. When the Newton loop ran out of iterations, recompute the residual
+  // of the final solution, as when the loop converged.
+  if (newton_iteration == max_newton_iterations && max_newton_iterations > 0)
+    compute_residual(true);
+
+  post_update().execute();
+  U.synchronize();
+
+  ++m_nb_steps;
+  m_previous_dt = dt;
+  time.current_time() = T0;
+  time.dt() = dt;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+} // sdm
+} // cf3
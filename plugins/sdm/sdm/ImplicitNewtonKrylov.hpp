@@ -0,0 +1,116 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_sdm_ImplicitNewtonKrylov_hpp
+#define cf3_sdm_ImplicitNewtonKrylov_hpp
+
+#include "sdm/IterativeSolver.hpp"
+
+namespace cf3 {
+namespace math { namespace LSS { class System; } }
+namespace sdm {
+
+class NewtonKrylovOperator;
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+/// Implicit time integration with a Jacobian-free Newton-Krylov method.
+///
+/// Every time step solves the nonlinear system
+///   G(U) = ( a0 U + a1 U^n + a2 U^(n-1) ) / H - R(U) = 0
+/// with H the update coefficient of ComputeUpdateCoefficient. Backward Euler has (a0,a1,a2) = (1,-1,0),
+/// BDF2 uses the variable step size coefficients, with a backward Euler first step.
+/// For steady (not time-accurate) runs H is the local pseudo time step and the scheme is backward Euler,
+/// so a large cfl gives a pseudo-transient continuation towards Newton's method.
+///
+/// Each Newton iteration solves J dU = -G(U) with right-preconditioned GMRES, where the product
+/// with the Jacobian is approximated by a finite difference of the residual computed by the Terms:
+///   J v = a0 v / H - ( R(U + eps v) - R(U) ) / eps
+/// The preconditioner is the element-block Jacobi matrix, made of the Jacobians of the residual of every element
+/// with respect to its own solution points. These are also finite differences: elements of one color don't touch
+/// each other, so all elements of a color are perturbed together and only their residual is computed
+/// (see DomainDiscretization::active_elements()). The blocks are stored in a math::LSS::System. Its preconditioner
+/// is factored once per assembly, and every GMRES iteration only applies the factorization.
+class sdm_API ImplicitNewtonKrylov : public IterativeSolver {
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  ImplicitNewtonKrylov ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~ImplicitNewtonKrylov() {}
+
+  /// Get the class name
+  static std::string type_name () { return "ImplicitNewtonKrylov"; }
+
+  /// execute the action
+  virtual void execute ();
+
+private: // functions
+
+  friend class NewtonKrylovOperator;
+
+  virtual void link_fields();
+
+  /// Find or create a field in the solution dictionary, and link it in the field manager
+  void link_field(Handle<mesh::Field>& field, const std::string& name, const std::string& prefix);
+
+  /// Collect the solution points of the owned cells, and create the linear system holding the preconditioner
+  void setup();
+
+  /// Compute the residual of the current solution, after applying the boundary conditions
+  void compute_residual(const bool synchronize);
+
+  /// Compute the element Jacobians and store them in the linear system
+  void assemble_preconditioner();
+
+  /// y = J x
+  void jacobian_product(const Real* x, Real* y);
+
+  /// z = M^-1 r
+  void precondition(const Real* r, Real* z);
+
+  /// Dot product of vectors over the owned solution points, summed over all ranks
+  Real dot(const Real* a, const Real* b) const;
+
+private: // data
+
+  /// Solution at the start of the time step
+  Handle<mesh::Field> m_solution_previous;
+
+  /// Solution at the start of the previous time step, for BDF2
+  Handle<mesh::Field> m_solution_previous2;
+
+  /// Linear system with the element-block Jacobi preconditioner
+  Handle<math::LSS::System> m_lss;
+
+  /// Solution points of the owned cells, in the order of the Krylov vectors
+  std::vector<Uint> m_points;
+
+  /// Solution and residual at which the Jacobian is evaluated
+  std::vector<Real> m_state;
+  std::vector<Real> m_state_residual;
+
+  /// Coefficient a0 of the time discretization
+  Real m_alpha0;
+
+  /// Time step of the previous time step, or zero before the first one
+  Real m_previous_dt;
+
+  /// Number of completed time steps
+  Uint m_nb_steps;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+} // sdm
+} // cf3
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_sdm_ImplicitNewtonKrylov_hpp
@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
 
@@ -92,13 +94,20 @@ void Init::execute()
 
   Variables& input_vars = *m_input_vars;
 
-  std::vector<Real> params(DIM_3D,0.);
+  const Uint nb_vars = m_function.nbvars();
+  const Uint nb_funcs = m_function.nbfuncs();
   RealVector return_val( solution.row_size() );
   RealMatrix grad_vars( physical_model().neqs(), physical_model().ndim() );
   RealVector sol (physical_model().neqs() );
 
   std::auto_ptr<physics::Properties> props = physical_model().create_properties();
 
+  // The function is evaluated for chunks of points at once
+  const Uint chunk_size = 65536;
+  std::vector<Real> params;
+  std::vector<Real> values;
+  std::vector<Uint> points;
+
   boost_foreach(const Handle<Entities>& entities, solution.entities_range())
   {
     const Space& space = solution.space(*entities);
@@ -110,45 +119,66 @@ void Init::execute()
 
     RealMatrix space_coords;
     space.allocate_coordinates(space_coords);
+    const Uint ndim = space_coords.cols();
+    RealVector coords(ndim);
 
     const ShapeFunction& geometry_shape_func = entities->element_type().shape_function();
     RealRowVector geometry_shape_func_values (geometry_shape_func.nb_nodes());
 
     const Connectivity& field_connectivity = space.connectivity();
 
-    for (Uint elem=0; elem<entities->size(); ++elem)
+    const Uint nb_nodes = space.shape_function().nb_nodes();
+    const Uint nb_chunk_elems = std::max(1u, chunk_size/nb_nodes);
+
+    for (Uint begin=0; begin<entities->size(); begin+=nb_chunk_elems)
     {
-      entities->geometry_space().put_coordinates(geometry_coords,elem);
+      const Uint end = std::min(begin+nb_chunk_elems, entities->size());
+      const Uint nb_pts = (end-begin)*nb_nodes;
+      params.assign(nb_pts*nb_vars, 0.);
+      points.resize(nb_pts);
 
-      for (Uint node=0; node<space.shape_function().nb_nodes();++node)
+      Uint pt = 0;
+      for (Uint elem=begin; elem<end; ++elem)
       {
-        Uint p = field_connectivity[elem][node];
-        // Get the coordinates for this point, and put in params
-        geometry_shape_func.compute_value(local_coords.row(node),geometry_shape_func_values);
-        space_coords.row(node) = geometry_shape_func_values * geometry_coords;
-        for (Uint d=0; d<space_coords.cols(); ++d)
-          params[d] = space_coords(node,d);
+        entities->geometry_space().put_coordinates(geometry_coords,elem);
 
-        // Evaluate function
-        m_function.evaluate(params,return_val);
+        for (Uint node=0; node<nb_nodes; ++node, ++pt)
+        {
+          points[pt] = field_connectivity[elem][node];
+          // Get the coordinates for this point, and put in params
+          geometry_shape_func.compute_value(local_coords.row(node),geometry_shape_func_values);
+          space_coords.row(node) = geometry_shape_func_values * geometry_coords;
+          for (Uint d=0; d<ndim; ++d)
+            params[pt*nb_vars+d] = space_coords(node,d);
+        }
+      }
+
+      // Evaluate function
+      values.resize(nb_pts*nb_funcs);
+      m_function.evaluate_batch(nb_pts, &params[0], nb_vars, &values[0], nb_funcs);
+
+      for (pt=0; pt<nb_pts; ++pt)
+      {
+        for (Uint i=0; i<nb_funcs; ++i)
+          return_val[i] = values[pt*nb_funcs+i];
 
         // Transform the return_val of the function to solution variables,
         if (m_input_vars != solution_vars)
         {
-          input_vars.compute_properties(space_coords.row(node),return_val,grad_vars,*props);
+          for (Uint d=0; d<ndim; ++d)
+            coords[d] = params[pt*nb_vars+d];
+          input_vars.compute_properties(coords,return_val,grad_vars,*props);
           solution_vars->compute_variables(*props,sol);
 
           // Copy in the solution field
-          solution.set_row(p,sol);
+          solution.set_row(points[pt],sol);
         }
         else
         {
           // Copy in the solution field
-          solution.set_row(p,return_val);
+          solution.set_row(points[pt],return_val);
         }
-
       }
-
     }
   }
   solution.synchronize();
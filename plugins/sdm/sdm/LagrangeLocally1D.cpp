@@ -35,6 +35,9 @@ QuadP4_builder(LibSDM::library_namespace()+".P4.Quad");
 ComponentBuilder<QuadLagrange1D<5>,mesh::ShapeFunction,LibSDM>
 QuadP5_builder(LibSDM::library_namespace()+".P5.Quad");
 
+ComponentBuilder<QuadLagrange1D<6>,mesh::ShapeFunction,LibSDM>
+QuadP6_builder(LibSDM::library_namespace()+".P6.Quad");
+
 ////////////////////////////////////////////////////////////////////////////////
 
 ComponentBuilder<LineLagrange1D<0>,mesh::ShapeFunction,LibSDM>
@@ -55,6 +58,9 @@ LineP4_builder(LibSDM::library_namespace()+".P4.Line");
 ComponentBuilder<LineLagrange1D<5>,mesh::ShapeFunction,LibSDM>
 LineP5_builder(LibSDM::library_namespace()+".P5.Line");
 
+ComponentBuilder<LineLagrange1D<6>,mesh::ShapeFunction,LibSDM>
+LineP6_builder(LibSDM::library_namespace()+".P6.Line");
+
 ////////////////////////////////////////////////////////////////////////////////
 
 ComponentBuilder<Point<0>,mesh::ShapeFunction,LibSDM>
@@ -75,6 +81,9 @@ PointP4_builder(LibSDM::library_namespace()+".P4.Point");
 ComponentBuilder<Point<5>,mesh::ShapeFunction,LibSDM>
 PointP5_builder(LibSDM::library_namespace()+".P5.Point");
 
+ComponentBuilder<Point<6>,mesh::ShapeFunction,LibSDM>
+PointP6_builder(LibSDM::library_namespace()+".P6.Point");
+
 ////////////////////////////////////////////////////////////////////////////////
 
 } // sdm
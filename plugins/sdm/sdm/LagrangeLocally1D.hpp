@@ -96,6 +96,9 @@ struct sdm_API Locally_1d
     case 5:
       flx_pts << -1, -sqrt(5.+2.*sqrt(10./7.))/3., -sqrt(5.-2.*sqrt(10./7.))/3., 0., +sqrt(5.-2.*sqrt(10./7.))/3., +sqrt(5.+2.*sqrt(10./7.))/3., +1;
       break;
+    case 6:
+      flx_pts << -1, -0.9324695142031520278, -0.6612093864662645136, -0.2386191860831969086, +0.2386191860831969086, +0.6612093864662645136, +0.9324695142031520278, +1;
+      break;
     default:
       throw common::NotImplemented(FromHere(),"1D flux-point locations for P"+common::to_str(p)+" are not yet defined");
       break;
@@ -148,6 +151,20 @@ struct sdm_API Locally_1d
         interpolate_grad_flx_to_sol(s,f) = Lagrange::deriv_coeff(sol_pts[s],flx_pts,f);
       }
     }
+
+    interpolate_grad_sol_to_flx.resize(flx_pts.size(),sol_pts.size());
+    for (Uint f=0; f<flx_pts.size(); ++f) {
+      for (Uint s=0; s<sol_pts.size(); ++s) {
+        interpolate_grad_sol_to_flx(f,s) = Lagrange::deriv_coeff(flx_pts[f],sol_pts,s);
+      }
+    }
+
+    interpolate_grad_sol_to_sol.resize(sol_pts.size(),sol_pts.size());
+    for (Uint r=0; r<sol_pts.size(); ++r) {
+      for (Uint s=0; s<sol_pts.size(); ++s) {
+        interpolate_grad_sol_to_sol(r,s) = Lagrange::deriv_coeff(sol_pts[r],sol_pts,s);
+      }
+    }
   }
 
   RealVector sol_pts;
@@ -158,6 +175,8 @@ struct sdm_API Locally_1d
   RealMatrix interpolate_sol_to_flx;
   RealMatrix interpolate_flx_to_sol;
   RealMatrix interpolate_grad_flx_to_sol;
+  RealMatrix interpolate_grad_sol_to_flx;
+  RealMatrix interpolate_grad_sol_to_sol;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -421,6 +440,7 @@ public: // functions
   virtual const std::vector<Uint>& interior_flx_pts() const { return m_interior_flx_pts; }
   virtual const std::vector<Uint>& face_flx_pts(const Uint face_idx) const { cf3_assert(face_idx<nb_faces()); return m_face_flx_pts[face_idx]; }
   virtual const Real& flx_pt_sign(const Uint flx_pt, const Uint dir) const { return m_flx_pt_sign[flx_pt]; }
+  virtual const Locally_1d* locally_1d() const { return &m_local_1d; }
 
 private: // data
 
@@ -595,6 +615,7 @@ public: // functions
   virtual const std::vector<Uint>& interior_flx_pts() const { return m_interior_flx_pts; }
   virtual const std::vector<Uint>& face_flx_pts(const Uint face_idx) const { cf3_assert(face_idx<nb_faces()); return m_face_flx_pts[face_idx]; }
   virtual const Real& flx_pt_sign(const Uint flx_pt, const Uint dir) const { return m_flx_pt_sign[flx_pt]; }
+  virtual const Locally_1d* locally_1d() const { return &m_local_1d; }
 
 private: // data
 
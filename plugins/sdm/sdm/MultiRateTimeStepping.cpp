@@ -0,0 +1,256 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/ActionDirector.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Group.hpp"
+#include "common/Link.hpp"
+#include "common/StringConversion.hpp"
+
+#include "math/Defs.hpp"
+#include "math/VariablesDescriptor.hpp"
+
+#include "solver/Time.hpp"
+#include "solver/Solver.hpp"
+
+#include "mesh/Cells.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/FieldManager.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ElementConnectivity.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+
+#include "sdm/MultiRateTimeStepping.hpp"
+#include "sdm/DomainDiscretization.hpp"
+#include "sdm/Tags.hpp"
+#include "sdm/SDSolver.hpp"
+
+using namespace cf3::common;
+using namespace cf3::solver;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace sdm {
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < MultiRateTimeStepping, common::Action, LibSDM > MultiRateTimeStepping_Builder;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+MultiRateTimeStepping::MultiRateTimeStepping ( const std::string& name ) :
+  IterativeSolver(name)
+{
+  mark_basic();
+
+  options().add_option("nb_levels", 4u)
+      .description("Number of time step levels. Element time steps are powers of two times the smallest one,\n"
+                   "and one time step spans 2^(nb_levels-1) of the smallest ones.")
+      .pretty_name("Number of Levels")
+      .mark_basic();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MultiRateTimeStepping::link_fields()
+{
+  IterativeSolver::link_fields();
+
+  if ( is_null(m_increment) )  // increment not created --> create field
+  {
+    if (Handle< Component > found_increment = solver().field_manager().get_child( "solution_increment" ))
+    {
+      m_increment = Handle<Field>( follow_link(found_increment) );
+    }
+    else if ( Handle< Component > found_increment = m_solution->dict().get_child( "solution_increment" ) )
+    {
+      solver().field_manager().create_component<Link>("solution_increment")->link_to(*found_increment);
+      m_increment = found_increment->handle<Field>();
+    }
+    else
+    {
+      m_increment = m_solution->dict().create_field("solution_increment", m_solution->descriptor().description()).handle<Field>();
+      m_increment->descriptor().prefix_variable_names("increment_");
+      solver().field_manager().create_component<Link>("solution_increment")->link_to(*m_increment);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MultiRateTimeStepping::compute_levels(const Uint nb_substeps, const Real dt)
+{
+  const Field& H = *m_update_coeff;
+
+  m_step_size.clear();
+  m_interface.clear();
+  boost_foreach(const Handle<Entities>& entities, m_solution->entities_range())
+  {
+    if ( is_null(entities->handle<Cells>()) )
+      continue;
+    const Space& space = m_solution->space(*entities);
+    std::vector<Uint>& step_size = m_step_size[entities];
+    step_size.resize(entities->size());
+    for (Uint elem=0; elem<entities->size(); ++elem)
+    {
+      step_size[elem] = nb_substeps == 1 ? 1u : static_cast<Uint>( H[space.connectivity()[elem][0]][0]/dt + 0.5 );
+    }
+  }
+
+  boost_foreach(const Handle<Entities>& entities, m_solution->entities_range())
+  {
+    if ( is_null(entities->handle<Cells>()) )
+      continue;
+    const std::vector<Uint>& step_size = m_step_size[entities];
+    std::vector<bool>& interface = m_interface[entities];
+    interface.assign(entities->size(), false);
+
+    const Handle<ElementConnectivity const> cell2face ( entities->connectivity_cell2face() );
+    cf3_assert(cell2face);
+    for (Uint elem=0; elem<entities->size(); ++elem)
+    {
+      if (entities->is_ghost(elem))
+        continue;
+      boost_foreach(const Entity& face, (*cell2face)[elem])
+      {
+        const FaceCellConnectivity& face2cell = *face.comp->connectivity_face2cell();
+        if (face2cell.is_bdry_face()[face.idx])
+          continue;
+        const ElementConnectivity::ConstRow cells = face2cell.connectivity()[face.idx];
+        const Entity& neighbour = (cells[LEFT].comp == entities.get() && cells[LEFT].idx == elem) ? cells[RIGHT] : cells[LEFT];
+        const std::map< Handle<Entities const>, std::vector<Uint> >::const_iterator neighbour_step_size = m_step_size.find(neighbour.comp->handle<Entities>());
+        if (neighbour_step_size != m_step_size.end() && neighbour_step_size->second[neighbour.idx] < step_size[elem])
+        {
+          interface[elem] = true;
+          break;
+        }
+      }
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MultiRateTimeStepping::execute()
+{
+  configure_option_recursively( "iterator", handle<Component>() );
+
+  link_fields();
+
+  if (is_null(m_time))        throw SetupError(FromHere(), "Time was not set");
+  Time& time = *m_time;
+
+  const Uint nb_levels = options().option("nb_levels").value<Uint>();
+  const Uint solution_order = solver().options().option(sdm::Tags::solution_order()).value<Uint>();
+  if (nb_levels > 1 && solution_order > 1)
+    throw SetupError(FromHere(), "Multi-rate time stepping of "+uri().string()+" is first order in time, and only supports P0 solutions when nb_levels > 1 (solution_order is "+common::to_str(solution_order)+")");
+
+  SDSolver& sd_solver = *solver().handle<SDSolver>();
+  DomainDiscretization& domain_discretization = sd_solver.domain_discretization();
+  Component& compute_update_coefficient = *sd_solver.actions().get_child("compute_update_coefficient");
+
+  Field& U  = *m_solution;
+  Field& dU = *m_increment;
+  Field& R  = *m_residual;
+  Field& H  = *m_update_coeff;
+  const Uint nb_vars = U.row_size();
+
+  const Real T0 = time.current_time();
+
+  // Residual and wave speeds in all elements, then the time step levels
+  domain_discretization.active_elements().clear();
+  properties().property("iteration") = Uint(1);
+  pre_update().execute();
+
+  compute_update_coefficient.options().configure_option("nb_levels", nb_levels);
+  compute_update_coefficient.handle<common::Action>()->execute();
+  compute_update_coefficient.options().configure_option("nb_levels", 1u);
+
+  const Real time_step = time.dt();
+  const Uint nb_substeps = compute_update_coefficient.properties().value<Uint>("nb_substeps");
+  const Real dt = time_step/nb_substeps;
+
+  compute_levels(nb_substeps, dt);
+
+  dU = 0.;
+  for (Uint substep=0; substep<nb_substeps; ++substep)
+  {
+    // Compute the residual of the elements that start a step, and of the interface elements
+    if (substep > 0)
+    {
+      boost_foreach(const Handle<Entities>& entities, m_solution->entities_range())
+      {
+        if ( is_null(entities->handle<Cells>()) )
+          continue;
+        const std::vector<Uint>& step_size = m_step_size[entities];
+        const std::vector<bool>& interface = m_interface[entities];
+        std::vector<bool>& active = domain_discretization.active_elements()[entities];
+        active.resize(entities->size());
+        for (Uint elem=0; elem<entities->size(); ++elem)
+          active[elem] = interface[elem] || substep % step_size[elem] == 0;
+      }
+      properties().property("iteration") = substep+1;
+      time.current_time() = T0 + substep*dt;
+      pre_update().execute();
+    }
+
+    // Accumulate the residual, and update the elements that end a step
+    boost_foreach(const Handle<Entities>& entities, m_solution->entities_range())
+    {
+      if ( is_null(entities->handle<Cells>()) )
+        continue;
+      const Space& space = m_solution->space(*entities);
+      const std::vector<Uint>& step_size = m_step_size[entities];
+      const std::vector<bool>& interface = m_interface[entities];
+      for (Uint elem=0; elem<entities->size(); ++elem)
+      {
+        if (entities->is_ghost(elem))
+          continue;
+        const bool computed = interface[elem] || substep % step_size[elem] == 0;
+        const bool step_done = (substep+1) % step_size[elem] == 0;
+        boost_foreach(const Uint pt, space.connectivity()[elem])
+        {
+          if (computed)
+          {
+            const Real weight = interface[elem] ? dt : H[pt][0];
+            for (Uint var=0; var<nb_vars; ++var)
+              dU[pt][var] += weight*R[pt][var];
+          }
+          if (step_done)
+          {
+            for (Uint var=0; var<nb_vars; ++var)
+            {
+              U[pt][var] += dU[pt][var];
+              dU[pt][var] = 0.;
+            }
+          }
+        }
+      }
+    }
+
+    // Do post-processing per substep after update
+    post_update().execute();
+    U.synchronize();
+
+    // raise signal that iteration is done
+    raise_iteration_done();
+  }
+
+  domain_discretization.active_elements().clear();
+  time.current_time() = T0;
+  time.dt() = time_step;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+} // sdm
+} // cf3
@@ -0,0 +1,80 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_sdm_MultiRateTimeStepping_hpp
+#define cf3_sdm_MultiRateTimeStepping_hpp
+
+#include "sdm/IterativeSolver.hpp"
+
+namespace cf3 {
+namespace mesh { class Entities; }
+namespace sdm {
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+/// Multi-rate forward Euler time integration.
+///
+/// ComputeUpdateCoefficient assigns every element a time step dt*2^level, with dt the smallest
+/// time step and level < nb_levels. One time step of this integrator spans nb_substeps = 2^(nb_levels-1)
+/// substeps of size dt. At every substep only the elements that start a new step of their own compute
+/// a residual, so large cells are not computed at the rate of the smallest ones.
+///
+/// Each element accumulates its update over its own step, and applies it at the end of that step,
+/// so neighbours always see the solution at the start of its step.
+/// Elements with a neighbour of a lower level ("interface elements") compute their residual at every substep
+/// instead, with weight dt. Both sides of a level interface then integrate the same numerical fluxes
+/// over the same substeps, so the scheme stays conservative.
+///
+/// With nb_levels = 1, or for steady (not time-accurate) runs, this is the forward Euler method
+/// with the update coefficient of ComputeUpdateCoefficient.
+///
+/// The scheme is first order in time, so with nb_levels > 1 only P0 (solution_order = 1) solutions are accepted,
+/// and a SetupError is thrown otherwise.
+class sdm_API MultiRateTimeStepping : public IterativeSolver {
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  MultiRateTimeStepping ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~MultiRateTimeStepping() {}
+
+  /// Get the class name
+  static std::string type_name () { return "MultiRateTimeStepping"; }
+
+  /// execute the action
+  virtual void execute ();
+
+private: // functions
+
+  virtual void link_fields();
+
+  /// Compute the step size of every element, in substeps of size dt, from the update coefficient,
+  /// and find the interface elements
+  void compute_levels(const Uint nb_substeps, const Real dt);
+
+private: // data
+
+  /// Update accumulated by each element over its own step
+  Handle<mesh::Field> m_increment;
+
+  /// Number of substeps per step, for each set of cells
+  std::map< Handle<mesh::Entities const>, std::vector<Uint> > m_step_size;
+
+  /// Elements with a neighbour of a lower level
+  std::map< Handle<mesh::Entities const>, std::vector<bool> > m_interface;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+} // sdm
+} // cf3
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_sdm_MultiRateTimeStepping_hpp
@@ -11,6 +11,7 @@
 
 #include "mesh/Reconstructions.hpp"
 #include "sdm/ShapeFunction.hpp"
+#include "sdm/SumFactorization.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -84,8 +85,47 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
-struct ReconstructToFluxPoints
+/// Adaptor functions to support RealMatrix, multi_array, multi_array_view and std::vector of vectors
+/// with values in row-vectors in the sum-factorized reconstructions
+struct SumFactorizedReconstructBase
 {
+protected:
+  template <typename matrix_type>
+  static Uint nb_rows(const matrix_type& m) { return m.size(); }
+  static Uint nb_rows(const RealMatrix& m) { return m.rows(); }
+  static Uint nb_rows(const boost::detail::multi_array::multi_array_view<Real, 2>& m) { return m.shape()[0]; }
+
+  template <typename matrix_type>
+  static Uint nb_vars(const matrix_type& m) { return m[0].size(); }
+  static Uint nb_vars(const RealMatrix& m) { return m.cols(); }
+  static Uint nb_vars(const boost::detail::multi_array::multi_array_view<Real, 2>& m) { return m.shape()[1]; }
+
+  template <typename matrix_type>
+  static void gather(const matrix_type& m, std::vector<Real>& values)
+  {
+    const Uint rows = nb_rows(m);
+    const Uint vars = nb_vars(m);
+    values.resize(rows*vars);
+    for (Uint r=0; r<rows; ++r)
+      for (Uint v=0; v<vars; ++v)
+        values[r*vars+v] = m[r][v];
+  }
+  static void gather(const RealMatrix& m, std::vector<Real>& values)
+  {
+    values.resize(m.rows()*m.cols());
+    for (Uint r=0; r<m.rows(); ++r)
+      for (Uint v=0; v<m.cols(); ++v)
+        values[r*m.cols()+v] = m(r,v);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Reconstruct values in solution points (or in geometry nodes) to all flux points.
+/// Reconstructions from the solution points of a Locally_1d shape function are sum-factorized.
+struct ReconstructToFluxPoints : SumFactorizedReconstructBase
+{
+  ReconstructToFluxPoints() : m_sum_factorized(false) {}
 
   void build_coefficients(const Handle<mesh::ShapeFunction const>& from_sf, const Handle<sdm::ShapeFunction const>& sf)
   {
@@ -95,6 +135,7 @@ struct ReconstructToFluxPoints
     {
       m_reconstruct[flx_pt].build_coefficients(sf->flx_pts().row(flx_pt),from_sf);
     }
+    m_sum_factorized = from_sf.get() == static_cast<const mesh::ShapeFunction*>(sf.get()) && m_sum_factorization.build(*sf);
   }
 
   void build_coefficients(const Handle<sdm::ShapeFunction const>& sf)
@@ -104,6 +145,7 @@ struct ReconstructToFluxPoints
     {
       m_reconstruct[flx_pt].build_coefficients(sf->flx_pts().row(flx_pt),sf);
     }
+    m_sum_factorized = m_sum_factorization.build(*sf);
   }
 
   const mesh::ReconstructPoint& operator[](const Uint flx_pt) const
@@ -111,11 +153,25 @@ struct ReconstructToFluxPoints
     return m_reconstruct[flx_pt];
   }
 
+  /// Sum-factorized reconstruction, to reconstruct batches of elements at once, or NULL if not available
+  const SumFactorization* sum_factorization() const
+  {
+    return m_sum_factorized ? &m_sum_factorization : NULL;
+  }
+
   /// Reconstruct values from matrix with values in row-vectors to matrix with values in row-vectors
   template <typename matrix_type_from, typename matrix_type_to>
   void operator()(const matrix_type_from& from, matrix_type_to& to) const
   {
     cf3_assert(m_reconstruct.size()==to.size());
+    if (m_sum_factorized)
+    {
+      const Uint vars = interpolate(from);
+      for (Uint r=0; r<m_reconstruct.size(); ++r)
+        for (Uint v=0; v<vars; ++v)
+          to[r][v] = m_to[r*vars+v];
+      return;
+    }
     for (Uint r=0; r<m_reconstruct.size(); ++r)
       m_reconstruct[r](from,to[r]);
   }
@@ -125,27 +181,58 @@ struct ReconstructToFluxPoints
   void operator()(const matrix_type_from& from, RealMatrix& to) const
   {
     cf3_assert(m_reconstruct.size()==to.rows());
+    if (m_sum_factorized)
+    {
+      const Uint vars = interpolate(from);
+      for (Uint r=0; r<m_reconstruct.size(); ++r)
+        for (Uint v=0; v<vars; ++v)
+          to(r,v) = m_to[r*vars+v];
+      return;
+    }
     for (Uint r=0; r<m_reconstruct.size(); ++r)
       m_reconstruct[r](from,to.row(r));
   }
 
+private:
+
+  /// Sum-factorized reconstruction of one element into m_to
+  /// @return number of variables
+  template <typename matrix_type_from>
+  Uint interpolate(const matrix_type_from& from) const
+  {
+    gather(from,m_from);
+    const Uint vars = nb_vars(from);
+    m_to.resize(m_reconstruct.size()*vars);
+    m_sum_factorization.interpolate(1,vars,&m_from[0],&m_to[0]);
+    return vars;
+  }
+
 private:
   std::vector<mesh::ReconstructPoint> m_reconstruct;
+  SumFactorization m_sum_factorization;
+  bool m_sum_factorized;
+  mutable std::vector<Real> m_from;
+  mutable std::vector<Real> m_to;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
-struct GradientReconstructToFluxPoints
+/// Reconstruct the derivatives to the local coordinates of values in solution points, to all flux points.
+/// Reconstructions from the solution points of a Locally_1d shape function are sum-factorized.
+struct GradientReconstructToFluxPoints : SumFactorizedReconstructBase
 {
+  GradientReconstructToFluxPoints() : m_sum_factorized(false) {}
+
   void build_coefficients(Handle<sdm::ShapeFunction const> sf)
   {
-    m_derivative_reconstruct_to_flx_pt.resize(sf->nb_nodes());
-    for (Uint pt=0; pt<sf->nb_nodes(); ++pt)
+    m_derivative_reconstruct_to_flx_pt.resize(sf->nb_flx_pts());
+    for (Uint pt=0; pt<sf->nb_flx_pts(); ++pt)
     {
       m_derivative_reconstruct_to_flx_pt[pt].resize(sf->dimensionality());
       for (Uint d=0; d<sf->dimensionality(); ++d)
         m_derivative_reconstruct_to_flx_pt[pt][d].build_coefficients(d,sf->flx_pts().row(pt),sf);
     }
+    m_sum_factorized = m_sum_factorization.build(*sf);
   }
 
   void build_coefficients(const Handle<mesh::ShapeFunction const>& from_sf,Handle<sdm::ShapeFunction const> to_sf)
@@ -157,6 +244,7 @@ struct GradientReconstructToFluxPoints
       for (Uint d=0; d<to_sf->dimensionality(); ++d)
         m_derivative_reconstruct_to_flx_pt[pt][d].build_coefficients(d,to_sf->flx_pts().row(pt),from_sf);
     }
+    m_sum_factorized = from_sf.get() == static_cast<const mesh::ShapeFunction*>(to_sf.get()) && m_sum_factorization.build(*to_sf);
   }
 
 
@@ -167,8 +255,42 @@ struct GradientReconstructToFluxPoints
     return m_derivative_reconstruct_to_flx_pt[pt];
   }
 
+  /// Sum-factorized reconstruction, to reconstruct batches of elements at once, or NULL if not available
+  const SumFactorization* sum_factorization() const
+  {
+    return m_sum_factorized ? &m_sum_factorization : NULL;
+  }
+
+  /// Reconstruct gradients from matrix with values in row-vectors to a vector of matrices,
+  /// with to[flx_pt](var,derivative)
+  template <typename matrix_type_from, typename matrix_type_to>
+  void operator()(const matrix_type_from& from, std::vector<matrix_type_to>& to) const
+  {
+    cf3_assert(m_derivative_reconstruct_to_flx_pt.size()==to.size());
+    if (m_sum_factorized)
+    {
+      gather(from,m_from);
+      const Uint vars = nb_vars(from);
+      const Uint ndims = m_sum_factorization.ndims();
+      m_to.resize(to.size()*ndims*vars);
+      m_sum_factorization.gradient(1,vars,&m_from[0],&m_to[0]);
+      for (Uint pt=0; pt<to.size(); ++pt)
+        for (Uint d=0; d<ndims; ++d)
+          for (Uint v=0; v<vars; ++v)
+            to[pt](v,d) = m_to[(pt*ndims+d)*vars+v];
+      return;
+    }
+    for (Uint pt=0; pt<to.size(); ++pt)
+      for (Uint d=0; d<m_derivative_reconstruct_to_flx_pt[pt].size(); ++d)
+        m_derivative_reconstruct_to_flx_pt[pt][d](from,to[pt].col(d));
+  }
+
 private:
   std::vector< std::vector<mesh::DerivativeReconstructPoint> > m_derivative_reconstruct_to_flx_pt;
+  SumFactorization m_sum_factorization;
+  bool m_sum_factorized;
+  mutable std::vector<Real> m_from;
+  mutable std::vector<Real> m_to;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
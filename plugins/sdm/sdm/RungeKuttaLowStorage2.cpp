@@ -229,23 +229,9 @@ void RungeKuttaLowStorage2::execute()
     // - H
     // - time.dt()
 
-    const Real one_minus_alpha = 1. - alpha[stage];
-    boost_foreach(const Handle<Entities>& elements_handle, U.entities_range())
-    {
-      Entities& elements = *elements_handle;
-      const Connectivity& space_connectivity = U.space(elements).connectivity();
-
-      for (Uint e=0; e<elements.size(); ++e)
-      {
-        boost_foreach(const Uint state, space_connectivity[e])
-        {
-          for (Uint var=0; var<U.row_size(); ++var)
-          {
-            U[state][var] = one_minus_alpha*U0[state][var] + alpha[stage]*U[state][var] + beta[stage]*H[state][0]*R[state][var];
-          }
-        }
-      }
-    }
+    // U = (1-alpha)*U0 + alpha*U + beta*H*R
+    U.axpby(1. - alpha[stage], U0, alpha[stage]);
+    U.axpy(beta[stage], H, R);
 
     // U has now been updated
 
@@ -220,26 +220,10 @@ void RungeKuttaLowStorage3::execute()
     /// // for error_estimate, use:
     ///     S2 := 1/sum(delta) * (S2 + delta(m+1)*S1 + delta(m+2)*S3
 
-    boost_foreach(const Handle<Entities>& elements_handle, m_solution->entities_range())
-    {
-      Entities& elements = *elements_handle;
-      const Connectivity& space_connectivity = m_solution->space(elements).connectivity();
-
-      for (Uint e=0; e<elements.size(); ++e)
-      {
-        boost_foreach(const Uint state, space_connectivity[e])
-        {
-          for (Uint var=0; var<m_solution->row_size(); ++var)
-          {
-            S2[state][var] = S2[state][var] + delta*S1[state][var];
-            S1[state][var] =   gamma1*S1[state][var]
-                             + gamma2*S2[state][var]
-                             + gamma3*S3[state][var]
-                             + beta*H[state][0]*R[state][var];
-          }
-        }
-      }
-    }
+    S2.axpy(delta, S1);
+    S1.axpby(gamma2, S2, gamma1);
+    S1.axpy(gamma3, S3);
+    S1.axpy(beta, H, R);
 
     // U (=S1) has now been updated
 
@@ -19,6 +19,8 @@
 namespace cf3 {
 namespace sdm {
 
+struct Locally_1d;
+
 /// @brief Spectral Finite Difference shape function base class
 ///
 /// SFD shape functions are comprised of 1D shape functions, in every direction of the
@@ -103,6 +105,10 @@ public:
   /// Sign to be multiplied with the flux computed in flx_pt
   virtual const Real& flx_pt_sign(const Uint flx_pt, const Uint dir=999) const = 0;
 
+  /// 1D interpolation matrices of which this shape function is the tensorial product,
+  /// or NULL if the shape function is not built from Locally_1d lines
+  virtual const Locally_1d* locally_1d() const { return NULL; }
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,232 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_sdm_SumFactorization_hpp
+#define cf3_sdm_SumFactorization_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#include "math/MatrixTypes.hpp"
+
+#include "sdm/ShapeFunction.hpp"
+#include "sdm/LagrangeLocally1D.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace sdm {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Sum-factorized reconstructions for shape functions that are tensorial products of Locally_1d lines
+///
+/// The solution points of such an element lie on lines of p+1 points in every direction, and the flux points
+/// of a direction lie on the same lines, with p+2 points per line. Reconstructions from solution points to
+/// flux points are then products of the small 1D matrices of Locally_1d with the values along every line.
+/// The derivative across the lines of a direction is first computed in the solution points, along the lines
+/// of the other direction, and then interpolated. This costs O(p^(d+1)) per element instead of O(p^(2d))
+/// for the reconstruction of every point from all solution points.
+///
+/// Values of all lines of a batch of elements are gathered in the columns of one matrix, so every 1D
+/// operator is applied to the batch as a single dense matrix product.
+/// Values are stored per element, per point, per variable: values[(elem*nb_pts + pt)*nb_vars + var]
+class SumFactorization
+{
+public:
+
+  SumFactorization() : m_ndims(0), m_nb_sol_pts(0), m_nb_flx_pts(0) {}
+
+  /// Find the lines of solution and flux points of the shape function
+  /// @return false if the shape function is not built from Locally_1d lines
+  bool build(const sdm::ShapeFunction& sf)
+  {
+    m_sol_lines.clear();
+    m_flx_lines.clear();
+    const Locally_1d* local_1d = sf.locally_1d();
+    if (local_1d == NULL || local_1d->nb_sol_pts < 2)
+      return false;
+
+    m_ndims = sf.dimensionality();
+    m_nb_sol_pts = sf.nb_sol_pts();
+    m_nb_flx_pts = sf.nb_flx_pts();
+    m_interpolate = local_1d->interpolate_sol_to_flx;
+    m_derivative_in_flx_pts = local_1d->interpolate_grad_sol_to_flx;
+    m_derivative_in_sol_pts = local_1d->interpolate_grad_sol_to_sol;
+
+    // 1D indices of every solution point
+    std::map< std::vector<Uint>, Uint > sol_pt_of_index;
+    std::vector< std::vector<Uint> > sol_pt_index(m_nb_sol_pts, std::vector<Uint>(m_ndims));
+    for (Uint sol_pt=0; sol_pt<m_nb_sol_pts; ++sol_pt)
+    {
+      for (Uint d=0; d<m_ndims; ++d)
+        sol_pt_index[sol_pt][d] = index_1d(local_1d->sol_pts, sf.sol_pts()(sol_pt,d));
+      sol_pt_of_index[sol_pt_index[sol_pt]] = sol_pt;
+    }
+
+    // Lines of solution points in every direction, starting from the points with index 0 in that direction
+    m_sol_lines.resize(m_ndims);
+    m_flx_lines.resize(m_ndims);
+    std::vector< std::map< std::vector<Uint>, Uint > > line_of_index(m_ndims);
+    for (Uint d=0; d<m_ndims; ++d)
+    {
+      for (Uint sol_pt=0; sol_pt<m_nb_sol_pts; ++sol_pt)
+      {
+        if (sol_pt_index[sol_pt][d] != 0)
+          continue;
+        std::vector<Uint> index = sol_pt_index[sol_pt];
+        line_of_index[d][index] = m_sol_lines[d].size();
+        m_sol_lines[d].push_back(std::vector<Uint>(local_1d->nb_sol_pts));
+        for (Uint k=0; k<local_1d->nb_sol_pts; ++k)
+        {
+          index[d] = k;
+          m_sol_lines[d].back()[k] = sol_pt_of_index[index];
+        }
+      }
+      m_flx_lines[d].resize(m_sol_lines[d].size(), std::vector<Uint>(local_1d->nb_flx_pts));
+    }
+
+    // Every flux point lies on the line of solution points in its direction
+    for (Uint flx_pt=0; flx_pt<m_nb_flx_pts; ++flx_pt)
+    {
+      const Uint d = sf.flx_pt_dirs(flx_pt)[0];
+      std::vector<Uint> index(m_ndims,0);
+      for (Uint e=0; e<m_ndims; ++e)
+      {
+        if (e != d)
+          index[e] = index_1d(local_1d->sol_pts, sf.flx_pts()(flx_pt,e));
+      }
+      m_flx_lines[d][line_of_index[d][index]][index_1d(local_1d->flx_pts, sf.flx_pts()(flx_pt,d))] = flx_pt;
+    }
+    return true;
+  }
+
+  /// Interpolate values from the solution points to the flux points of a batch of elements
+  /// @param [in]  nb_elems  number of elements in the batch
+  /// @param [in]  nb_vars   number of variables per point
+  /// @param [in]  sol       values in the solution points
+  /// @param [out] flx       values in the flux points
+  void interpolate(const Uint nb_elems, const Uint nb_vars, const Real* sol, Real* flx) const
+  {
+    for (Uint d=0; d<m_ndims; ++d)
+      apply(m_interpolate, m_sol_lines[d], m_nb_sol_pts, m_flx_lines[d], m_nb_flx_pts, 1, 0, nb_elems, nb_vars, sol, flx);
+  }
+
+  /// Derivatives to the local coordinates of values in the solution points, in the flux points of a batch of elements
+  /// @param [in]  nb_elems  number of elements in the batch
+  /// @param [in]  nb_vars   number of variables per point
+  /// @param [in]  sol       values in the solution points
+  /// @param [out] grad      derivatives in the flux points, stored as grad[((elem*nb_flx_pts + flx_pt)*ndims + dim)*nb_vars + var]
+  void gradient(const Uint nb_elems, const Uint nb_vars, const Real* sol, Real* grad) const
+  {
+    // Derivatives along the lines of every direction, in the solution points
+    const Uint size = nb_elems*m_nb_sol_pts*nb_vars;
+    m_derivatives.resize(m_ndims*size);
+    for (Uint e=0; e<m_ndims; ++e)
+      apply(m_derivative_in_sol_pts, m_sol_lines[e], m_nb_sol_pts, m_sol_lines[e], m_nb_sol_pts, 1, 0, nb_elems, nb_vars, sol, &m_derivatives[e*size]);
+
+    for (Uint d=0; d<m_ndims; ++d)
+    {
+      for (Uint e=0; e<m_ndims; ++e)
+      {
+        if (e == d) // derivative along the line of the flux point
+          apply(m_derivative_in_flx_pts, m_sol_lines[d], m_nb_sol_pts, m_flx_lines[d], m_nb_flx_pts, m_ndims, e, nb_elems, nb_vars, sol, grad);
+        else        // derivative across the line, interpolated along it
+          apply(m_interpolate, m_sol_lines[d], m_nb_sol_pts, m_flx_lines[d], m_nb_flx_pts, m_ndims, e, nb_elems, nb_vars, &m_derivatives[e*size], grad);
+      }
+    }
+  }
+
+  Uint ndims() const { return m_ndims; }
+  Uint nb_sol_pts() const { return m_nb_sol_pts; }
+  Uint nb_flx_pts() const { return m_nb_flx_pts; }
+
+private:
+
+  /// Index of a coordinate in a set of 1D points
+  static Uint index_1d(const RealVector& pts, const Real coord)
+  {
+    Uint idx = 0;
+    for (Uint k=1; k<pts.size(); ++k)
+    {
+      if (std::abs(pts[k]-coord) < std::abs(pts[idx]-coord))
+        idx = k;
+    }
+    return idx;
+  }
+
+  /// Apply a 1D operator to the lines of one direction, of all elements and variables at once
+  /// @param [in]  to_stride  number of values stored per point and variable in to, e.g. ndims for gradients
+  /// @param [in]  to_offset  position of the computed value among these
+  void apply(const RealMatrix& op,
+             const std::vector< std::vector<Uint> >& from_lines, const Uint from_size,
+             const std::vector< std::vector<Uint> >& to_lines, const Uint to_size,
+             const Uint to_stride, const Uint to_offset,
+             const Uint nb_elems, const Uint nb_vars, const Real* from, Real* to) const
+  {
+    const Uint nb_lines = from_lines.size();
+    m_from.resize(op.cols(), nb_elems*nb_lines*nb_vars);
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      for (Uint line=0; line<nb_lines; ++line)
+      {
+        const Uint col = (elem*nb_lines+line)*nb_vars;
+        for (Uint k=0; k<from_lines[line].size(); ++k)
+        {
+          const Real* values = from + (elem*from_size + from_lines[line][k])*nb_vars;
+          for (Uint var=0; var<nb_vars; ++var)
+            m_from(k,col+var) = values[var];
+        }
+      }
+    }
+
+    m_to.noalias() = op * m_from;
+
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      for (Uint line=0; line<nb_lines; ++line)
+      {
+        const Uint col = (elem*nb_lines+line)*nb_vars;
+        for (Uint k=0; k<to_lines[line].size(); ++k)
+        {
+          Real* values = to + ((elem*to_size + to_lines[line][k])*to_stride + to_offset)*nb_vars;
+          for (Uint var=0; var<nb_vars; ++var)
+            values[var] = m_to(k,col+var);
+        }
+      }
+    }
+  }
+
+private:
+
+  Uint m_ndims;
+  Uint m_nb_sol_pts;
+  Uint m_nb_flx_pts;
+
+  /// 1D operators: values in flux points, derivatives in flux points, derivatives in solution points
+  RealMatrix m_interpolate;
+  RealMatrix m_derivative_in_flx_pts;
+  RealMatrix m_derivative_in_sol_pts;
+
+  /// For every direction, the solution points and the flux points of every line
+  std::vector< std::vector< std::vector<Uint> > > m_sol_lines;
+  std::vector< std::vector< std::vector<Uint> > > m_flx_lines;
+
+  /// Work storage
+  mutable RealMatrix m_from;
+  mutable RealMatrix m_to;
+  mutable std::vector<Real> m_derivatives;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // sdm
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_sdm_SumFactorization_hpp
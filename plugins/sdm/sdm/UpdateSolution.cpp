@@ -70,13 +70,7 @@ void UpdateSolution::execute()
   Field& update_coeff = *m_update_coeff;
   Field& jacobian_determinant = *m_jacobian_determinant;
 
-  for (Uint i=0; i<solution.size(); ++i)
-  {
-    for (Uint j=0; j<solution.row_size(); ++j)
-    {
-      solution[i][j] += update_coeff[i][0] * residual[i][j];
-    }
-  }
+  solution.axpy(1., update_coeff, residual);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -16,6 +16,7 @@
 #include "sdm/navierstokes/LibNavierStokes.hpp"
 #include "Physics/NavierStokes/Cons2D.hpp"
 #include "Physics/NavierStokes/Roe2D.hpp"
+#include "RiemannSolvers/RiemannSolvers/EulerKernels.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -85,6 +86,32 @@ public:
     wave_speed = eigenvalues.cwiseAbs().maxCoeff();
   }
 
+  /// Roe fluxes of all points of a face at once, with the batched kernel of RiemannSolvers::Roe
+  virtual void compute_numerical_fluxes(const Uint nb_pts, std::vector<boost::shared_ptr< PhysData > >& left, std::vector<boost::shared_ptr< PhysData > >& right,
+                                        const Real* unit_normals, Real* fluxes, Real* wave_speeds)
+  {
+    batch_left.resize(NEQS*nb_pts);
+    batch_right.resize(NEQS*nb_pts);
+    batch_eigenvalues.resize(NEQS*nb_pts);
+    for (Uint pt=0; pt<nb_pts; ++pt)
+    {
+      for (Uint v=0; v<NEQS; ++v)
+      {
+        batch_left[v*nb_pts+pt]  = left[pt]->solution[v];
+        batch_right[v*nb_pts+pt] = right[pt]->solution[v];
+      }
+    }
+
+    RiemannSolvers::EulerKernels<NDIM>::roe(nb_pts, p.gamma, &batch_left[0], &batch_right[0], unit_normals, fluxes, &batch_eigenvalues[0]);
+
+    for (Uint pt=0; pt<nb_pts; ++pt)
+    {
+      wave_speeds[pt] = 0.;
+      for (Uint v=0; v<NEQS; ++v)
+        wave_speeds[pt] = std::max(wave_speeds[pt], std::abs(batch_eigenvalues[v*nb_pts+pt]));
+    }
+  }
+
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 private:
 
@@ -106,6 +133,10 @@ private:
   PHYS::MODEL::JacM right_eigenvectors;
   PHYS::MODEL::JacM left_eigenvectors;
   PHYS::MODEL::JacM  abs_jacobian;
+
+  std::vector<Real> batch_left;
+  std::vector<Real> batch_right;
+  std::vector<Real> batch_eigenvalues;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,144 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Benchmark of the cf3::sdm convective term"
+
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/OptionList.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Domain.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/MeshTransformer.hpp"
+
+#include "physics/PhysModel.hpp"
+
+#include "solver/ModelUnsteady.hpp"
+#include "solver/Time.hpp"
+
+#include "sdm/DomainDiscretization.hpp"
+#include "sdm/InitialConditions.hpp"
+#include "sdm/PrepareMesh.hpp"
+#include "sdm/SDSolver.hpp"
+#include "sdm/Tags.hpp"
+#include "sdm/Term.hpp"
+
+#include "Tools/Testing/BenchmarkReport.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver;
+using namespace cf3::sdm;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Arguments: number of cells in x and y, solution order, number of residual evaluations to time
+struct ConvectionBenchmarkFixture
+{
+  ConvectionBenchmarkFixture() :
+    m_argc(boost::unit_test::framework::master_test_suite().argc),
+    m_argv(boost::unit_test::framework::master_test_suite().argv)
+  {
+  }
+
+  Uint argument(const int i, const Uint default_value) const
+  {
+    return i < m_argc ? boost::lexical_cast<Uint>(m_argv[i]) : default_value;
+  }
+
+  int    m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( ConvectionBenchmarkSuite, ConvectionBenchmarkFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( euler_convection )
+{
+  std::vector<Uint> nb_cells(2);
+  nb_cells[XX] = argument(1, 200u);
+  nb_cells[YY] = argument(2, 200u);
+  const Uint solution_order = argument(3, 3u);
+  const Uint nb_calls = argument(4, 10u);
+
+  ModelUnsteady& model = *Core::instance().root().create_component<ModelUnsteady>("model");
+  Time& time = model.create_time();
+  SDSolver& solver = *model.create_solver("cf3.sdm.SDSolver").handle<SDSolver>();
+  physics::PhysModel& physics = model.create_physics("cf3.physics.NavierStokes.NavierStokes2D");
+  Domain& domain = model.create_domain("domain");
+
+  Mesh& mesh = *domain.create_component<Mesh>("mesh");
+  boost::shared_ptr< MeshGenerator > generate_mesh = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","meshgenerator");
+  generate_mesh->options().configure_option("mesh",mesh.uri());
+  generate_mesh->options().configure_option("nb_cells",nb_cells);
+  generate_mesh->options().configure_option("lengths",std::vector<Real>(2,10.));
+  generate_mesh->options().configure_option("offsets",std::vector<Real>(2,-5.));
+  generate_mesh->execute();
+  build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.LoadBalance","load_balance")->transform(mesh);
+
+  physics.options().configure_option("gamma",1.4);
+  physics.options().configure_option("R",287.05);
+
+  solver.options().configure_option(sdm::Tags::time(),time.handle<Time>());
+  solver.options().configure_option(sdm::Tags::mesh(),mesh.handle<Mesh>());
+  solver.options().configure_option(sdm::Tags::solution_vars(),std::string("cf3.physics.NavierStokes.Cons2D"));
+  solver.options().configure_option(sdm::Tags::solution_order(),solution_order);
+  solver.prepare_mesh().execute();
+
+  // Uniform flow at Mach 0.5
+  std::vector<std::string> functions;
+  functions.push_back("1.");
+  functions.push_back("0.5*sqrt(1.4*287.05*300.)");
+  functions.push_back("0.");
+  functions.push_back("287.05*300./0.4 + 0.5*0.25*1.4*287.05*300.");
+  solver.initial_conditions().create_initial_condition("uniform").options().configure_option("functions",functions);
+  solver.initial_conditions().execute();
+
+  Term& convection = solver.domain_discretization().create_term("cf3.sdm.navierstokes.Convection2D","convection");
+
+  Tools::Testing::BenchmarkReport report("sdm-convection");
+  report.add_parameter("nb_cells_x",nb_cells[XX]);
+  report.add_parameter("nb_cells_y",nb_cells[YY]);
+  report.add_parameter("solution_order",solution_order);
+
+  report.time("convective_term", boost::bind(&Term::execute, &convection), nb_calls);
+
+  report.write();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,195 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::sdm::ImplicitNewtonKrylov"
+
+#include <cmath>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Link.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "math/LSS/System.hpp"
+
+#include "solver/Model.hpp"
+#include "solver/Time.hpp"
+
+#include "mesh/Domain.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/FieldManager.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+#include "mesh/MeshTransformer.hpp"
+
+#include "sdm/SDSolver.hpp"
+#include "sdm/Term.hpp"
+#include "sdm/DomainDiscretization.hpp"
+#include "sdm/TimeStepping.hpp"
+#include "sdm/IterativeSolver.hpp"
+#include "sdm/Tags.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver;
+using namespace cf3::sdm;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct sdm_Implicit_Fixture
+{
+  /// common setup for each test case
+  sdm_Implicit_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// common tear-down for each test case
+  ~sdm_Implicit_Fixture()
+  {
+  }
+
+  Field& field(SDSolver& solver, const std::string& tag)
+  {
+    return *Handle<Field>( follow_link( solver.field_manager().get_child(tag) ) );
+  }
+
+  /// Advance the solver by one time step
+  void step(SDSolver& solver)
+  {
+    solver.time_stepping().options().configure_option("max_iteration",solver.time().iter()+1);
+    solver.execute();
+  }
+
+  /// @return a counter of the matrix that stores the preconditioner
+  Uint matrix_count(SDSolver& solver, const std::string& name)
+  {
+    math::LSS::System& lss = *Handle<math::LSS::System>(solver.iterative_solver().get_child("LSS"));
+    return lss.matrix()->properties().value<Uint>(name);
+  }
+
+  /// common values accessed by all tests goes here
+  int    m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( sdm_Implicit_TestSuite, sdm_Implicit_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  PE::Comm::instance().init(m_argc,m_argv);
+  Core::instance().environment().options().configure_option("log_level", (Uint)WARNING);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( backward_euler_linear_advection )
+{
+  Model& model = *Core::instance().root().create_component<Model>("model");
+  model.setup("cf3.sdm.SDSolver","cf3.physics.Scalar.Scalar1D");
+  SDSolver& solver = *model.solver().handle<SDSolver>();
+  Domain& domain = model.domain();
+
+  solver.options().configure_option("iterative_solver",std::string("cf3.sdm.ImplicitNewtonKrylov"));
+  IterativeSolver& implicit = solver.iterative_solver();
+  implicit.options().configure_option("max_newton_iterations",5u);
+  implicit.options().configure_option("newton_tolerance",1e-8);
+  implicit.options().configure_option("krylov_tolerance",1e-10);
+  implicit.options().configure_option("max_krylov_iterations",200u);
+  implicit.options().configure_option("gmres_restart",100u);
+
+  Mesh& mesh = *domain.create_component<Mesh>("mesh");
+  SimpleMeshGenerator& generate_mesh = *domain.create_component<SimpleMeshGenerator>("generate_mesh");
+  generate_mesh.options().configure_option("mesh",mesh.uri());
+  generate_mesh.options().configure_option("nb_cells",std::vector<Uint>(1,20u));
+  generate_mesh.options().configure_option("lengths",std::vector<Real>(1,10.));
+  generate_mesh.options().configure_option("bdry",true);
+  generate_mesh.execute();
+  build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.LoadBalance","load_balance")->transform(mesh);
+
+  solver.options().configure_option(sdm::Tags::mesh(),mesh.handle<Mesh>());
+  solver.options().configure_option(sdm::Tags::solution_vars(),std::string("cf3.physics.Scalar.LinearAdv1D"));
+  solver.options().configure_option(sdm::Tags::solution_order(),2u);
+  solver.prepare_mesh().execute();
+
+  solver::Action& init_gauss = solver.initial_conditions().create_initial_condition("gaussian");
+  init_gauss.options().configure_option("functions",std::vector<std::string>(1,"sigma:=0.5;mu:=5.;exp(-(x-mu)^2/(2*sigma^2))"));
+  solver.initial_conditions().execute();
+
+  Term& convection = solver.domain_discretization().create_term("cf3.sdm.scalar.LinearAdvection1D","convection",std::vector<URI>(1,mesh.topology().uri()));
+  convection.options().configure_option("advection_speed",std::vector<Real>(1,2.));
+
+  solver.time().options().configure_option("time_step",100.);
+  solver.time().options().configure_option("end_time",100.);
+  solver.time_stepping().options().configure_option("cfl",std::string("2."));
+
+  Field& U = field(solver,sdm::Tags::solution());
+  Field& R = field(solver,sdm::Tags::residual());
+  Field& H = field(solver,sdm::Tags::update_coeff());
+
+  // Residual of the initial solution, which is the nonlinear residual G(U) = (U-Un)/H - R(U) at the start
+  solver.domain_discretization().execute();
+  const std::vector<Real> U0(U.array().data(), U.array().data()+U.array().num_elements());
+  Real initial_norm = 0.;
+  for (Uint i=0; i<U.size(); ++i)
+    if ( ! U.is_ghost(i) )
+      initial_norm = std::max(initial_norm, std::abs(R[i][0]));
+  BOOST_CHECK_GT(initial_norm, 0.);
+
+  for (Uint s=0; s<2; ++s)
+  {
+    const std::vector<Real> Un(U.array().data(), U.array().data()+U.array().num_elements());
+    step(solver);
+    BOOST_CHECK_LT(implicit.properties().value<Uint>("newton_iterations"), 5u);
+    BOOST_CHECK_GT(implicit.properties().value<Uint>("krylov_iterations"), 0u);
+
+    // Newton converged: the backward Euler equations hold for the new solution
+    solver.domain_discretization().execute();
+    Real norm = 0.;
+    for (Uint i=0; i<U.size(); ++i)
+      if ( ! U.is_ghost(i) )
+        norm = std::max(norm, std::abs( (U[i][0]-Un[i])/H[i][0] - R[i][0] ));
+    BOOST_CHECK_LT(norm, 1e-6*initial_norm);
+
+    // The preconditioner is factored once per time step, and only applied in the GMRES iterations
+    BOOST_CHECK_EQUAL(matrix_count(solver,"solver_builds"), 1u);
+    BOOST_CHECK_EQUAL(matrix_count(solver,"preconditioner_recomputes"), s);
+    BOOST_CHECK_GT(matrix_count(solver,"preconditioner_reuses"), 0u);
+  }
+
+  // the solution changed
+  Real change = 0.;
+  for (Uint i=0; i<U.size(); ++i)
+    change = std::max(change, std::abs(U[i][0]-U0[i]));
+  BOOST_CHECK_GT(change, 1e-3);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
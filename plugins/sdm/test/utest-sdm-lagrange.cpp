@@ -26,6 +26,7 @@
 #include "sdm/Tags.hpp"
 
 #include "sdm/LagrangeLocally1D.hpp"
+#include "sdm/Reconstructions.hpp"
 
 
 using namespace boost::assign;
@@ -228,6 +229,79 @@ void test_convection(const SF& sf)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Compare the sum-factorized reconstructions to flux points with the reconstruction of every point separately
+void test_sum_factorization(const boost::shared_ptr<sdm::ShapeFunction>& shape_function)
+{
+  const Handle<sdm::ShapeFunction const> sf(shape_function);
+  const Uint nb_vars = 3;
+  const Uint ndims = sf->dimensionality();
+
+  RealMatrix solution(sf->nb_sol_pts(),nb_vars);
+  for (Uint pt=0; pt<sf->nb_sol_pts(); ++pt)
+    for (Uint var=0; var<nb_vars; ++var)
+      solution(pt,var) = std::sin(1.+pt+0.3*var);
+
+  ReconstructToFluxPoints reconstruct;
+  reconstruct.build_coefficients(sf);
+  BOOST_CHECK(reconstruct.sum_factorization() != NULL);
+  RealMatrix in_flx_pts(sf->nb_flx_pts(),nb_vars);
+  reconstruct(solution,in_flx_pts);
+
+  GradientReconstructToFluxPoints gradient;
+  gradient.build_coefficients(sf);
+  BOOST_CHECK(gradient.sum_factorization() != NULL);
+  std::vector<RealMatrix> grad_in_flx_pts(sf->nb_flx_pts(),RealMatrix(nb_vars,ndims));
+  gradient(solution,grad_in_flx_pts);
+
+  RealRowVector value(nb_vars);
+  for (Uint flx_pt=0; flx_pt<sf->nb_flx_pts(); ++flx_pt)
+  {
+    reconstruct[flx_pt](solution,value);
+    for (Uint var=0; var<nb_vars; ++var)
+      BOOST_CHECK_SMALL(in_flx_pts(flx_pt,var)-value[var],1e-12);
+    for (Uint d=0; d<ndims; ++d)
+    {
+      gradient[flx_pt][d](solution,value);
+      for (Uint var=0; var<nb_vars; ++var)
+        BOOST_CHECK_SMALL(grad_in_flx_pts[flx_pt](var,d)-value[var],1e-10);
+    }
+  }
+
+  // A batch of several elements, each with its own values, gives the reconstruction of every element separately
+  const Uint nb_elems = 4;
+  const SumFactorization& batch = *reconstruct.sum_factorization();
+  std::vector<Real> batch_solution(nb_elems*sf->nb_sol_pts()*nb_vars);
+  for (Uint e=0; e<nb_elems; ++e)
+    for (Uint pt=0; pt<sf->nb_sol_pts(); ++pt)
+      for (Uint var=0; var<nb_vars; ++var)
+        batch_solution[(e*sf->nb_sol_pts()+pt)*nb_vars+var] = std::cos(0.7*e+pt+0.3*var);
+  std::vector<Real> batch_values(nb_elems*sf->nb_flx_pts()*nb_vars);
+  batch.interpolate(nb_elems,nb_vars,&batch_solution[0],&batch_values[0]);
+  std::vector<Real> batch_gradients(nb_elems*sf->nb_flx_pts()*ndims*nb_vars);
+  gradient.sum_factorization()->gradient(nb_elems,nb_vars,&batch_solution[0],&batch_gradients[0]);
+
+  for (Uint e=0; e<nb_elems; ++e)
+  {
+    for (Uint pt=0; pt<sf->nb_sol_pts(); ++pt)
+      for (Uint var=0; var<nb_vars; ++var)
+        solution(pt,var) = batch_solution[(e*sf->nb_sol_pts()+pt)*nb_vars+var];
+    for (Uint flx_pt=0; flx_pt<sf->nb_flx_pts(); ++flx_pt)
+    {
+      reconstruct[flx_pt](solution,value);
+      for (Uint var=0; var<nb_vars; ++var)
+        BOOST_CHECK_SMALL(batch_values[(e*sf->nb_flx_pts()+flx_pt)*nb_vars+var]-value[var],1e-12);
+      for (Uint d=0; d<ndims; ++d)
+      {
+        gradient[flx_pt][d](solution,value);
+        for (Uint var=0; var<nb_vars; ++var)
+          BOOST_CHECK_SMALL(batch_gradients[((e*sf->nb_flx_pts()+flx_pt)*ndims+d)*nb_vars+var]-value[var],1e-10);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_FIXTURE_TEST_SUITE( sdm_solver_TestSuite, sdm_MPITests_Fixture )
 
 //////////////////////////////////////////////////////////////////////////////
@@ -304,6 +378,25 @@ BOOST_AUTO_TEST_CASE( test_P5_quad )
   test_convection( *allocate_component< QuadLagrange1D<5> >("sf") );
 }
 
+BOOST_AUTO_TEST_CASE( test_P6_quad )
+{
+  test_convection( *allocate_component< QuadLagrange1D<6> >("sf") );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_sum_factorization_line )
+{
+  test_sum_factorization( allocate_component< LineLagrange1D<4> >("sf") );
+}
+
+BOOST_AUTO_TEST_CASE( test_sum_factorization_quad )
+{
+  test_sum_factorization( allocate_component< QuadLagrange1D<1> >("sf") );
+  test_sum_factorization( allocate_component< QuadLagrange1D<3> >("sf") );
+  test_sum_factorization( allocate_component< QuadLagrange1D<6> >("sf") );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_CASE( finalize_mpi )
@@ -0,0 +1,244 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::sdm::MultiRateTimeStepping"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/assign/list_of.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Link.hpp"
+#include "common/BasicExceptions.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "solver/Model.hpp"
+#include "solver/Time.hpp"
+
+#include "mesh/Domain.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/FieldManager.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+#include "mesh/MeshTransformer.hpp"
+
+#include "sdm/SDSolver.hpp"
+#include "sdm/Term.hpp"
+#include "sdm/DomainDiscretization.hpp"
+#include "sdm/TimeStepping.hpp"
+#include "sdm/IterativeSolver.hpp"
+#include "sdm/Tags.hpp"
+
+using namespace boost::assign;
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver;
+using namespace cf3::sdm;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct sdm_MultiRate_Fixture
+{
+  /// common setup for each test case
+  sdm_MultiRate_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// common tear-down for each test case
+  ~sdm_MultiRate_Fixture()
+  {
+  }
+
+  /// Linear advection of a gaussian with P0 (finite volume) on the line [0,10],
+  /// with cells of size 0.25 left of x=2.5 and cells of size 0.75 right of it.
+  SDSolver& create_solver(const std::string& name, const Uint nb_levels, const Uint solution_order = 1u)
+  {
+    Model& model = *Core::instance().root().create_component<Model>(name);
+    model.setup("cf3.sdm.SDSolver","cf3.physics.Scalar.Scalar1D");
+    SDSolver& solver = *model.solver().handle<SDSolver>();
+    Domain& domain = model.domain();
+
+    solver.options().configure_option("iterative_solver",std::string("cf3.sdm.MultiRateTimeStepping"));
+    solver.iterative_solver().options().configure_option("nb_levels",nb_levels);
+
+    Mesh& mesh = *domain.create_component<Mesh>("mesh");
+    SimpleMeshGenerator& generate_mesh = *domain.create_component<SimpleMeshGenerator>("generate_mesh");
+    generate_mesh.options().configure_option("mesh",mesh.uri());
+    generate_mesh.options().configure_option("nb_cells",std::vector<Uint>(1,20u));
+    generate_mesh.options().configure_option("lengths",std::vector<Real>(1,10.));
+    generate_mesh.options().configure_option("bdry",true);
+    generate_mesh.execute();
+
+    Field& coordinates = mesh.geometry_fields().coordinates();
+    for (Uint n=0; n<coordinates.size(); ++n)
+    {
+      const Real x = coordinates[n][XX];
+      coordinates[n][XX] = x < 5. ? 0.5*x : 1.5*x-5.;
+    }
+
+    build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.LoadBalance","load_balance")->transform(mesh);
+    solver.options().configure_option(sdm::Tags::mesh(),mesh.handle<Mesh>());
+    solver.options().configure_option(sdm::Tags::solution_vars(),std::string("cf3.physics.Scalar.LinearAdv1D"));
+    solver.options().configure_option(sdm::Tags::solution_order(),solution_order);
+    solver.prepare_mesh().execute();
+
+    solver::Action& init_gauss = solver.initial_conditions().create_initial_condition("gaussian");
+    init_gauss.options().configure_option("functions",std::vector<std::string>(1,"sigma:=0.5;mu:=5.;exp(-(x-mu)^2/(2*sigma^2))"));
+    solver.initial_conditions().execute();
+
+    Term& convection = solver.domain_discretization().create_term("cf3.sdm.scalar.LinearAdvection1D","convection",std::vector<URI>(1,mesh.topology().uri()));
+    convection.options().configure_option("advection_speed",std::vector<Real>(1,2.));
+
+    solver.time().options().configure_option("time_step",100.);
+    solver.time().options().configure_option("end_time",100.);
+    solver.time_stepping().options().configure_option("cfl",std::string("0.5"));
+    return solver;
+  }
+
+  Field& field(SDSolver& solver, const std::string& tag)
+  {
+    return *Handle<Field>( follow_link( solver.field_manager().get_child(tag) ) );
+  }
+
+  /// Advance the solver by one time step
+  void step(SDSolver& solver)
+  {
+    solver.time_stepping().options().configure_option("max_iteration",solver.time().iter()+1);
+    solver.execute();
+  }
+
+  /// @return the integral of the P0 solution over all owned cells
+  Real integral(const Field& solution)
+  {
+    Real loc_integral = 0.;
+    boost_foreach(const Handle<Entities>& entities, solution.entities_range())
+    {
+      if ( is_null(entities->handle<Cells>()) )
+        continue;
+      const Space& space = solution.space(*entities);
+      for (Uint elem=0; elem<entities->size(); ++elem)
+      {
+        if (entities->is_ghost(elem))
+          continue;
+        const Real volume = entities->element_type().volume(entities->geometry_space().get_coordinates(elem));
+        loc_integral += volume * solution[space.connectivity()[elem][0]][0];
+      }
+    }
+    Real glb_integral;
+    PE::Comm::instance().all_reduce(PE::plus(), &loc_integral, 1, &glb_integral);
+    return glb_integral;
+  }
+
+  /// common values accessed by all tests goes here
+  int    m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( sdm_MultiRate_TestSuite, sdm_MultiRate_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  PE::Comm::instance().init(m_argc,m_argv);
+  Core::instance().environment().options().configure_option("log_level", (Uint)WARNING);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( one_level_is_forward_euler )
+{
+  SDSolver& solver = create_solver("forward_euler",1u);
+  Field& U = field(solver,sdm::Tags::solution());
+  Field& R = field(solver,sdm::Tags::residual());
+
+  const std::vector<Real> U0(U.array().data(), U.array().data()+U.array().num_elements());
+
+  step(solver);
+  BOOST_CHECK_EQUAL(solver.actions().get_child("compute_update_coefficient")->properties().value<Uint>("nb_substeps"), 1u);
+  const Real dt = solver.time().dt();
+  BOOST_CHECK_GT(dt, 0.);
+  const std::vector<Real> U1(U.array().data(), U.array().data()+U.array().num_elements());
+
+  // The residual of the initial solution gives the forward Euler step
+  std::copy(U0.begin(), U0.end(), U.array().data());
+  solver.domain_discretization().execute();
+  for (Uint i=0; i<U.size(); ++i)
+  {
+    if (U.is_ghost(i))
+      continue;
+    BOOST_CHECK_EQUAL(U1[i], U0[i] + dt*R[i][0]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( two_levels_conserve )
+{
+  SDSolver& solver = create_solver("conservation",2u);
+  Field& U = field(solver,sdm::Tags::solution());
+  Field& H = field(solver,sdm::Tags::update_coeff());
+
+  const Real initial_integral = integral(U);
+  BOOST_CHECK_GT(initial_integral, 0.);
+
+  for (Uint i=0; i<10; ++i)
+  {
+    step(solver);
+
+    // both levels are used: the fine cells step twice within one time step of the coarse cells
+    BOOST_CHECK_EQUAL(solver.actions().get_child("compute_update_coefficient")->properties().value<Uint>("nb_substeps"), 2u);
+    Real min_H = solver.time().dt();
+    Real max_H = 0.;
+    for (Uint pt=0; pt<H.size(); ++pt)
+    {
+      min_H = std::min(min_H, H[pt][0]);
+      max_H = std::max(max_H, H[pt][0]);
+    }
+    BOOST_CHECK_CLOSE(max_H, 2.*min_H, 1e-10);
+    BOOST_CHECK_CLOSE(max_H, solver.time().dt(), 1e-10);
+
+    BOOST_CHECK_CLOSE(integral(U), initial_integral, 1e-10);
+  }
+  BOOST_CHECK_GT(solver.time().current_time(), 0.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( high_order_is_rejected )
+{
+  SDSolver& solver = create_solver("high_order",2u,2u);
+  BOOST_CHECK_THROW(step(solver), SetupError);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,7 @@
 #include "common/PE/CommWrapper.hpp"
 #include "common/PE/CommWrapperMArray.hpp"
 #include "common/PE/CommPattern.hpp"
+#include "common/PE/PersistentExchange.hpp"
 #include "common/PE/debug.hpp"
 #include "common/Group.hpp"
 
@@ -212,6 +213,121 @@ BOOST_AUTO_TEST_CASE( commpattern_mainstream )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( commpattern_nonblocking_synchronization )
+{
+  // general constants in this routine
+  const int nproc=PE::Comm::instance().size();
+  const int irank=PE::Comm::instance().rank();
+
+  // commpattern
+  boost::shared_ptr<CommPattern> pecp_ptr = allocate_component<CommPattern>("CommPattern");
+  CommPattern& pecp = *pecp_ptr;
+
+  // setup gid & rank
+  std::vector<Uint> gid;
+  std::vector<Uint> rank;
+  setupGidAndRank(gid,rank);
+  pecp.insert("gid",gid,1,false);
+
+  // additional arrays for testing
+  std::vector<int> v1;
+  for(int i=0;i<6*nproc;i++) v1.push_back(-((irank+1)*1000+i+1));
+  pecp.insert("v1",v1,1,true);
+  std::vector<double> v2;
+  for(int i=0;i<12*nproc;i++) v2.push_back((double)((irank+1)*1000+i+1));
+  pecp.insert("v2",v2,2,true);
+
+  pecp.setup(Handle<CommWrapper>(pecp.get_child("gid")),rank);
+
+  // both exchanges are in flight at the same time, and are finished in the opposite order
+  pecp.synchronize_start("v1");
+  pecp.synchronize_start("v2");
+  BOOST_CHECK_THROW(pecp.synchronize_start("v1"), IllegalCall);
+  pecp.synchronize_finish("v2");
+  pecp.synchronize_finish("v1");
+
+  // finishing without a pending exchange is harmless
+  pecp.synchronize_finish("v1");
+
+  // check results, which must be the same as with the blocking synchronization
+  Uint idx=0;
+  Uint i;
+  for (i=0; i<  nproc; i++, idx++ ) BOOST_CHECK_EQUAL( v1[i], (int)(-((((i-0*nproc)/1)+1)*1000+idx+1)) );
+  for (   ; i<3*nproc; i++, idx++ ) BOOST_CHECK_EQUAL( v1[i], (int)(-((((i-1*nproc)/2)+1)*1000+idx+1)) );
+  for (   ; i<6*nproc; i++, idx++ ) BOOST_CHECK_EQUAL( v1[i], (int)(-((((i-3*nproc)/3)+1)*1000+idx+1)) );
+  idx=0;
+  for (i=0; i< 2*nproc; i++, idx++) BOOST_CHECK_EQUAL( v2[i], (double)((((i-0*nproc)/2)+1)*1000+idx+1) );
+  for (   ; i< 6*nproc; i++, idx++) BOOST_CHECK_EQUAL( v2[i], (double)((((i-2*nproc)/4)+1)*1000+idx+1) );
+  for (   ; i<12*nproc; i++, idx++) BOOST_CHECK_EQUAL( v2[i], (double)((((i-6*nproc)/6)+1)*1000+idx+1) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( commpattern_persistent_exchange )
+{
+  // general constants in this routine
+  const int nproc=PE::Comm::instance().size();
+  const int irank=PE::Comm::instance().rank();
+
+  // commpattern
+  boost::shared_ptr<CommPattern> pecp_ptr = allocate_component<CommPattern>("CommPattern");
+  CommPattern& pecp = *pecp_ptr;
+
+  // setup gid & rank
+  std::vector<Uint> gid;
+  std::vector<Uint> rank;
+  setupGidAndRank(gid,rank);
+  pecp.insert("gid",gid,1,false);
+
+  std::vector<int> v1(6*nproc);
+  pecp.insert("v1",v1,1,true);
+  std::vector<double> v2(12*nproc);
+  pecp.insert("v2",v2,2,true);
+
+  // each setup changes the revision, which the exchange checks to know if its maps are still valid
+  const Uint revision = pecp.revision();
+  pecp.setup(Handle<CommWrapper>(pecp.get_child("gid")),rank);
+  BOOST_CHECK_EQUAL(pecp.revision(), revision+1);
+
+  // gid is not synchronized and must be skipped
+  std::vector< Handle<CommWrapper> > wrappers;
+  wrappers.push_back(Handle<CommWrapper>(pecp.get_child("gid")));
+  wrappers.push_back(Handle<CommWrapper>(pecp.get_child("v1")));
+  wrappers.push_back(Handle<CommWrapper>(pecp.get_child("v2")));
+
+  boost::shared_ptr<PersistentExchange> exchange = allocate_component<PersistentExchange>("Exchange");
+  exchange->setup(pecp,wrappers);
+  BOOST_CHECK(exchange->is_valid());
+  BOOST_CHECK(exchange->nb_neighbours() <= nproc);
+
+  // the same exchange is reused for several steps, with different data each time
+  for (int step=0; step<3; step++)
+  {
+    for(int i=0;i<6*nproc;i++) v1[i]=-((irank+1)*1000+i+1+step);
+    for(int i=0;i<12*nproc;i++) v2[i]=(double)((irank+1)*1000+i+1+step);
+
+    exchange->start();
+    BOOST_CHECK_THROW(exchange->start(), IllegalCall);
+    exchange->finish();
+
+    Uint idx=0;
+    Uint i;
+    for (i=0; i<  nproc; i++, idx++ ) BOOST_CHECK_EQUAL( v1[i], (int)(-((((i-0*nproc)/1)+1)*1000+idx+1+step)) );
+    for (   ; i<3*nproc; i++, idx++ ) BOOST_CHECK_EQUAL( v1[i], (int)(-((((i-1*nproc)/2)+1)*1000+idx+1+step)) );
+    for (   ; i<6*nproc; i++, idx++ ) BOOST_CHECK_EQUAL( v1[i], (int)(-((((i-3*nproc)/3)+1)*1000+idx+1+step)) );
+    idx=0;
+    for (i=0; i< 2*nproc; i++, idx++) BOOST_CHECK_EQUAL( v2[i], (double)((((i-0*nproc)/2)+1)*1000+idx+1+step) );
+    for (   ; i< 6*nproc; i++, idx++) BOOST_CHECK_EQUAL( v2[i], (double)((((i-2*nproc)/4)+1)*1000+idx+1+step) );
+    for (   ; i<12*nproc; i++, idx++) BOOST_CHECK_EQUAL( v2[i], (double)((((i-6*nproc)/6)+1)*1000+idx+1+step) );
+  }
+
+  // resizing registered data invalidates the exchange
+  v1.push_back(0);
+  BOOST_CHECK(!exchange->is_valid());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( commpattern_external_synchronization )
 {
 /*
@@ -9,6 +9,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
+
 #include <boost/assign/list_of.hpp>
 
 #include "math/VectorialFunction.hpp"
@@ -81,6 +83,43 @@ BOOST_AUTO_TEST_CASE( function_2 )
 
 }
 
+BOOST_AUTO_TEST_CASE( evaluate_batch )
+{
+  std::vector<std::string> functions = boost::assign::list_of
+    ("x*y - 2*z^2 + 3")
+    ("sin(pi*x)*exp(-y) + sqrt(x*x+y*y)")
+    ("if(x<0.5, y, if(z>0.2, x*z, -y)) + max(x,z)")
+    ("(x<0.3)&(y>0.4) | (z>=0.9)")
+    // domain errors give 0, like the parser, except in the branch of if() that is not taken
+    ("sqrt(-1)")
+    ("x/0")
+    ("if(x<0.5, 1/(y-0.5), sqrt(x-0.5)) + log(z-0.2)");
+  cf3::math::VectorialFunction f;
+  f.functions(functions);
+  f.variables("x,y,z");
+  f.parse();
+
+  // more points than one block, and one more value per point than variables and functions
+  const Uint nb_points = 1000;
+  const Uint nb_funcs = functions.size();
+  std::vector<Real> vars(nb_points*4), results(nb_points*(nb_funcs+1));
+  for(Uint i = 0; i < vars.size(); ++i)
+    vars[i] = std::fmod(0.37*i, 1.);
+
+  f.evaluate_batch(nb_points, &vars[0], 4, &results[0], nb_funcs+1, 2);
+
+  RealVector r(nb_funcs);
+  for(Uint pt = 0; pt < nb_points; ++pt)
+  {
+    cf3::math::VectorialFunction::VariablesT u(vars.begin()+pt*4, vars.begin()+pt*4+3);
+    f.evaluate(u, r);
+    for(Uint i = 0; i < nb_funcs; ++i)
+      BOOST_CHECK_SMALL( results[pt*(nb_funcs+1)+i] - r[i], 1e-12 );
+    BOOST_CHECK_EQUAL( results[pt*(nb_funcs+1)+4], 0. );
+    BOOST_CHECK_EQUAL( results[pt*(nb_funcs+1)+5], 0. );
+  }
+}
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
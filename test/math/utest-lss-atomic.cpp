@@ -17,6 +17,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include "common/Log.hpp"
+#include "common/PropertyList.hpp"
 #include "math/LSS/System.hpp"
 #include "math/VariablesDescriptor.hpp"
 
@@ -61,6 +62,8 @@ struct LSSAtomicFixture
     if(m_argc != 2)
       throw common::ParsingFailed(FromHere(), "Failed to parse command line arguments: expected one argument: builder name for the matrix");
     matrix_builder = m_argv[1];
+    if (matrix_builder.find("cf3.math.LSS.Native") == 0)
+      solvertype = "Native";
   }
 
   /// common tear-down for each test case
@@ -101,6 +104,30 @@ struct LSSAtomicFixture
     sys.create(cp,neq,node_connectivity,starting_indices);
   }
 
+  /// solve the system again from the same initial guess, check the solution and return how the solver was updated
+  /// @return the increase of the solver_builds, preconditioner_recomputes and preconditioner_reuses properties of the matrix
+  std::vector<Uint> solve_again(LSS::System& sys, common::PE::CommPattern& cp, const std::vector<Real>& refvals)
+  {
+    const common::PropertyList& props = sys.matrix()->properties();
+    std::vector<Uint> counts(3);
+    counts[0] = props.value<Uint>("solver_builds");
+    counts[1] = props.value<Uint>("preconditioner_recomputes");
+    counts[2] = props.value<Uint>("preconditioner_reuses");
+
+    sys.solution()->reset(1.);
+    sys.solve();
+    std::vector<Real> vals;
+    sys.solution()->debug_data(vals);
+    for (int i=0; i<vals.size(); i++)
+      if (cp.isUpdatable()[i/neq])
+        BOOST_CHECK_CLOSE( vals[i], refvals[gid[i/neq]*neq], 1e-8);
+
+    counts[0] = props.value<Uint>("solver_builds") - counts[0];
+    counts[1] = props.value<Uint>("preconditioner_recomputes") - counts[1];
+    counts[2] = props.value<Uint>("preconditioner_reuses") - counts[2];
+    return counts;
+  }
+
   /// main solver selector
   std::string solvertype;
   std::string matrix_builder;
@@ -843,7 +870,7 @@ BOOST_AUTO_TEST_CASE( test_complete_system )
 
   // test swapping rhs and sol
   boost::shared_ptr<LSS::System> sys2(common::allocate_component<LSS::System>("sys2"));
-  sys->options().option("matrix_builder").change_value(matrix_builder);
+  sys2->options().option("matrix_builder").change_value(matrix_builder);
   build_system(*sys2,cp);
   BOOST_CHECK_EQUAL(sys2->is_created(),true);
   BOOST_CHECK_EQUAL(sys2->solvertype(),solvertype);
@@ -945,6 +972,8 @@ BOOST_AUTO_TEST_CASE( solve_system )
     trilinos_xml.close();
   }
   common::PE::Comm::instance().barrier();
+  if (solvertype == "Native")
+    sys->matrix()->options().configure_option("tolerance", 1e-13);
 
   // set intital values and boundary conditions
   sys->matrix()->reset(-0.5);
@@ -971,6 +1000,133 @@ BOOST_AUTO_TEST_CASE( solve_system )
     if (cp.isUpdatable()[i/neq])
       BOOST_CHECK_CLOSE( vals[i], refvals[gid[i/neq]*neq], 1e-8);
 
+
+  // solve again with each reuse policy, checking how the solver is updated
+  // counts are the number of solver builds, preconditioner recomputes and preconditioner reuses of one solve
+  LSS::Matrix& mat = *sys->matrix();
+  BOOST_CHECK_EQUAL(mat.properties().value<Uint>("solver_builds"), 1u);
+  std::vector<Uint> counts;
+
+  // none: build for every solve
+  counts = solve_again(*sys, cp, refvals);
+  BOOST_CHECK_EQUAL(counts[0], 1u); BOOST_CHECK_EQUAL(counts[1], 0u); BOOST_CHECK_EQUAL(counts[2], 0u);
+
+  // symbolic: build once after changing the policy, then recompute the preconditioner for every solve
+  mat.options().configure_option("solver_reuse", std::string("symbolic"));
+  counts = solve_again(*sys, cp, refvals);
+  BOOST_CHECK_EQUAL(counts[0], 1u); BOOST_CHECK_EQUAL(counts[1], 0u); BOOST_CHECK_EQUAL(counts[2], 0u);
+  for (Uint isolve=0; isolve<2; ++isolve)
+  {
+    counts = solve_again(*sys, cp, refvals);
+    BOOST_CHECK_EQUAL(counts[0], 0u); BOOST_CHECK_EQUAL(counts[1], 1u); BOOST_CHECK_EQUAL(counts[2], 0u);
+  }
+
+  // interval: build, reuse once, recompute, reuse once
+  mat.options().configure_option("rebuild_interval", 2u);
+  mat.options().configure_option("solver_reuse", std::string("interval"));
+  counts = solve_again(*sys, cp, refvals);
+  BOOST_CHECK_EQUAL(counts[0], 1u); BOOST_CHECK_EQUAL(counts[1], 0u); BOOST_CHECK_EQUAL(counts[2], 0u);
+  counts = solve_again(*sys, cp, refvals);
+  BOOST_CHECK_EQUAL(counts[0], 0u); BOOST_CHECK_EQUAL(counts[1], 0u); BOOST_CHECK_EQUAL(counts[2], 1u);
+  counts = solve_again(*sys, cp, refvals);
+  BOOST_CHECK_EQUAL(counts[0], 0u); BOOST_CHECK_EQUAL(counts[1], 1u); BOOST_CHECK_EQUAL(counts[2], 0u);
+  counts = solve_again(*sys, cp, refvals);
+  BOOST_CHECK_EQUAL(counts[0], 0u); BOOST_CHECK_EQUAL(counts[1], 0u); BOOST_CHECK_EQUAL(counts[2], 1u);
+
+  // iterations: identical solves take the same number of iterations, so the preconditioner is kept
+  mat.options().configure_option("iteration_growth", 1.5);
+  mat.options().configure_option("solver_reuse", std::string("iterations"));
+  counts = solve_again(*sys, cp, refvals);
+  BOOST_CHECK_EQUAL(counts[0], 1u); BOOST_CHECK_EQUAL(counts[1], 0u); BOOST_CHECK_EQUAL(counts[2], 0u);
+  for (Uint isolve=0; isolve<2; ++isolve)
+  {
+    counts = solve_again(*sys, cp, refvals);
+    BOOST_CHECK_EQUAL(counts[0], 0u); BOOST_CHECK_EQUAL(counts[1], 0u); BOOST_CHECK_EQUAL(counts[2], 1u);
+  }
+
+  // iterations: with an allowed growth below one, any solve after the first one exceeds it,
+  // so the preconditioner is recomputed on the solve that follows
+  mat.options().configure_option("iteration_growth", 0.5);
+  mat.options().configure_option("solver_reuse", std::string("iterations"));
+  counts = solve_again(*sys, cp, refvals);
+  BOOST_CHECK_EQUAL(counts[0], 1u);
+  BOOST_CHECK_GT(mat.properties().value<Uint>("solver_iterations"), 0u);
+  counts = solve_again(*sys, cp, refvals);
+  BOOST_CHECK_EQUAL(counts[0], 0u); BOOST_CHECK_EQUAL(counts[1], 0u); BOOST_CHECK_EQUAL(counts[2], 1u);
+  counts = solve_again(*sys, cp, refvals);
+  BOOST_CHECK_EQUAL(counts[0], 0u); BOOST_CHECK_EQUAL(counts[1], 1u); BOOST_CHECK_EQUAL(counts[2], 0u);
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( solve_system_native_methods )
+{
+  // every Krylov method and preconditioner of the native backend, on one or more threads
+  if (solvertype != "Native")
+    return;
+
+  // same distribution as solve_system
+  if (irank==0)
+  {
+    gid += 0,1,2,3,4;
+    rank_updatable += 0,0,0,0,1;
+  } else {
+    gid += 3,4,5,6,7,8,9;
+    rank_updatable += 0,1,1,1,1,1,1;
+  }
+  boost::shared_ptr<common::PE::CommPattern> cp_ptr = common::allocate_component<common::PE::CommPattern>("commpattern");
+  common::PE::CommPattern& cp = *cp_ptr;
+  cp.insert("gid",gid,1,false);
+  cp.setup(Handle<common::PE::CommWrapper>(cp.get_child("gid")),rank_updatable);
+
+  if (irank==0)
+  {
+    node_connectivity += 0,1,0,1,2,1,2,3,2,3,4,3,4;
+    starting_indices += 0,2,5,8,11,13;
+  } else {
+    node_connectivity += 0,1,0,1,2,1,2,3,2,3,4,3,4,5,4,5,6,5,6;
+    starting_indices +=  0,2,5,8,11,14,17,19;
+  }
+  boost::shared_ptr<System> sys(common::allocate_component<System>("sys"));
+  sys->options().option("matrix_builder").change_value(matrix_builder);
+  sys->create(cp,2,node_connectivity,starting_indices);
+
+  // symmetric and strictly diagonally dominant, hence positive definite as CG requires
+  sys->matrix()->reset(-0.25);
+  sys->set_diagonal(std::vector<Real>(irank==0 ? 10 : 14, 4.));
+  sys->rhs()->reset(1.);
+  sys->matrix()->options().configure_option("tolerance", 1e-13);
+
+  // reference with the default GMRES and ILU0
+  sys->solution()->reset(0.);
+  sys->solve();
+  std::vector<Real> refvals;
+  sys->solution()->debug_data(refvals);
+
+  const std::string solvers[] = { "CG", "BiCGStab", "GMRES" };
+  const std::string preconditioners[] = { "None", "Jacobi", "ILU0" };
+  for (Uint isolver=0; isolver<3; ++isolver)
+  {
+    for (Uint iprec=0; iprec<3; ++iprec)
+    {
+      for (Uint nb_threads=1; nb_threads<=2; ++nb_threads)
+      {
+        BOOST_TEST_CHECKPOINT(solvers[isolver] << " with " << preconditioners[iprec] << " on " << nb_threads << " threads");
+        sys->matrix()->options().configure_option("solver", solvers[isolver]);
+        sys->matrix()->options().configure_option("preconditioner", preconditioners[iprec]);
+        sys->matrix()->options().configure_option("nb_threads", nb_threads);
+        sys->solution()->reset(0.);
+        sys->solve();
+        std::vector<Real> vals;
+        sys->solution()->debug_data(vals);
+        BOOST_CHECK_EQUAL(vals.size(), refvals.size());
+        for (int i=0; i<vals.size(); i++)
+          if (cp.isUpdatable()[i/neq])
+            BOOST_CHECK_CLOSE( vals[i], refvals[i], 1e-8);
+      }
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1063,6 +1219,8 @@ BOOST_AUTO_TEST_CASE( solve_system_blocked )
     trilinos_xml.close();
   }
   common::PE::Comm::instance().barrier();
+  if (solvertype == "Native")
+    sys->matrix()->options().configure_option("tolerance", 1e-13);
 
   // set intital values and boundary conditions
   sys->matrix()->reset(-0.5);
@@ -0,0 +1,273 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::DynamicLoadBalance"
+
+#include <cmath>
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Core.hpp"
+#include "common/PE/debug.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/actions/DynamicLoadBalance.hpp"
+#include "mesh/actions/LoadBalance.hpp"
+
+#include "mesh/MeshAdaptor.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+using namespace cf3::common::PE;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct TestDynamicLoadBalance_Fixture
+{
+  /// common setup for each test case
+  TestDynamicLoadBalance_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// common tear-down for each test case
+  ~TestDynamicLoadBalance_Fixture()
+  {
+  }
+
+  /// possibly common functions used on the tests below
+
+  /// @return the global indices of the cells owned by this rank
+  std::vector<Uint> owned_cells(const Mesh& mesh)
+  {
+    std::vector<Uint> cells;
+    boost_foreach(const Handle<Entities>& entities, mesh.elements())
+    {
+      if ( is_null(entities->handle<Cells>()) )
+        continue;
+      for (Uint e=0; e<entities->size(); ++e)
+      {
+        if ( ! entities->is_ghost(e) )
+          cells.push_back(entities->glb_idx()[e]);
+      }
+    }
+    return cells;
+  }
+
+  /// @return the total number of owned cells over all ranks
+  Uint nb_owned_cells(const Mesh& mesh)
+  {
+    Uint loc_nb_cells = owned_cells(mesh).size();
+    Uint glb_nb_cells;
+    Comm::instance().all_reduce(PE::plus(), &loc_nb_cells, 1, &glb_nb_cells);
+    return glb_nb_cells;
+  }
+
+  /// @return true if the field still holds the x-coordinate of every node
+  bool field_follows_nodes(const Field& field)
+  {
+    for (Uint n=0; n<field.size(); ++n)
+    {
+      if (field[n][0] != field.coordinates()[n][XX])
+        return false;
+    }
+    return true;
+  }
+
+  int m_argc;
+  char** m_argv;
+
+  /// common values accessed by all tests goes here
+  static Handle< Mesh > mesh;
+};
+
+Handle< Mesh > TestDynamicLoadBalance_Fixture::mesh = Core::instance().root().create_component<Mesh>("mesh");
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( TestDynamicLoadBalance_TestSuite, TestDynamicLoadBalance_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+  BOOST_CHECK_EQUAL(PE::Comm::instance().size(), 2u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( build )
+{
+  Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>("mesh_generator");
+  mesh_generator->options().configure_option("mesh",mesh->uri());
+  mesh_generator->options().configure_option("lengths",std::vector<Real>(2,10.));
+  std::vector<Uint> nb_cells(2);
+  nb_cells[XX] = 20u;
+  nb_cells[YY] = 4u;
+  mesh_generator->options().configure_option("nb_cells",nb_cells);
+  mesh_generator->generate();
+
+  Core::instance().root().create_component<LoadBalance>("load_balance")->transform(*mesh);
+
+  Field& field = mesh->geometry_fields().create_field("x");
+  for (Uint n=0; n<field.size(); ++n)
+    field[n][0] = field.coordinates()[n][XX];
+
+  BOOST_CHECK_EQUAL(nb_owned_cells(*mesh), 80u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( remove_overlap )
+{
+  MeshAdaptor mesh_adaptor(*mesh);
+  mesh_adaptor.prepare();
+  mesh_adaptor.remove_overlap();
+  mesh_adaptor.finish();
+
+  // only owned elements are left, and the fields are kept
+  boost_foreach(const Handle<Entities>& entities, mesh->elements())
+  {
+    for (Uint e=0; e<entities->size(); ++e)
+      BOOST_CHECK( ! entities->is_ghost(e) );
+  }
+  BOOST_CHECK_EQUAL(nb_owned_cells(*mesh), 80u);
+  BOOST_CHECK(field_follows_nodes(*Handle<Field>(mesh->geometry_fields().get_child("x"))));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( weighted_load_balance )
+{
+  // the cells owned by rank 0 are 4 times as heavy as the other cells, faces and nodes
+  const std::vector<Uint> loc_cells = owned_cells(*mesh);
+  std::vector< std::vector<Uint> > glb_cells;
+  Comm::instance().all_gather(loc_cells, glb_cells);
+  const std::set<Uint> heavy_cells(glb_cells[0].begin(), glb_cells[0].end());
+
+  std::vector<Uint> weights(mesh->elements().size(), 1u);
+  for (Uint c=0; c<weights.size(); ++c)
+  {
+    if ( Comm::instance().rank() == 0 && is_not_null(mesh->elements()[c]->handle<Cells>()) )
+      weights[c] = 4u;
+  }
+
+  LoadBalance& load_balance = *Handle<LoadBalance>(Core::instance().root().get_child("load_balance"));
+  load_balance.set_element_weights(weights);
+  load_balance.transform(*mesh);
+  load_balance.set_element_weights(std::vector<Uint>());
+
+  // fields are migrated together with the nodes
+  BOOST_CHECK_EQUAL(nb_owned_cells(*mesh), 80u);
+  BOOST_CHECK(field_follows_nodes(*Handle<Field>(mesh->geometry_fields().get_child("x"))));
+
+  // per rank: the owned heavy cells, all owned cells, and the weight of all owned objects
+  Uint loc_counts[3] = {0u, 0u, 0u};
+  boost_foreach(const Handle<Entities>& entities, mesh->elements())
+  {
+    const bool cells = is_not_null(entities->handle<Cells>());
+    for (Uint e=0; e<entities->size(); ++e)
+    {
+      if ( entities->is_ghost(e) )
+        continue;
+      const bool heavy = cells && heavy_cells.count(entities->glb_idx()[e]);
+      loc_counts[0] += heavy ? 1u : 0u;
+      loc_counts[1] += cells ? 1u : 0u;
+      loc_counts[2] += heavy ? 4u : 1u;
+    }
+  }
+  for (Uint n=0; n<mesh->geometry_fields().size(); ++n)
+  {
+    if ( ! mesh->geometry_fields().is_ghost(n) )
+      ++loc_counts[2];
+  }
+  std::vector<Uint> counts(3*Comm::instance().size());
+  Comm::instance().all_gather(loc_counts, 3, &counts[0]);
+
+  // the weight is balanced instead of the number of cells,
+  // so that the rank with more heavy cells owns fewer cells
+  const Real mean_weight = 0.5 * (counts[2] + counts[5]);
+  BOOST_CHECK_LT(std::abs(static_cast<Real>(counts[2]) - static_cast<Real>(counts[5])), 0.2*mean_weight);
+  if (counts[0] > counts[3])
+    BOOST_CHECK_LT(counts[1], counts[4]);
+  else if (counts[0] < counts[3])
+    BOOST_CHECK_GT(counts[1], counts[4]);
+  else
+    BOOST_CHECK_EQUAL(counts[1], counts[4]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( dynamic_load_balance )
+{
+  Field& field = *Handle<Field>(mesh->geometry_fields().get_child("x"));
+
+  Handle<MeshTransformer> init_field(Core::instance().root().create_component("init_field","cf3.mesh.actions.InitFieldFunction"));
+  init_field->options().configure_option("field",field.handle<Field>());
+  init_field->options().configure_option("functions",std::vector<std::string>(1,"x"));
+
+  DynamicLoadBalance& balancer = *Core::instance().root().create_component<DynamicLoadBalance>("dynamic_load_balance");
+  balancer.options().configure_option("timed_actions",std::vector<URI>(1,init_field->uri()));
+  balancer.options().configure_option("imbalance_threshold",0.5);
+  balancer.transform(*mesh);
+
+  const Uint nb_cells_before = owned_cells(*mesh).size();
+
+  // rank 0 does much more work than rank 1
+  const Uint nb_executions = Comm::instance().rank() == 0 ? 50u : 1u;
+  for (Uint i=0; i<nb_executions; ++i)
+    init_field->execute();
+
+  balancer.transform(*mesh);
+
+  BOOST_CHECK_EQUAL(nb_owned_cells(*mesh), 80u);
+  const Uint nb_cells_after = owned_cells(*mesh).size();
+
+#ifdef CF3_ENABLE_COMPONENT_TIMING
+  // the elements of the slow rank are given away
+  BOOST_CHECK_GT(balancer.properties().value<Real>("imbalance"), 0.5);
+  if (Comm::instance().rank() == 0)
+    BOOST_CHECK_LT(nb_cells_after, nb_cells_before);
+  else
+    BOOST_CHECK_GT(nb_cells_after, nb_cells_before);
+#else
+  BOOST_CHECK_EQUAL(balancer.properties().value<Real>("imbalance"), 0.);
+  BOOST_CHECK_EQUAL(nb_cells_after, nb_cells_before);
+#endif
+
+  BOOST_CHECK(field_follows_nodes(field));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Terminate )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
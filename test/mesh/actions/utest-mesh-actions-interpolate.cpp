@@ -17,6 +17,9 @@
 
 #include "mesh/actions/Interpolate.hpp"
 
+#include "mesh/InterpolationOperator.hpp"
+#include "mesh/Field.hpp"
+
 #include "mesh/MeshWriter.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/Region.hpp"
@@ -117,6 +120,67 @@ BOOST_AUTO_TEST_CASE( build )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( repeated_interpolation )
+{
+  Interpolate& interpolator = *Handle<Interpolate>(Core::instance().root().get_child("interpolator"));
+  Field& source = *Handle<Field>(Core::instance().root().access_component("rect/geometry/solution"));
+  Field& target = *Handle<Field>(Core::instance().root().access_component("line/geometry/solution"));
+
+  // The weights computed in the first interpolation are reused
+  InterpolationOperator& op = *Handle<InterpolationOperator>(interpolator.get_child("operator"));
+  BOOST_CHECK(op.is_built_for(source.dict(),target.coordinates()));
+
+  for (Uint factor=1; factor<=3; ++factor)
+  {
+    for(Uint i=0; i<source.size();++i)
+      source[i][0] = factor*source.coordinates()[i][XX];
+
+    interpolator.execute();
+
+    // The rectangle covers the first half of the line
+    for(Uint i=0; i<target.size();++i)
+    {
+      const Real x = target.coordinates()[i][XX];
+      if (x <= 10.)
+        BOOST_CHECK_CLOSE(target[i][0], factor*x, 1e-8);
+      else
+        BOOST_CHECK_EQUAL(target[i][0], 0.);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( moved_coordinates )
+{
+  Interpolate& interpolator = *Handle<Interpolate>(Core::instance().root().get_child("interpolator"));
+  Field& source = *Handle<Field>(Core::instance().root().access_component("rect/geometry/solution"));
+  Field& target = *Handle<Field>(Core::instance().root().access_component("line/geometry/solution"));
+  InterpolationOperator& op = *Handle<InterpolationOperator>(interpolator.get_child("operator"));
+
+  // Moving the nodes of the line in place invalidates the weights
+  Field& coordinates = target.dict().coordinates();
+  for(Uint i=0; i<coordinates.size();++i)
+    coordinates[i][XX] -= 1.;
+  BOOST_CHECK(!op.is_built_for(source.dict(),target.coordinates()));
+
+  for(Uint i=0; i<source.size();++i)
+    source[i][0] = source.coordinates()[i][XX];
+  interpolator.execute();
+  BOOST_CHECK(op.is_built_for(source.dict(),target.coordinates()));
+
+  for(Uint i=0; i<target.size();++i)
+  {
+    const Real x = target.coordinates()[i][XX];
+    if (x >= 0. && x <= 10.)
+      BOOST_CHECK_CLOSE(target[i][0]+1., x+1., 1e-8);
+    else
+      BOOST_CHECK_EQUAL(target[i][0], 0.);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( Terminate )
 {
   PE::Comm::instance().finalize();
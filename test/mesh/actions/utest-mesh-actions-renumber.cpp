@@ -0,0 +1,182 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::Renumber"
+
+#include <algorithm>
+#include <map>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/List.hpp"
+#include "common/Map.hpp"
+#include "common/OptionList.hpp"
+#include "common/CompressedTable.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/MeshTransformer.hpp"
+#include "mesh/Space.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct RenumberFixture
+{
+  RenumberFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// Value of the test function at a point
+  template <typename VectorT>
+  static Real function(const VectorT& x) { return x[XX] + 10.*x[YY]; }
+
+  /// Sorted global node indices of an element
+  static std::vector<Uint> element_nodes(const Entities& entities, const Uint e)
+  {
+    std::vector<Uint> nodes;
+    boost_foreach(const Uint n, entities.geometry_space().connectivity()[e])
+      nodes.push_back(entities.geometry_fields().glb_idx()[n]);
+    std::sort(nodes.begin(),nodes.end());
+    return nodes;
+  }
+
+  static RealVector centroid(const Entities& entities, const Uint e)
+  {
+    RealMatrix coordinates = entities.geometry_space().get_coordinates(e);
+    RealVector c(coordinates.cols());
+    entities.element_type().compute_centroid(coordinates,c);
+    return c;
+  }
+
+  int    m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( RenumberSuite, RenumberFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( renumber )
+{
+  const Uint nb_cells = 16;
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("mesh");
+  boost::shared_ptr< MeshGenerator > generate_mesh = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","meshgenerator");
+  generate_mesh->options().configure_option("nb_cells",std::vector<Uint>(DIM_2D,nb_cells));
+  generate_mesh->options().configure_option("lengths",std::vector<Real>(DIM_2D,1.));
+  generate_mesh->options().configure_option("mesh",mesh->uri());
+  generate_mesh->execute();
+
+  Dictionary& geometry = mesh->geometry_fields();
+  Field& node_field = geometry.create_field("node_field");
+  for (Uint n=0; n<geometry.size(); ++n)
+    node_field[n][0] = function(geometry.coordinates()[n]);
+
+  Dictionary& solution = mesh->create_discontinuous_space("solution","cf3.mesh.LagrangeP0");
+  Field& cell_field = solution.create_field("cell_field");
+  boost_foreach(const Handle<Entities>& entities, solution.entities_range())
+  {
+    for (Uint e=0; e<entities->size(); ++e)
+      cell_field[solution.space(*entities).connectivity()[e][0]][0] = function(centroid(*entities,e));
+  }
+
+  // Remember the mesh in terms of global indices
+  std::map<Uint, std::vector<Uint> > elements_before;
+  boost_foreach(const Handle<Entities>& entities, mesh->elements())
+    for (Uint e=0; e<entities->size(); ++e)
+      elements_before[entities->glb_idx()[e]] = element_nodes(*entities,e);
+
+  boost::shared_ptr< MeshTransformer > renumber = build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.Renumber","renumber");
+  renumber->transform(*mesh);
+
+  BOOST_CHECK(mesh->check_sanity());
+
+  // Fields moved with their nodes
+  BOOST_REQUIRE_EQUAL(node_field.size(), geometry.size());
+  for (Uint n=0; n<geometry.size(); ++n)
+  {
+    BOOST_CHECK_CLOSE(node_field[n][0], function(geometry.coordinates()[n]), 1e-10);
+    BOOST_CHECK_EQUAL(geometry.glb_to_loc()[geometry.glb_idx()[n]], n);
+  }
+  boost_foreach(const Handle<Entities>& entities, solution.entities_range())
+  {
+    for (Uint e=0; e<entities->size(); ++e)
+      BOOST_CHECK_CLOSE(cell_field[solution.space(*entities).connectivity()[e][0]][0], function(centroid(*entities,e)), 1e-10);
+  }
+
+  // Elements still connect the same nodes
+  Uint nb_elements = 0;
+  boost_foreach(const Handle<Entities>& entities, mesh->elements())
+  {
+    for (Uint e=0; e<entities->size(); ++e)
+    {
+      const std::vector<Uint> nodes = element_nodes(*entities,e);
+      const std::vector<Uint>& nodes_before = elements_before[entities->glb_idx()[e]];
+      BOOST_CHECK(nodes == nodes_before);
+      ++nb_elements;
+    }
+  }
+  BOOST_CHECK_EQUAL(nb_elements, elements_before.size());
+
+  // Node to element connectivity is rebuilt
+  for (Uint n=0; n<geometry.size(); ++n)
+  {
+    BOOST_CHECK(geometry.connectivity().row_size(n) > 0);
+    boost_foreach(const SpaceElem& elem, geometry.connectivity()[n])
+    {
+      Connectivity::ConstRow nodes = elem.comp->connectivity()[elem.idx];
+      BOOST_CHECK(std::find(nodes.begin(),nodes.end(),n) != nodes.end());
+    }
+  }
+
+  // On a regular grid of 2^k cells, consecutive cells along the Hilbert curve are neighbours
+  boost_foreach(const Cells& cells, find_components_recursively<Cells>(mesh->topology()))
+  {
+    BOOST_CHECK_EQUAL(cells.size(), nb_cells*nb_cells);
+    for (Uint e=1; e<cells.size(); ++e)
+      BOOST_CHECK_CLOSE((centroid(cells,e)-centroid(cells,e-1)).norm(), 1./nb_cells, 1e-8);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,147 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Benchmark of the synchronization of fields"
+
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/List.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+
+#include "common/PE/Comm.hpp"
+#include "common/PE/CommPattern.hpp"
+#include "common/PE/CommWrapper.hpp"
+#include "common/PE/PersistentExchange.hpp"
+
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+
+#include "Tools/Testing/BenchmarkReport.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Non-blocking synchronization, without any work in between
+void synchronize_start_finish(Field& field)
+{
+  field.synchronize_start();
+  field.synchronize_finish();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Arguments: number of cells in x and y, number of synchronizations to time
+struct SynchronizeBenchmarkFixture
+{
+  SynchronizeBenchmarkFixture() :
+    m_argc(boost::unit_test::framework::master_test_suite().argc),
+    m_argv(boost::unit_test::framework::master_test_suite().argv)
+  {
+  }
+
+  Uint argument(const int i, const Uint default_value) const
+  {
+    return i < m_argc ? boost::lexical_cast<Uint>(m_argv[i]) : default_value;
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( SynchronizeBenchmarkSuite, SynchronizeBenchmarkFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( synchronize )
+{
+  std::vector<Uint> nb_cells(2);
+  nb_cells[XX] = argument(1, 500u);
+  nb_cells[YY] = argument(2, 500u);
+  const Uint nb_calls = argument(3, 100u);
+
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("mesh");
+  boost::shared_ptr< MeshGenerator > generate_mesh = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","meshgenerator");
+  generate_mesh->options().configure_option("nb_cells",nb_cells);
+  generate_mesh->options().configure_option("lengths",std::vector<Real>(2,1.));
+  generate_mesh->options().configure_option("mesh",mesh->uri());
+  generate_mesh->execute();
+
+  // A system of 4 equations, and 2 scalars as for turbulence variables
+  Dictionary& geometry = mesh->geometry_fields();
+  Field& solution = geometry.create_field("solution","rho[scalar],rhoU[vector],rhoE[scalar]");
+  Field& k = geometry.create_field("k","k[scalar]");
+  Field& omega = geometry.create_field("omega","omega[scalar]");
+  for (Uint i=0; i<geometry.size(); ++i)
+  {
+    for (Uint j=0; j<solution.row_size(); ++j)
+      solution[i][j] = geometry.glb_idx()[i];
+    k[i][0] = omega[i][0] = geometry.glb_idx()[i];
+  }
+  solution.parallelize();
+  k.parallelize();
+  omega.parallelize();
+
+  std::vector< Handle<PE::CommWrapper> > wrappers;
+  wrappers.push_back(Handle<PE::CommWrapper>(solution.comm_pattern()->get_child(solution.name())));
+  wrappers.push_back(Handle<PE::CommWrapper>(solution.comm_pattern()->get_child(k.name())));
+  wrappers.push_back(Handle<PE::CommWrapper>(solution.comm_pattern()->get_child(omega.name())));
+  boost::shared_ptr<PE::PersistentExchange> exchange = allocate_component<PE::PersistentExchange>("exchange");
+  exchange->setup(*solution.comm_pattern(),wrappers);
+
+  Tools::Testing::BenchmarkReport report("mesh-synchronize");
+  report.add_parameter("nb_cells_x",nb_cells[XX]);
+  report.add_parameter("nb_cells_y",nb_cells[YY]);
+  report.add_parameter("nb_nodes",geometry.size());
+
+  report.time("synchronize", boost::bind(&Field::synchronize, &solution), nb_calls);
+  report.time("synchronize_start_finish", boost::bind(&synchronize_start_finish, boost::ref(solution)), nb_calls);
+  report.time("synchronize_3_fields", boost::bind(&PE::CommPattern::synchronize_all, solution.comm_pattern().get()), nb_calls);
+  report.time("persistent_exchange_3_fields", boost::bind(&PE::PersistentExchange::synchronize, exchange.get()), nb_calls);
+
+  report.write();
+
+  // Ghost values must still be the global index of their owner
+  for (Uint i=0; i<geometry.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(solution[i][0], geometry.glb_idx()[i]);
+    BOOST_CHECK_EQUAL(omega[i][0], geometry.glb_idx()[i]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,105 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for benchmarking the gmsh reader"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/OptionList.hpp"
+#include "common/BoostFilesystem.hpp"
+#include "common/Timer.hpp"
+#include "common/Table.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshReader.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Region.hpp"
+
+using namespace cf3;
+using namespace cf3::mesh;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct GmshBenchmarkFixture
+{
+  GmshBenchmarkFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  int    m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( GmshBenchmarkSuite, GmshBenchmarkFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init )
+{
+  Core::instance().initiate(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Reads every mesh given as argument a few times, and reports the fastest read
+BOOST_AUTO_TEST_CASE( read_meshes )
+{
+  const Uint nb_repeats = 3;
+
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.gmsh.Reader","meshreader");
+
+  Real total_time = 0.;
+  for (int i=1; i<m_argc; ++i)
+  {
+    const boost::filesystem::path path(m_argv[i]);
+    BOOST_REQUIRE(boost::filesystem::exists(path));
+    const Real megabytes = boost::filesystem::file_size(path) / (1024.*1024.);
+
+    Real best_time = 0.;
+    Uint nb_nodes = 0;
+    Uint nb_elements = 0;
+    for (Uint r=0; r<nb_repeats; ++r)
+    {
+      Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("mesh");
+      Timer timer;
+      meshreader->read_mesh_into(URI(path.string()), *mesh);
+      const Real time = timer.elapsed();
+      if (r == 0 || time < best_time)
+        best_time = time;
+      nb_nodes = mesh->geometry_fields().size();
+      nb_elements = mesh->topology().recursive_elements_count(true);
+      Core::instance().root().remove_component(*mesh);
+    }
+    total_time += best_time;
+
+    CFinfo << path.filename() << ": " << nb_nodes << " nodes, " << nb_elements << " elements, "
+           << megabytes << " MB read in " << best_time << " s (" << megabytes/best_time << " MB/s)" << CFendl;
+    std::cout << "<DartMeasurement name=\"" << path.filename().string() << " time\" type=\"numeric/double\">" << best_time << "</DartMeasurement>" << std::endl;
+  }
+  std::cout << "<DartMeasurement name=\"total time\" type=\"numeric/double\">" << total_time << "</DartMeasurement>" << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( terminate )
+{
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -23,6 +23,7 @@
 #include "common/List.hpp"
 #include "common/Table.hpp"
 #include "common/DynTable.hpp"
+#include "common/CompressedTable.hpp"
 #include "mesh/ElementType.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/Field.hpp"
@@ -701,6 +702,71 @@ BOOST_AUTO_TEST_CASE ( DynTable_test_hard )
 }
 
 
+BOOST_AUTO_TEST_CASE ( CompressedTable_test )
+{
+//  0:  0
+//  1:  ~
+//  2:  1 4 5
+//  3:  0 3
+  CompressedTable<Uint>& table = *root.create_component< CompressedTable<Uint> >("compressed_table");
+  BOOST_CHECK_EQUAL(table.size(), 0u);
+
+  std::vector< std::vector<Uint> > rows(4);
+  rows[0] = list_of(0);
+  rows[2] = list_of(1)(4)(5);
+  rows[3] = list_of(0)(3);
+
+  // two-pass construction, rows filled in arbitrary order
+  table.start_build(rows.size());
+  for (Uint i=0; i<rows.size(); ++i)
+    table.count(i,rows[i].size());
+  table.allocate();
+  for (Uint i=rows.size(); i>0; --i)
+    boost_foreach(const Uint v, rows[i-1])
+      table.push_back(i-1,v);
+  table.finish_build();
+
+  BOOST_CHECK_EQUAL(table.size(), 4u);
+  BOOST_CHECK_EQUAL(table.nb_values(), 6u);
+  BOOST_CHECK_EQUAL(table.row_size(1), 0u);
+  BOOST_CHECK(table[1].empty());
+  BOOST_CHECK_EQUAL(table.row_size(2), 3u);
+  BOOST_CHECK_EQUAL(table[2][0], 1u);
+  BOOST_CHECK_EQUAL(table[2][2], 5u);
+  BOOST_CHECK_EQUAL(table[3][1], 3u);
+
+  // rows are contiguous in memory
+  BOOST_CHECK_EQUAL(&table[3][0], &table[2][0] + 3);
+
+  Uint sum = 0;
+  boost_foreach(const Uint v, table[2])
+    sum += v;
+  BOOST_CHECK_EQUAL(sum, 10u);
+
+  // rows are writable
+  table[0][0] = 7;
+  BOOST_CHECK_EQUAL(table.values()[0], 7u);
+
+  // copy from nested vectors
+  CompressedTable<Uint>& copy = *root.create_component< CompressedTable<Uint> >("compressed_table_copy");
+  copy.assign(rows);
+  BOOST_CHECK_EQUAL(copy.size(), 4u);
+  BOOST_CHECK_EQUAL(copy[2][1], 4u);
+  BOOST_CHECK_EQUAL(copy.offsets()[4], 6u);
+
+  // resizing keeps existing rows and appends empty rows
+  copy.resize(6);
+  BOOST_CHECK_EQUAL(copy.size(), 6u);
+  BOOST_CHECK_EQUAL(copy.row_size(5), 0u);
+  BOOST_CHECK_EQUAL(copy[3][1], 3u);
+  copy.resize(3);
+  BOOST_CHECK_EQUAL(copy.nb_values(), 4u);
+
+  root.remove_component("compressed_table");
+  root.remove_component("compressed_table_copy");
+}
+
+
 BOOST_AUTO_TEST_CASE ( Mesh_test )
 {
   boost::shared_ptr<Component> root = boost::static_pointer_cast<Component>(allocate_component<Group>("root"));
@@ -0,0 +1,188 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the whole-field operations of cf3::mesh::Field"
+
+#include <cmath>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/Table.hpp"
+#include "common/OptionList.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Dictionary.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+
+using namespace cf3;
+using namespace cf3::mesh;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct FieldOperationsFixture
+{
+  FieldOperationsFixture() :
+    mesh(*Core::instance().root().create_component<Mesh>("mesh")),
+    U(mesh.geometry_fields().create_field("U","u[vector]")),
+    X(mesh.geometry_fields().create_field("X","x[vector]")),
+    D(mesh.geometry_fields().create_field("D","d[scalar]"))
+  {
+  }
+
+  ~FieldOperationsFixture()
+  {
+    Core::instance().root().remove_component(mesh);
+  }
+
+  /// Fill the fields with values that differ per entry
+  void fill()
+  {
+    for (Uint i=0; i<U.size(); ++i)
+    {
+      D[i][0] = 1. + 0.5*i;
+      for (Uint j=0; j<U.row_size(); ++j)
+      {
+        U[i][j] = 0.25*i - j;
+        X[i][j] = 1. / (1. + i + j);
+      }
+    }
+  }
+
+  Mesh& mesh;
+  Field& U;
+  Field& X;
+  Field& D;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( FieldOperationsSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_CASE( axpy_axpby_scale, FieldOperationsFixture )
+{
+  Tools::MeshGeneration::create_rectangle(mesh, 1., 1., 10, 10);
+  BOOST_REQUIRE(U.size() > 0);
+  BOOST_REQUIRE_EQUAL(U.row_size(), 2u);
+  fill();
+
+  Table<Real>::ArrayT expected = U.array();
+
+  U.axpy(2., X);
+  for (Uint i=0; i<U.size(); ++i)
+    for (Uint j=0; j<U.row_size(); ++j)
+      BOOST_CHECK_EQUAL(U[i][j], expected[i][j] + 2.*X[i][j]);
+
+  fill();
+  U.axpby(3., X, -0.5);
+  for (Uint i=0; i<U.size(); ++i)
+    for (Uint j=0; j<U.row_size(); ++j)
+      BOOST_CHECK_EQUAL(U[i][j], 3.*X[i][j] + -0.5*expected[i][j]);
+
+  fill();
+  U.axpy(0.1, D, X);
+  for (Uint i=0; i<U.size(); ++i)
+    for (Uint j=0; j<U.row_size(); ++j)
+      BOOST_CHECK_EQUAL(U[i][j], expected[i][j] + 0.1*D[i][0]*X[i][j]);
+
+  fill();
+  U.scale(4.);
+  for (Uint i=0; i<U.size(); ++i)
+    for (Uint j=0; j<U.row_size(); ++j)
+      BOOST_CHECK_EQUAL(U[i][j], 4.*expected[i][j]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_CASE( copy_norm_operators, FieldOperationsFixture )
+{
+  Tools::MeshGeneration::create_rectangle(mesh, 1., 1., 10, 10);
+  fill();
+
+  U.copy(X);
+  for (Uint i=0; i<U.size(); ++i)
+    for (Uint j=0; j<U.row_size(); ++j)
+      BOOST_CHECK_EQUAL(U[i][j], X[i][j]);
+
+  Real sum = 0.;
+  for (Uint i=0; i<X.size(); ++i)
+    for (Uint j=0; j<X.row_size(); ++j)
+      sum += X[i][j]*X[i][j];
+  BOOST_CHECK_CLOSE(X.norm(), std::sqrt(sum), 1e-12);
+
+  U = 2.;
+  U *= D;
+  for (Uint i=0; i<U.size(); ++i)
+    for (Uint j=0; j<U.row_size(); ++j)
+      BOOST_CHECK_EQUAL(U[i][j], 2.*D[i][0]);
+
+  U /= D;
+  U -= 1.;
+  U += X;
+  U -= X;
+  for (Uint i=0; i<U.size(); ++i)
+    for (Uint j=0; j<U.row_size(); ++j)
+      BOOST_CHECK_CLOSE(U[i][j], 1., 1e-12);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_CASE( padded_storage, FieldOperationsFixture )
+{
+  Tools::MeshGeneration::create_rectangle(mesh, 1., 1., 10, 10);
+  fill();
+  const Table<Real>::ArrayT initial = U.array();
+
+  // Without the option, the values stay in the table
+  D.unpack();
+  BOOST_CHECK(!D.is_unpacked());
+
+  U.options().configure_option("padded", true);
+  X.options().configure_option("padded", true);
+  U.unpack();
+  X.unpack();
+  BOOST_REQUIRE(U.is_unpacked());
+  BOOST_CHECK_EQUAL(U.padded_row_size(), 64/sizeof(Real));
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::size_t>(U.padded_data()) % 64, 0u);
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::size_t>(X.padded_data()) % 64, 0u);
+
+  // Operations between padded fields, and with the scalar field D in the table
+  U.axpy(2., X);
+  U.axpy(0.1, D, X);
+  U.scale(0.5);
+  U += 1.;
+  const Real padded_norm = U.norm();
+
+  // The table is only updated by pack()
+  BOOST_CHECK_EQUAL(U[3][1], initial[3][1]);
+  U.pack();
+  X.pack();
+  BOOST_CHECK(!U.is_unpacked());
+
+  Real sum = 0.;
+  for (Uint i=0; i<U.size(); ++i)
+  {
+    for (Uint j=0; j<U.row_size(); ++j)
+    {
+      BOOST_CHECK_CLOSE(U[i][j], 0.5*(initial[i][j] + 2.*X[i][j] + 0.1*D[i][0]*X[i][j]) + 1., 1e-12);
+      sum += U[i][j]*U[i][j];
+    }
+  }
+  BOOST_CHECK_CLOSE(padded_norm, std::sqrt(sum), 1e-12);
+  BOOST_CHECK_CLOSE(U.norm(), padded_norm, 1e-12);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,9 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Test module for cf3::mesh::gmsh::Reader"
 
+#include <fstream>
+
+#include <boost/cstdint.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include "common/Log.hpp"
@@ -30,6 +33,7 @@
 #include "common/List.hpp"
 #include "common/Table.hpp"
 #include "mesh/Dictionary.hpp"
+#include "mesh/Connectivity.hpp"
 
 using namespace std;
 using namespace boost;
@@ -63,6 +67,91 @@ struct gmshReaderMPITests_Fixture
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Write a value in binary form
+template <typename T>
+void write_binary(std::ofstream& file, const T value)
+{
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/// Write the same small mesh of 2 quads and 2 boundary lines, with a nodal field,
+/// in the ASCII and in the binary variant of the gmsh 2.2 format
+void write_ascii_and_binary_meshes()
+{
+  const Real coords[6][2] = { {0.,0.}, {0.5,0.}, {1.25,0.}, {0.,1.}, {0.5,1.1}, {1.25,1.} };
+  const boost::int32_t quads[2][4] = { {1,2,5,4}, {2,3,6,5} };
+  const boost::int32_t lines[2][2] = { {1,2}, {2,3} };
+
+  std::ofstream ascii("utest-mesh-gmsh-ascii.msh");
+  std::ofstream binary("utest-mesh-gmsh-binary.msh", std::ios_base::out | std::ios_base::binary);
+  ascii.precision(17);
+
+  ascii << "$MeshFormat\n2.2 0 8\n$EndMeshFormat\n";
+  binary << "$MeshFormat\n2.2 1 8\n";
+  write_binary<boost::int32_t>(binary,1);
+  binary << "\n$EndMeshFormat\n";
+
+  const std::string names = "$PhysicalNames\n2\n1 1 \"bottom\"\n2 2 \"domain\"\n$EndPhysicalNames\n";
+  ascii << names;
+  binary << names;
+
+  ascii << "$Nodes\n6\n";
+  binary << "$Nodes\n6\n";
+  for (Uint n=0; n<6; ++n)
+  {
+    ascii << n+1 << " " << coords[n][0] << " " << coords[n][1] << " 0\n";
+    write_binary<boost::int32_t>(binary,n+1);
+    write_binary<double>(binary,coords[n][0]);
+    write_binary<double>(binary,coords[n][1]);
+    write_binary<double>(binary,0.);
+  }
+  ascii << "$EndNodes\n";
+  binary << "\n$EndNodes\n";
+
+  ascii << "$Elements\n4\n";
+  binary << "$Elements\n4\n";
+  write_binary<boost::int32_t>(binary,3); // quads
+  write_binary<boost::int32_t>(binary,2); // 2 elements
+  write_binary<boost::int32_t>(binary,2); // 2 tags
+  for (Uint e=0; e<2; ++e)
+  {
+    ascii << e+1 << " 3 2 2 1 " << quads[e][0] << " " << quads[e][1] << " " << quads[e][2] << " " << quads[e][3] << "\n";
+    write_binary<boost::int32_t>(binary,e+1);
+    write_binary<boost::int32_t>(binary,2);
+    write_binary<boost::int32_t>(binary,1);
+    for (Uint n=0; n<4; ++n)
+      write_binary<boost::int32_t>(binary,quads[e][n]);
+  }
+  write_binary<boost::int32_t>(binary,1); // lines
+  write_binary<boost::int32_t>(binary,2); // 2 elements
+  write_binary<boost::int32_t>(binary,2); // 2 tags
+  for (Uint e=0; e<2; ++e)
+  {
+    ascii << e+3 << " 1 2 1 2 " << lines[e][0] << " " << lines[e][1] << "\n";
+    write_binary<boost::int32_t>(binary,e+3);
+    write_binary<boost::int32_t>(binary,1);
+    write_binary<boost::int32_t>(binary,2);
+    for (Uint n=0; n<2; ++n)
+      write_binary<boost::int32_t>(binary,lines[e][n]);
+  }
+  ascii << "$EndElements\n";
+  binary << "\n$EndElements\n";
+
+  const std::string data_header = "$NodeData\n1\n\"u\"\n1\n0.5\n3\n0\n1\n6\n";
+  ascii << data_header;
+  binary << data_header;
+  for (Uint n=0; n<6; ++n)
+  {
+    ascii << n+1 << " " << 0.1*n << "\n";
+    write_binary<boost::int32_t>(binary,n+1);
+    write_binary<double>(binary,0.1*n);
+  }
+  ascii << "$EndNodeData\n";
+  binary << "\n$EndNodeData\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_FIXTURE_TEST_SUITE( gmshReaderMPITests_TestSuite, gmshReaderMPITests_Fixture )
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -311,6 +400,56 @@ BOOST_AUTO_TEST_CASE( read_2d_mesh_mix_p1_out )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( read_binary )
+{
+  write_ascii_and_binary_meshes();
+
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.gmsh.Reader","meshreader");
+
+  Mesh& ascii = *Core::instance().root().create_component<Mesh>("mesh_ascii");
+  meshreader->read_mesh_into("utest-mesh-gmsh-ascii.msh",ascii);
+
+  Mesh& binary = *Core::instance().root().create_component<Mesh>("mesh_binary");
+  meshreader->read_mesh_into("utest-mesh-gmsh-binary.msh",binary);
+
+  BOOST_CHECK_EQUAL(binary.dimension(), 2u);
+  BOOST_REQUIRE_EQUAL(binary.geometry_fields().size(), 6u);
+  BOOST_REQUIRE_EQUAL(ascii.geometry_fields().size(), 6u);
+  for (Uint n=0; n<6; ++n)
+  {
+    BOOST_CHECK_EQUAL(binary.geometry_fields().glb_idx()[n], ascii.geometry_fields().glb_idx()[n]);
+    for (Uint d=0; d<2; ++d)
+      BOOST_CHECK_EQUAL(binary.geometry_fields().coordinates()[n][d], ascii.geometry_fields().coordinates()[n][d]);
+  }
+  BOOST_CHECK_EQUAL(ascii.geometry_fields().coordinates()[4][1], 1.1);
+
+  const char* regions[] = { "topology/domain", "topology/bottom" };
+  for (Uint r=0; r<2; ++r)
+  {
+    const Entities& ascii_elements = find_component<Entities>(*ascii.access_component_checked(regions[r]));
+    const Entities& binary_elements = find_component<Entities>(*binary.access_component_checked(regions[r]));
+    BOOST_CHECK_EQUAL(binary_elements.element_type().derived_type_name(), ascii_elements.element_type().derived_type_name());
+    BOOST_REQUIRE_EQUAL(binary_elements.size(), 2u);
+    BOOST_REQUIRE_EQUAL(ascii_elements.size(), 2u);
+    for (Uint e=0; e<2; ++e)
+    {
+      BOOST_CHECK_EQUAL(binary_elements.glb_idx()[e], ascii_elements.glb_idx()[e]);
+      for (Uint n=0; n<binary_elements.geometry_space().connectivity().row_size(); ++n)
+        BOOST_CHECK_EQUAL(binary_elements.geometry_space().connectivity()[e][n], ascii_elements.geometry_space().connectivity()[e][n]);
+    }
+  }
+
+  const Field& ascii_u = *Handle<Field const>(ascii.geometry_fields().get_child("u"));
+  const Field& binary_u = *Handle<Field const>(binary.geometry_fields().get_child("u"));
+  for (Uint n=0; n<6; ++n)
+  {
+    BOOST_CHECK_EQUAL(binary_u[n][0], ascii_u[n][0]);
+    BOOST_CHECK_EQUAL(binary_u[n][0], 0.1*ascii.geometry_fields().glb_idx()[n]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( finalize_mpi )
 {
   Core::instance().terminate();
@@ -216,6 +216,42 @@ BOOST_AUTO_TEST_CASE( Interpolation )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( StoredWeights )
+{
+  Mesh& source = *Core::instance().root().get_child("hextet")->handle<Mesh>();
+  Mesh& target = *Core::instance().root().get_child("quadtriag")->handle<Mesh>();
+  Field& s_nodebased = *source.geometry_fields().get_child("nodebased")->handle<Field>();
+  Field& t_nodebased = *target.geometry_fields().get_child("nodebased")->handle<Field>();
+  Field& t_nodebased_2 = *target.geometry_fields().get_child("nodebased_2")->handle<Field>();
+
+  boost::shared_ptr< Interpolator > stored = build_component_abstract_type<Interpolator>("cf3.mesh.LinearInterpolator","stored");
+  boost::shared_ptr< Interpolator > computed = build_component_abstract_type<Interpolator>("cf3.mesh.LinearInterpolator","computed");
+  computed->options().configure_option("store", false);
+  stored->construct_internal_storage(source);
+  computed->construct_internal_storage(source);
+
+  stored->interpolate_field_from_to(s_nodebased,t_nodebased);
+
+  // rows of the target that are not found in the source are not written
+  for (Uint idx=0; idx!=t_nodebased.size(); ++idx)
+    for (Uint var=0; var!=t_nodebased.row_size(); ++var)
+      t_nodebased[idx][var] = t_nodebased_2[idx][var] = 0.;
+
+  // other values of the source, interpolated with the stored weights and with weights computed again
+  for (Uint idx=0; idx!=s_nodebased.size(); ++idx)
+    for (Uint var=0; var!=s_nodebased.row_size(); ++var)
+      s_nodebased[idx][var] = 3.*s_nodebased[idx][var] - 1.;
+
+  stored->interpolate_field_from_to(s_nodebased,t_nodebased);
+  computed->interpolate_field_from_to(s_nodebased,t_nodebased_2);
+
+  for (Uint idx=0; idx!=t_nodebased.size(); ++idx)
+    for (Uint var=0; var!=t_nodebased.row_size(); ++var)
+      BOOST_CHECK_EQUAL(t_nodebased[idx][var], t_nodebased_2[idx][var]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
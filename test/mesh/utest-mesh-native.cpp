@@ -0,0 +1,214 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::mesh::native::Reader and Writer"
+
+#include <fstream>
+#include <iterator>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/OptionList.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/Table.hpp"
+#include "common/List.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/MeshReader.hpp"
+#include "mesh/MeshWriter.hpp"
+#include "mesh/MeshGenerator.hpp"
+
+using namespace cf3;
+using namespace cf3::mesh;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct NativeMeshFixture
+{
+  NativeMeshFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  int    m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( NativeMeshSuite, NativeMeshFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( write_and_read )
+{
+  const Uint dim = 2;
+
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("mesh");
+  boost::shared_ptr< MeshGenerator > generate_mesh = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","meshgenerator");
+  generate_mesh->options().configure_option("nb_cells",std::vector<Uint>(dim,10));
+  generate_mesh->options().configure_option("lengths",std::vector<Real>(dim,2.));
+  generate_mesh->options().configure_option("mesh",mesh->uri());
+  generate_mesh->execute();
+
+  // A field in the geometry dictionary and one in a discontinuous dictionary
+  Field& node_field = mesh->geometry_fields().create_field("node_field","u[vector]");
+  for (Uint i=0; i<node_field.size(); ++i)
+    for (Uint j=0; j<node_field.row_size(); ++j)
+      node_field[i][j] = mesh->geometry_fields().glb_idx()[i] + 0.5*j;
+
+  Dictionary& solution = mesh->create_discontinuous_space("solution","cf3.mesh.LagrangeP0");
+  Field& cell_field = solution.create_field("cell_field","p[scalar]");
+  for (Uint i=0; i<cell_field.size(); ++i)
+    cell_field[i][0] = 3.*solution.glb_idx()[i] + PE::Comm::instance().rank();
+
+  std::vector<URI> fields;
+  fields.push_back(node_field.uri());
+  fields.push_back(cell_field.uri());
+
+  boost::shared_ptr< MeshWriter > writer = build_component_abstract_type<MeshWriter>("cf3.mesh.native.Writer","meshwriter");
+  writer->options().configure_option("fields",fields);
+  writer->options().configure_option("mesh",mesh);
+  writer->options().configure_option("file",URI("utest-mesh-native.cf3mesh"));
+  writer->execute();
+
+  Handle<Mesh> restored = Core::instance().root().create_component<Mesh>("restored");
+  boost::shared_ptr< MeshReader > reader = build_component_abstract_type<MeshReader>("cf3.mesh.native.Reader","meshreader");
+  reader->read_mesh_into(URI("utest-mesh-native.cf3mesh"), *restored);
+
+  // Nodes are restored exactly, including the ghost nodes
+  const Dictionary& geometry = mesh->geometry_fields();
+  const Dictionary& restored_geometry = restored->geometry_fields();
+  BOOST_CHECK_EQUAL(restored->dimension(), mesh->dimension());
+  BOOST_REQUIRE_EQUAL(restored_geometry.size(), geometry.size());
+  for (Uint i=0; i<geometry.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(restored_geometry.glb_idx()[i], geometry.glb_idx()[i]);
+    BOOST_CHECK_EQUAL(restored_geometry.rank()[i], geometry.rank()[i]);
+    for (Uint d=0; d<dim; ++d)
+      BOOST_CHECK_EQUAL(restored_geometry.coordinates()[i][d], geometry.coordinates()[i][d]);
+  }
+
+  // Elements are restored in the same regions
+  std::vector< Handle<Entities> > entities, restored_entities;
+  boost_foreach(Entities& e, find_components_recursively<Entities>(mesh->topology()))
+    entities.push_back(e.handle<Entities>());
+  boost_foreach(Entities& e, find_components_recursively<Entities>(restored->topology()))
+    restored_entities.push_back(e.handle<Entities>());
+  BOOST_REQUIRE_EQUAL(restored_entities.size(), entities.size());
+  for (Uint k=0; k<entities.size(); ++k)
+  {
+    BOOST_CHECK_EQUAL(restored_entities[k]->uri().path().substr(restored->uri().path().size()),
+                      entities[k]->uri().path().substr(mesh->uri().path().size()));
+    BOOST_CHECK_EQUAL(restored_entities[k]->element_type().derived_type_name(), entities[k]->element_type().derived_type_name());
+    BOOST_REQUIRE_EQUAL(restored_entities[k]->size(), entities[k]->size());
+    const Connectivity& connectivity = entities[k]->geometry_space().connectivity();
+    const Connectivity& restored_connectivity = restored_entities[k]->geometry_space().connectivity();
+    for (Uint e=0; e<entities[k]->size(); ++e)
+    {
+      BOOST_CHECK_EQUAL(restored_entities[k]->glb_idx()[e], entities[k]->glb_idx()[e]);
+      BOOST_CHECK_EQUAL(restored_entities[k]->rank()[e], entities[k]->rank()[e]);
+      for (Uint n=0; n<connectivity.row_size(); ++n)
+        BOOST_CHECK_EQUAL(restored_connectivity[e][n], connectivity[e][n]);
+    }
+  }
+
+  // Fields
+  const Field& restored_node_field = *Handle<Field const>(restored_geometry.get_child("node_field"));
+  BOOST_REQUIRE_EQUAL(restored_node_field.row_size(), node_field.row_size());
+  for (Uint i=0; i<node_field.size(); ++i)
+    for (Uint j=0; j<node_field.row_size(); ++j)
+      BOOST_CHECK_EQUAL(restored_node_field[i][j], node_field[i][j]);
+
+  const Dictionary& restored_solution = *Handle<Dictionary const>(restored->get_child("solution"));
+  BOOST_CHECK(restored_solution.discontinuous());
+  const Field& restored_cell_field = *Handle<Field const>(restored_solution.get_child("cell_field"));
+  BOOST_REQUIRE_EQUAL(restored_cell_field.size(), cell_field.size());
+  for (Uint i=0; i<cell_field.size(); ++i)
+    BOOST_CHECK_EQUAL(restored_cell_field[i][0], cell_field[i][0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( aggregated_write )
+{
+  Handle<Mesh> mesh(Core::instance().root().get_child("mesh"));
+
+  std::vector<URI> fields;
+  fields.push_back(mesh->geometry_fields().get_child("node_field")->uri());
+  fields.push_back(mesh->get_child("solution")->get_child("cell_field")->uri());
+
+  // A single process writes all partitions, which must give the same file
+  boost::shared_ptr< MeshWriter > writer = build_component_abstract_type<MeshWriter>("cf3.mesh.native.Writer","meshwriter");
+  writer->options().configure_option("fields",fields);
+  writer->options().configure_option("mesh",mesh);
+  writer->options().configure_option("file",URI("utest-mesh-native-aggregated.cf3mesh"));
+  writer->options().configure_option("nb_aggregators",1u);
+  writer->execute();
+
+  if (PE::Comm::instance().rank() == 0)
+  {
+    std::ifstream file("utest-mesh-native.cf3mesh", std::ios_base::binary);
+    std::ifstream aggregated_file("utest-mesh-native-aggregated.cf3mesh", std::ios_base::binary);
+    const std::string contents( (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>() );
+    const std::string aggregated_contents( (std::istreambuf_iterator<char>(aggregated_file)), std::istreambuf_iterator<char>() );
+    BOOST_CHECK(!contents.empty());
+    BOOST_CHECK(contents == aggregated_contents);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( wrong_file )
+{
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("wrong");
+  boost::shared_ptr< MeshReader > reader = build_component_abstract_type<MeshReader>("cf3.mesh.native.Reader","meshreader");
+
+  if (PE::Comm::instance().rank() == 0)
+  {
+    std::ofstream file("utest-mesh-native-wrong.cf3mesh");
+    file << "$MeshFormat\n2 0 8\n$EndMeshFormat\n";
+  }
+  PE::Comm::instance().barrier();
+
+  BOOST_CHECK_THROW(reader->read_mesh_into(URI("utest-mesh-native-wrong.cf3mesh"), *mesh), common::FileFormatError);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,8 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Tests mesh octtree"
 
+#include <algorithm>
+
 #include <boost/test/unit_test.hpp>
 #include <boost/assign/list_of.hpp>
 #include <boost/assign/std/vector.hpp>
@@ -21,6 +23,8 @@
 #include "common/PE/Comm.hpp"
 #include "common/PE/debug.hpp"
 
+#include "math/Consts.hpp"
+
 #include "mesh/Mesh.hpp"
 #include "mesh/Region.hpp"
 #include "mesh/Elements.hpp"
@@ -29,6 +33,7 @@
 #include "mesh/MeshGenerator.hpp"
 #include "mesh/Octtree.hpp"
 #include "mesh/StencilComputerOcttree.hpp"
+#include "mesh/ElementTree.hpp"
 #include "mesh/MeshWriter.hpp"
 
 using namespace boost;
@@ -128,15 +133,17 @@ BOOST_AUTO_TEST_CASE( Octtree_creation )
   stencil_computer->compute_stencil(7, stencil);
   BOOST_CHECK_EQUAL(stencil.size(), 1u);
 
+  BOOST_CHECK_EQUAL(stencil[0], 7u);
+
   stencil_computer->options().configure_option("stencil_size", 2u );
   stencil_computer->compute_stencil(7, stencil);
-  BOOST_CHECK_EQUAL(stencil.size(), 9u);
+  BOOST_CHECK_EQUAL(stencil.size(), 2u);
 
   stencil_computer->options().configure_option("stencil_size", 10u );
   stencil_computer->compute_stencil(7, stencil);
-  BOOST_CHECK_EQUAL(stencil.size(), 20u);
+  BOOST_CHECK_EQUAL(stencil.size(), 10u);
 
-  stencil_computer->options().configure_option("stencil_size", 21u );
+  stencil_computer->options().configure_option("stencil_size", 30u );
   stencil_computer->compute_stencil(7, stencil);
   BOOST_CHECK_EQUAL(stencil.size(), 25u); // mesh size
 
@@ -146,6 +153,57 @@ BOOST_AUTO_TEST_CASE( Octtree_creation )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( ElementTree_search )
+{
+  Mesh& mesh = *Handle<Mesh>(Core::instance().root().get_child("mesh"));
+
+  ElementTree& tree = *mesh.create_component<ElementTree>("element_tree");
+  tree.options().configure_option("mesh", mesh.handle<Mesh>());
+  tree.options().configure_option("max_elems_per_leaf", 2u);
+  tree.build();
+  BOOST_CHECK_EQUAL(tree.nb_elems(), 25u);
+
+  // centroids of all elements, and a point outside the mesh
+  boost::multi_array<Real,2> coordinates(boost::extents[26][2]);
+  for (Uint j=0; j<5; ++j)
+  {
+    for (Uint i=0; i<5; ++i)
+    {
+      coordinates[5*j+i][XX] = 1.+2.*i;
+      coordinates[5*j+i][YY] = 1.+2.*j;
+    }
+  }
+  coordinates[25][XX] = 11.;  coordinates[25][YY] = 5.;
+
+  std::vector<Uint> found;
+  tree.find_elements(coordinates,found);
+  for (Uint e=0; e<25; ++e)
+    BOOST_CHECK_EQUAL(found[e], e);
+  BOOST_CHECK_EQUAL(found[25], cf3::math::Consts::uint_max());
+
+  // on the corner shared by 4 elements
+  RealVector2 coord;
+  coord << 4. , 4. ;
+  Handle< Elements > elements;
+  Uint idx(0);
+  BOOST_CHECK(tree.find_element(coord,elements,idx));
+  BOOST_CHECK(idx == 6u || idx == 7u || idx == 11u || idx == 12u);
+
+  // 4 direct neighbours of element 12 at equal distance, after itself
+  coord << 5. , 5. ;
+  std::vector<Uint> nearest;
+  tree.find_nearest_elements(coord,5,nearest);
+  BOOST_CHECK_EQUAL(nearest.size(), 5u);
+  BOOST_CHECK_EQUAL(nearest[0], 12u);
+  std::sort(nearest.begin()+1,nearest.end());
+  BOOST_CHECK_EQUAL(nearest[1], 7u);
+  BOOST_CHECK_EQUAL(nearest[2], 11u);
+  BOOST_CHECK_EQUAL(nearest[3], 13u);
+  BOOST_CHECK_EQUAL(nearest[4], 17u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( Octtree_parallel )
 {
   Handle< MeshGenerator > mesh_generator(Core::instance().root().get_child("mesh_generator"));
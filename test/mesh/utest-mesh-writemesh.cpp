@@ -7,6 +7,9 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Test module for cf3::mesh::tecplot::Writer"
 
+#include <fstream>
+#include <iterator>
+
 #include <boost/test/unit_test.hpp>
 
 #include "common/Log.hpp"
@@ -112,6 +115,71 @@ BOOST_AUTO_TEST_CASE( read_2d_mesh )
   domain.write_mesh("quadtriag.msh");
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( asynchronous_write )
+{
+  Mesh& mesh = *Handle<Mesh>(Core::instance().root().access_component_checked("domain/mesh"));
+  Field& nodal = *Handle<Field>(mesh.geometry_fields().get_child("nodal"));
+
+  std::vector<URI> fields;
+  fields.push_back(nodal.uri());
+
+  WriteMesh& write_mesh = *Core::instance().root().create_component<WriteMesh>("async_write_mesh");
+  write_mesh.write_mesh(mesh,"quadtriag_sync.msh",fields);
+
+  // the file is written from a snapshot, so changing the field afterwards must not change the file
+  write_mesh.options().configure_option("asynchronous",true);
+  write_mesh.write_mesh(mesh,"quadtriag_async.msh",fields);
+  for (Uint n=0; n<nodal.size(); ++n)
+  {
+    for(Uint j=0; j<nodal.row_size(); ++j)
+      nodal[n][j] = -1.;
+  }
+  write_mesh.flush();
+
+  std::ifstream sync_file("quadtriag_sync.msh");
+  std::ifstream async_file("quadtriag_async.msh");
+  const std::string sync_contents( (std::istreambuf_iterator<char>(sync_file)), std::istreambuf_iterator<char>() );
+  const std::string async_contents( (std::istreambuf_iterator<char>(async_file)), std::istreambuf_iterator<char>() );
+  BOOST_CHECK(!sync_contents.empty());
+  BOOST_CHECK(sync_contents == async_contents);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( asynchronous_write_before_transform )
+{
+  Mesh& mesh = *Handle<Mesh>(Core::instance().root().access_component_checked("domain/mesh"));
+  Field& nodal = *Handle<Field>(mesh.geometry_fields().get_child("nodal"));
+
+  std::vector<URI> fields;
+  fields.push_back(nodal.uri());
+
+  WriteMesh& write_mesh = *Handle<WriteMesh>(Core::instance().root().access_component_checked("async_write_mesh"));
+  write_mesh.options().configure_option("asynchronous",false);
+  write_mesh.write_mesh(mesh,"quadtriag_sync.msh",fields);
+  write_mesh.write_mesh(mesh,"quadtriag_sync.plt",fields);
+
+  write_mesh.options().configure_option("asynchronous",true);
+  write_mesh.write_mesh(mesh,"quadtriag_async.msh",fields);
+  write_mesh.write_mesh(mesh,"quadtriag_async.plt",fields);
+
+  // Renumbering reorders the nodes and elements, so the pending writes must finish before it starts
+  build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.Renumber","renumber")->transform(mesh);
+
+  const std::string extensions[] = {".msh", ".plt"};
+  for (Uint i=0; i<2; ++i)
+  {
+    std::ifstream sync_file(("quadtriag_sync"+extensions[i]).c_str());
+    std::ifstream async_file(("quadtriag_async"+extensions[i]).c_str());
+    const std::string sync_contents( (std::istreambuf_iterator<char>(sync_file)), std::istreambuf_iterator<char>() );
+    const std::string async_contents( (std::istreambuf_iterator<char>(async_file)), std::istreambuf_iterator<char>() );
+    BOOST_CHECK(!sync_contents.empty());
+    BOOST_CHECK(sync_contents == async_contents);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /*
 BOOST_AUTO_TEST_CASE( threeD_test )
@@ -0,0 +1,103 @@
+import sys
+from coolfluid import *
+
+try:
+  import numpy
+except ImportError:
+  print 'numpy is not available, skipping test'
+  sys.exit(0)
+
+root = Core.root()
+env = Core.environment()
+
+env.options().configure_option('assertion_backtrace', False)
+env.options().configure_option('exception_backtrace', False)
+env.options().configure_option('regist_signal_handlers', False)
+env.options().configure_option('exception_log_level', 0)
+env.options().configure_option('log_level', 4)
+env.options().configure_option('exception_outputs', False)
+
+# Real table: the array shares its memory with the table
+table = root.create_component("real_table", "cf3.common.Table<real>")
+table.set_row_size(3)
+table.resize(4)
+
+values = table.array()
+cf_check_equal(values.shape, (4, 3), 'Incorrect array shape')
+
+values[:,1] = numpy.arange(4)
+values[2,2] = 5.
+cf_check_equal(table[3][1], 3., 'Array write not seen in the table')
+cf_check_equal(table[2][2], 5., 'Array write not seen in the table')
+
+table[0][0] = 7.
+cf_check_equal(values[0,0], 7., 'Table write not seen in the array')
+
+# Uint table
+conn = root.create_component("uint_table", "cf3.common.Table<unsigned>")
+conn.set_row_size(2)
+conn.resize(2)
+conn[1] = [4, 2]
+indices = conn.array()
+cf_check_equal(indices[1,0], 4, 'Incorrect unsigned array value')
+cf_check_equal(indices.sum(), 6, 'Incorrect unsigned array sum')
+
+# Empty table
+empty = root.create_component("empty_table", "cf3.common.Table<real>")
+cf_check_equal(empty.array().size, 0, 'Empty table must give an empty array')
+
+# Resizing moves the storage: the base of the array holds the table, and reports it
+cf_check(values.base.valid, 'Array must be valid while the table keeps its storage')
+table.resize(100)
+cf_check(not values.base.valid, 'Array must be invalid after the table is resized')
+try:
+  values.base.__array_interface__
+  cf_error('Array interface of a resized table must not be given')
+except RuntimeError:
+  pass
+
+values = table.array()
+cf_check_equal(values.shape, (100, 3), 'Incorrect array shape after resize')
+values[99,2] = 11.
+
+# The array shares ownership of the table, so removing it from the tree does not free the memory
+table.delete_component()
+cf_check(values.base.valid, 'Array must stay valid after the table is removed from the tree')
+cf_check_equal(values.base.owner.name(), 'real_table', 'The base of the array must expose the table')
+cf_check_equal(values.base.owner[99][2], 11., 'The table kept alive by the array must keep its values')
+values[0,0] = 1.
+cf_check_equal(values.base.owner[0][0], 1., 'Array write not seen in the table kept alive by the array')
+
+# Field of a mesh, which is a Table<real>
+mesh = root.create_component('mesh', 'cf3.mesh.Mesh')
+mesh_generator = root.create_component('mesh_generator', 'cf3.mesh.SimpleMeshGenerator')
+mesh_generator.options().configure_option('mesh', mesh.uri())
+mesh_generator.options().configure_option('nb_cells', [4, 2])
+mesh_generator.options().configure_option('lengths', [4., 2.])
+mesh_generator.execute()
+
+geometry = mesh.get_child('geometry')
+geometry.create_field(name = 'field', variables = 'a[1],b[1]')
+field = geometry.get_child('field')
+
+field_values = field.array()
+cf_check_equal(field_values.shape, (15, 2), 'Incorrect field array shape')
+field_values[:,1] = numpy.arange(15)
+cf_check_equal(field[7][1], 7., 'Array write not seen in the field')
+field[3][0] = -2.
+cf_check_equal(field_values[3,0], -2., 'Field write not seen in the array')
+cf_check(field_values.base.valid, 'Field array must be valid')
+
+# Vector of the native linear system, with one block row per node of the mesh
+vector = root.create_component('vector', 'cf3.math.LSS.NativeVector')
+vector.create(geometry, 3)
+
+vector_values = vector.array()
+cf_check_equal(vector_values.shape, (15, 3), 'Incorrect vector array shape')
+vector_values[4,:] = [1., 2., 3.]
+cf_check_equal(vector.array()[4,2], 3., 'Array write not seen in the vector')
+cf_check_equal(vector.array().sum(), 6., 'Incorrect vector array sum')
+
+vector.create(geometry, 1)
+cf_check(not vector_values.base.valid, 'Array must be invalid after the vector is created again')
+cf_check_equal(vector.array().shape, (15, 1), 'Incorrect vector array shape after create')
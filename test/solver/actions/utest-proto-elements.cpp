@@ -25,6 +25,8 @@
 #include "mesh/ElementData.hpp"
 #include "mesh/FieldManager.hpp"
 #include "mesh/Dictionary.hpp"
+#include "mesh/Functions.hpp"
+#include "mesh/Space.hpp"
 
 #include "mesh/Integrators/Gauss.hpp"
 #include "mesh/ElementTypes.hpp"
@@ -226,6 +228,92 @@ BOOST_AUTO_TEST_CASE( ProtoVectorElementField )
   writer.execute();
 }
 
+
+// Test the threaded element loop, which assembles colored batches of elements concurrently
+BOOST_AUTO_TEST_CASE( ProtoThreadedElementField )
+{
+  // Setup a model
+  Model& model = *Core::instance().root().create_component<Model>("ThreadedModel");
+  physics::PhysModel& phys_model = model.create_physics("cf3.physics.DynamicModel");
+  Domain& dom = model.create_domain("Domain");
+  Solver& solver = model.create_solver("cf3.solver.SimpleSolver");
+
+  Mesh& mesh = *dom.create_component<Mesh>("mesh");
+
+  const Real length = 20.;
+  const Real height = 20.;
+  const Real ratio = 0.2;
+  const Uint x_segs = 20;
+  const Uint y_segs = 20;
+
+  BlockMesh::BlockArrays& blocks = *dom.create_component<BlockMesh::BlockArrays>("blocks");
+
+  *blocks.create_points(2, 4) << 0. << 0. << length << 0. << length << height << 0. << height;
+  *blocks.create_blocks(1) << 0 << 1 << 2 << 3;
+  *blocks.create_block_subdivisions() << x_segs << y_segs;
+  *blocks.create_block_gradings() << ratio << ratio << ratio << ratio;
+
+  *blocks.create_patch("bottom", 1) << 0 << 1;
+  *blocks.create_patch("right", 1) << 1 << 2;
+  *blocks.create_patch("top", 1) << 2 << 3;
+  *blocks.create_patch("left", 1) << 3 << 0;
+
+  blocks.create_mesh(mesh);
+
+  // Check the coloring: all elements must be colored, and no two elements of a color may share a node
+  Elements& cells = find_component_recursively_with_filter<Elements>(mesh.topology(), IsElementsVolume());
+  std::vector< std::vector<Uint> > colors;
+  build_element_colors(cells.geometry_space().connectivity(), mesh.geometry_fields().size(), colors);
+  BOOST_CHECK_EQUAL(colors.size(), 4u); // Structured quads need 4 colors
+  Uint nb_colored = 0;
+  BOOST_FOREACH(const std::vector<Uint>& color, colors)
+  {
+    std::vector<bool> node_used(mesh.geometry_fields().size(), false);
+    BOOST_FOREACH(const Uint elem, color)
+    {
+      BOOST_FOREACH(const Uint node, cells.geometry_space().connectivity()[elem])
+      {
+        BOOST_CHECK(!node_used[node]);
+        node_used[node] = true;
+      }
+    }
+    nb_colored += color.size();
+  }
+  BOOST_CHECK_EQUAL(nb_colored, cells.size());
+
+  MeshTerm<0, ScalarField> V("CellVolume", "volumes");
+
+  Real total_error = 0;
+
+  boost::mpl::vector2<mesh::LagrangeP0::Quad, mesh::LagrangeP1::Quad2D> allowed_elements;
+
+  boost::shared_ptr<Expression> volumes = elements_expression
+  (
+    allowed_elements,
+    V = (nodes[1][0] - nodes[0][0]) * (nodes[3][1] - nodes[0][1])
+  );
+
+  volumes->register_variables(phys_model);
+
+  // The error is accumulated into a single scalar, so it is computed serially
+  solver
+    << create_proto_action("Volumes", volumes)
+    << create_proto_action("Output", elements_expression(allowed_elements, total_error += V - volume));
+
+  solver.get_child("Volumes")->options().configure_option("nb_threads", 4u);
+
+  Dictionary& elems_P0 = mesh.create_discontinuous_space("elems_P0","cf3.mesh.LagrangeP0");
+  solver.field_manager().create_field("volumes", elems_P0);
+
+  std::vector<URI> root_regions;
+  root_regions.push_back(mesh.topology().uri());
+  solver.configure_option_recursively(solver::Tags::regions(), root_regions);
+
+  model.simulate();
+
+  BOOST_CHECK_SMALL(total_error, 1e-12);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
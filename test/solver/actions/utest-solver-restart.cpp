@@ -0,0 +1,141 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::solver::actions::WriteRestartFile and ReadRestartFile"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/OptionList.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/List.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/MeshGenerator.hpp"
+
+#include "solver/Time.hpp"
+#include "solver/Tags.hpp"
+#include "solver/actions/WriteRestartFile.hpp"
+#include "solver/actions/ReadRestartFile.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver;
+using namespace cf3::solver::actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct RestartFixture
+{
+  RestartFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  int    m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( RestartSuite, RestartFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( write_and_read )
+{
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("mesh");
+  boost::shared_ptr< MeshGenerator > generate_mesh = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","meshgenerator");
+  generate_mesh->options().configure_option("nb_cells",std::vector<Uint>(2,8));
+  generate_mesh->options().configure_option("lengths",std::vector<Real>(2,1.));
+  generate_mesh->options().configure_option("mesh",mesh->uri());
+  generate_mesh->execute();
+
+  Dictionary& solution = mesh->create_discontinuous_space("solution","cf3.mesh.LagrangeP1");
+  Field& u = solution.create_field("u","u[vector]");
+  Field& p = mesh->geometry_fields().create_field("p","p[scalar]");
+  for (Uint i=0; i<u.size(); ++i)
+    for (Uint j=0; j<u.row_size(); ++j)
+      u[i][j] = solution.glb_idx()[i] + 0.25*j;
+  for (Uint i=0; i<p.size(); ++i)
+    p[i][0] = 2.*mesh->geometry_fields().glb_idx()[i];
+
+  Handle<Time> time = Core::instance().root().create_component<Time>("time");
+  time->options().configure_option("iteration", 42u);
+  time->options().configure_option("current_time", 1.5);
+  time->options().configure_option("time_step", 0.25);
+
+  Handle<WriteRestartFile> writer = Core::instance().root().create_component<WriteRestartFile>("write_restart");
+  writer->options().configure_option("mesh", mesh);
+  writer->options().configure_option(solver::Tags::time(), time);
+  writer->options().configure_option("file", URI("utest-solver-restart.cf3restart"));
+  writer->execute();
+
+  // Destroy the state
+  for (Uint i=0; i<u.size(); ++i)
+    u[i][0] = 0.;
+  for (Uint i=0; i<p.size(); ++i)
+    p[i][0] = 0.;
+  time->options().configure_option("iteration", 0u);
+  time->options().configure_option("current_time", 0.);
+  time->options().configure_option("time_step", 1.);
+
+  Handle<ReadRestartFile> reader = Core::instance().root().create_component<ReadRestartFile>("read_restart");
+  reader->options().configure_option("mesh", mesh);
+  reader->options().configure_option(solver::Tags::time(), time);
+  reader->options().configure_option("file", URI("utest-solver-restart.cf3restart"));
+  reader->execute();
+
+  for (Uint i=0; i<u.size(); ++i)
+    for (Uint j=0; j<u.row_size(); ++j)
+      BOOST_CHECK_EQUAL(u[i][j], solution.glb_idx()[i] + 0.25*j);
+  for (Uint i=0; i<p.size(); ++i)
+    BOOST_CHECK_EQUAL(p[i][0], 2.*mesh->geometry_fields().glb_idx()[i]);
+
+  BOOST_CHECK_EQUAL(time->iter(), 42u);
+  BOOST_CHECK_EQUAL(time->current_time(), 1.5);
+  BOOST_CHECK_EQUAL(time->dt(), 0.25);
+  BOOST_CHECK_EQUAL(time->invdt(), 4.);
+
+  // A mesh with a different size can't be restored from the same file
+  Handle<Mesh> coarse = Core::instance().root().create_component<Mesh>("coarse");
+  generate_mesh->options().configure_option("nb_cells",std::vector<Uint>(2,4));
+  generate_mesh->options().configure_option("mesh",coarse->uri());
+  generate_mesh->execute();
+  coarse->create_discontinuous_space("solution","cf3.mesh.LagrangeP1").create_field("u","u[vector]");
+  coarse->geometry_fields().create_field("p","p[scalar]");
+
+  reader->options().configure_option("mesh", coarse);
+  BOOST_CHECK_THROW(reader->execute(), common::FileFormatError);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,109 @@
+#!python
+# -*- coding: utf-8 -*-
+
+# Runs the benchmark executables (ptest-*-benchmark-*) for a range of process counts,
+# and merges the JSON files they write into one summary.
+#
+# usage: benchmark-suite.py --build-dir <dir> --source-dir <dir> [--mpirun mpirun] [--max-procs 4]
+#                           [--cells 200] [--weak] [--output-dir benchmark-results] [--skip-missing]
+#                           [benchmark names]
+#
+# The benchmarks are performance tests, built only with CF3_ENABLE_PERFORMANCE_TESTS=ON.
+# A selected benchmark that was not built is an error, unless --skip-missing is given.
+#
+# With --weak the number of cells per direction grows with the square root of the number of
+# processes, so the load per process is constant. Otherwise the mesh size is fixed.
+
+from __future__ import print_function
+
+import json
+import math
+import optparse
+import os
+import subprocess
+import sys
+
+# name, executable relative to the build directory, arguments as a function of (cells per direction, source directory)
+benchmarks = [
+  ('mesh-synchronize', 'test/mesh/ptest-mesh-benchmark-synchronize',
+    lambda cells, src: [cells, cells, 100]),
+  ('ufem-heat', 'plugins/UFEM/test/ptest-ufem-benchmark-heat',
+    lambda cells, src: [os.path.join(src, 'plugins/UFEM/test/solver.xml'), cells, cells, 10]),
+  ('rdm-lda', 'plugins/RDM/test/ptest-rdm-benchmark-lda',
+    lambda cells, src: [cells, cells, 10]),
+  ('sdm-convection', 'plugins/sdm/test/ptest-sdm-benchmark-convection',
+    lambda cells, src: [max(cells // 2, 1), max(cells // 2, 1), 3, 10])
+]
+
+parser = optparse.OptionParser()
+parser.add_option('--build-dir', default='.', help='coolfluid build directory')
+parser.add_option('--source-dir', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'), help='coolfluid source directory')
+parser.add_option('--mpirun', default='mpirun', help='command to start MPI programs')
+parser.add_option('--max-procs', type='int', default=1, help='run on 1, 2, 4, ... up to this number of processes')
+parser.add_option('--cells', type='int', default=200, help='number of cells per direction, on one process')
+parser.add_option('--weak', action='store_true', default=False, help='keep the number of cells per process constant')
+parser.add_option('--output-dir', default='benchmark-results', help='directory for the JSON files')
+parser.add_option('--skip-missing', action='store_true', default=False, help='warn about benchmarks that were not built, instead of failing')
+(options, selected) = parser.parse_args()
+
+unknown = [name for name in selected if name not in [benchmark[0] for benchmark in benchmarks]]
+if unknown:
+  parser.error('unknown benchmarks: ' + ', '.join(unknown))
+
+build_dir = os.path.abspath(options.build_dir)
+source_dir = os.path.abspath(options.source_dir)
+output_dir = os.path.abspath(options.output_dir)
+if not os.path.isdir(output_dir):
+  os.makedirs(output_dir)
+
+nb_procs_lst = [1]
+while 2*nb_procs_lst[-1] <= options.max_procs:
+  nb_procs_lst.append(2*nb_procs_lst[-1])
+
+results = []
+failures = []
+missing = []
+for (name, executable, arguments) in benchmarks:
+  if selected and name not in selected:
+    continue
+  command = os.path.join(build_dir, executable)
+  if not os.path.exists(command):
+    print('WARNING:' if options.skip_missing else 'ERROR:', name, 'was not built, expected', command, file=sys.stderr)
+    missing.append(name)
+    continue
+
+  for nb_procs in nb_procs_lst:
+    cells = options.cells
+    if options.weak:
+      cells = int(round(cells * math.sqrt(nb_procs)))
+    cmd = [options.mpirun, '-np', str(nb_procs), command] + [str(arg) for arg in arguments(cells, source_dir)]
+    print('running', ' '.join(cmd))
+    sys.stdout.flush()
+
+    log = open(os.path.join(output_dir, 'benchmark-%s-P%d.log' % (name, nb_procs)), 'w')
+    status = subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT, cwd=output_dir)
+    log.close()
+    if status != 0:
+      print('  failed with status', status, '- see', log.name)
+      failures.append('%s on %d processes' % (name, nb_procs))
+      continue
+
+    report = open(os.path.join(output_dir, 'benchmark-%s-P%d.json' % (name, nb_procs)))
+    result = json.load(report)
+    report.close()
+    results.append(result)
+    for kernel in result['kernels']:
+      print('  %-32s %12.6f s per call (max over processes)' % (kernel['name'], kernel['max_per_call']))
+
+summary_filename = os.path.join(output_dir, 'benchmark-summary.json')
+summary = open(summary_filename, 'w')
+json.dump({'weak_scaling': options.weak, 'cells': options.cells, 'results': results}, summary, indent=2)
+summary.close()
+print('summary written to', summary_filename)
+
+if missing:
+  print('benchmarks not built:', ', '.join(missing), '(configure with CF3_ENABLE_PERFORMANCE_TESTS=ON and the required plugins)')
+if failures:
+  print('failed runs:', ', '.join(failures))
+if failures or (missing and not options.skip_missing):
+  sys.exit(1)